@@ -0,0 +1,596 @@
+/**
+ * @file fake_mpi.c
+ * @brief Stub MPI layer simulating every process of a run inside a single one, so that the aggregator can be tested at scale on a single node.
+ * @details Linked before the MPI library, the routines below take precedence over those of the library, which is never initialised. Windows only hold the memory of MPI process 0: puts, gets and accumulates replacing data targeting it are memory copies, other accumulates and operations targeting virtual ranks are dropped. Collectives behave as if the virtual ranks contributed zeros. Point-to-point communications complete at once, unless the next one is made to hang with MPIM_fake_hang_next_call.
+ * Only the routines called by the monitor and by the simulated applications are provided; any other one would reach the uninitialised MPI library.
+ **/
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> // memcpy
+#include <time.h> // clock_gettime
+#include "fake_mpi.h"
+
+/// Maximum number of datatypes created and not freed at a time
+#define MPIM_FAKE_MAX_DATATYPES 64
+
+/// A window of the stub, of which only the memory of MPI process 0 exists
+struct MPIM_fake_window_t
+{
+    /// The memory exposed by MPI process 0
+    char* base;
+    /// Indicates if the memory was allocated by MPI_Win_allocate, which the monitor only uses for the slots of the aggregator
+    bool slots;
+    /// The identifier of the window, as given by MPI_Win_c2f
+    MPI_Fint identifier;
+};
+
+/// A datatype created by the stub
+struct MPIM_fake_datatype_t
+{
+    /// The size of the datatype, in bytes
+    int size;
+};
+
+/// The size of MPI_COMM_WORLD
+int MPIM_fake_comm_size = 1;
+/// The virtual rank on behalf of which the calls are issued
+int MPIM_fake_rank = 0;
+/// The level of thread support given by MPI_Init_thread
+int MPIM_fake_thread_support = MPI_THREAD_SINGLE;
+/// Indicates if the next communication of the selected virtual rank hangs
+bool MPIM_fake_hang_pending = false;
+/// Indicates if the selected virtual rank hangs in a communication, its updates being dropped
+bool MPIM_fake_hanging = false;
+/// Indicates if the updates go to the slot of every virtual rank
+bool MPIM_fake_broadcast = false;
+/// Number of updates published to the aggregator
+uint64_t MPIM_fake_update_count = 0;
+/// Number of windows created so far, from which their identifiers are drawn
+MPI_Fint MPIM_fake_window_count = 0;
+/// The datatypes created and not freed yet
+struct MPIM_fake_datatype_t* MPIM_fake_datatypes[MPIM_FAKE_MAX_DATATYPES];
+
+void MPIM_fake_set_comm_size(int comm_size)
+{
+    MPIM_fake_comm_size = comm_size;
+}
+
+void MPIM_fake_set_rank(int rank)
+{
+    MPIM_fake_rank = rank;
+    MPIM_fake_hang_pending = false;
+    MPIM_fake_hanging = false;
+}
+
+void MPIM_fake_hang_next_call()
+{
+    MPIM_fake_hang_pending = true;
+}
+
+void MPIM_fake_set_broadcast(bool broadcast)
+{
+    MPIM_fake_broadcast = broadcast;
+}
+
+uint64_t MPIM_fake_get_update_count()
+{
+    return MPIM_fake_update_count;
+}
+
+/**
+ * @brief Starts a communication of the selected virtual rank, which hangs if requested.
+ **/
+static void MPIM_fake_communicate()
+{
+    if(MPIM_fake_hang_pending)
+    {
+        MPIM_fake_hang_pending = false;
+        MPIM_fake_hanging = true;
+    }
+}
+
+/**
+ * @brief Gives the size of a datatype, predefined or created by the stub.
+ * @param[in] datatype The datatype.
+ * @return The size of the datatype in bytes, 0 if it is unknown.
+ **/
+static int MPIM_fake_get_size(MPI_Datatype datatype)
+{
+    for(int i = 0; i < MPIM_FAKE_MAX_DATATYPES; i++)
+    {
+        if(MPIM_fake_datatypes[i] != NULL && (MPI_Datatype)(void*)MPIM_fake_datatypes[i] == datatype)
+        {
+            return MPIM_fake_datatypes[i]->size;
+        }
+    }
+    if(datatype == MPI_CHAR || datatype == MPI_SIGNED_CHAR || datatype == MPI_UNSIGNED_CHAR || datatype == MPI_BYTE || datatype == MPI_INT8_T || datatype == MPI_UINT8_T)
+    {
+        return 1;
+    }
+    if(datatype == MPI_SHORT || datatype == MPI_UNSIGNED_SHORT || datatype == MPI_INT16_T || datatype == MPI_UINT16_T)
+    {
+        return 2;
+    }
+    if(datatype == MPI_INT || datatype == MPI_UNSIGNED || datatype == MPI_FLOAT || datatype == MPI_INT32_T || datatype == MPI_UINT32_T)
+    {
+        return 4;
+    }
+    if(datatype == MPI_LONG || datatype == MPI_UNSIGNED_LONG || datatype == MPI_LONG_LONG || datatype == MPI_UNSIGNED_LONG_LONG || datatype == MPI_DOUBLE || datatype == MPI_INT64_T || datatype == MPI_UINT64_T || datatype == MPI_AINT)
+    {
+        return 8;
+    }
+    return 0;
+}
+
+/**
+ * @brief Copies the contribution of MPI process 0 to a collective, the buffer being left untouched if it is given in place.
+ * @param[in] source The contribution, or MPI_IN_PLACE.
+ * @param[out] destination The buffer receiving the contribution, NULL if there is none.
+ * @param[in] count The number of elements of the contribution.
+ * @param[in] datatype The datatype of the elements.
+ **/
+static void MPIM_fake_copy(const void* source, void* destination, int count, MPI_Datatype datatype)
+{
+    if(source != MPI_IN_PLACE && destination != NULL)
+    {
+        memcpy(destination, source, (size_t)count * MPIM_fake_get_size(datatype));
+    }
+}
+
+int MPI_Init(int* argc, char*** argv)
+{
+    (void)argc;
+    (void)argv;
+    return MPI_SUCCESS;
+}
+
+int MPI_Init_thread(int* argc, char*** argv, int required, int* provided)
+{
+    (void)argc;
+    (void)argv;
+    MPIM_fake_thread_support = required;
+    *provided = required;
+    return MPI_SUCCESS;
+}
+
+int MPI_Query_thread(int* provided)
+{
+    *provided = MPIM_fake_thread_support;
+    return MPI_SUCCESS;
+}
+
+int MPI_Finalize(void)
+{
+    return MPI_SUCCESS;
+}
+
+int MPI_Abort(MPI_Comm comm, int errorcode)
+{
+    (void)comm;
+    fprintf(stderr, "MPI_Abort called by virtual rank %d with error code %d.\n", MPIM_fake_rank, errorcode);
+    exit(errorcode);
+}
+
+double MPI_Wtime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1.0E-9;
+}
+
+int MPI_Comm_size(MPI_Comm comm, int* size)
+{
+    *size = (comm == MPI_COMM_SELF) ? 1 : MPIM_fake_comm_size;
+    return MPI_SUCCESS;
+}
+
+int MPI_Comm_rank(MPI_Comm comm, int* rank)
+{
+    *rank = (comm == MPI_COMM_SELF) ? 0 : MPIM_fake_rank;
+    return MPI_SUCCESS;
+}
+
+MPI_Fint MPI_Comm_c2f(MPI_Comm comm)
+{
+    // The communicators of the stub are those predefined, with the identifiers of Open MPI
+    if(comm == MPI_COMM_WORLD)
+    {
+        return 0;
+    }
+    return (comm == MPI_COMM_SELF) ? 1 : 2;
+}
+
+MPI_Comm MPI_Comm_f2c(MPI_Fint comm)
+{
+    if(comm == 0)
+    {
+        return MPI_COMM_WORLD;
+    }
+    return (comm == 1) ? MPI_COMM_SELF : MPI_COMM_NULL;
+}
+
+int MPI_Comm_dup(MPI_Comm comm, MPI_Comm* newcomm)
+{
+    *newcomm = comm;
+    return MPI_SUCCESS;
+}
+
+int MPI_Comm_free(MPI_Comm* comm)
+{
+    *comm = MPI_COMM_NULL;
+    return MPI_SUCCESS;
+}
+
+int MPI_Comm_test_inter(MPI_Comm comm, int* flag)
+{
+    (void)comm;
+    *flag = 0;
+    return MPI_SUCCESS;
+}
+
+int MPI_Comm_group(MPI_Comm comm, MPI_Group* group)
+{
+    (void)comm;
+    *group = MPI_GROUP_EMPTY;
+    return MPI_SUCCESS;
+}
+
+int MPI_Group_translate_ranks(MPI_Group group1, int n, const int ranks1[], MPI_Group group2, int ranks2[])
+{
+    (void)group1;
+    (void)group2;
+    memcpy(ranks2, ranks1, n * sizeof(int));
+    return MPI_SUCCESS;
+}
+
+int MPI_Group_free(MPI_Group* group)
+{
+    *group = MPI_GROUP_NULL;
+    return MPI_SUCCESS;
+}
+
+int MPI_Type_size(MPI_Datatype type, int* size)
+{
+    *size = MPIM_fake_get_size(type);
+    return (*size == 0) ? MPI_ERR_TYPE : MPI_SUCCESS;
+}
+
+int MPI_Type_contiguous(int count, MPI_Datatype oldtype, MPI_Datatype* newtype)
+{
+    for(int i = 0; i < MPIM_FAKE_MAX_DATATYPES; i++)
+    {
+        if(MPIM_fake_datatypes[i] == NULL)
+        {
+            MPIM_fake_datatypes[i] = (struct MPIM_fake_datatype_t*)malloc(sizeof(struct MPIM_fake_datatype_t));
+            MPIM_fake_datatypes[i]->size = count * MPIM_fake_get_size(oldtype);
+            *newtype = (MPI_Datatype)(void*)MPIM_fake_datatypes[i];
+            return MPI_SUCCESS;
+        }
+    }
+    return MPI_ERR_INTERN;
+}
+
+int MPI_Type_commit(MPI_Datatype* type)
+{
+    (void)type;
+    return MPI_SUCCESS;
+}
+
+int MPI_Type_free(MPI_Datatype* type)
+{
+    for(int i = 0; i < MPIM_FAKE_MAX_DATATYPES; i++)
+    {
+        if(MPIM_fake_datatypes[i] != NULL && (MPI_Datatype)(void*)MPIM_fake_datatypes[i] == *type)
+        {
+            free(MPIM_fake_datatypes[i]);
+            MPIM_fake_datatypes[i] = NULL;
+        }
+    }
+    *type = MPI_DATATYPE_NULL;
+    return MPI_SUCCESS;
+}
+
+int MPI_Op_create(MPI_User_function* function, int commute, MPI_Op* op)
+{
+    (void)commute;
+    // Never applied, as only MPI process 0 contributes to reductions; any handle distinct from MPI_OP_NULL does
+    *op = (MPI_Op)(void*)function;
+    return MPI_SUCCESS;
+}
+
+int MPI_Op_free(MPI_Op* op)
+{
+    *op = MPI_OP_NULL;
+    return MPI_SUCCESS;
+}
+
+int MPI_Info_create(MPI_Info* info)
+{
+    *info = MPI_INFO_NULL;
+    return MPI_SUCCESS;
+}
+
+int MPI_Info_set(MPI_Info info, const char* key, const char* value)
+{
+    (void)info;
+    (void)key;
+    (void)value;
+    return MPI_SUCCESS;
+}
+
+int MPI_Info_free(MPI_Info* info)
+{
+    *info = MPI_INFO_NULL;
+    return MPI_SUCCESS;
+}
+
+int MPI_Win_allocate(MPI_Aint size, int disp_unit, MPI_Info info, MPI_Comm comm, void* baseptr, MPI_Win* win)
+{
+    (void)disp_unit;
+    (void)info;
+    (void)comm;
+    struct MPIM_fake_window_t* window = (struct MPIM_fake_window_t*)malloc(sizeof(struct MPIM_fake_window_t));
+    window->base = (char*)calloc(1, (size > 0) ? size : 1);
+    window->slots = true;
+    window->identifier = ++MPIM_fake_window_count;
+    *(void**)baseptr = window->base;
+    *win = (MPI_Win)(void*)window;
+    return MPI_SUCCESS;
+}
+
+int MPI_Win_create(void* base, MPI_Aint size, int disp_unit, MPI_Info info, MPI_Comm comm, MPI_Win* win)
+{
+    (void)size;
+    (void)disp_unit;
+    (void)info;
+    (void)comm;
+    struct MPIM_fake_window_t* window = (struct MPIM_fake_window_t*)malloc(sizeof(struct MPIM_fake_window_t));
+    window->base = (char*)base;
+    window->slots = false;
+    window->identifier = ++MPIM_fake_window_count;
+    *win = (MPI_Win)(void*)window;
+    return MPI_SUCCESS;
+}
+
+int MPI_Win_free(MPI_Win* win)
+{
+    struct MPIM_fake_window_t* window = (struct MPIM_fake_window_t*)(void*)*win;
+    if(window->slots)
+    {
+        free(window->base);
+    }
+    free(window);
+    *win = MPI_WIN_NULL;
+    return MPI_SUCCESS;
+}
+
+MPI_Fint MPI_Win_c2f(MPI_Win win)
+{
+    return (win == MPI_WIN_NULL) ? 0 : ((struct MPIM_fake_window_t*)(void*)win)->identifier;
+}
+
+int MPI_Win_lock(int lock_type, int rank, int assert, MPI_Win win)
+{
+    (void)lock_type;
+    (void)rank;
+    (void)assert;
+    (void)win;
+    return MPI_SUCCESS;
+}
+
+int MPI_Win_unlock(int rank, MPI_Win win)
+{
+    (void)rank;
+    (void)win;
+    return MPI_SUCCESS;
+}
+
+int MPI_Win_lock_all(int assert, MPI_Win win)
+{
+    (void)assert;
+    (void)win;
+    return MPI_SUCCESS;
+}
+
+int MPI_Win_unlock_all(MPI_Win win)
+{
+    (void)win;
+    return MPI_SUCCESS;
+}
+
+int MPI_Win_flush(int rank, MPI_Win win)
+{
+    (void)rank;
+    (void)win;
+    return MPI_SUCCESS;
+}
+
+int MPI_Win_flush_all(MPI_Win win)
+{
+    (void)win;
+    return MPI_SUCCESS;
+}
+
+int MPI_Win_flush_local(int rank, MPI_Win win)
+{
+    (void)rank;
+    (void)win;
+    return MPI_SUCCESS;
+}
+
+int MPI_Put(const void* origin_addr, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_disp, int target_count, MPI_Datatype target_datatype, MPI_Win win)
+{
+    (void)target_count;
+    (void)target_datatype;
+    struct MPIM_fake_window_t* window = (struct MPIM_fake_window_t*)(void*)win;
+    if(target_rank != 0)
+    {
+        return MPI_SUCCESS;
+    }
+    size_t length = (size_t)origin_count * MPIM_fake_get_size(origin_datatype);
+    if(!window->slots)
+    {
+        memcpy(window->base + target_disp, origin_addr, length);
+        return MPI_SUCCESS;
+    }
+    // The monitor puts to the slot of its own rank, 0, so the slot of a virtual rank lies as many slots further
+    if(MPIM_fake_broadcast)
+    {
+        for(int rank = 0; rank < MPIM_fake_comm_size; rank++)
+        {
+            memcpy(window->base + target_disp + rank * length, origin_addr, length);
+        }
+        MPIM_fake_update_count += MPIM_fake_comm_size;
+    }
+    else if(!MPIM_fake_hanging)
+    {
+        memcpy(window->base + target_disp + MPIM_fake_rank * length, origin_addr, length);
+        MPIM_fake_update_count++;
+    }
+    return MPI_SUCCESS;
+}
+
+int MPI_Get(void* origin_addr, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_disp, int target_count, MPI_Datatype target_datatype, MPI_Win win)
+{
+    (void)target_count;
+    (void)target_datatype;
+    struct MPIM_fake_window_t* window = (struct MPIM_fake_window_t*)(void*)win;
+    size_t length = (size_t)origin_count * MPIM_fake_get_size(origin_datatype);
+    if(target_rank == 0)
+    {
+        memcpy(origin_addr, window->base + target_disp, length);
+    }
+    else
+    {
+        memset(origin_addr, 0, length);
+    }
+    return MPI_SUCCESS;
+}
+
+int MPI_Accumulate(const void* origin_addr, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_disp, int target_count, MPI_Datatype target_datatype, MPI_Op op, MPI_Win win)
+{
+    // The updates of the monitor replace their slot, other accumulates are dropped
+    if(op == MPI_REPLACE)
+    {
+        return MPI_Put(origin_addr, origin_count, origin_datatype, target_rank, target_disp, target_count, target_datatype, win);
+    }
+    return MPI_SUCCESS;
+}
+
+int MPI_Barrier(MPI_Comm comm)
+{
+    (void)comm;
+    MPIM_fake_communicate();
+    return MPI_SUCCESS;
+}
+
+int MPI_Bcast(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm)
+{
+    (void)buffer;
+    (void)count;
+    (void)datatype;
+    (void)root;
+    (void)comm;
+    MPIM_fake_communicate();
+    return MPI_SUCCESS;
+}
+
+int MPI_Reduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm)
+{
+    (void)op;
+    (void)root;
+    (void)comm;
+    MPIM_fake_communicate();
+    MPIM_fake_copy(sendbuf, recvbuf, count, datatype);
+    return MPI_SUCCESS;
+}
+
+int MPI_Ireduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm, MPI_Request* request)
+{
+    *request = MPI_REQUEST_NULL;
+    return MPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+}
+
+int MPI_Allreduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
+{
+    return MPI_Reduce(sendbuf, recvbuf, count, datatype, op, 0, comm);
+}
+
+int MPI_Gather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+    (void)root;
+    (void)comm;
+    MPIM_fake_communicate();
+    size_t length = (size_t)recvcount * MPIM_fake_get_size(recvtype);
+    MPIM_fake_copy(sendbuf, recvbuf, sendcount, sendtype);
+    memset((char*)recvbuf + length, 0, length * (MPIM_fake_comm_size - 1));
+    return MPI_SUCCESS;
+}
+
+int MPI_Igather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm, MPI_Request* request)
+{
+    *request = MPI_REQUEST_NULL;
+    return MPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+}
+
+int MPI_Gatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, const int recvcounts[], const int displs[], MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+    (void)recvcounts;
+    (void)root;
+    (void)comm;
+    MPIM_fake_communicate();
+    // The virtual ranks gathered zero counts beforehand, so only MPI process 0 contributes
+    MPIM_fake_copy(sendbuf, (char*)recvbuf + (size_t)displs[0] * MPIM_fake_get_size(recvtype), sendcount, sendtype);
+    return MPI_SUCCESS;
+}
+
+int MPI_Waitall(int count, MPI_Request array_of_requests[], MPI_Status* array_of_statuses)
+{
+    (void)array_of_statuses;
+    for(int i = 0; i < count; i++)
+    {
+        array_of_requests[i] = MPI_REQUEST_NULL;
+    }
+    return MPI_SUCCESS;
+}
+
+int MPI_Request_free(MPI_Request* request)
+{
+    *request = MPI_REQUEST_NULL;
+    return MPI_SUCCESS;
+}
+
+int MPI_Send(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm)
+{
+    (void)buf;
+    (void)count;
+    (void)datatype;
+    (void)dest;
+    (void)tag;
+    (void)comm;
+    MPIM_fake_communicate();
+    return MPI_SUCCESS;
+}
+
+int MPI_Ssend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm)
+{
+    return MPI_Send(buf, count, datatype, dest, tag, comm);
+}
+
+int MPI_Recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Status* status)
+{
+    (void)buf;
+    (void)count;
+    (void)datatype;
+    (void)comm;
+    MPIM_fake_communicate();
+    if(status != MPI_STATUS_IGNORE)
+    {
+        status->MPI_SOURCE = (source == MPI_ANY_SOURCE) ? 0 : source;
+        status->MPI_TAG = (tag == MPI_ANY_TAG) ? 0 : tag;
+        status->MPI_ERROR = MPI_SUCCESS;
+    }
+    return MPI_SUCCESS;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file fake_mpi.h
+ * @brief Drives the stub MPI layer of fake_mpi.c, which simulates every process of a run inside a single one.
+ * @details The stub replaces the MPI routines called by the monitor and by the simulated applications. The real process is MPI process 0, which runs the aggregator; the other processes are virtual, and the calls issued on their behalf are published to the slot of the virtual rank currently selected.
+ * Every virtual rank has a single slot, the MPIM_THREADS_PER_PROCESS environment variable being ignored.
+ **/
+
+#ifndef FAKE_MPI_H_INCLUDED
+#define FAKE_MPI_H_INCLUDED
+
+#include <stdbool.h> // bool
+#include <stdint.h> // uint64_t
+
+/**
+ * @brief Sets the number of processes of the simulated run, before MPI_Init.
+ * @param[in] comm_size The size of MPI_COMM_WORLD.
+ **/
+void MPIM_fake_set_comm_size(int comm_size);
+
+/**
+ * @brief Selects the virtual rank on behalf of which the next MPI calls are issued.
+ * @details The virtual rank selected is no longer hanging, as its previous call is considered completed.
+ * @param[in] rank The virtual rank.
+ **/
+void MPIM_fake_set_rank(int rank);
+
+/**
+ * @brief Makes the next communication of the virtual rank selected hang: its start is published, its completion is not.
+ **/
+void MPIM_fake_hang_next_call();
+
+/**
+ * @brief Makes the next updates go to the slot of every virtual rank, as when every process calls MPI_Finalize at once.
+ * @param[in] broadcast true to publish the updates to every virtual rank, false to publish them to the selected one only.
+ **/
+void MPIM_fake_set_broadcast(bool broadcast);
+
+/**
+ * @brief Gives the number of updates published to the aggregator so far.
+ * @return The number of puts to the slots of the aggregator.
+ **/
+uint64_t MPIM_fake_get_update_count();
+
+#endif // FAKE_MPI_H_INCLUDED
@@ -0,0 +1,798 @@
+/**
+ * @file mpim_trace.c
+ * @brief Decoder of the traces written by the MPI processes when the MPIM_TRACE_DIRECTORY environment variable is set, printing their events one per line.
+ * @details Usage: mpim-trace [--summary | --wait-states] trace files. With --summary, only the number of events and their size in the trace are printed. With --wait-states, the traces of the processes of a job are analysed together, as the MPIM_WAIT_STATES environment variable does live, to list the processes causing the most waiting time to others. Traces cut short by a killed job are decoded up to their last complete block.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h> // bool
+#include <stdint.h> // uint64_t
+#include <inttypes.h> // PRIu64
+#include <string.h> // strcmp
+#include "mpi_monitor_trace.h"
+#include "mpi_monitor_routines.h"
+
+/// Size of the buffer holding the file name of a callsite.
+#define MPIM_FILE_LENGTH 257
+/// Largest number of callsites defined in a block.
+#define MPIM_MAX_CALLSITES 4096
+/// Largest number of threads per process, as numbered in the blocks.
+#define MPIM_MAX_THREADS 65536
+/// Default number of ranks listed by the wait state analysis, changed with the MPIM_WAIT_STATES_TOP environment variable as for the live analysis.
+#define MPIM_DEFAULT_WAIT_STATES_TOP 5
+
+/// What is done with the events decoded
+enum MPIM_mode_t { /// Every event is printed
+                   MPIM_MODE_PRINT,
+                   /// Only the statistics of the traces are printed
+                   MPIM_MODE_SUMMARY,
+                   /// The events taking part in the wait state analysis are collected
+                   MPIM_MODE_WAIT_STATES };
+
+/// Kinds of events collected for the wait state analysis
+enum MPIM_wait_event_kind_t { /// A point-to-point send started
+                              MPIM_WAIT_EVENT_SEND,
+                              /// A blocking receive completed
+                              MPIM_WAIT_EVENT_RECEIVE,
+                              /// A nonblocking receive was posted
+                              MPIM_WAIT_EVENT_POST,
+                              /// An N-to-N collective started
+                              MPIM_WAIT_EVENT_COLLECTIVE };
+
+/// Classes of waiting time, as told apart by the live analysis
+enum MPIM_wait_state_t { MPIM_WAIT_LATE_SENDER,
+                         MPIM_WAIT_LATE_RECEIVER,
+                         MPIM_WAIT_N_TO_N,
+                         MPIM_WAIT_STATE_COUNT };
+
+/**
+ * @brief A callsite defined in the block being decoded.
+ **/
+struct MPIM_callsite_t
+{
+    /// The routine called, an index in the routine names
+    uint64_t type;
+    /// The line of the call
+    uint64_t line;
+    /// The identity of the module of the call, 0 if unknown
+    uint64_t module;
+    /// The offset of the return address in the module
+    uint64_t offset;
+    /// The file of the call
+    char file[MPIM_FILE_LENGTH];
+    /// The arguments of the last call at the callsite
+    uint64_t kind;
+    /// The communicator, count, datatype size and up to 4 peers and tags of the last call at the callsite
+    int64_t values[7];
+};
+
+/// Statistics of a trace
+struct MPIM_statistics_t
+{
+    /// Number of complete blocks
+    uint64_t blocks;
+    /// Number of events
+    uint64_t events;
+    /// Size of the payloads once decompressed, in bytes
+    uint64_t raw_bytes;
+    /// Size of the trace file, headers included, in bytes
+    uint64_t file_bytes;
+};
+
+/// A point-to-point or N-to-N collective call on MPI_COMM_WORLD, collected for the wait state analysis
+struct MPIM_wait_event_t
+{
+    /// The kind of event
+    enum MPIM_wait_event_kind_t kind;
+    /// The rank of the process issuing the call
+    int32_t rank;
+    /// The destination of a send or the source of a receive
+    int32_t peer;
+    /// The tag of the message, negative for MPI_ANY_TAG
+    int32_t tag;
+    /// Indicates if a send is synchronous, in which case the sender waits for the receive to start
+    bool synchronous;
+    /// Indicates if a send was matched with a receive
+    bool matched;
+    /// The time at which the call started, in seconds on the clock of MPI process 0
+    double start;
+    /// The time at which a blocking receive completed, in seconds on the clock of MPI process 0
+    double end;
+};
+
+/// Waiting time caused by a process to another one
+struct MPIM_wait_pair_t
+{
+    /// The rank of the process that caused the wait
+    int32_t causing;
+    /// The rank of the process that waited
+    int32_t waiting;
+    /// The wait state
+    enum MPIM_wait_state_t state;
+    /// The waiting time, in seconds
+    double seconds;
+};
+
+/// Gives the attributes of a routine, as named in the traces
+#define MPIM_ROUTINE_ATTRIBUTES(TYPE, Name, return_type, attributes, ...) { "MPI_" #Name, attributes },
+
+/// The attributes of the routines monitored, to tell the routines of the events apart
+const struct
+{
+    /// The name of the routine
+    const char* name;
+    /// Its MPIM_ROUTINE_ attributes
+    int attributes;
+} MPIM_routine_attributes[] = { MPIM_ROUTINES(MPIM_ROUTINE_ATTRIBUTES) };
+
+/// The routine names of the trace being decoded
+char** MPIM_names = NULL;
+/// The MPIM_ROUTINE_ attributes of the routines of the trace being decoded, indexed like their names
+int* MPIM_attributes = NULL;
+/// Number of routine names
+uint32_t MPIM_name_count = 0;
+/// The callsites of the block being decoded
+struct MPIM_callsite_t MPIM_callsites[MPIM_MAX_CALLSITES];
+/// The time at which the current call of every thread of the trace being decoded started, in seconds on the clock of MPI process 0
+double MPIM_thread_starts[MPIM_MAX_THREADS];
+/// The events collected for the wait state analysis
+struct MPIM_wait_event_t* MPIM_wait_events = NULL;
+/// Number of events in MPIM_wait_events
+size_t MPIM_wait_event_count = 0;
+/// Number of events MPIM_wait_events can hold
+size_t MPIM_wait_event_capacity = 0;
+/// The waiting times found by the wait state analysis
+struct MPIM_wait_pair_t* MPIM_wait_pairs = NULL;
+/// Number of waiting times in MPIM_wait_pairs
+size_t MPIM_wait_pair_count = 0;
+/// Number of waiting times MPIM_wait_pairs can hold
+size_t MPIM_wait_pair_capacity = 0;
+/// Number of processes of the job, as given by the trace headers
+int MPIM_comm_size = 0;
+
+/**
+ * @brief Gives the number of peers and tags recorded for a kind of arguments.
+ * @param[in] kind The kind of arguments.
+ * @return The number of integers following the datatype size.
+ **/
+static int MPIM_arguments_words(uint64_t kind)
+{
+    switch(kind)
+    {
+        case MPIM_TRACE_ARGUMENTS_SEND:
+        case MPIM_TRACE_ARGUMENTS_RECEIVE:
+        case MPIM_TRACE_ARGUMENTS_RMA:
+            return 2;
+        case MPIM_TRACE_ARGUMENTS_SENDRECV:
+            return 4;
+        case MPIM_TRACE_ARGUMENTS_ROOTED_COLLECTIVE:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Prints the arguments of an event.
+ * @param[in] callsite The callsite of the event, holding its arguments.
+ **/
+static void MPIM_arguments_print(const struct MPIM_callsite_t* callsite)
+{
+    const int64_t* values = callsite->values;
+    switch(callsite->kind)
+    {
+        case MPIM_TRACE_ARGUMENTS_COMMUNICATOR:
+        case MPIM_TRACE_ARGUMENTS_COLLECTIVE:
+            printf(" comm #%" PRId64, values[0]);
+            break;
+        case MPIM_TRACE_ARGUMENTS_SEND:
+        case MPIM_TRACE_ARGUMENTS_RECEIVE:
+            printf(" %s %" PRId64 ", tag %" PRId64 ", comm #%" PRId64, (callsite->kind == MPIM_TRACE_ARGUMENTS_SEND) ? "to" : "from", values[3], values[4], values[0]);
+            break;
+        case MPIM_TRACE_ARGUMENTS_SENDRECV:
+            printf(" to %" PRId64 ", tag %" PRId64 ", from %" PRId64 ", tag %" PRId64 ", comm #%" PRId64, values[3], values[4], values[5], values[6], values[0]);
+            break;
+        case MPIM_TRACE_ARGUMENTS_ROOTED_COLLECTIVE:
+            printf(" root %" PRId64 ", comm #%" PRId64, values[3], values[0]);
+            break;
+        case MPIM_TRACE_ARGUMENTS_RMA:
+            printf(" target %" PRId64 ", win #%" PRId64, values[3], values[4]);
+            break;
+        case MPIM_TRACE_ARGUMENTS_REQUESTS:
+            printf(" %" PRId64 " requests", values[1]);
+            return;
+        default:
+            return;
+    }
+    if(callsite->kind != MPIM_TRACE_ARGUMENTS_COMMUNICATOR)
+    {
+        printf(", %" PRId64 " x %" PRId64 " B", values[1], values[2]);
+    }
+}
+
+/**
+ * @brief Adds an event to the events collected for the wait state analysis.
+ * @param[in] event The event.
+ **/
+static void MPIM_wait_event_add(const struct MPIM_wait_event_t* event)
+{
+    if(MPIM_wait_event_count == MPIM_wait_event_capacity)
+    {
+        MPIM_wait_event_capacity = (MPIM_wait_event_capacity == 0) ? 4096 : 2 * MPIM_wait_event_capacity;
+        MPIM_wait_events = (struct MPIM_wait_event_t*)realloc(MPIM_wait_events, MPIM_wait_event_capacity * sizeof(struct MPIM_wait_event_t));
+        if(MPIM_wait_events == NULL)
+        {
+            printf("Failure in allocating the events of the wait state analysis.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    MPIM_wait_events[MPIM_wait_event_count++] = *event;
+}
+
+/**
+ * @brief Collects an event for the wait state analysis if it is a point-to-point or N-to-N collective call on MPI_COMM_WORLD.
+ * @details Only MPI_COMM_WORLD is analysed, as the traces do not tell the processes of the other communicators. Nonblocking receives are matched with their sends when posted, but the traces do not tell which completion call completed them, so only their late receivers are found.
+ * @param[in] header The trace header.
+ * @param[in] thread The thread issuing the call.
+ * @param[in] callsite The callsite of the event, holding its arguments.
+ * @param[in] started Indicates if the call started, otherwise it completed.
+ * @param[in] time The time of the event, in seconds on the clock of MPI process 0.
+ **/
+static void MPIM_wait_event_collect(const struct MPIM_trace_header_t* header, uint16_t thread, const struct MPIM_callsite_t* callsite, bool started, double time)
+{
+    if(callsite->type >= MPIM_name_count)
+    {
+        return;
+    }
+    int attributes = MPIM_attributes[callsite->type];
+    const int64_t* values = callsite->values;
+    if(started)
+    {
+        MPIM_thread_starts[thread] = time;
+    }
+    if(callsite->kind == MPIM_TRACE_ARGUMENTS_NONE || callsite->kind == MPIM_TRACE_ARGUMENTS_RMA || callsite->kind == MPIM_TRACE_ARGUMENTS_REQUESTS || callsite->kind == MPIM_TRACE_ARGUMENTS_MATCHED_RECEIVE || values[0] != header->world_communicator || (attributes & MPIM_ROUTINE_PERSISTENT))
+    {
+        return;
+    }
+
+    struct MPIM_wait_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.rank = header->rank;
+    event.start = started ? time : MPIM_thread_starts[thread];
+    event.end = time;
+    const char* name = MPIM_names[callsite->type];
+    if(started && (callsite->kind == MPIM_TRACE_ARGUMENTS_SEND || callsite->kind == MPIM_TRACE_ARGUMENTS_SENDRECV))
+    {
+        event.kind = MPIM_WAIT_EVENT_SEND;
+        event.peer = (int32_t)values[3];
+        event.tag = (int32_t)values[4];
+        event.synchronous = (strcmp(name, "MPI_Ssend") == 0 || strcmp(name, "MPI_Issend") == 0);
+        MPIM_wait_event_add(&event);
+    }
+    else if(started && callsite->kind == MPIM_TRACE_ARGUMENTS_RECEIVE && (attributes & MPIM_ROUTINE_NONBLOCKING))
+    {
+        event.kind = MPIM_WAIT_EVENT_POST;
+        event.peer = (int32_t)values[3];
+        event.tag = (int32_t)values[4];
+        MPIM_wait_event_add(&event);
+    }
+    else if(!started && (attributes & MPIM_ROUTINE_BLOCKING) && (callsite->kind == MPIM_TRACE_ARGUMENTS_RECEIVE || callsite->kind == MPIM_TRACE_ARGUMENTS_SENDRECV))
+    {
+        // MPI_Recv resolves its wildcards at completion
+        event.kind = MPIM_WAIT_EVENT_RECEIVE;
+        event.peer = (int32_t)values[(callsite->kind == MPIM_TRACE_ARGUMENTS_RECEIVE) ? 3 : 5];
+        event.tag = (int32_t)values[(callsite->kind == MPIM_TRACE_ARGUMENTS_RECEIVE) ? 4 : 6];
+        MPIM_wait_event_add(&event);
+    }
+    else if(started && (attributes & MPIM_ROUTINE_N_TO_N))
+    {
+        event.kind = MPIM_WAIT_EVENT_COLLECTIVE;
+        MPIM_wait_event_add(&event);
+    }
+}
+
+/**
+ * @brief Records waiting time caused by a process to another one.
+ * @param[in] state The wait state.
+ * @param[in] waiting The rank of the process that waited.
+ * @param[in] causing The rank of the process that made it wait.
+ * @param[in] seconds The waiting time, in seconds.
+ **/
+static void MPIM_wait_pair_add(enum MPIM_wait_state_t state, int waiting, int causing, double seconds)
+{
+    if(seconds <= 0.0 || waiting == causing || causing < 0 || causing >= MPIM_comm_size)
+    {
+        return;
+    }
+    if(MPIM_wait_pair_count == MPIM_wait_pair_capacity)
+    {
+        MPIM_wait_pair_capacity = (MPIM_wait_pair_capacity == 0) ? 4096 : 2 * MPIM_wait_pair_capacity;
+        MPIM_wait_pairs = (struct MPIM_wait_pair_t*)realloc(MPIM_wait_pairs, MPIM_wait_pair_capacity * sizeof(struct MPIM_wait_pair_t));
+        if(MPIM_wait_pairs == NULL)
+        {
+            printf("Failure in allocating the waiting times of the wait state analysis.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    struct MPIM_wait_pair_t* pair = &MPIM_wait_pairs[MPIM_wait_pair_count++];
+    pair->causing = causing;
+    pair->waiting = waiting;
+    pair->state = state;
+    pair->seconds = seconds;
+}
+
+/**
+ * @brief Orders events by rank, then by the time at which they started.
+ * @param[in] a The first event.
+ * @param[in] b The second event.
+ * @return A negative value, zero or a positive value if a comes before, with or after b.
+ **/
+static int MPIM_wait_event_compare_rank(const void* a, const void* b)
+{
+    const struct MPIM_wait_event_t* first = (const struct MPIM_wait_event_t*)a;
+    const struct MPIM_wait_event_t* second = (const struct MPIM_wait_event_t*)b;
+    if(first->rank != second->rank)
+    {
+        return (first->rank < second->rank) ? -1 : 1;
+    }
+    return (first->start < second->start) ? -1 : (first->start > second->start);
+}
+
+/**
+ * @brief Orders sends by destination, then by sender, then by the time at which they started, which is the order in which MPI matches them.
+ * @param[in] a The first send.
+ * @param[in] b The second send.
+ * @return A negative value, zero or a positive value if a comes before, with or after b.
+ **/
+static int MPIM_wait_send_compare(const void* a, const void* b)
+{
+    const struct MPIM_wait_event_t* first = (const struct MPIM_wait_event_t*)a;
+    const struct MPIM_wait_event_t* second = (const struct MPIM_wait_event_t*)b;
+    if(first->peer != second->peer)
+    {
+        return (first->peer < second->peer) ? -1 : 1;
+    }
+    if(first->rank != second->rank)
+    {
+        return (first->rank < second->rank) ? -1 : 1;
+    }
+    return (first->start < second->start) ? -1 : (first->start > second->start);
+}
+
+/**
+ * @brief Orders waiting times by causing rank, then by waiting rank.
+ * @param[in] a The first waiting time.
+ * @param[in] b The second waiting time.
+ * @return A negative value, zero or a positive value if a comes before, with or after b.
+ **/
+static int MPIM_wait_pair_compare(const void* a, const void* b)
+{
+    const struct MPIM_wait_pair_t* first = (const struct MPIM_wait_pair_t*)a;
+    const struct MPIM_wait_pair_t* second = (const struct MPIM_wait_pair_t*)b;
+    if(first->causing != second->causing)
+    {
+        return (first->causing < second->causing) ? -1 : 1;
+    }
+    return (first->waiting > second->waiting) - (first->waiting < second->waiting);
+}
+
+/**
+ * @brief Matches a receive with the oldest unmatched send of its sender bearing the same tag, and marks that send as matched.
+ * @param[in] sends The sends, sorted with MPIM_wait_send_compare.
+ * @param[in] send_count The number of sends.
+ * @param[in] receive The receive.
+ * @return The send, NULL if none matches.
+ **/
+static struct MPIM_wait_event_t* MPIM_wait_send_match(struct MPIM_wait_event_t* sends, size_t send_count, const struct MPIM_wait_event_t* receive)
+{
+    // The first send from the sender of the receive to its process
+    size_t low = 0;
+    size_t high = send_count;
+    while(low < high)
+    {
+        size_t middle = (low + high) / 2;
+        if(sends[middle].peer < receive->rank || (sends[middle].peer == receive->rank && sends[middle].rank < receive->peer))
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    for(size_t i = low; i < send_count && sends[i].peer == receive->rank && sends[i].rank == receive->peer; i++)
+    {
+        if(!sends[i].matched && (receive->tag < 0 || sends[i].tag == receive->tag))
+        {
+            sends[i].matched = true;
+            return &sends[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Classifies the waiting time of the events collected from the traces, and prints the processes causing the most waiting time to others.
+ * @details Receives are matched with sends and N-to-N collectives with each other as in the live analysis, but on the whole run rather than on the last stamps and arrivals.
+ **/
+static void MPIM_wait_states_analyse()
+{
+    qsort(MPIM_wait_events, MPIM_wait_event_count, sizeof(struct MPIM_wait_event_t), MPIM_wait_event_compare_rank);
+
+    // The sends are moved to an array of their own, sorted so that the sends of a pair of processes are contiguous
+    size_t send_count = 0;
+    for(size_t i = 0; i < MPIM_wait_event_count; i++)
+    {
+        send_count += (MPIM_wait_events[i].kind == MPIM_WAIT_EVENT_SEND);
+    }
+    struct MPIM_wait_event_t* sends = (struct MPIM_wait_event_t*)malloc((send_count + 1) * sizeof(struct MPIM_wait_event_t));
+    uint64_t* collective_counts = (uint64_t*)calloc(MPIM_comm_size, sizeof(uint64_t));
+    size_t* collective_first = (size_t*)calloc(MPIM_comm_size, sizeof(size_t));
+    if(sends == NULL || collective_counts == NULL || collective_first == NULL)
+    {
+        printf("Failure in allocating the wait state analysis.\n");
+        exit(EXIT_FAILURE);
+    }
+    send_count = 0;
+    for(size_t i = 0; i < MPIM_wait_event_count; i++)
+    {
+        if(MPIM_wait_events[i].kind == MPIM_WAIT_EVENT_SEND)
+        {
+            sends[send_count++] = MPIM_wait_events[i];
+        }
+    }
+    qsort(sends, send_count, sizeof(struct MPIM_wait_event_t), MPIM_wait_send_compare);
+
+    // Receives are matched in the order in which their process posted them
+    for(size_t i = 0; i < MPIM_wait_event_count; i++)
+    {
+        const struct MPIM_wait_event_t* event = &MPIM_wait_events[i];
+        if(event->kind == MPIM_WAIT_EVENT_COLLECTIVE && event->rank >= 0 && event->rank < MPIM_comm_size)
+        {
+            if(collective_counts[event->rank]++ == 0)
+            {
+                collective_first[event->rank] = i;
+            }
+            continue;
+        }
+        if((event->kind != MPIM_WAIT_EVENT_RECEIVE && event->kind != MPIM_WAIT_EVENT_POST) || event->peer < 0)
+        {
+            continue;
+        }
+        const struct MPIM_wait_event_t* send = MPIM_wait_send_match(sends, send_count, event);
+        if(send == NULL)
+        {
+            continue;
+        }
+        if(event->kind == MPIM_WAIT_EVENT_RECEIVE && send->start > event->start)
+        {
+            MPIM_wait_pair_add(MPIM_WAIT_LATE_SENDER, event->rank, send->rank, ((send->start < event->end) ? send->start : event->end) - event->start);
+        }
+        else if(send->synchronous && send->start < event->start)
+        {
+            MPIM_wait_pair_add(MPIM_WAIT_LATE_RECEIVER, send->rank, event->rank, event->start - send->start);
+        }
+    }
+
+    // Collectives on MPI_COMM_WORLD are issued in the same order by all processes, so the k-th collectives of every process are the same
+    uint64_t collective_count = UINT64_MAX;
+    for(int rank = 0; rank < MPIM_comm_size; rank++)
+    {
+        if(collective_counts[rank] < collective_count)
+        {
+            collective_count = collective_counts[rank];
+        }
+    }
+    for(uint64_t k = 0; k < collective_count; k++)
+    {
+        // The events of a rank are sorted by time, and the collectives of a rank follow each other among them
+        int last = -1;
+        double last_time = 0.0;
+        for(int rank = 0; rank < MPIM_comm_size; rank++)
+        {
+            while(MPIM_wait_events[collective_first[rank]].kind != MPIM_WAIT_EVENT_COLLECTIVE)
+            {
+                collective_first[rank]++;
+            }
+            if(last == -1 || MPIM_wait_events[collective_first[rank]].start > last_time)
+            {
+                last = rank;
+                last_time = MPIM_wait_events[collective_first[rank]].start;
+            }
+        }
+        for(int rank = 0; rank < MPIM_comm_size; rank++)
+        {
+            MPIM_wait_pair_add(MPIM_WAIT_N_TO_N, rank, last, last_time - MPIM_wait_events[collective_first[rank]].start);
+            collective_first[rank]++;
+        }
+    }
+
+    // Totals per causing rank, then per pair for the rank delayed the most
+    qsort(MPIM_wait_pairs, MPIM_wait_pair_count, sizeof(struct MPIM_wait_pair_t), MPIM_wait_pair_compare);
+    double* caused = (double*)calloc((size_t)MPIM_comm_size * (MPIM_WAIT_STATE_COUNT + 1), sizeof(double));
+    int* most_delayed = (int*)calloc(MPIM_comm_size, sizeof(int));
+    double* most_delayed_time = (double*)calloc(MPIM_comm_size, sizeof(double));
+    if(caused == NULL || most_delayed == NULL || most_delayed_time == NULL)
+    {
+        printf("Failure in allocating the wait state analysis.\n");
+        exit(EXIT_FAILURE);
+    }
+    for(size_t i = 0; i < MPIM_wait_pair_count;)
+    {
+        const struct MPIM_wait_pair_t* pair = &MPIM_wait_pairs[i];
+        double pair_seconds = 0.0;
+        for(; i < MPIM_wait_pair_count && MPIM_wait_pairs[i].causing == pair->causing && MPIM_wait_pairs[i].waiting == pair->waiting; i++)
+        {
+            caused[pair->causing * (MPIM_WAIT_STATE_COUNT + 1) + MPIM_wait_pairs[i].state] += MPIM_wait_pairs[i].seconds;
+            pair_seconds += MPIM_wait_pairs[i].seconds;
+        }
+        caused[pair->causing * (MPIM_WAIT_STATE_COUNT + 1) + MPIM_WAIT_STATE_COUNT] += pair_seconds;
+        if(pair_seconds > most_delayed_time[pair->causing])
+        {
+            most_delayed_time[pair->causing] = pair_seconds;
+            most_delayed[pair->causing] = pair->waiting;
+        }
+    }
+
+    int top_count = MPIM_DEFAULT_WAIT_STATES_TOP;
+    const char* wait_states_top = getenv("MPIM_WAIT_STATES_TOP");
+    if(wait_states_top != NULL && atoi(wait_states_top) > 0)
+    {
+        top_count = atoi(wait_states_top);
+    }
+    printf("Ranks causing the most waiting time to other ranks on MPI_COMM_WORLD, in seconds, from %zu sends and %zu waiting times:\n", send_count, MPIM_wait_pair_count);
+    printf("+--------+------------+--------------+---------------+-------------+-------------------------+\n");
+    printf("| %6s | %10s | %12s | %13s | %11s | %23s |\n", "Rank", "Total", "Late sender", "Late receiver", "Wait at NxN", "Most delayed rank");
+    printf("+--------+------------+--------------+---------------+-------------+-------------------------+\n");
+    for(int listed = 0; listed < top_count; listed++)
+    {
+        // Selection of the next rank, the list being short
+        int top = -1;
+        for(int causing = 0; causing < MPIM_comm_size; causing++)
+        {
+            double total = caused[causing * (MPIM_WAIT_STATE_COUNT + 1) + MPIM_WAIT_STATE_COUNT];
+            if(total > 0.0 && (top == -1 || total > caused[top * (MPIM_WAIT_STATE_COUNT + 1) + MPIM_WAIT_STATE_COUNT]))
+            {
+                top = causing;
+            }
+        }
+        if(top == -1)
+        {
+            break;
+        }
+        const double* totals = &caused[top * (MPIM_WAIT_STATE_COUNT + 1)];
+        char delayed[32];
+        snprintf(delayed, sizeof(delayed), "%d (%.6f)", most_delayed[top], most_delayed_time[top]);
+        printf("| %6d | %10.6f | %12.6f | %13.6f | %11.6f | %23s |\n", top, totals[MPIM_WAIT_STATE_COUNT], totals[MPIM_WAIT_LATE_SENDER], totals[MPIM_WAIT_LATE_RECEIVER], totals[MPIM_WAIT_N_TO_N], delayed);
+        caused[top * (MPIM_WAIT_STATE_COUNT + 1) + MPIM_WAIT_STATE_COUNT] = 0.0;
+    }
+    printf("+--------+------------+--------------+---------------+-------------+-------------------------+\n");
+
+    free(caused);
+    free(most_delayed);
+    free(most_delayed_time);
+    free(collective_counts);
+    free(collective_first);
+    free(sends);
+}
+
+/**
+ * @brief Decodes the events of a block.
+ * @param[in] header The trace header.
+ * @param[in] block The block header.
+ * @param[in] data The payload of the block, decompressed.
+ * @param[in] mode What is done with the events.
+ * @return true if the payload holds the events announced, false if it is corrupt.
+ **/
+static bool MPIM_block_decode(const struct MPIM_trace_header_t* header, const struct MPIM_trace_block_t* block, const uint8_t* data, enum MPIM_mode_t mode)
+{
+    const uint8_t* cursor = data;
+    const uint8_t* end = data + block->raw_length;
+    uint64_t callsite_count = 0;
+    uint64_t time = block->time;
+    for(uint32_t i = 0; i < block->event_count; i++)
+    {
+        uint64_t head;
+        if(!MPIM_trace_read_varint(&cursor, end, &head) || (head >> 2) > callsite_count || (head >> 2) >= MPIM_MAX_CALLSITES)
+        {
+            return false;
+        }
+        struct MPIM_callsite_t* callsite = &MPIM_callsites[head >> 2];
+        if((head >> 2) == callsite_count)
+        {
+            uint64_t file_length;
+            if(!MPIM_trace_read_varint(&cursor, end, &callsite->type) || !MPIM_trace_read_varint(&cursor, end, &callsite->line) || !MPIM_trace_read_varint(&cursor, end, &callsite->module) || !MPIM_trace_read_varint(&cursor, end, &callsite->offset) || !MPIM_trace_read_varint(&cursor, end, &file_length) || file_length >= MPIM_FILE_LENGTH || file_length > (uint64_t)(end - cursor))
+            {
+                return false;
+            }
+            memcpy(callsite->file, cursor, file_length);
+            callsite->file[file_length] = '\0';
+            cursor += file_length;
+            callsite_count++;
+        }
+        int64_t delta;
+        if(!MPIM_trace_read_signed_varint(&cursor, end, &delta))
+        {
+            return false;
+        }
+        time += delta;
+        if(head & 1)
+        {
+            if(!MPIM_trace_read_varint(&cursor, end, &callsite->kind))
+            {
+                return false;
+            }
+            memset(callsite->values, 0, sizeof(callsite->values));
+            for(int j = 0; j < 3 + MPIM_arguments_words(callsite->kind); j++)
+            {
+                if(!MPIM_trace_read_signed_varint(&cursor, end, &callsite->values[j]))
+                {
+                    return false;
+                }
+            }
+        }
+        // Processes convert their time to that of MPI process 0 by adding the clock offset to their absolute time
+        double aggregator_seconds = (header->start + time) / header->ticks_per_second + block->clock_offset;
+        if(mode == MPIM_MODE_WAIT_STATES)
+        {
+            MPIM_wait_event_collect(header, block->thread, callsite, (head & 2) != 0, aggregator_seconds);
+        }
+        else if(mode == MPIM_MODE_PRINT)
+        {
+            double seconds = time / header->ticks_per_second;
+            const char* name = (callsite->type < MPIM_name_count) ? MPIM_names[callsite->type] : "?";
+            printf("%d.%u %.9f %.9f %s %s %s:%" PRIu64, header->rank, block->thread, seconds, aggregator_seconds, name, (head & 2) ? "started" : "completed", callsite->file, callsite->line);
+            MPIM_arguments_print(callsite);
+            printf("\n");
+        }
+    }
+    return cursor == end;
+}
+
+/**
+ * @brief Decodes a trace file.
+ * @param[in] path The path of the trace.
+ * @param[in] mode What is done with the events.
+ * @param[out] statistics The statistics of the trace.
+ * @return true if the file is a trace, false otherwise.
+ **/
+static bool MPIM_trace_decode(const char* path, enum MPIM_mode_t mode, struct MPIM_statistics_t* statistics)
+{
+    memset(statistics, 0, sizeof(struct MPIM_statistics_t));
+    FILE* file = fopen(path, "rb");
+    if(file == NULL)
+    {
+        printf("Cannot open \"%s\".\n", path);
+        return false;
+    }
+    struct MPIM_trace_header_t header;
+    if(fread(&header, sizeof(header), 1, file) != 1 || header.magic != MPIM_TRACE_MAGIC || header.version != MPIM_TRACE_VERSION)
+    {
+        printf("\"%s\" is not a version %d MPI_monitor trace.\n", path, MPIM_TRACE_VERSION);
+        fclose(file);
+        return false;
+    }
+    char* names = (char*)malloc(header.names_length);
+    MPIM_names = (char**)malloc(header.name_count * sizeof(char*));
+    MPIM_attributes = (int*)calloc(header.name_count, sizeof(int));
+    uint8_t* stored = (uint8_t*)malloc(MPIM_TRACE_MAX_BLOCK_LENGTH);
+    uint8_t* raw = (uint8_t*)malloc(MPIM_TRACE_MAX_BLOCK_LENGTH);
+    if(names == NULL || MPIM_names == NULL || MPIM_attributes == NULL || stored == NULL || raw == NULL)
+    {
+        printf("Failure in allocating the trace buffers.\n");
+        exit(EXIT_FAILURE);
+    }
+    MPIM_name_count = 0;
+    if(fread(names, 1, header.names_length, file) == header.names_length)
+    {
+        for(uint32_t position = 0; position < header.names_length && MPIM_name_count < header.name_count; position += strlen(names + position) + 1)
+        {
+            MPIM_names[MPIM_name_count++] = names + position;
+        }
+        names[header.names_length - 1] = '\0';
+    }
+    for(uint32_t type = 0; type < MPIM_name_count; type++)
+    {
+        for(size_t i = 0; i < sizeof(MPIM_routine_attributes) / sizeof(MPIM_routine_attributes[0]); i++)
+        {
+            if(strcmp(MPIM_names[type], MPIM_routine_attributes[i].name) == 0)
+            {
+                MPIM_attributes[type] = MPIM_routine_attributes[i].attributes;
+            }
+        }
+    }
+    if(header.comm_size > MPIM_comm_size)
+    {
+        MPIM_comm_size = header.comm_size;
+    }
+    statistics->file_bytes = sizeof(header) + header.names_length;
+
+    struct MPIM_trace_block_t block;
+    while(fread(&block, sizeof(block), 1, file) == 1)
+    {
+        if(block.magic != MPIM_TRACE_BLOCK_MAGIC || block.stored_length > MPIM_TRACE_MAX_BLOCK_LENGTH || block.raw_length > MPIM_TRACE_MAX_BLOCK_LENGTH || fread(stored, 1, block.stored_length, file) != block.stored_length || MPIM_trace_checksum(stored, block.stored_length) != block.checksum)
+        {
+            printf("\"%s\" is cut short after %" PRIu64 " blocks, the rest of the trace is lost.\n", path, statistics->blocks);
+            break;
+        }
+        const uint8_t* data = stored;
+        if(block.flags & MPIM_TRACE_BLOCK_COMPRESSED)
+        {
+            if(!MPIM_trace_decompress(stored, block.stored_length, raw, block.raw_length))
+            {
+                printf("Block %" PRIu64 " of \"%s\" cannot be decompressed, it is skipped.\n", statistics->blocks, path);
+                continue;
+            }
+            data = raw;
+        }
+        else if(block.stored_length != block.raw_length)
+        {
+            printf("Block %" PRIu64 " of \"%s\" is corrupt, it is skipped.\n", statistics->blocks, path);
+            continue;
+        }
+        if(!MPIM_block_decode(&header, &block, data, mode))
+        {
+            printf("Block %" PRIu64 " of \"%s\" is corrupt, its remaining events are skipped.\n", statistics->blocks, path);
+        }
+        statistics->blocks++;
+        statistics->events += block.event_count;
+        statistics->raw_bytes += block.raw_length;
+        statistics->file_bytes += sizeof(block) + block.stored_length;
+    }
+    free(raw);
+    free(stored);
+    free(MPIM_attributes);
+    free(MPIM_names);
+    free(names);
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    enum MPIM_mode_t mode = MPIM_MODE_PRINT;
+    if(argc > 1 && strcmp(argv[1], "--summary") == 0)
+    {
+        mode = MPIM_MODE_SUMMARY;
+    }
+    else if(argc > 1 && strcmp(argv[1], "--wait-states") == 0)
+    {
+        mode = MPIM_MODE_WAIT_STATES;
+    }
+    int first = (mode == MPIM_MODE_PRINT) ? 1 : 2;
+    if(argc <= first)
+    {
+        printf("Usage: %s [--summary | --wait-states] trace files.\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if(mode == MPIM_MODE_PRINT)
+    {
+        printf("# rank.thread time since the trace started (s) time on the clock of MPI process 0 (s) routine started/completed file:line arguments\n");
+    }
+    int result = EXIT_SUCCESS;
+    for(int i = first; i < argc; i++)
+    {
+        struct MPIM_statistics_t statistics;
+        if(!MPIM_trace_decode(argv[i], mode, &statistics))
+        {
+            result = EXIT_FAILURE;
+            continue;
+        }
+        if(mode == MPIM_MODE_SUMMARY && statistics.events == 0)
+        {
+            printf("%s: no events.\n", argv[i]);
+        }
+        else if(mode == MPIM_MODE_SUMMARY)
+        {
+            printf("%s: %" PRIu64 " events in %" PRIu64 " blocks, %.2f bytes per event encoded, %.2f bytes per event in the file.\n", argv[i], statistics.events, statistics.blocks, (double)statistics.raw_bytes / statistics.events, (double)statistics.file_bytes / statistics.events);
+        }
+    }
+    if(mode == MPIM_MODE_WAIT_STATES)
+    {
+        MPIM_wait_states_analyse();
+        free(MPIM_wait_events);
+        free(MPIM_wait_pairs);
+    }
+    return result;
+}
@@ -0,0 +1,1139 @@
+/**
+ * @file mpim_view.c
+ * @brief Viewer attaching to the socket on which MPI process 0 serves the live display when the MPIM_VIEW_SOCKET environment variable is set, and printing it.
+ * @details Usage: mpim-view [socket path], the path defaulting to the MPIM_VIEW_SOCKET environment variable. Viewers can attach and detach at any time during the run.
+ * On a terminal, the display is interactive: rows can be sorted, filtered and scrolled, and the threads stuck for the longest time are listed above them. Keys are read between messages of the aggregator, which never waits for the viewer.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h> // bool
+#include <stdint.h> // uint32_t
+#include <string.h> // memcpy
+#include <strings.h> // strcasecmp
+#include <stdarg.h> // va_list
+#include <errno.h> // errno
+#include <unistd.h> // read, usleep, isatty
+#include <poll.h> // poll
+#include <termios.h> // tcsetattr
+#include <sys/ioctl.h> // TIOCGWINSZ
+#include <sys/socket.h> // socket, connect
+#include <sys/un.h> // sockaddr_un
+#include "mpi_monitor_view.h"
+
+/// Number of milliseconds during which the viewer waits for the run to open its socket.
+#define MPIM_VIEW_CONNECT_TIMEOUT 10000
+/// Default maximum number of threads displayed one per row, changed with the MPIM_DISPLAY_ROWS environment variable; larger jobs are displayed grouped by state.
+#define MPIM_DEFAULT_DISPLAY_ROWS 256
+/// Size of the buffer receiving the identifier of a thread.
+#define MPIM_WHO_LENGTH 24
+/// Size of the buffer receiving the age of an update.
+#define MPIM_WHEN_LENGTH 32
+/// Size of the buffers holding the callsite of a slot.
+#define MPIM_WHERE_LENGTH 64
+/// Size of the buffers holding the details of a slot.
+#define MPIM_DETAILS_LENGTH 256
+/// Default number of threads listed as stuck for the longest time in the interactive display.
+#define MPIM_DEFAULT_STUCK_TOP 5
+/// Maximum number of threads listed as stuck for the longest time in the interactive display.
+#define MPIM_MAX_STUCK_TOP 32
+/// Size of the buffer holding a line of the interactive display, longer lines being cut to the width of the terminal anyway.
+#define MPIM_LINE_LENGTH 1024
+/// Size of the buffer holding the text typed at a prompt of the interactive display.
+#define MPIM_PROMPT_LENGTH 48
+
+/**
+ * @brief The last update received for a slot.
+ **/
+struct MPIM_slot_t
+{
+    /// The routine called, an index in MPIM_names
+    uint32_t type;
+    /// The time at which the update was sent, in seconds since the aggregator started
+    double time;
+    /// Size of the data sent and received by the thread in point-to-point communications, in bytes
+    uint64_t bytes;
+    /// The name of the communicator of the call, empty if the call has none
+    char communicator[MPIM_VIEW_COMMUNICATOR_LENGTH];
+    /// true if the update was sent before the call, false if after
+    bool before;
+    /// true if the slot must be displayed
+    bool displayed;
+    /// The callsite of the call
+    char where[MPIM_WHERE_LENGTH];
+    /// The details of the call
+    char details[MPIM_DETAILS_LENGTH];
+};
+
+/// The names of the routines, indexed by the types of the slots
+char** MPIM_names = NULL;
+/// Number of names in MPIM_names
+uint32_t MPIM_name_count = 0;
+/// The slots, as of the last frame received
+struct MPIM_slot_t* MPIM_slots = NULL;
+/// The last frame received, whose rows have been applied to MPIM_slots
+struct MPIM_view_frame_t MPIM_frame;
+/// Maximum number of threads displayed one per row
+int MPIM_display_rows = MPIM_DEFAULT_DISPLAY_ROWS;
+
+/// Orders in which the rows of the interactive display can be sorted
+enum MPIM_sort_t { MPIM_SORT_RANK,
+                   MPIM_SORT_AGE,
+                   MPIM_SORT_ROUTINE,
+                   MPIM_SORT_CALLSITE,
+                   MPIM_SORT_BYTES,
+                   MPIM_SORT_COUNT };
+/// Names of the orders, as shown in the status line
+const char* MPIM_sort_name_t[] = {"rank", "age", "routine", "callsite", "bytes"};
+
+/// Filters of the interactive display typed at a prompt
+enum MPIM_prompt_t { MPIM_PROMPT_NONE,
+                     MPIM_PROMPT_ROUTINE,
+                     MPIM_PROMPT_COMMUNICATOR };
+
+/// Indicates if the display is interactive, which it is when both the standard input and output are terminals
+bool MPIM_interactive = false;
+/// Terminal settings to restore when the viewer exits
+struct termios MPIM_terminal_settings;
+/// Order of the rows
+enum MPIM_sort_t MPIM_sort = MPIM_SORT_RANK;
+/// Indicates if the order of the rows is reversed
+bool MPIM_sort_reversed = false;
+/// Minimum age, in seconds, of the calls started and not completed yet to show; 0 to show every row
+double MPIM_minimum_age = 0.0;
+/// Age applied by MPIM_minimum_age when the filter is toggled on
+double MPIM_stuck_threshold = 5.0;
+/// Only routine shown, empty to show them all
+char MPIM_routine_filter[MPIM_PROMPT_LENGTH] = "";
+/// Only communicator shown, empty to show them all
+char MPIM_communicator_filter[MPIM_PROMPT_LENGTH] = "";
+/// The prompt being typed at, if any
+enum MPIM_prompt_t MPIM_prompt = MPIM_PROMPT_NONE;
+/// The text typed at the prompt
+char MPIM_prompt_text[MPIM_PROMPT_LENGTH];
+/// Index of the first row shown
+int MPIM_scroll = 0;
+/// Number of threads listed as stuck for the longest time
+int MPIM_stuck_top = MPIM_DEFAULT_STUCK_TOP;
+/// Indicates if the aggregator announced the end of the run
+bool MPIM_run_over = false;
+/// The slots displayed, in display order whatever the filters, which are applied while printing
+uint32_t* MPIM_rows = NULL;
+/// Number of slots in MPIM_rows
+uint32_t MPIM_row_count = 0;
+/// Indicates if MPIM_rows must be sorted again from scratch, as the order or every slot changed
+bool MPIM_rows_stale = true;
+/// Slots updated since MPIM_rows was last ordered, to be moved to their new place
+uint32_t* MPIM_updated_slots = NULL;
+/// Number of slots in MPIM_updated_slots
+uint32_t MPIM_updated_slot_count = 0;
+/// Indicates for every slot if it is in MPIM_updated_slots
+bool* MPIM_slot_updated = NULL;
+
+/**
+ * @brief Reads a number of bytes from the socket.
+ * @param[in] socket_descriptor The socket.
+ * @param[out] buffer The buffer receiving the bytes.
+ * @param[in] size The number of bytes.
+ * @return true if all bytes were read, false if the aggregator closed the socket.
+ **/
+static bool MPIM_read(int socket_descriptor, void* buffer, size_t size)
+{
+    size_t received = 0;
+    while(received < size)
+    {
+        ssize_t result = read(socket_descriptor, (char*)buffer + received, size - received);
+        if(result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(result <= 0)
+        {
+            return false;
+        }
+        received += result;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a string of the socket, truncating it to the buffer receiving it.
+ * @param[in] socket_descriptor The socket.
+ * @param[out] text The buffer receiving the string.
+ * @param[in] text_length The size of the text buffer.
+ * @param[in] length The number of bytes of the string, not NUL-terminated, in the socket.
+ * @return true if the string was read, false if the aggregator closed the socket.
+ **/
+static bool MPIM_read_text(int socket_descriptor, char* text, size_t text_length, size_t length)
+{
+    char discarded[MPIM_DETAILS_LENGTH];
+    size_t kept = (length < text_length) ? length : text_length - 1;
+    if(!MPIM_read(socket_descriptor, text, kept))
+    {
+        return false;
+    }
+    text[kept] = '\0';
+    while(length > kept)
+    {
+        size_t chunk = (length - kept < MPIM_DETAILS_LENGTH) ? length - kept : MPIM_DETAILS_LENGTH;
+        if(!MPIM_read(socket_descriptor, discarded, chunk))
+        {
+            return false;
+        }
+        kept += chunk;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the names of the routines.
+ * @param[in] socket_descriptor The socket.
+ * @param[in] length The length of the payload.
+ * @return true if the names were read, false if the aggregator closed the socket.
+ **/
+static bool MPIM_names_read(int socket_descriptor, uint32_t length)
+{
+    char* payload = (char*)malloc(length + 1);
+    if(payload == NULL)
+    {
+        printf("Failure in allocating the routine names.\n");
+        exit(EXIT_FAILURE);
+    }
+    if(!MPIM_read(socket_descriptor, payload, length))
+    {
+        free(payload);
+        return false;
+    }
+    payload[length] = '\0';
+    memcpy(&MPIM_name_count, payload, sizeof(uint32_t));
+    MPIM_names = (char**)calloc(MPIM_name_count, sizeof(char*));
+    if(MPIM_names == NULL)
+    {
+        printf("Failure in allocating the routine names.\n");
+        exit(EXIT_FAILURE);
+    }
+    char* name = payload + sizeof(uint32_t);
+    for(uint32_t i = 0; i < MPIM_name_count; i++)
+    {
+        MPIM_names[i] = (name < payload + length) ? name : "";
+        name += strlen(name) + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a frame and applies its rows to the slots.
+ * @param[in] socket_descriptor The socket.
+ * @return true if the frame was read, false if the aggregator closed the socket.
+ **/
+static bool MPIM_frame_read(int socket_descriptor)
+{
+    uint32_t slot_count = MPIM_frame.slot_count;
+    if(!MPIM_read(socket_descriptor, &MPIM_frame, sizeof(struct MPIM_view_frame_t)))
+    {
+        return false;
+    }
+    MPIM_frame.flush_policy[MPIM_VIEW_FLUSH_POLICY_LENGTH - 1] = '\0';
+    if(MPIM_slots == NULL || MPIM_frame.slot_count != slot_count)
+    {
+        free(MPIM_slots);
+        free(MPIM_rows);
+        free(MPIM_updated_slots);
+        free(MPIM_slot_updated);
+        MPIM_slots = (struct MPIM_slot_t*)calloc(MPIM_frame.slot_count, sizeof(struct MPIM_slot_t));
+        MPIM_rows = (uint32_t*)malloc(MPIM_frame.slot_count * sizeof(uint32_t));
+        MPIM_updated_slots = (uint32_t*)malloc(MPIM_frame.slot_count * sizeof(uint32_t));
+        MPIM_slot_updated = (bool*)calloc(MPIM_frame.slot_count, sizeof(bool));
+        if(MPIM_slots == NULL || MPIM_rows == NULL || MPIM_updated_slots == NULL || MPIM_slot_updated == NULL)
+        {
+            printf("Failure in allocating the slots.\n");
+            exit(EXIT_FAILURE);
+        }
+        MPIM_row_count = 0;
+        MPIM_updated_slot_count = 0;
+    }
+    // Keyframes may shift the times of every slot, as they follow the clock offsets
+    if(MPIM_frame.keyframe)
+    {
+        MPIM_rows_stale = true;
+    }
+    for(uint32_t i = 0; i < MPIM_frame.row_count; i++)
+    {
+        struct MPIM_view_row_t row;
+        struct MPIM_slot_t slot;
+        if(!MPIM_read(socket_descriptor, &row, sizeof(struct MPIM_view_row_t)) ||
+           !MPIM_read_text(socket_descriptor, slot.where, MPIM_WHERE_LENGTH, row.where_length) ||
+           !MPIM_read_text(socket_descriptor, slot.details, MPIM_DETAILS_LENGTH, row.details_length))
+        {
+            return false;
+        }
+        slot.type = (row.type < MPIM_name_count) ? row.type : 0;
+        slot.time = row.time;
+        slot.bytes = row.sent_bytes + row.received_bytes;
+        memcpy(slot.communicator, row.communicator, MPIM_VIEW_COMMUNICATOR_LENGTH);
+        slot.communicator[MPIM_VIEW_COMMUNICATOR_LENGTH - 1] = '\0';
+        slot.before = row.before;
+        slot.displayed = row.displayed;
+        if(row.slot < MPIM_frame.slot_count)
+        {
+            MPIM_slots[row.slot] = slot;
+            if(!MPIM_rows_stale && !MPIM_slot_updated[row.slot])
+            {
+                MPIM_slot_updated[row.slot] = true;
+                MPIM_updated_slots[MPIM_updated_slot_count++] = row.slot;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Prints a horizontal separator of the table of slots.
+ * @param[in] widths The widths of the columns.
+ * @param[in] column_count The number of columns.
+ **/
+static void MPIM_separator_print(const int* widths, int column_count)
+{
+    for(int i = 0; i < column_count; i++)
+    {
+        printf("+-");
+        for(int j = 0; j < widths[i]; j++)
+        {
+            printf("-");
+        }
+        printf("-");
+    }
+    printf("+\n");
+}
+
+/**
+ * @brief Writes the identifier of the thread owning a slot, in the form "rank" for the first thread of a process and "rank.thread" for the others.
+ * @param[in] slot The index of the slot.
+ * @param[out] who The buffer receiving the identifier.
+ **/
+static void MPIM_slot_get_who(uint32_t slot, char* who)
+{
+    uint32_t rank = slot / MPIM_frame.threads_per_process;
+    uint32_t thread = slot % MPIM_frame.threads_per_process;
+    if(thread == 0)
+    {
+        snprintf(who, MPIM_WHO_LENGTH, "%u", rank);
+    }
+    else
+    {
+        snprintf(who, MPIM_WHO_LENGTH, "%u.%u", rank, thread);
+    }
+}
+
+/**
+ * @brief Writes the state of a slot and how long ago it was updated.
+ * @param[in] slot The slot.
+ * @param[out] when The buffer receiving the text.
+ **/
+static void MPIM_slot_get_when(const struct MPIM_slot_t* slot, char* when)
+{
+    double elapsed = MPIM_frame.runtime - slot->time;
+    if(elapsed > 0.01)
+    {
+        snprintf(when, MPIM_WHEN_LENGTH, "%9s %.2fs ago", slot->before ? "started" : "completed", elapsed);
+    }
+    else
+    {
+        snprintf(when, MPIM_WHEN_LENGTH, "%9s just now", slot->before ? "started" : "completed");
+    }
+}
+
+/**
+ * @brief Prints the number of threads in every state, for runs with too many threads to print a row per thread.
+ * @param[in] displayed_count The number of slots displayed.
+ **/
+static void MPIM_states_print(int displayed_count)
+{
+    int state_count = MPIM_name_count * 2;
+    int* counts = (int*)calloc(state_count, sizeof(int));
+    if(counts == NULL)
+    {
+        printf("Failure in allocating the state counts.\n");
+        exit(EXIT_FAILURE);
+    }
+    for(uint32_t i = 0; i < MPIM_frame.slot_count; i++)
+    {
+        if(MPIM_slots[i].displayed)
+        {
+            counts[MPIM_slots[i].type * 2 + (MPIM_slots[i].before ? 0 : 1)]++;
+        }
+    }
+    int widths[3] = {4, 9, 10};
+    for(int i = 0; i < state_count; i++)
+    {
+        if(counts[i] > 0 && (int)strlen(MPIM_names[i / 2]) > widths[0])
+        {
+            widths[0] = strlen(MPIM_names[i / 2]);
+        }
+    }
+
+    printf("%d threads displayed, grouped by state as there are more than %d:\n", displayed_count, MPIM_display_rows);
+    MPIM_separator_print(widths, 3);
+    printf("| %*s | %*s | %*s |\n", widths[0], "What", widths[1], "State", widths[2], "Threads");
+    MPIM_separator_print(widths, 3);
+    // States by decreasing number of threads
+    while(true)
+    {
+        int largest = -1;
+        for(int i = 0; i < state_count; i++)
+        {
+            if(counts[i] > 0 && (largest == -1 || counts[i] > counts[largest]))
+            {
+                largest = i;
+            }
+        }
+        if(largest == -1)
+        {
+            break;
+        }
+        printf("| %*s | %*s | %*d |\n", widths[0], MPIM_names[largest / 2], widths[1], (largest % 2 == 0) ? "started" : "completed", widths[2], counts[largest]);
+        counts[largest] = 0;
+    }
+    MPIM_separator_print(widths, 3);
+    free(counts);
+}
+
+/**
+ * @brief Prints the live display from the last frame received.
+ **/
+static void MPIM_display_print()
+{
+    if(isatty(STDOUT_FILENO))
+    {
+        printf("\033[2J\033[1;1H");
+    }
+    printf("Runtime: %s%.2f seconds (clock error bound: %.3f ms, flush policy: %s)\n", MPIM_frame.runtime < 0.01 ? "<" : "", MPIM_frame.runtime, MPIM_frame.clock_error * 1000.0, MPIM_frame.flush_policy);
+
+    int displayed_count = 0;
+    char who[MPIM_WHO_LENGTH];
+    char when[MPIM_WHEN_LENGTH];
+    int widths[5] = {3, 4, 5, 4, 7};
+    for(uint32_t i = 0; i < MPIM_frame.slot_count; i++)
+    {
+        const struct MPIM_slot_t* slot = &MPIM_slots[i];
+        if(!slot->displayed)
+        {
+            continue;
+        }
+        displayed_count++;
+        MPIM_slot_get_who(i, who);
+        MPIM_slot_get_when(slot, when);
+        int lengths[5] = {strlen(who), strlen(MPIM_names[slot->type]), strlen(slot->where), strlen(when), strlen(slot->details)};
+        for(int j = 0; j < 5; j++)
+        {
+            if(lengths[j] > widths[j])
+            {
+                widths[j] = lengths[j];
+            }
+        }
+    }
+    if(displayed_count > MPIM_display_rows)
+    {
+        MPIM_states_print(displayed_count);
+        fflush(stdout);
+        return;
+    }
+
+    MPIM_separator_print(widths, 5);
+    printf("| %*s | %*s | %*s | %*s | %-*s |\n", widths[0], "Who", widths[1], "What", widths[2], "Where", widths[3], "When", widths[4], "Details");
+    MPIM_separator_print(widths, 5);
+    for(uint32_t i = 0; i < MPIM_frame.slot_count; i++)
+    {
+        const struct MPIM_slot_t* slot = &MPIM_slots[i];
+        if(!slot->displayed)
+        {
+            continue;
+        }
+        MPIM_slot_get_who(i, who);
+        MPIM_slot_get_when(slot, when);
+        printf("| %*s | %*s | %*s | %-*s | %-*s |\n", widths[0], who, widths[1], MPIM_names[slot->type], widths[2], slot->where, widths[3], when, widths[4], slot->details);
+    }
+    MPIM_separator_print(widths, 5);
+    fflush(stdout);
+}
+
+/**
+ * @brief Restores the settings of the terminal changed by MPIM_terminal_initialise.
+ **/
+static void MPIM_terminal_restore()
+{
+    tcsetattr(STDIN_FILENO, TCSANOW, &MPIM_terminal_settings);
+    // Show the cursor again
+    printf("\033[?25h\n");
+    fflush(stdout);
+}
+
+/**
+ * @brief Makes the display interactive if both the standard input and output are terminals: keys are read one at a time without echo.
+ **/
+static void MPIM_terminal_initialise()
+{
+    if(!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO) || tcgetattr(STDIN_FILENO, &MPIM_terminal_settings) != 0)
+    {
+        return;
+    }
+    struct termios settings = MPIM_terminal_settings;
+    settings.c_lflag &= ~(ICANON | ECHO);
+    settings.c_cc[VMIN] = 0;
+    settings.c_cc[VTIME] = 0;
+    if(tcsetattr(STDIN_FILENO, TCSANOW, &settings) != 0)
+    {
+        return;
+    }
+    MPIM_interactive = true;
+    atexit(MPIM_terminal_restore);
+    // Hide the cursor, the display being redrawn in place
+    printf("\033[?25l");
+}
+
+/**
+ * @brief Prints a line of the interactive display, cut to the width of the terminal so that it never wraps.
+ * @param[in] columns The width of the terminal.
+ * @param[in] format The format, as in printf.
+ **/
+static void MPIM_line_print(int columns, const char* format, ...)
+{
+    char line[MPIM_LINE_LENGTH];
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(line, MPIM_LINE_LENGTH, format, arguments);
+    va_end(arguments);
+    if(columns > 0 && columns < MPIM_LINE_LENGTH)
+    {
+        line[columns] = '\0';
+    }
+    // Clear the end of the line, left from the previous frame
+    printf("%s\033[K\n", line);
+}
+
+/**
+ * @brief Gives the time elapsed since the last update of a slot.
+ * @param[in] slot The slot.
+ * @return The age, in seconds.
+ **/
+static double MPIM_slot_get_age(const struct MPIM_slot_t* slot)
+{
+    return MPIM_frame.runtime - slot->time;
+}
+
+/**
+ * @brief Tells whether a slot passes the filters of the interactive display.
+ * @param[in] slot The slot.
+ * @return true if the slot is shown, false otherwise.
+ **/
+static bool MPIM_slot_matches(const struct MPIM_slot_t* slot)
+{
+    if(!slot->displayed)
+    {
+        return false;
+    }
+    if(MPIM_minimum_age > 0.0 && (!slot->before || MPIM_slot_get_age(slot) < MPIM_minimum_age))
+    {
+        return false;
+    }
+    if(MPIM_routine_filter[0] != '\0')
+    {
+        // The prefix of the routine can be omitted: "recv" matches MPI_Recv
+        const char* name = MPIM_names[slot->type];
+        if(strcasecmp(name, MPIM_routine_filter) != 0 && (strncmp(name, "MPI_", 4) != 0 || strcasecmp(name + 4, MPIM_routine_filter) != 0))
+        {
+            return false;
+        }
+    }
+    if(MPIM_communicator_filter[0] != '\0')
+    {
+        // Communicators other than world and self are named by their number, whose # can be omitted
+        const char* filter = (MPIM_communicator_filter[0] == '#') ? MPIM_communicator_filter + 1 : MPIM_communicator_filter;
+        const char* name = (slot->communicator[0] == '#') ? slot->communicator + 1 : slot->communicator;
+        if(strcasecmp(name, filter) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Orders two rows of the interactive display according to MPIM_sort, ties being broken by slot.
+ * @param[in] a The slot of the first row.
+ * @param[in] b The slot of the second row.
+ * @return A negative value if a comes first, a positive value if b comes first.
+ **/
+static int MPIM_row_compare(const void* a, const void* b)
+{
+    uint32_t first = *(const uint32_t*)a;
+    uint32_t second = *(const uint32_t*)b;
+    const struct MPIM_slot_t* x = &MPIM_slots[first];
+    const struct MPIM_slot_t* y = &MPIM_slots[second];
+    int order = 0;
+    switch(MPIM_sort)
+    {
+        case MPIM_SORT_AGE:
+            // Oldest first
+            order = (x->time > y->time) - (x->time < y->time);
+            break;
+        case MPIM_SORT_ROUTINE:
+            order = strcmp(MPIM_names[x->type], MPIM_names[y->type]);
+            break;
+        case MPIM_SORT_CALLSITE:
+            order = strcmp(x->where, y->where);
+            break;
+        case MPIM_SORT_BYTES:
+            // Largest first
+            order = (x->bytes < y->bytes) - (x->bytes > y->bytes);
+            break;
+        default:
+            break;
+    }
+    if(order == 0)
+    {
+        order = (first > second) - (first < second);
+    }
+    return MPIM_sort_reversed ? -order : order;
+}
+
+/**
+ * @brief Restores the heap property of the stuck threads downwards from an entry: the most recent call is at the root.
+ * @param[in,out] heap The slots of the heap.
+ * @param[in] count The number of slots in the heap.
+ * @param[in] entry The entry to sift down.
+ **/
+static void MPIM_stuck_sift_down(uint32_t* heap, int count, int entry)
+{
+    while(true)
+    {
+        int smallest = entry;
+        int left = 2 * entry + 1;
+        int right = left + 1;
+        // A later start means a shorter stay in the call
+        if(left < count && MPIM_slots[heap[left]].time > MPIM_slots[heap[smallest]].time)
+        {
+            smallest = left;
+        }
+        if(right < count && MPIM_slots[heap[right]].time > MPIM_slots[heap[smallest]].time)
+        {
+            smallest = right;
+        }
+        if(smallest == entry)
+        {
+            return;
+        }
+        uint32_t swapped = heap[entry];
+        heap[entry] = heap[smallest];
+        heap[smallest] = swapped;
+        entry = smallest;
+    }
+}
+
+/**
+ * @brief Finds the threads that have been inside their current MPI call for the longest time.
+ * @details A heap of the k longest calls seen so far is kept, whose root is the shortest of them. Every thread is compared with the root, and only those longer than it enter the heap, for O(log k) each, instead of sorting the N threads.
+ * @param[out] top The slots of the threads, longest first.
+ * @param[in] k The maximum number of threads.
+ * @return The number of threads found, at most k.
+ **/
+static int MPIM_stuck_find(uint32_t* top, int k)
+{
+    int count = 0;
+    for(uint32_t i = 0; i < MPIM_frame.slot_count; i++)
+    {
+        const struct MPIM_slot_t* slot = &MPIM_slots[i];
+        if(!slot->displayed || !slot->before)
+        {
+            continue;
+        }
+        if(count < k)
+        {
+            // Sift the new entry up
+            int entry = count++;
+            top[entry] = i;
+            while(entry > 0 && MPIM_slots[top[(entry - 1) / 2]].time < MPIM_slots[top[entry]].time)
+            {
+                uint32_t swapped = top[entry];
+                top[entry] = top[(entry - 1) / 2];
+                top[(entry - 1) / 2] = swapped;
+                entry = (entry - 1) / 2;
+            }
+        }
+        else if(count > 0 && slot->time < MPIM_slots[top[0]].time)
+        {
+            top[0] = i;
+            MPIM_stuck_sift_down(top, count, 0);
+        }
+    }
+    // Pop the heap to order the threads, the shortest going to the end
+    for(int end = count - 1; end > 0; end--)
+    {
+        uint32_t swapped = top[0];
+        top[0] = top[end];
+        top[end] = swapped;
+        MPIM_stuck_sift_down(top, end, 0);
+    }
+    return count;
+}
+
+/**
+ * @brief Brings MPIM_rows up to date with the slots and the order of the rows.
+ * @details The rows are only sorted from scratch when the order changed, after a keyframe or when most slots were updated. Otherwise, the slots updated since the previous call are taken out of the rows, sorted among themselves and merged back, so that a frame costs O(N + m log m) for m updates rather than O(N log N).
+ **/
+static void MPIM_rows_update()
+{
+    if(MPIM_updated_slot_count > MPIM_frame.slot_count / 4)
+    {
+        MPIM_rows_stale = true;
+    }
+    if(MPIM_rows_stale)
+    {
+        for(uint32_t i = 0; i < MPIM_updated_slot_count; i++)
+        {
+            MPIM_slot_updated[MPIM_updated_slots[i]] = false;
+        }
+        MPIM_row_count = 0;
+        for(uint32_t i = 0; i < MPIM_frame.slot_count; i++)
+        {
+            if(MPIM_slots[i].displayed)
+            {
+                MPIM_rows[MPIM_row_count++] = i;
+            }
+        }
+        qsort(MPIM_rows, MPIM_row_count, sizeof(uint32_t), MPIM_row_compare);
+    }
+    else if(MPIM_updated_slot_count > 0)
+    {
+        uint32_t kept_count = 0;
+        for(uint32_t i = 0; i < MPIM_row_count; i++)
+        {
+            if(!MPIM_slot_updated[MPIM_rows[i]])
+            {
+                MPIM_rows[kept_count++] = MPIM_rows[i];
+            }
+        }
+        uint32_t inserted_count = 0;
+        for(uint32_t i = 0; i < MPIM_updated_slot_count; i++)
+        {
+            MPIM_slot_updated[MPIM_updated_slots[i]] = false;
+            if(MPIM_slots[MPIM_updated_slots[i]].displayed)
+            {
+                MPIM_updated_slots[inserted_count++] = MPIM_updated_slots[i];
+            }
+        }
+        qsort(MPIM_updated_slots, inserted_count, sizeof(uint32_t), MPIM_row_compare);
+
+        // Merged from the end, so that the rows kept are moved at most once and in place
+        int64_t kept = (int64_t)kept_count - 1;
+        int64_t inserted = (int64_t)inserted_count - 1;
+        int64_t merged = (int64_t)kept_count + inserted_count - 1;
+        while(inserted >= 0)
+        {
+            if(kept >= 0 && MPIM_row_compare(&MPIM_rows[kept], &MPIM_updated_slots[inserted]) > 0)
+            {
+                MPIM_rows[merged--] = MPIM_rows[kept--];
+            }
+            else
+            {
+                MPIM_rows[merged--] = MPIM_updated_slots[inserted--];
+            }
+        }
+        MPIM_row_count = kept_count + inserted_count;
+    }
+    MPIM_updated_slot_count = 0;
+    MPIM_rows_stale = false;
+}
+
+/**
+ * @brief Prints the interactive display from the last frame received: a status line, the threads stuck for the longest time, then a scrollable table of the rows matching the filters.
+ * @details The rows are kept in order by MPIM_rows_update; the filters are applied while going through them, only the rows of the visible page being remembered.
+ **/
+static void MPIM_interface_print()
+{
+    struct winsize size;
+    int lines = 24;
+    int columns = 80;
+    if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0)
+    {
+        lines = size.ws_row;
+        columns = size.ws_col;
+    }
+    char who[MPIM_WHO_LENGTH];
+    char when[MPIM_WHEN_LENGTH];
+
+    // Move to the top left corner, lines are overwritten rather than cleared to avoid flickering
+    printf("\033[H");
+    int used = 0;
+    MPIM_line_print(columns, "Runtime: %.2f seconds (clock error bound: %.3f ms, flush policy: %s)%s", MPIM_frame.runtime, MPIM_frame.clock_error * 1000.0, MPIM_frame.flush_policy, MPIM_run_over ? ", run over" : "");
+    used++;
+
+    uint32_t top[MPIM_MAX_STUCK_TOP];
+    int top_count = MPIM_stuck_find(top, MPIM_stuck_top);
+    if(top_count > 0)
+    {
+        MPIM_line_print(columns, "Longest in their current call:");
+        used++;
+        for(int i = 0; i < top_count; i++)
+        {
+            const struct MPIM_slot_t* slot = &MPIM_slots[top[i]];
+            MPIM_slot_get_who(top[i], who);
+            MPIM_line_print(columns, "  %8.2fs  %s in %s at %s: %s", MPIM_slot_get_age(slot), who, MPIM_names[slot->type], slot->where, slot->details);
+            used++;
+        }
+    }
+
+    MPIM_rows_update();
+    int row_count = 0;
+    for(uint32_t i = 0; i < MPIM_row_count; i++)
+    {
+        if(MPIM_slot_matches(&MPIM_slots[MPIM_rows[i]]))
+        {
+            row_count++;
+        }
+    }
+
+    char filters[MPIM_LINE_LENGTH] = "";
+    if(MPIM_minimum_age > 0.0)
+    {
+        snprintf(filters + strlen(filters), MPIM_LINE_LENGTH - strlen(filters), ", started > %.0f s", MPIM_minimum_age);
+    }
+    if(MPIM_routine_filter[0] != '\0')
+    {
+        snprintf(filters + strlen(filters), MPIM_LINE_LENGTH - strlen(filters), ", routine %s", MPIM_routine_filter);
+    }
+    if(MPIM_communicator_filter[0] != '\0')
+    {
+        snprintf(filters + strlen(filters), MPIM_LINE_LENGTH - strlen(filters), ", comm %s", MPIM_communicator_filter);
+    }
+    MPIM_line_print(columns, "");
+    MPIM_line_print(columns, "%d of %u threads, sorted by %s%s%s", row_count, MPIM_frame.slot_count, MPIM_sort_name_t[MPIM_sort], MPIM_sort_reversed ? " (reversed)" : "", filters);
+    used += 2;
+
+    // The table takes what is left above the help line
+    int table_lines = lines - used - 4;
+    if(table_lines < 1)
+    {
+        table_lines = 1;
+    }
+    if(MPIM_scroll > row_count - table_lines)
+    {
+        MPIM_scroll = row_count - table_lines;
+    }
+    if(MPIM_scroll < 0)
+    {
+        MPIM_scroll = 0;
+    }
+    MPIM_line_print(columns, "%8s | %-24s | %-24s | %-22s | %10s | %s", "Who", "What", "Where", "When", "Bytes", "Details");
+    int row = 0;
+    for(uint32_t i = 0; i < MPIM_row_count && row < MPIM_scroll + table_lines; i++)
+    {
+        const struct MPIM_slot_t* slot = &MPIM_slots[MPIM_rows[i]];
+        if(!MPIM_slot_matches(slot) || row++ < MPIM_scroll)
+        {
+            continue;
+        }
+        MPIM_slot_get_who(MPIM_rows[i], who);
+        MPIM_slot_get_when(slot, when);
+        MPIM_line_print(columns, "%8s | %-24s | %-24s | %-22s | %10llu | %s", who, MPIM_names[slot->type], slot->where, when, (unsigned long long)slot->bytes, slot->details);
+    }
+    // Clear what is left of the previous frame
+    printf("\033[J");
+    printf("\033[%d;1H", lines);
+    if(MPIM_prompt == MPIM_PROMPT_ROUTINE)
+    {
+        printf("Only routine (empty for all): %s\033[K", MPIM_prompt_text);
+    }
+    else if(MPIM_prompt == MPIM_PROMPT_COMMUNICATOR)
+    {
+        printf("Only communicator (empty for all): %s\033[K", MPIM_prompt_text);
+    }
+    else
+    {
+        char help[MPIM_LINE_LENGTH];
+        snprintf(help, MPIM_LINE_LENGTH, "[s]ort [r]everse [t] started > %.0f s [+/-] [f] routine [c] comm [</>] top %d, arrows/pgup/pgdn scroll, [q]uit", MPIM_stuck_threshold, MPIM_stuck_top);
+        if(columns > 0 && columns < MPIM_LINE_LENGTH)
+        {
+            help[columns - 1] = '\0';
+        }
+        printf("%s\033[K", help);
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief Handles the keys pressed since the last check.
+ * @param[in] keys The keys, as read from the terminal, escape sequences included.
+ * @param[in] key_count The number of bytes in keys.
+ * @return false if the viewer must exit, true otherwise.
+ **/
+static bool MPIM_keys_handle(const char* keys, int key_count)
+{
+    int page = 10;
+    for(int i = 0; i < key_count; i++)
+    {
+        char key = keys[i];
+        if(MPIM_prompt != MPIM_PROMPT_NONE)
+        {
+            size_t length = strlen(MPIM_prompt_text);
+            if(key == '\n' || key == '\r')
+            {
+                char* filter = (MPIM_prompt == MPIM_PROMPT_ROUTINE) ? MPIM_routine_filter : MPIM_communicator_filter;
+                snprintf(filter, MPIM_PROMPT_LENGTH, "%s", MPIM_prompt_text);
+                MPIM_prompt = MPIM_PROMPT_NONE;
+                MPIM_scroll = 0;
+            }
+            else if(key == 27)
+            {
+                MPIM_prompt = MPIM_PROMPT_NONE;
+            }
+            else if((key == 127 || key == 8) && length > 0)
+            {
+                MPIM_prompt_text[length - 1] = '\0';
+            }
+            else if(key >= ' ' && key < 127 && length < MPIM_PROMPT_LENGTH - 1)
+            {
+                MPIM_prompt_text[length] = key;
+                MPIM_prompt_text[length + 1] = '\0';
+            }
+            continue;
+        }
+        // Arrows and page keys arrive as ESC [ A, ESC [ B, ESC [ 5 ~ and ESC [ 6 ~
+        if(key == 27 && i + 2 < key_count && keys[i + 1] == '[')
+        {
+            char code = keys[i + 2];
+            i += 2;
+            if(code == 'A')
+            {
+                MPIM_scroll--;
+            }
+            else if(code == 'B')
+            {
+                MPIM_scroll++;
+            }
+            else if((code == '5' || code == '6') && i + 1 < key_count && keys[i + 1] == '~')
+            {
+                MPIM_scroll += (code == '5') ? -page : page;
+                i++;
+            }
+            continue;
+        }
+        switch(key)
+        {
+            case 'q':
+                return false;
+            case 's':
+                MPIM_sort = (enum MPIM_sort_t)((MPIM_sort + 1) % MPIM_SORT_COUNT);
+                MPIM_rows_stale = true;
+                break;
+            case 'r':
+                MPIM_sort_reversed = !MPIM_sort_reversed;
+                MPIM_rows_stale = true;
+                break;
+            case 't':
+                MPIM_minimum_age = (MPIM_minimum_age > 0.0) ? 0.0 : MPIM_stuck_threshold;
+                break;
+            case '+':
+            case '-':
+                MPIM_stuck_threshold += (key == '+') ? 1.0 : -1.0;
+                if(MPIM_stuck_threshold < 1.0)
+                {
+                    MPIM_stuck_threshold = 1.0;
+                }
+                if(MPIM_minimum_age > 0.0)
+                {
+                    MPIM_minimum_age = MPIM_stuck_threshold;
+                }
+                break;
+            case 'f':
+            case 'c':
+                MPIM_prompt = (key == 'f') ? MPIM_PROMPT_ROUTINE : MPIM_PROMPT_COMMUNICATOR;
+                MPIM_prompt_text[0] = '\0';
+                break;
+            case '<':
+                MPIM_stuck_top = (MPIM_stuck_top > 0) ? MPIM_stuck_top - 1 : 0;
+                break;
+            case '>':
+                MPIM_stuck_top = (MPIM_stuck_top < MPIM_MAX_STUCK_TOP) ? MPIM_stuck_top + 1 : MPIM_MAX_STUCK_TOP;
+                break;
+            case 'j':
+                MPIM_scroll++;
+                break;
+            case 'k':
+                MPIM_scroll--;
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Attaches to the socket of the aggregator, waiting for the run to open it.
+ * @param[in] path The path of the socket.
+ * @return The socket, -1 if the aggregator could not be reached.
+ **/
+static int MPIM_connect(const char* path)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(struct sockaddr_un));
+    address.sun_family = AF_UNIX;
+    if(strlen(path) >= sizeof(address.sun_path))
+    {
+        printf("The socket path \"%s\" is too long.\n", path);
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+    for(int waited = 0; waited < MPIM_VIEW_CONNECT_TIMEOUT; waited += 100)
+    {
+        int socket_descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(socket_descriptor == -1)
+        {
+            break;
+        }
+        if(connect(socket_descriptor, (struct sockaddr*)&address, sizeof(struct sockaddr_un)) == 0)
+        {
+            return socket_descriptor;
+        }
+        close(socket_descriptor);
+        if(errno != ENOENT && errno != ECONNREFUSED)
+        {
+            break;
+        }
+        usleep(100 * 1000);
+    }
+    printf("Cannot attach to \"%s\": %s.\n", path, strerror(errno));
+    return -1;
+}
+
+/// Outcomes of reading a message of the aggregator
+enum MPIM_read_t { MPIM_READ_NAMES,
+                   MPIM_READ_SKIPPED,
+                   MPIM_READ_FRAME,
+                   MPIM_READ_END,
+                   MPIM_READ_CLOSED,
+                   MPIM_READ_INVALID };
+
+/**
+ * @brief Reads a message of the aggregator, applying it to the slots.
+ * @param[in] socket_descriptor The socket.
+ * @return What the message was.
+ **/
+static enum MPIM_read_t MPIM_message_read(int socket_descriptor)
+{
+    struct MPIM_view_header_t header;
+    if(!MPIM_read(socket_descriptor, &header, sizeof(struct MPIM_view_header_t)))
+    {
+        return MPIM_READ_CLOSED;
+    }
+    if(header.magic != MPIM_VIEW_MAGIC || header.version != MPIM_VIEW_VERSION)
+    {
+        return MPIM_READ_INVALID;
+    }
+    if(header.kind == MPIM_VIEW_NAMES)
+    {
+        return MPIM_names_read(socket_descriptor, header.length) ? MPIM_READ_NAMES : MPIM_READ_CLOSED;
+    }
+    if(header.kind == MPIM_VIEW_FRAME && MPIM_names != NULL)
+    {
+        return MPIM_frame_read(socket_descriptor) ? MPIM_READ_FRAME : MPIM_READ_CLOSED;
+    }
+    if(header.kind == MPIM_VIEW_END)
+    {
+        return MPIM_READ_END;
+    }
+    char discarded[MPIM_DETAILS_LENGTH];
+    return MPIM_read_text(socket_descriptor, discarded, MPIM_DETAILS_LENGTH, header.length) ? MPIM_READ_SKIPPED : MPIM_READ_CLOSED;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* path = (argc > 1) ? argv[1] : getenv("MPIM_VIEW_SOCKET");
+    if(path == NULL || path[0] == '\0')
+    {
+        printf("Usage: %s [socket path], the path defaulting to the MPIM_VIEW_SOCKET environment variable.\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char* display_rows = getenv("MPIM_DISPLAY_ROWS");
+    if(display_rows != NULL && atoi(display_rows) >= 0)
+    {
+        MPIM_display_rows = atoi(display_rows);
+    }
+
+    int socket_descriptor = MPIM_connect(path);
+    if(socket_descriptor == -1)
+    {
+        return EXIT_FAILURE;
+    }
+    MPIM_terminal_initialise();
+
+    // Wait for whichever comes first, a message or a key, so that keys are handled even when the run is stuck
+    struct pollfd sources[2] = {{socket_descriptor, POLLIN, 0}, {STDIN_FILENO, POLLIN, 0}};
+    int source_count = MPIM_interactive ? 2 : 1;
+    while(true)
+    {
+        if(poll(sources, source_count, -1) < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        if(source_count > 1 && (sources[1].revents & POLLIN))
+        {
+            char keys[64];
+            ssize_t key_count = read(STDIN_FILENO, keys, sizeof(keys));
+            if(key_count > 0)
+            {
+                if(!MPIM_keys_handle(keys, key_count))
+                {
+                    break;
+                }
+                if(MPIM_slots != NULL)
+                {
+                    MPIM_interface_print();
+                }
+            }
+        }
+        if(sources[0].revents & (POLLIN | POLLHUP | POLLERR))
+        {
+            enum MPIM_read_t result = MPIM_message_read(socket_descriptor);
+            if(result == MPIM_READ_INVALID)
+            {
+                printf("\"%s\" does not serve version %d of the MPI_monitor viewer protocol.\n", path, MPIM_VIEW_VERSION);
+                close(socket_descriptor);
+                return EXIT_FAILURE;
+            }
+            if(result == MPIM_READ_FRAME)
+            {
+                if(MPIM_interactive)
+                {
+                    MPIM_interface_print();
+                }
+                else
+                {
+                    MPIM_display_print();
+                }
+            }
+            else if(result == MPIM_READ_END || result == MPIM_READ_CLOSED)
+            {
+                MPIM_run_over = true;
+                if(!MPIM_interactive)
+                {
+                    printf((result == MPIM_READ_END) ? "The run is over.\n" : "The run closed the connection.\n");
+                    break;
+                }
+                // The last frame stays on screen until the user quits, poll ignoring negative descriptors
+                sources[0].fd = -1;
+                if(MPIM_slots != NULL)
+                {
+                    MPIM_interface_print();
+                }
+            }
+        }
+    }
+    close(socket_descriptor);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../src/mpi_monitor.h"
+
+/**
+ * @brief Gives the time elapsed between two instants.
+ * @param[in] start The first instant.
+ * @param[in] end The second instant.
+ * @return The time elapsed, in nanoseconds.
+ **/
+static double get_nanoseconds(const struct timespec* start, const struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) * 1.0E9 + (end->tv_nsec - start->tv_nsec);
+}
+
+/**
+ * @details Measures the overhead the monitor adds to every MPI call, by timing a loop of MPI_Test calls on a null request, whose own cost is negligible.
+ * Local queries such as MPI_Comm_rank are not published to the coordinator, so they would not measure the full overhead.
+ * A loop of MPI_Barrier calls on MPI_COMM_SELF measures blocking routines, whose update may be flushed to the coordinator before entering the routine.
+ * Run it with different values of the MPIM_CLOCK_SOURCE environment variable, such as "tsc", "monotonic_raw" or "gettimeofday", to compare the clock sources,
+ * and of the MPIM_FLUSH_POLICY environment variable, "none", "blocking" or "all", to compare the flush policies.
+ **/
+int main(int argc, char* argv[])
+{
+    MPI_Init(&argc, &argv);
+
+    int my_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+    const int ITERATIONS = 1000000;
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(int i = 0; i < ITERATIONS; i++)
+    {
+        MPI_Request request = MPI_REQUEST_NULL;
+        int flag;
+        MPI_Test(&request, &flag, MPI_STATUS_IGNORE);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double nanoseconds_per_call[2];
+    nanoseconds_per_call[0] = get_nanoseconds(&start, &end) / ITERATIONS;
+
+    const int BLOCKING_ITERATIONS = ITERATIONS / 10;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(int i = 0; i < BLOCKING_ITERATIONS; i++)
+    {
+        MPI_Barrier(MPI_COMM_SELF);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    nanoseconds_per_call[1] = get_nanoseconds(&start, &end) / BLOCKING_ITERATIONS;
+
+    double max_nanoseconds_per_call[2];
+    MPI_Reduce(nanoseconds_per_call, max_nanoseconds_per_call, 2, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    MPI_Finalize();
+
+    if(my_rank == 0)
+    {
+        const char* clock_source = getenv("MPIM_CLOCK_SOURCE");
+        const char* flush_policy = getenv("MPIM_FLUSH_POLICY");
+        printf("Clock source %s, flush policy %s: %.1f ns per monitored nonblocking MPI call, %.1f ns per monitored blocking MPI call.\n", (clock_source == NULL) ? "default" : clock_source,
+               (flush_policy == NULL) ? "default" : flush_policy, max_nanoseconds_per_call[0], max_nanoseconds_per_call[1]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,450 @@
+/**
+ * @file scalability.c
+ * @brief Measures how the aggregator scales with the number of MPI processes, simulated inside a single process by the stub MPI layer of fake_mpi.c.
+ * @details Usage: scalability [seconds] [virtual rank counts]. Every rank count, 1000, 10000 and 100000 by default, is simulated for the given number of seconds, 5 by default, in a process of its own, since MPI is initialised once per process. Virtual ranks replay the cases of all_states.c, rank r behaving as rank r % 8 there:
+ * - 0 and 1 hang in a mutual MPI_Ssend, and 2 hangs in an MPI_Ssend to 1;
+ * - 3 and 4 keep exchanging messages;
+ * - 5 hangs in an MPI_Ssend to 6 until 6 receives it, halfway through;
+ * - 7 does nothing.
+ * For every rank count, the harness reports:
+ * - the memory taken by the monitor once initialised, and the peak memory of the process;
+ * - the CPU time the manager thread of the aggregator spends per frame, snapshot, display and snapshot file included;
+ * - the latency of aggregation, from the update of virtual rank 3 to its publication in the snapshot file, half a refresh period on average plus the time to process a frame;
+ * - the duration of MPI_Finalize, until the aggregator notices that every process has finalised and stops;
+ * - the rate at which updates are published;
+ * - from 10000 virtual ranks on, in a second simulation, the number of frames received by a viewer attached to the socket of the aggregator, which reads them at its own pace, and whether it stayed attached until the end of the run.
+ * The display of the aggregator is discarded.
+ **/
+
+#define _GNU_SOURCE // pthread_getcpuclockid
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> // strstr
+#include <fcntl.h> // open
+#include <pthread.h> // pthread_getcpuclockid
+#include <sys/mman.h> // mmap
+#include <sys/socket.h> // socket, connect
+#include <sys/stat.h> // fstat
+#include <sys/un.h> // sockaddr_un
+#include <sys/wait.h> // waitpid
+#include <time.h> // clock_gettime
+#include <unistd.h> // fork, pipe
+#include "../src/mpi_monitor.h"
+#include "../src/mpi_monitor_snapshot.h"
+#include "../src/mpi_monitor_view.h"
+#include "fake_mpi.h"
+
+/// Maximum number of aggregation latencies measured per rank count
+#define MAX_SAMPLES 1024
+/// Number of seconds after which an update that did not reach the snapshot file is considered lost
+#define LATENCY_TIMEOUT 10.0
+/// The refresh period of the aggregator, 4 frames per second
+#define REFRESH_MICROSECONDS 250000
+/// Smallest number of virtual ranks simulated a second time with a viewer attached
+#define VIEWER_MIN_COMM_SIZE 10000
+/// Number of bytes the viewer reads at a time, pausing VIEWER_PAUSE_MICROSECONDS in between so that the aggregator has to queue its keyframes
+#define VIEWER_READ_SIZE 65536
+/// Pause of the viewer between two reads
+#define VIEWER_PAUSE_MICROSECONDS 500
+
+/// The manager thread of the aggregator, whose CPU time gives the cost of the frames
+extern pthread_t MPIM_manager_thread;
+
+/// The results of the simulation of a rank count
+struct result_t
+{
+    /// The number of virtual ranks
+    int comm_size;
+    /// Memory taken by MPI_Init, in megabytes
+    double init_megabytes;
+    /// Peak memory of the process, in megabytes
+    double peak_megabytes;
+    /// CPU time of the manager thread per frame, in milliseconds
+    double frame_milliseconds;
+    /// Median aggregation latency, in milliseconds
+    double median_latency;
+    /// Largest aggregation latency, in milliseconds
+    double max_latency;
+    /// Duration of MPI_Finalize, in milliseconds
+    double finalize_milliseconds;
+    /// Updates published per second
+    double update_rate;
+    /// Number of frames received by the viewer, -1 if no viewer was attached
+    int viewer_frames;
+    /// Indicates if the viewer received the end of the run, rather than being detached
+    bool viewer_ended;
+};
+
+/// A viewer attached to the socket of the aggregator, reading in a thread of its own
+struct viewer_t
+{
+    /// The path of the socket
+    const char* path;
+    /// Number of frames received
+    int frames;
+    /// Indicates if the end of the run was received
+    bool ended;
+};
+
+/**
+ * @brief Gives the time elapsed since an arbitrary instant.
+ * @param[in] clock The clock to read.
+ * @return The time, in seconds.
+ **/
+static double get_seconds(clockid_t clock)
+{
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return now.tv_sec + now.tv_nsec * 1.0E-9;
+}
+
+/**
+ * @brief Reads a memory figure of the process.
+ * @param[in] field The field of /proc/self/status, such as "VmRSS:" or "VmHWM:".
+ * @return The figure, in megabytes.
+ **/
+static double get_megabytes(const char* field)
+{
+    FILE* status = fopen("/proc/self/status", "r");
+    char line[256];
+    double kilobytes = 0.0;
+    while(status != NULL && fgets(line, sizeof(line), status) != NULL)
+    {
+        if(strncmp(line, field, strlen(field)) == 0)
+        {
+            kilobytes = atof(line + strlen(field));
+        }
+    }
+    if(status != NULL)
+    {
+        fclose(status);
+    }
+    return kilobytes / 1024.0;
+}
+
+/**
+ * @brief Compares two latencies, for qsort.
+ **/
+static int compare_doubles(const void* a, const void* b)
+{
+    double difference = *(const double*)a - *(const double*)b;
+    return (difference > 0.0) - (difference < 0.0);
+}
+
+/**
+ * @brief Reads exactly a number of bytes from a socket, in reads of at most VIEWER_READ_SIZE bytes separated by pauses.
+ * @param[in] socket The socket.
+ * @param[out] data The buffer receiving the bytes, NULL to discard them.
+ * @param[in] size The number of bytes.
+ * @return true if the bytes were read, false if the socket was closed first.
+ **/
+static bool read_slowly(int socket, void* data, size_t size)
+{
+    static char discarded[VIEWER_READ_SIZE];
+    size_t received = 0;
+    while(received < size)
+    {
+        size_t length = (size - received < VIEWER_READ_SIZE) ? size - received : VIEWER_READ_SIZE;
+        ssize_t result = read(socket, (data != NULL) ? (char*)data + received : discarded, length);
+        if(result <= 0)
+        {
+            return false;
+        }
+        received += result;
+        usleep(VIEWER_PAUSE_MICROSECONDS);
+    }
+    return true;
+}
+
+/**
+ * @brief Attaches to the socket of the aggregator and reads its messages until the end of the run or until it is detached.
+ * @param[in,out] argument The viewer.
+ * @return NULL.
+ **/
+static void* view(void* argument)
+{
+    struct viewer_t* viewer = (struct viewer_t*)argument;
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(struct sockaddr_un));
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", viewer->path);
+    int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    while(connect(descriptor, (struct sockaddr*)&address, sizeof(struct sockaddr_un)) != 0)
+    {
+        usleep(1000);
+    }
+    struct MPIM_view_header_t header;
+    while(read_slowly(descriptor, &header, sizeof(struct MPIM_view_header_t)) && read_slowly(descriptor, NULL, header.length))
+    {
+        if(header.kind == MPIM_VIEW_FRAME)
+        {
+            viewer->frames++;
+        }
+        else if(header.kind == MPIM_VIEW_END)
+        {
+            viewer->ended = true;
+            break;
+        }
+    }
+    close(descriptor);
+    return NULL;
+}
+
+/**
+ * @brief Issues an MPI_Ssend on behalf of a virtual rank.
+ * @param[in] rank The virtual rank.
+ * @param[in] destination The rank of the destination.
+ * @param[in] hang Indicates if the MPI_Ssend never completes.
+ **/
+static void issue_ssend(int rank, int destination, bool hang)
+{
+    int buffer = 0;
+    MPIM_fake_set_rank(rank);
+    if(hang)
+    {
+        MPIM_fake_hang_next_call();
+    }
+    MPI_Ssend(&buffer, 1, MPI_INT, destination, 0, MPI_COMM_WORLD);
+}
+
+/**
+ * @brief Issues an MPI_Recv on behalf of a virtual rank.
+ * @param[in] rank The virtual rank.
+ * @param[in] source The rank of the source.
+ **/
+static void issue_recv(int rank, int source)
+{
+    int buffer;
+    MPIM_fake_set_rank(rank);
+    MPI_Recv(&buffer, 1, MPI_INT, source, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+}
+
+/**
+ * @brief Simulates a run, in a process of its own.
+ * @param[in] comm_size The number of virtual ranks.
+ * @param[in] duration The number of seconds during which the virtual ranks exchange messages.
+ * @param[in] with_viewer Indicates if a viewer attaches to the aggregator.
+ * @param[out] result The measures.
+ * @return true if the simulation completed, false if the snapshot file could not be read.
+ **/
+static bool simulate(int comm_size, double duration, bool with_viewer, struct result_t* result)
+{
+    char snapshot_path[64];
+    snprintf(snapshot_path, sizeof(snapshot_path), "/tmp/mpim_scalability.%d.snapshot", (int)getpid());
+    setenv("MPIM_SNAPSHOT_FILE", snapshot_path, 1);
+    setenv("MPIM_PROFILE_FILE", "", 1);
+    unsetenv("MPIM_THREADS_PER_PROCESS");
+    unsetenv("MPIM_METRICS_PORT");
+    char view_path[64];
+    snprintf(view_path, sizeof(view_path), "/tmp/mpim_scalability.%d.socket", (int)getpid());
+    struct viewer_t viewer = { view_path, 0, false };
+    pthread_t viewer_thread;
+    if(with_viewer)
+    {
+        setenv("MPIM_VIEW_SOCKET", view_path, 1);
+    }
+    else
+    {
+        unsetenv("MPIM_VIEW_SOCKET");
+    }
+
+    result->comm_size = comm_size;
+    MPIM_fake_set_comm_size(comm_size);
+    double megabytes = get_megabytes("VmRSS:");
+    MPI_Init(NULL, NULL);
+    result->init_megabytes = get_megabytes("VmRSS:") - megabytes;
+    if(with_viewer)
+    {
+        pthread_create(&viewer_thread, NULL, view, &viewer);
+    }
+
+    int descriptor = open(snapshot_path, O_RDONLY);
+    struct stat file_status;
+    if(descriptor == -1 || fstat(descriptor, &file_status) == -1)
+    {
+        return false;
+    }
+    const char* mapping = (const char*)mmap(NULL, file_status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if(mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    const struct MPIM_published_header_t* header = (const struct MPIM_published_header_t*)mapping;
+    while(__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != MPIM_PUBLISHED_MAGIC)
+    {
+        usleep(1000);
+    }
+    const struct MPIM_published_slot_t* slots = (const struct MPIM_published_slot_t*)(mapping + header->slots_offset);
+
+    // The hanging calls are issued once, as in all_states.c
+    for(int rank = 0; rank < comm_size; rank++)
+    {
+        switch(rank % 8)
+        {
+            case 0:
+            case 5:
+                issue_ssend(rank, (rank + 1) % comm_size, true);
+                break;
+            case 1:
+            case 2:
+                issue_ssend(rank, rank - 1, true);
+                break;
+        }
+    }
+
+    clockid_t manager_clock;
+    pthread_getcpuclockid(MPIM_manager_thread, &manager_clock);
+    double manager_start = get_seconds(manager_clock);
+    uint64_t generation_start = __atomic_load_n(&header->generation, __ATOMIC_ACQUIRE);
+    uint64_t update_start = MPIM_fake_get_update_count();
+    double start = get_seconds(CLOCK_MONOTONIC);
+    double issue_time = 0.0;
+    double latencies[MAX_SAMPLES];
+    int sample_count = 0;
+    bool halfway = false;
+    for(int round = 1; get_seconds(CLOCK_MONOTONIC) - start < duration; round++)
+    {
+        double issue_start = get_seconds(CLOCK_MONOTONIC);
+        for(int rank = 3; rank + 1 < comm_size; rank += 8)
+        {
+            issue_ssend(rank, rank + 1, false);
+            issue_recv(rank + 1, rank);
+        }
+        if(!halfway && get_seconds(CLOCK_MONOTONIC) - start >= duration / 2.0)
+        {
+            for(int rank = 5; rank + 1 < comm_size; rank += 8)
+            {
+                issue_recv(rank + 1, rank);
+                issue_ssend(rank, rank + 1, false);
+            }
+            halfway = true;
+        }
+        issue_time += get_seconds(CLOCK_MONOTONIC) - issue_start;
+
+        // The probe is sent at a random point of the refresh period, as it would otherwise follow the frame that published the previous one; its tag tells its update apart in the snapshot file
+        usleep(rand() % REFRESH_MICROSECONDS);
+        int buffer = 0;
+        MPIM_fake_set_rank(3);
+        double sent = get_seconds(CLOCK_MONOTONIC);
+        MPI_Send(&buffer, 1, MPI_INT, 4, round, MPI_COMM_WORLD);
+        char expected[32];
+        snprintf(expected, sizeof(expected), ", tag %d,", round);
+        struct MPIM_published_slot_t slot;
+        while(!MPIM_published_slot_read(&slots[3], &slot, 16) || strstr(slot.details, expected) == NULL)
+        {
+            if(get_seconds(CLOCK_MONOTONIC) - sent > LATENCY_TIMEOUT)
+            {
+                return false;
+            }
+            usleep(100);
+        }
+        if(sample_count < MAX_SAMPLES)
+        {
+            latencies[sample_count++] = (get_seconds(CLOCK_MONOTONIC) - sent) * 1.0E3;
+        }
+    }
+    uint64_t frame_count = (__atomic_load_n(&header->generation, __ATOMIC_ACQUIRE) - generation_start) / 2;
+    result->frame_milliseconds = (frame_count > 0) ? (get_seconds(manager_clock) - manager_start) * 1.0E3 / frame_count : 0.0;
+    result->update_rate = (issue_time > 0.0) ? (MPIM_fake_get_update_count() - update_start) / issue_time : 0.0;
+    qsort(latencies, sample_count, sizeof(double), compare_doubles);
+    result->median_latency = (sample_count > 0) ? latencies[sample_count / 2] : 0.0;
+    result->max_latency = (sample_count > 0) ? latencies[sample_count - 1] : 0.0;
+
+    // Every process calls MPI_Finalize at once
+    MPIM_fake_set_rank(0);
+    MPIM_fake_set_broadcast(true);
+    double finalize_start = get_seconds(CLOCK_MONOTONIC);
+    MPI_Finalize();
+    result->finalize_milliseconds = (get_seconds(CLOCK_MONOTONIC) - finalize_start) * 1.0E3;
+    result->peak_megabytes = get_megabytes("VmHWM:");
+    result->viewer_frames = -1;
+    result->viewer_ended = false;
+    if(with_viewer)
+    {
+        pthread_join(viewer_thread, NULL);
+        result->viewer_frames = viewer.frames;
+        result->viewer_ended = viewer.ended;
+    }
+
+    munmap((void*)mapping, file_status.st_size);
+    unlink(snapshot_path);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    double duration = (argc > 1) ? atof(argv[1]) : 5.0;
+    const int DEFAULT_COMM_SIZES[] = {1000, 10000, 100000};
+    int comm_size_count = (argc > 2) ? argc - 2 : 3;
+
+    printf("+---------------+------------+------------+------------+--------------+--------------+------------+-------------+------------------+\n");
+    printf("| %13s | %10s | %10s | %10s | %12s | %12s | %10s | %11s | %16s |\n", "Virtual ranks", "Init (MB)", "Peak (MB)", "Frame (ms)", "Latency (ms)", "Max lat (ms)", "Final (ms)", "Updates/s", "Viewer frames");
+    printf("+---------------+------------+------------+------------+--------------+--------------+------------+-------------+------------------+\n");
+    fflush(stdout);
+    for(int simulation = 0; simulation < 2 * comm_size_count; simulation++)
+    {
+        // Every rank count is simulated without viewer, then with one from VIEWER_MIN_COMM_SIZE virtual ranks on
+        int i = simulation / 2;
+        bool with_viewer = (simulation % 2) == 1;
+        int comm_size = (argc > 2) ? atoi(argv[i + 2]) : DEFAULT_COMM_SIZES[i];
+        if(with_viewer && comm_size < VIEWER_MIN_COMM_SIZE)
+        {
+            continue;
+        }
+        if(comm_size < 8)
+        {
+            if(!with_viewer)
+            {
+                printf("The simulation needs at least 8 virtual ranks, %d skipped.\n", comm_size);
+            }
+            continue;
+        }
+        int channel[2];
+        if(pipe(channel) == -1)
+        {
+            perror("pipe");
+            return EXIT_FAILURE;
+        }
+        pid_t child = fork();
+        if(child == 0)
+        {
+            // The display of the aggregator and its reports go to stdout, which the results must not share
+            close(channel[0]);
+            int null_descriptor = open("/dev/null", O_WRONLY);
+            dup2(null_descriptor, STDOUT_FILENO);
+            struct result_t result;
+            bool completed = simulate(comm_size, duration, with_viewer, &result);
+            if(completed)
+            {
+                write(channel[1], &result, sizeof(result));
+            }
+            _exit(completed ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        close(channel[1]);
+        struct result_t result;
+        ssize_t length = read(channel[0], &result, sizeof(result));
+        close(channel[0]);
+        waitpid(child, NULL, 0);
+        if(length != sizeof(result))
+        {
+            printf("| %13d | %s |\n", comm_size, "simulation failed");
+            continue;
+        }
+        char viewer_frames[32];
+        if(result.viewer_frames < 0)
+        {
+            snprintf(viewer_frames, sizeof(viewer_frames), "-");
+        }
+        else
+        {
+            snprintf(viewer_frames, sizeof(viewer_frames), "%d%s", result.viewer_frames, result.viewer_ended ? "" : ", detached");
+        }
+        printf("| %13d | %10.1f | %10.1f | %10.3f | %12.1f | %12.1f | %10.1f | %11.0f | %16s |\n", result.comm_size, result.init_megabytes, result.peak_megabytes, result.frame_milliseconds,
+               result.median_latency, result.max_latency, result.finalize_milliseconds, result.update_rate, viewer_frames);
+        fflush(stdout);
+    }
+    printf("+---------------+------------+------------+------------+--------------+--------------+------------+-------------+------------------+\n");
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include <fcntl.h> // open
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> // strcmp, strstr
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <time.h> // clock_gettime
+#include <unistd.h>
+#include "../src/mpi_monitor.h"
+#include "../src/mpi_monitor_snapshot.h"
+
+/// The refresh period of the aggregator, 4 frames per second
+#define REFRESH_SECONDS 0.25
+/// Margin granted on top of the refresh period and the clock error bound, for the manager thread to be scheduled
+#define MARGIN_SECONDS 0.05
+/// Number of seconds after which a process that did not appear blocked in a round is given up
+#define ROUND_TIMEOUT_SECONDS 5.0
+
+/**
+ * @brief Reads the monotonic clock, so that process 0 does not call MPI while it checks the snapshot file.
+ * @return The time, in seconds.
+ **/
+static double get_seconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1.0E-9;
+}
+
+/**
+ * @brief Maps the snapshot file of the aggregator, waiting for it to be laid out.
+ * @param[in] path The path of the snapshot file.
+ * @param[out] size The size of the mapping.
+ * @return The header of the snapshot file, NULL if it cannot be mapped.
+ **/
+static const struct MPIM_published_header_t* map_snapshot(const char* path, size_t* size)
+{
+    int descriptor = open(path, O_RDONLY);
+    struct stat file_status;
+    if(descriptor == -1 || fstat(descriptor, &file_status) == -1)
+    {
+        return NULL;
+    }
+    void* mapping = mmap(NULL, file_status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if(mapping == MAP_FAILED)
+    {
+        return NULL;
+    }
+    *size = file_status.st_size;
+    const struct MPIM_published_header_t* header = (const struct MPIM_published_header_t*)mapping;
+    while(__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != MPIM_PUBLISHED_MAGIC)
+    {
+        usleep(1000);
+    }
+    return header;
+}
+
+/**
+ * @brief Waits for the first thread of a process to appear as having started the MPI_Recv of a round in the snapshot file.
+ * @param[in] header The header of the snapshot file.
+ * @param[in] rank The rank of the process.
+ * @param[in] round The round, used as the tag of the MPI_Recv.
+ * @param[out] delay The time from the update announcing the MPI_Recv to the frame that published it, in seconds.
+ * @param[out] bound The largest delay allowed, one refresh period plus the clock error bound of that frame and a margin.
+ * @return true if the MPI_Recv appeared within ROUND_TIMEOUT_SECONDS, false otherwise.
+ **/
+static bool wait_blocked(const struct MPIM_published_header_t* header, int rank, int round, double* delay, double* bound)
+{
+    const char* mapping = (const char*)header;
+    const struct MPIM_published_slot_t* slots = (const struct MPIM_published_slot_t*)(mapping + header->slots_offset);
+    const struct MPIM_published_slot_t* slot = &slots[rank * header->threads_per_process];
+    char expected[32];
+    snprintf(expected, sizeof(expected), ", tag %d,", round);
+    double start = get_seconds();
+    while(get_seconds() - start < ROUND_TIMEOUT_SECONDS)
+    {
+        // The slot is read within a single frame, so that the runtime read along gives the frame that published it
+        uint64_t generation = __atomic_load_n(&header->generation, __ATOMIC_ACQUIRE);
+        struct MPIM_published_slot_t copy;
+        if(generation % 2 == 0 && MPIM_published_slot_read(slot, &copy, 16))
+        {
+            double runtime = header->runtime;
+            double clock_error = header->clock_error;
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            const char* name = mapping + header->names_offset + copy.type * MPIM_PUBLISHED_NAME_LENGTH;
+            if(__atomic_load_n(&header->generation, __ATOMIC_RELAXED) == generation && copy.before == 1 && strcmp(name, "MPI_Recv") == 0 && strstr(copy.details, expected) != NULL)
+            {
+                *delay = runtime - copy.time;
+                *bound = REFRESH_SECONDS + clock_error + MARGIN_SECONDS;
+                return true;
+            }
+        }
+        usleep(1000);
+    }
+    return false;
+}
+
+/**
+ * @details Checks that a process blocked in MPI is reported as such within one refresh of the display, exiting with a failure otherwise.
+ * In every round, the processes other than 0 first issue a burst of monitored nonblocking calls, leaving updates in flight, then block in MPI_Recv until process 0 sends them a message.
+ * Before sending, process 0 reads the snapshot file of the aggregator, without calling MPI: every other process must appear as having started MPI_Recv, in a frame published at most one refresh period after the update announcing it.
+ * With the MPIM_FLUSH_POLICY environment variable set to "blocking", the default, or "all", this holds in every round; with "none", it depends on the MPI implementation progressing the updates of blocked processes. The MPIM_SNAPSHOT_FILE environment variable is set by the application.
+ **/
+int main(int argc, char* argv[])
+{
+    char snapshot_path[64];
+    snprintf(snapshot_path, sizeof(snapshot_path), "/tmp/mpim_stuck_visibility.%d.snapshot", (int)getpid());
+    setenv("MPIM_SNAPSHOT_FILE", snapshot_path, 1);
+
+    MPI_Init(&argc, &argv);
+
+    int my_rank;
+    int comm_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+    if(comm_size < 2)
+    {
+        printf("This application must be run with at least 2 MPI processes.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+
+    const struct MPIM_published_header_t* header = NULL;
+    size_t mapping_size = 0;
+    if(my_rank == 0)
+    {
+        header = map_snapshot(snapshot_path, &mapping_size);
+        if(header == NULL)
+        {
+            fprintf(stderr, "Cannot map the snapshot file \"%s\".\n", snapshot_path);
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+    }
+
+    const int ROUNDS = 8;
+    int miss_count = 0;
+    for(int round = 0; round < ROUNDS; round++)
+    {
+        int token = round;
+        if(my_rank == 0)
+        {
+            double worst_delay = 0.0;
+            for(int i = 1; i < comm_size; i++)
+            {
+                double delay = 0.0;
+                double bound = 0.0;
+                if(!wait_blocked(header, i, round, &delay, &bound))
+                {
+                    fprintf(stderr, "Round %d: process %d never appeared blocked in MPI_Recv.\n", round, i);
+                    miss_count++;
+                }
+                else
+                {
+                    if(delay > bound)
+                    {
+                        fprintf(stderr, "Round %d: process %d appeared blocked in MPI_Recv %.1f ms after its update, more than %.1f ms.\n", round, i, delay * 1.0E3, bound * 1.0E3);
+                        miss_count++;
+                    }
+                    if(delay > worst_delay)
+                    {
+                        worst_delay = delay;
+                    }
+                }
+            }
+            fprintf(stderr, "Round %d: worst delay %.1f ms.\n", round, worst_delay * 1.0E3);
+            for(int i = 1; i < comm_size; i++)
+            {
+                MPI_Send(&token, 1, MPI_INT, i, round, MPI_COMM_WORLD);
+            }
+        }
+        else
+        {
+            // Bursts of different lengths leave the outbox of the thread more or less full when blocking
+            for(int i = 0; i < round * 37; i++)
+            {
+                MPI_Request request = MPI_REQUEST_NULL;
+                int flag;
+                MPI_Test(&request, &flag, MPI_STATUS_IGNORE);
+            }
+            MPI_Recv(&token, 1, MPI_INT, 0, round, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+    }
+
+    MPI_Finalize();
+
+    if(my_rank == 0)
+    {
+        munmap((void*)header, mapping_size);
+        unlink(snapshot_path);
+        fprintf(stderr, "%d process%s not shown blocked within one refresh.\n", miss_count, (miss_count == 1) ? "" : "es");
+    }
+
+    return (miss_count == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -2,22 +2,191 @@
  * @file mpi_monitor.c
  **/
 
+#define _GNU_SOURCE // dl_iterate_phdr, accept4
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h> // bool
-#include <math.h> // fabs
+#include <stdint.h> // uintptr_t, uint64_t
+#include <link.h> // dl_iterate_phdr
+#include <backtrace.h> // backtrace_pcinfo, backtrace_syminfo
 #include <pthread.h> // pthread_t
+#include <sched.h> // sched_yield
+#include <stdatomic.h> // atomic_int
 #include <string.h> // memcpy
-#include <unistd.h> // sleep, usleep
+#include <stddef.h> // offsetof
+#include <unistd.h> // sleep, usleep, readlink
 #include <sys/time.h> // gettimeofday
+#include <time.h> // clock_gettime
+#include <signal.h> // pthread_kill, sigaction
+#include <execinfo.h> // backtrace
+#include <errno.h> // errno
+#include <sys/socket.h> // socket, accept4, send
+#include <sys/un.h> // sockaddr_un
+#include <sys/stat.h> // lstat
+#include <netinet/in.h> // sockaddr_in
+#include <arpa/inet.h> // htons
+#include <poll.h> // poll
+#include <stdarg.h> // va_list
+#include <inttypes.h> // PRIu64
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc
+#include <cpuid.h> // __get_cpuid
+#endif
 /// Allows to include the mpi_monitor header without MPI substitions so that MPI calls are issued as is.
 #define MPI_MONITOR_NO_SUBSTITUTION
 #include "mpi_monitor.h"
+#include "mpi_monitor_view.h"
+#include "mpi_monitor_snapshot.h"
+#include "mpi_monitor_trace.h"
 
 /// Maximum length of names used in this library.
 #define MPIM_MAX_FILENAME_LENGTH 256
-/// Maximum length of arguments used in this library.
+/// Maximum length of the description of the arguments of an MPI call.
 #define MPIM_MAX_ARGUMENTS_LENGTH 256
+/// Count recorded for routines whose count differs from one process to the other, such as MPI_Alltoallv.
+#define MPIM_VARIABLE_COUNT -1
+/// Maximum number of modules (executable and shared libraries) in which callsites can be located.
+#define MPIM_MAX_MODULES 256
+/// Number of entries in the direct-mapped cache translating return addresses into module indexes.
+#define MPIM_CALLSITE_CACHE_SIZE 64
+/// Number of buckets in the hash map caching symbolised callsites on the aggregator.
+#define MPIM_SYMBOL_CACHE_SIZE 1024
+/// Maximum length of a symbolised callsite.
+#define MPIM_MAX_SYMBOL_LENGTH 64
+/// Default number of threads per process that can be monitored when MPI calls may be issued from several threads.
+#define MPIM_DEFAULT_THREADS_PER_PROCESS 16
+/// Number of ping-pong exchanges performed to estimate the clock offset of a process, the one with the shortest round trip is kept.
+#define MPIM_CLOCK_SYNC_ROUNDS 8
+/// Default number of seconds between two estimations of the clock offset of a process, used to correct clock drift.
+#define MPIM_DEFAULT_CLOCK_SYNC_PERIOD 10.0
+/// Number of seconds after which a clock offset estimation is abandoned if the aggregator has not answered.
+#define MPIM_CLOCK_SYNC_TIMEOUT 0.1
+/// Number of milliseconds between two checks of the pending clock requests by the aggregator.
+#define MPIM_CLOCK_SERVE_PERIOD 1
+/// Factor by which the best round trip of a periodic estimation of the clock offset may exceed the shortest one kept so far; beyond it, the exchanges were slowed by the application between its MPI calls and the previous calibration is kept.
+#define MPIM_CLOCK_SYNC_ROUND_TRIP_TOLERANCE 2.0
+/// Bound on the error of the clock drift, in seconds per second, above which the drift estimated is discarded.
+#define MPIM_CLOCK_MAX_DRIFT_ERROR 1.0E-5
+/// Number of milliseconds during which the time-stamp counter is calibrated against CLOCK_MONOTONIC_RAW.
+#define MPIM_TSC_CALIBRATION_DURATION 20
+/// Number of payload size buckets in the histograms: 0 B, then one per power of two, the last one gathering everything larger.
+#define MPIM_HISTOGRAM_SIZE_BUCKETS 32
+/// Number of latency buckets in the histograms: below 1 us, then one per power of two of microseconds, the last one gathering everything longer.
+#define MPIM_HISTOGRAM_LATENCY_BUCKETS 24
+/// Number of entries in the direct-mapped cache of datatype sizes.
+#define MPIM_DATATYPE_CACHE_SIZE 16
+/// Maximum number of distinct callsites profiled, further callsites are only accounted for in the routine totals.
+#define MPIM_PROFILE_MAX_CALLSITES 512
+/// Default number of callsites printed by the end-of-run profile, changed with the MPIM_PROFILE_TOP environment variable.
+#define MPIM_DEFAULT_PROFILE_TOP 10
+/// Default file the full end-of-run profile is written to, changed with the MPIM_PROFILE_FILE environment variable.
+#define MPIM_DEFAULT_PROFILE_FILE "mpi_monitor_profile.txt"
+/// Maximum number of frames captured in the stack of a stalled call.
+#define MPIM_STACK_MAX_DEPTH 32
+/// Number of frames at the top of a captured stack that belong to the signal handler capturing it.
+#define MPIM_STACK_SKIPPED_FRAMES 2
+/// Signal sent to a stalled thread to capture its stack; ignored by default, so a late delivery is harmless.
+#define MPIM_STACK_SIGNAL SIGURG
+/// Number of milliseconds between two checks for stalled calls.
+#define MPIM_WATCHDOG_PERIOD 100
+/// Maximum number of stalled calls listed for a stack shared by several of them.
+#define MPIM_STACK_MAX_LISTED_CALLS 16
+/// Number of send stamps kept per sender on a receiver, older unmatched ones being overwritten.
+#define MPIM_WAIT_STAMP_RING 8
+/// Number of N-to-N collectives on MPI_COMM_WORLD whose arrival times are kept on the aggregator.
+#define MPIM_WAIT_ARRIVAL_RING 8
+/// Default number of ranks listed in the wait state report, changed with the MPIM_WAIT_STATES_TOP environment variable.
+#define MPIM_DEFAULT_WAIT_STATES_TOP 5
+/// Number of entries of the per-thread cache of the nonblocking receives posted, an entry being overwritten by a receive whose handle falls in the same entry.
+#define MPIM_WAIT_RECEIVE_CACHE_SIZE 64
+/// Maximum number of nonblocking receives analysed per completion call, further ones being ignored.
+#define MPIM_WAIT_COMPLETION_MAX 64
+/// Number of entries of the per-thread cache of the translations of communicator ranks into ranks in MPI_COMM_WORLD.
+#define MPIM_COMMUNICATOR_CACHE_SIZE 16
+/// Maximum number of persistent requests tracked at once per process, further ones are only counted; entries of freed requests are reused.
+#define MPIM_MAX_PERSISTENT_REQUESTS 1024
+/// Maximum number of callsites whose freed persistent requests are summed per process, requests freed at further callsites are only counted.
+#define MPIM_MAX_PERSISTENT_CALLSITES 256
+/// Number of buckets of the hash map finding the tracked persistent request of a handle, twice the number of requests to keep probes short.
+#define MPIM_PERSISTENT_INDEX_SIZE (2 * MPIM_MAX_PERSISTENT_REQUESTS)
+/// Default number of persistent requests printed by the end-of-run report, changed with the MPIM_PERSISTENT_TOP environment variable.
+#define MPIM_DEFAULT_PERSISTENT_TOP 10
+/// Number of times the aggregator reads a slot being written before leaving it for the next frame.
+#define MPIM_SNAPSHOT_RETRIES 16
+/// Default maximum number of threads displayed one per row, changed with the MPIM_DISPLAY_ROWS environment variable; larger jobs are displayed grouped by state.
+#define MPIM_DEFAULT_DISPLAY_ROWS 256
+/// Size of the buffer receiving the identifier of a thread in the live display.
+#define MPIM_WHO_LENGTH 24
+/// Size of the buffer receiving the callsite of a call in the live display.
+#define MPIM_WHERE_LENGTH 64
+/// Maximum number of viewers attached at the same time to the socket of the aggregator.
+#define MPIM_MAX_VIEWERS 16
+/// Number of frames between two keyframes sent to the viewers, which resynchronise the times of the slots not updated since with the clock offsets estimated meanwhile.
+#define MPIM_VIEW_KEYFRAME_PERIOD 16
+/// Number of keyframes' worth of output a viewer may leave unread before it is detached.
+#define MPIM_VIEW_BACKLOG_KEYFRAMES 4
+/// Number of bytes of output a viewer may always leave unread before it is detached, whatever the size of the keyframes.
+#define MPIM_VIEW_MIN_BACKLOG (4 << 20)
+/// Number of milliseconds the aggregator waits at the end of the run for the viewers to read their backlog.
+#define MPIM_VIEW_END_MILLISECONDS 1000
+/// Number of connections to the metrics endpoint waiting to be answered before new ones are refused.
+#define MPIM_METRICS_BACKLOG 8
+/// Maximum size of a request to the metrics endpoint, longer ones being truncated.
+#define MPIM_METRICS_REQUEST_LENGTH 1024
+/// Number of milliseconds between two checks for the end of the run by the metrics thread.
+#define MPIM_METRICS_POLL_PERIOD 100
+/// Number of frames between two rewrites of every slot of the snapshot file, which follow the clock offsets estimated meanwhile.
+#define MPIM_PUBLISH_REFRESH_PERIOD 16
+/// Number of MPI events kept by the flight recorder of every process, the oldest being overwritten.
+#define MPIM_FLIGHT_RECORDER_SIZE 256
+/// Maximum length of a line of a crash report.
+#define MPIM_CRASH_LINE_LENGTH 512
+/// Size of the stack on which the crash handlers run, so that stack overflows are reported too.
+#define MPIM_CRASH_STACK_SIZE 65536
+/// Number of signals on which the crash report is written.
+#define MPIM_CRASH_SIGNAL_COUNT 4
+/// Size of the trace blocks filled by the threads, in bytes.
+#define MPIM_TRACE_BLOCK_LENGTH 65536
+/// Largest encoding of an event in a trace block, callsite definition included, in bytes.
+#define MPIM_TRACE_MAX_EVENT_LENGTH 512
+/// Longest file name recorded in the trace, in bytes.
+#define MPIM_TRACE_MAX_FILE_LENGTH 256
+/// Size of the callsite dictionary of a trace stream, a block being handed over once half of it is used.
+#define MPIM_TRACE_MAX_CALLSITES 256
+/// Number of blocks waiting for the trace writer beyond which the threads filling new ones wait.
+#define MPIM_TRACE_MAX_PENDING_BLOCKS 64
+/// Signal switching the monitoring of a process on; forwarded by mpirun to every process.
+#define MPIM_MONITORING_ON_SIGNAL SIGUSR1
+/// Signal switching the monitoring of a process off; forwarded by mpirun to every process.
+#define MPIM_MONITORING_OFF_SIGNAL SIGUSR2
+/// Number of signals switching the monitoring.
+#define MPIM_MONITORING_SIGNAL_COUNT 2
+/// Value of the freed field of a window freed with MPI_Win_free.
+#define MPIM_RMA_WINDOW_FREED 1
+/// Value of the freed field of a window no longer tracked, as monitoring was switched off and on again since its creation.
+#define MPIM_RMA_WINDOW_UNTRACKED 2
+/// Number of bits of the hash of the 4-byte sequences searched by the trace compressor.
+#define MPIM_TRACE_HASH_BITS 14
+/// Size of the hash table of the trace compressor.
+#define MPIM_TRACE_HASH_SIZE (1 << MPIM_TRACE_HASH_BITS)
+/// Bytes left beyond the payload in the buffer of the trace compressor, for the varints of a sequence.
+#define MPIM_TRACE_COMPRESSION_SLACK 64
+/// Number of updates a thread may have in flight before waiting for their local completion, its outbox holding as many messages.
+#define MPIM_OUTBOX_SIZE 64
+/// Size of a cache line, on which the slots of the window are aligned.
+#define MPIM_CACHE_LINE_SIZE 64
+/// Number of 64-bit words of a message, the unit in which it is accumulated into its slot.
+#define MPIM_MESSAGE_WORDS (sizeof(struct MPIM_message_t) / sizeof(uint64_t))
+/// Maximum number of application windows tracked per process, further ones are only counted.
+#define MPIM_MAX_RMA_WINDOWS 64
+/// Target recorded for one-sided synchronisations covering every target of a window, and for operations pending towards several targets.
+#define MPIM_WHOLE_WINDOW INT32_MIN
+/// Gives the address in the application to which the current MPIM_ routine returns, which identifies its callsite.
+#define MPIM_CALLSITE __builtin_return_address(0)
+/// The slot of a thread that issued its first MPI call once all the slots of its process were taken
+#define MPIM_NO_SLOT -2
 
 /**
  * @brief Moves the cursor to the given coordinate in the console screen.
@@ -44,360 +213,774 @@ void MPIM_console_clear_screen()
 enum MPIM_message_temporality_t { MPIM_TEMPORALITY_BEFORE,
                                   MPIM_TEMPORALITY_AFTER };
 
-/// Indicates from which MPI call the message was issued
-enum MPIM_message_type_t { /// The message is sent about MPI_Abort
-                           MPIM_MESSAGE_ABORT,
-                           /// The message is sent about MPI_Accumulate
-                           MPIM_MESSAGE_ACCUMULATE,
-                           /// The message is sent about MPI_Allgather
-                           MPIM_MESSAGE_ALLGATHER,
-                           /// The message is sent about MPI_Allgatherv
-                           MPIM_MESSAGE_ALLGATHERV,
-                           /// The message is sent about MPI_Allreduce
-                           MPIM_MESSAGE_ALLREDUCE,
-                           /// The message is sent about MPI_Alltoall
-                           MPIM_MESSAGE_ALLTOALL,
-                           /// The message is sent about MPI_Alltoallv
-                           MPIM_MESSAGE_ALLTOALLV,
-                           /// The message is sent about MPI_Barrier
-                           MPIM_MESSAGE_BARRIER,
-                           /// The message is sent about MPI_Bsend
-                           MPIM_MESSAGE_BCAST,
-                           /// The message is sent about MPI_Bsend
-                           MPIM_MESSAGE_BSEND,
-                           /// The message is sent about MPI_Bsend_init
-                           MPIM_MESSAGE_BSEND_INIT,
-                           /// The message is sent about MPI_Cancel
-                           MPIM_MESSAGE_CANCEL,
-                           /// The message is sent about MPI_Cart_coords
-                           MPIM_MESSAGE_CART_COORDS,
-                           /// The message is sent about MPI_Cart_create
-                           MPIM_MESSAGE_CART_CREATE,
-                           /// The message is sent about MPI_Cart_get
-                           MPIM_MESSAGE_CART_GET,
-                           /// The message is sent about MPI_Cart_shift
-                           MPIM_MESSAGE_CART_SHIFT,
-                           /// The message is sent about MPI_Comm_create
-                           MPIM_MESSAGE_COMM_CREATE,
-                           /// The message is sent about MPI_Comm_get_name
-                           MPIM_MESSAGE_COMM_GET_NAME,
-                           /// The message is sent about MPI_Comm_get_parent
-                           MPIM_MESSAGE_COMM_GET_PARENT,
-                           /// The message is sent about MPI_Comm_group
-                           MPIM_MESSAGE_COMM_GROUP,
-                           /// The message is sent about MPI_Comm_rank
-                           MPIM_MESSAGE_COMM_RANK,
-                           /// The message is sent about MPI_Comm_set_name
-                           MPIM_MESSAGE_COMM_SET_NAME,
-                           /// The message is sent about MPI_Comm_size
-                           MPIM_MESSAGE_COMM_SIZE,
-                           /// The message is sent about MPI_Comm_spawn
-                           MPIM_MESSAGE_COMM_SPAWN,
-                           /// The message is sent about MPI_Comm_split
-                           MPIM_MESSAGE_COMM_SPLIT,
-                           /// The message is sent about MPI_Dims_create
-                           MPIM_MESSAGE_DIMS_CREATE,
-                           /// The message is sent about MPI_Exscan
-                           MPIM_MESSAGE_EXSCAN,
-                           /// The message is sent about MPI_Finalize
-                           MPIM_MESSAGE_FINALISED,
-                           /// The message is sent about MPI_Gather
-                           MPIM_MESSAGE_GATHER,
-                           /// The message is sent about MPI_Gatherv
-                           MPIM_MESSAGE_GATHERV,
-                           /// The message is sent about MPI_Get
-                           MPIM_MESSAGE_GET,
-                           /// The message is sent about MPI_Get_address
-                           MPIM_MESSAGE_GET_ADDRESS,
-                           /// The message is sent about MPI_Get_count
-                           MPIM_MESSAGE_GET_COUNT,
-                           /// The message is sent about MPI_Group_difference
-                           MPIM_MESSAGE_GROUP_DIFFERENCE,
-                           /// The message is sent about MPI_Group_incl
-                           MPIM_MESSAGE_GROUP_INCL,
-                           /// The message is sent about MPI_Group_intersection
-                           MPIM_MESSAGE_GROUP_INTERSECTION,
-                           /// The message is sent about MPI_Group_rank
-                           MPIM_MESSAGE_GROUP_RANK,
-                           /// The message is sent about MPI_Group_size
-                           MPIM_MESSAGE_GROUP_SIZE,
-                           /// The message is sent about MPI_Group_union
-                           MPIM_MESSAGE_GROUP_UNION,
-                           /// The message is sent about MPI_Iallgather
-                           MPIM_MESSAGE_IALLGATHER,
-                           /// The message is sent about MPI_Iallgatherv
-                           MPIM_MESSAGE_IALLGATHERV,
-                           /// The message is sent about MPI_Iallreduce
-                           MPIM_MESSAGE_IALLREDUCE,
-                           /// The message is sent about MPI_Ialltoall
-                           MPIM_MESSAGE_IALLTOALL,
-                           /// The message is sent about MPI_Ialltoallv
-                           MPIM_MESSAGE_IALLTOALLV,
-                           /// The message is sent about MPI_Ibarrier
-                           MPIM_MESSAGE_IBARRIER,
-                           /// The message is sent about MPI_Ibsend
-                           MPIM_MESSAGE_IBSEND,
-                           /// The message is sent about MPI_Igather
-                           MPIM_MESSAGE_IGATHER,
-                           /// The message is sent about MPI_Igatherv
-                           MPIM_MESSAGE_IGATHERV,
-                           /// The message is sent about MPI_Init
-                           MPIM_MESSAGE_INITIALISED,
-                           /// The message is sent about MPI_Iprobe
-                           MPIM_MESSAGE_IPROBE,
-                           /// The message is sent about MPI_Irecv
-                           MPIM_MESSAGE_IRECV,
-                           /// The message is sent about MPI_Ireduce
-                           MPIM_MESSAGE_IREDUCE,
-                           /// The message is sent about MPI_Ireduce_scatter
-                           MPIM_MESSAGE_IREDUCE_SCATTER,
-                           /// The message is sent about MPI_Ireduce_scatter_block
-                           MPIM_MESSAGE_IREDUCE_SCATTER_BLOCK,
-                           /// The message is sent about MPI_Irsend
-                           MPIM_MESSAGE_IRSEND,
-                           /// The message is sent about MPI_Iscatter
-                           MPIM_MESSAGE_ISCATTER,
-                           /// The message is sent about MPI_Iscatterv
-                           MPIM_MESSAGE_ISCATTERV,
-                           /// The message is sent about MPI_Isend
-                           MPIM_MESSAGE_ISEND,
-                           /// The message is sent about MPI_Issend
-                           MPIM_MESSAGE_ISSEND,
-                           /// The message is sent about MPI_Op_create
-                           MPIM_MESSAGE_OP_CREATE,
-                           /// The message is sent about MPI_Op_free
-                           MPIM_MESSAGE_OP_FREE,
-                           /// The message is sent about MPI_Probe
-                           MPIM_MESSAGE_PROBE,
-                           /// The message is sent about MPI_Put
-                           MPIM_MESSAGE_PUT,
-                           /// The message is sent about MPI_Recv
-                           MPIM_MESSAGE_RECV,
-                           /// The message is sent about MPI_Recv_init
-                           MPIM_MESSAGE_RECV_INIT,
-                           /// The message is sent about MPI_Reduce
-                           MPIM_MESSAGE_REDUCE,
-                           /// The message is sent about MPI_Reduce_scatter
-                           MPIM_MESSAGE_REDUCE_SCATTER,
-                           /// The message is sent about MPI_Reduce_scatter_block
-                           MPIM_MESSAGE_REDUCE_SCATTER_BLOCK,
-                           /// The message is sent about MPI_Rsend
-                           MPIM_MESSAGE_RSEND,
-                           /// The message is sent about MPI_Rsend_init
-                           MPIM_MESSAGE_RSEND_INIT,
-                           /// The message is sent about MPI_Scan
-                           MPIM_MESSAGE_SCAN,
-                           /// The message is sent about MPI_Scatter
-                           MPIM_MESSAGE_SCATTER,
-                           /// The message is sent about MPI_Scatterv
-                           MPIM_MESSAGE_SCATTERV,
-                           /// The message is sent about MPI_Send
-                           MPIM_MESSAGE_SEND,
-                           /// The message is sent about MPI_Send_init
-                           MPIM_MESSAGE_SEND_INIT,
-                           /// The message is sent about MPI_Sendrecv
-                           MPIM_MESSAGE_SENDRECV,
-                           /// The message is sent about MPI_Sendrecv_replace
-                           MPIM_MESSAGE_SENDRECV_REPLACE,
-                           /// The message is sent about MPI_Ssend
-                           MPIM_MESSAGE_SSEND,
-                           /// The message is sent about MPI_Ssend_init
-                           MPIM_MESSAGE_SSEND_INIT,
-                           /// The message is sent about MPI_Start
-                           MPIM_MESSAGE_START,
-                           /// The message is sent about MPI_Startall
-                           MPIM_MESSAGE_STARTALL,
-                           /// The message is sent about MPI_Test
-                           MPIM_MESSAGE_TEST,
-                           /// The message is sent about MPI_Test_cancelled
-                           MPIM_MESSAGE_TEST_CANCELLED,
-                           /// The message is sent about MPI_Testall
-                           MPIM_MESSAGE_TESTALL,
-                           /// The message is sent about MPI_Testany
-                           MPIM_MESSAGE_TESTANY,
-                           /// The message is sent about MPI_Testsome
-                           MPIM_MESSAGE_TESTSOME,
-                           /// The message is sent about MPI_Type_commit
-                           MPIM_MESSAGE_TYPE_COMMIT,
-                           /// The message is sent about MPI_Type_contiguous
-                           MPIM_MESSAGE_TYPE_CONTIGUOUS,
-                           /// The message is sent about MPI_Type_create_hindexed
-                           MPIM_MESSAGE_TYPE_CREATE_HINDEXED,
-                           /// The message is sent about MPI_Type_create_hindexed_block
-                           MPIM_MESSAGE_TYPE_CREATE_HINDEXED_BLOCK,
-                           /// The message is sent about MPI_Type_create_hvector
-                           MPIM_MESSAGE_TYPE_CREATE_HVECTOR,
-                           /// The message is sent about MPI_Type_create_indexed_block
-                           MPIM_MESSAGE_TYPE_CREATE_INDEXED_BLOCK,
-                           /// The message is sent about MPI_Type_create_struct
-                           MPIM_MESSAGE_TYPE_CREATE_STRUCT,
-                           /// The message is sent about MPI_Type_create_subarray
-                           MPIM_MESSAGE_TYPE_CREATE_SUBARRAY,
-                           /// The message is sent about MPI_Type_free
-                           MPIM_MESSAGE_TYPE_FREE,
-                           /// The message is sent about MPI_Type_get_extent
-                           MPIM_MESSAGE_TYPE_GET_EXTENT,
-                           /// The message is sent about MPI_Type_indexed
-                           MPIM_MESSAGE_TYPE_INDEXED,
-                           /// The message is sent about MPI_Type_vector
-                           MPIM_MESSAGE_TYPE_VECTOR,
-                           /// The process has not even called MPI_Init so far
-                           MPIM_MESSAGE_UNINITIALISED,
-                           /// The message is sent about MPI_Wait
-                           MPIM_MESSAGE_WAIT,
-                           /// The message is sent about MPI_Waitall
-                           MPIM_MESSAGE_WAITALL,
-                           /// The message is sent about MPI_Waitany
-                           MPIM_MESSAGE_WAITANY,
-                           /// The message is sent about MPI_Waitsome
-                           MPIM_MESSAGE_WAITSOME,
-                           /// The message is sent about MPI_Win_allocate
-                           MPIM_MESSAGE_WIN_ALLOCATE,
-                           /// The message is sent about MPI_Win_attach
-                           MPIM_MESSAGE_WIN_ATTACH,
-                           /// The message is sent about MPI_Win_create
-                           MPIM_MESSAGE_WIN_CREATE,
-                           /// The message is sent about MPI_Win_create_dynamic
-                           MPIM_MESSAGE_WIN_CREATE_DYNAMIC,
-                           /// The message is sent about MPI_Win_detach
-                           MPIM_MESSAGE_WIN_DETACH,
-                           /// The message is sent about MPI_Win_free
-                           MPIM_MESSAGE_WIN_FREE,
-                           /// The message is sent about MPI_Wtime
-                           MPIM_MESSAGE_WTIME };
+/// Expands an entry of MPIM_ROUTINES into its message type
+#define MPIM_ROUTINE_MESSAGE_TYPE(TYPE, ...) MPIM_MESSAGE_##TYPE,
+
+/// Indicates from which MPI call the message was issued, MPIM_MESSAGE_UNINITIALISED meaning that no call was issued yet
+enum MPIM_message_type_t { MPIM_MESSAGE_UNINITIALISED,
+                           MPIM_ROUTINES(MPIM_ROUTINE_MESSAGE_TYPE)
+                           /// Number of message types, used to size the tables indexed by message type
+                           MPIM_MESSAGE_TYPE_COUNT };
+
+/// Expands an entry of MPIM_ROUTINES into the name of its MPI routine
+#define MPIM_ROUTINE_NAME(TYPE, Name, ...) "MPI_" #Name,
 
 /// Contains the name of the MPI function matching to a message type
-const char* MPIM_routine_name_t[] = {
-                                    "MPI_Abort",
-                                    "MPI_Accumulate",
-                                    "MPI_Allgather",
-                                    "MPI_Allgatherv",
-                                    "MPI_Allreduce",
-                                    "MPI_Alltoall",
-                                    "MPI_Alltoallv",
-                                    "MPI_Barrier",
-                                    "MPI_Bcast",
-                                    "MPI_Bsend",
-                                    "MPI_Bsend_init",
-                                    "MPI_Cancel",
-                                    "MPI_Cart_coords",
-                                    "MPI_Cart_create",
-                                    "MPI_Cart_get",
-                                    "MPI_Cart_shift",
-                                    "MPI_Comm_create",
-                                    "MPI_Comm_get_name",
-                                    "MPI_Comm_get_parent",
-                                    "MPI_Comm_group",
-                                    "MPI_Comm_rank",
-                                    "MPI_Comm_set_name",
-                                    "MPI_Comm_size",
-                                    "MPI_Comm_spawn",
-                                    "MPI_Comm_split",
-                                    "MPI_Dims_create",
-                                    "MPI_Exscan",
-                                    "MPI_Finalize",
-                                    "MPI_Gather",
-                                    "MPI_Gatherv",
-                                    "MPI_Get",
-                                    "MPI_Get_address",
-                                    "MPI_Get_count",
-                                    "MPI_Group_difference",
-                                    "MPI_Group_incl",
-                                    "MPI_Group_intersection",
-                                    "MPI_Group_rank",
-                                    "MPI_Group_size",
-                                    "MPI_Group_union",
-                                    "MPI_Iallgather",
-                                    "MPI_Iallgatherv",
-                                    "MPI_Iallreduce",
-                                    "MPI_Ialltoall",
-                                    "MPI_Ialltoallv",
-                                    "MPI_Ibarrier",
-                                    "MPI_Ibsend",
-                                    "MPI_Igather",
-                                    "MPI_Igatherv",
-                                    "MPI_Init",
-                                    "MPI_Iprobe",
-                                    "MPI_Irecv",
-                                    "MPI_Ireduce",
-                                    "MPI_Ireduce_scatter",
-                                    "MPI_Ireduce_scatter_block",
-                                    "MPI_Irsend",
-                                    "MPI_Iscatter",
-                                    "MPI_Iscatterv",
-                                    "MPI_Isend",
-                                    "MPI_Issend",
-                                    "MPI_Op_create",
-                                    "MPI_Op_free",
-                                    "MPI_Probe",
-                                    "MPI_Put",
-                                    "MPI_Recv",
-                                    "MPI_Recv_init",
-                                    "MPI_Reduce",
-                                    "MPI_Reduce_scatter",
-                                    "MPI_Reduce_scatter_block",
-                                    "MPI_Rsend",
-                                    "MPI_Rsend_init",
-                                    "MPI_Scan",
-                                    "MPI_Scatter",
-                                    "MPI_Scatterv",
-                                    "MPI_Send",
-                                    "MPI_Send_init",
-                                    "MPI_Sendrecv",
-                                    "MPI_Sendrecv_replace",
-                                    "MPI_Ssend",
-                                    "MPI_Ssend_init",
-                                    "MPI_Start",
-                                    "MPI_Startall",
-                                    "MPI_Test",
-                                    "MPI_Test_cancelled",
-                                    "MPI_Testall",
-                                    "MPI_Testany",
-                                    "MPI_Testsome",
-                                    "MPI_Type_commit",
-                                    "MPI_Type_contiguous",
-                                    "MPI_Type_create_hindexed",
-                                    "MPI_Type_create_hindexed_block",
-                                    "MPI_Type_create_hvector",
-                                    "MPI_Type_create_indexed_block",
-                                    "MPI_Type_create_struct",
-                                    "MPI_Type_create_subarray",
-                                    "MPI_Type_free",
-                                    "MPI_Type_get_extent",
-                                    "MPI_Type_indexed",
-                                    "MPI_Type_vector",
-                                    "-",
-                                    "MPI_Wait",
-                                    "MPI_Waitall",
-                                    "MPI_Waitany",
-                                    "MPI_Waitsome",
-                                    "MPI_Win_allocate",
-                                    "MPI_Win_attach",
-                                    "MPI_Win_create",
-                                    "MPI_Win_create_dynamic",
-                                    "MPI_Win_detach",
-                                    "MPI_Win_free",
-                                    "MPI_Wtime" };
-
-/// Contains the message representing an update to the debugger
-struct MPIM_message_t
+const char* MPIM_routine_name_t[] = { "-",
+                                      MPIM_ROUTINES(MPIM_ROUTINE_NAME) };
+
+/// Expands an entry of MPIM_ROUTINES into its attributes
+#define MPIM_ROUTINE_ATTRIBUTES(TYPE, Name, return_type, attributes, ...) attributes,
+
+/// Contains the MPIM_ROUTINE_ attributes of the MPI function matching to a message type
+const unsigned char MPIM_routine_attributes_t[] = { 0,
+                                                    MPIM_ROUTINES(MPIM_ROUTINE_ATTRIBUTES) };
+
+/// Indicates which arguments of an MPI routine are recorded, depending on the class of the routine
+enum MPIM_arguments_kind_t { /// No argument is recorded
+                             MPIM_ARGUMENTS_NONE,
+                             /// Only the communicator is recorded
+                             MPIM_ARGUMENTS_COMMUNICATOR,
+                             /// Point-to-point send: destination, tag, communicator and data size
+                             MPIM_ARGUMENTS_SEND,
+                             /// Point-to-point receive: source, tag, communicator and data size
+                             MPIM_ARGUMENTS_RECEIVE,
+                             /// Combined send and receive: both peers and tags, communicator and data size sent
+                             MPIM_ARGUMENTS_SENDRECV,
+                             /// Collective without root: communicator and data size
+                             MPIM_ARGUMENTS_COLLECTIVE,
+                             /// Collective with a root: root, communicator and data size
+                             MPIM_ARGUMENTS_ROOTED_COLLECTIVE,
+                             /// One-sided communication: target and data size
+                             MPIM_ARGUMENTS_RMA,
+                             /// Request completion: number of requests
+                             MPIM_ARGUMENTS_REQUESTS,
+                             /// Receive of a message matched beforehand by MPI_Mprobe or MPI_Improbe: data size
+                             MPIM_ARGUMENTS_MATCHED_RECEIVE };
+
+/// Contains the runtime values of the arguments of an MPI call that matter to understand what a process does
+struct MPIM_arguments_t
+{
+    /// The class of the routine, telling which fields are meaningful
+    uint8_t kind;
+    /// Identifier of the communicator, as given by MPI_Comm_c2f
+    int32_t communicator;
+    /// Number of elements, number of requests for MPIM_ARGUMENTS_REQUESTS
+    int32_t count;
+    /// Size of the datatype of the elements, in bytes
+    int32_t datatype_size;
+    /// The ranks and tags involved, interpreted according to the kind
+    union
+    {
+        /// Point-to-point and one-sided routines: the destination, source or target, and the tag
+        struct
+        {
+            int32_t peer;
+            int32_t tag;
+        } p2p;
+        /// Combined send and receive
+        struct
+        {
+            int32_t destination;
+            int32_t send_tag;
+            int32_t source;
+            int32_t receive_tag;
+        } sendrecv;
+        /// Collectives with a root
+        struct
+        {
+            int32_t root;
+        } collective;
+        /// One-sided routines: the target, MPIM_WHOLE_WINDOW for synchronisations of every target, and the window as given by MPI_Win_c2f
+        struct
+        {
+            int32_t target;
+            int32_t window;
+        } rma;
+    };
+};
+
+/// Access epochs a process may have opened on a window
+enum MPIM_rma_access_t { /// No access epoch is open
+                         MPIM_RMA_ACCESS_NONE,
+                         /// Opened by MPI_Win_fence
+                         MPIM_RMA_ACCESS_FENCE,
+                         /// Opened by MPI_Win_lock with MPI_LOCK_SHARED
+                         MPIM_RMA_ACCESS_LOCK_SHARED,
+                         /// Opened by MPI_Win_lock with MPI_LOCK_EXCLUSIVE
+                         MPIM_RMA_ACCESS_LOCK_EXCLUSIVE,
+                         /// Opened by MPI_Win_lock_all
+                         MPIM_RMA_ACCESS_LOCK_ALL,
+                         /// Opened by MPI_Win_start
+                         MPIM_RMA_ACCESS_START };
+
+/// Names of the access epochs, as printed in the live display and the window report
+const char* MPIM_rma_access_name_t[] = {
+                                       "none",
+                                       "fence",
+                                       "lock shared",
+                                       "lock exclusive",
+                                       "lock all",
+                                       "start" };
+
+/// Exposure epochs a process may have opened on a window
+enum MPIM_rma_exposure_t { /// No exposure epoch is open
+                           MPIM_RMA_EXPOSURE_NONE,
+                           /// Opened by MPI_Win_fence
+                           MPIM_RMA_EXPOSURE_FENCE,
+                           /// Opened by MPI_Win_post
+                           MPIM_RMA_EXPOSURE_POST };
+
+/// Names of the exposure epochs, as printed in the live display and the window report
+const char* MPIM_rma_exposure_name_t[] = {
+                                         "none",
+                                         "fence",
+                                         "post" };
+
+/// Synchronisation state of a window in a process, as deduced from the calls issued so far
+struct MPIM_rma_epoch_t
+{
+    /// Indicates if the window is tracked, the other fields being meaningless otherwise
+    uint8_t tracked;
+    /// The access epoch open
+    uint8_t access;
+    /// The exposure epoch open
+    uint8_t exposure;
+    /// Number of targets locked with MPI_Win_lock
+    uint16_t locked_targets;
+    /// Target of the pending operations, MPIM_WHOLE_WINDOW if they go to several targets
+    int32_t pending_target;
+    /// Number of operations issued and not completed by a synchronisation yet
+    uint32_t pending_operations;
+    /// Size, in bytes, of the origin data of the pending operations
+    uint64_t pending_bytes;
+};
+
+/// Contains the message representing an update to the debugger, padded to whole cache lines so that the puts to two slots of the window never land on the same line
+struct __attribute__((aligned(MPIM_CACHE_LINE_SIZE))) MPIM_message_t
 {
+    /// Number of the update, unique and increasing in the process
+    uint64_t sequence;
     /// The type of the message, indicating the MPI routine to which it corresponds
     enum MPIM_message_type_t type;
     /// Indicates if the message is built right before or right after the MPI routine is called
     bool before;
-    /// Name of the file from which the MPI routine represented was issued
-    char file[MPIM_MAX_FILENAME_LENGTH];
+    /// Indicates if the call switched the monitoring of the process off, the message being the last one of the thread until it is switched on again
+    bool switched_off;
+    /// Indicates if the thread entered the call while the monitoring of its process was off, the message being written by the aggregator once it is switched on again
+    bool unmonitored;
+    /// Identity of the module containing the callsite, 0 if unknown
+    uint32_t callsite_module;
+    /// Offset of the return address of the MPI routine represented from the load base of its module
+    uint64_t callsite_offset;
     /// The line corresponding to the MPI routine about which the message was sent
     int line;
-    /// The time at which the message was created
-    double walltime;
+    /// The time at which the message was created, in ticks of the clock source of the process, converted by the aggregator
+    uint64_t timestamp;
     /// The arguments passed to the MPI routine
-    char args[MPIM_MAX_ARGUMENTS_LENGTH];
+    struct MPIM_arguments_t arguments;
+    /// Number of MPI calls issued by the thread so far, this one included
+    uint64_t call_count;
+    /// Number of persistent requests of the process started and not completed yet
+    uint32_t active_persistent_requests;
+    /// Synchronisation state of the window of a one-sided routine, when the routine is called
+    struct MPIM_rma_epoch_t epoch;
     /// Total size, in bytes, of data sent by this process
     size_t total_data_sent;
     /// Total size, in bytes, of data received by this process
     size_t total_data_received;
+    /// Time spent by the thread in the MPI calls it completed, in nanoseconds
+    uint64_t mpi_nanoseconds;
+    /// Checksum of the fields above, computed by MPIM_message_get_checksum; a copy mixing two updates does not match it
+    uint64_t checksum;
+};
+
+/// Columns of the live display whose width depends on the slots displayed
+enum MPIM_column_t { /// The thread
+                     MPIM_COLUMN_WHO,
+                     /// The MPI routine
+                     MPIM_COLUMN_WHAT,
+                     /// The callsite
+                     MPIM_COLUMN_WHERE,
+                     /// The arguments
+                     MPIM_COLUMN_DETAILS,
+                     /// Number of columns
+                     MPIM_COLUMN_COUNT };
+
+/// What the aggregator remembers of a slot between frames, so that only the slots updated since the previous frame are processed
+struct MPIM_slot_summary_t
+{
+    /// Indicates if the slot is displayed, and thus counted in the state and column statistics
+    bool displayed;
+    /// Indicates if the update held in the slot was sent before the call
+    bool before;
+    /// Message type of the update held in the slot
+    int32_t type;
+    /// Width of the slot in every column
+    uint16_t lengths[MPIM_COLUMN_COUNT];
+    /// Indicates if the slot is in MPIM_updated_slots
+    bool updated;
+};
+
+/// A set of slots, in no particular order, along with the position of every slot in it so that slots are added and removed in constant time
+struct MPIM_slot_list_t
+{
+    /// The slots of the list
+    int* slots;
+    /// Position of every slot in slots, -1 for the slots not in the list
+    int* positions;
+    /// Number of slots in the list
+    int count;
+};
+
+/// A viewer attached to the socket of the aggregator
+struct MPIM_viewer_t
+{
+    /// The socket of the viewer, nonblocking
+    int socket;
+    /// Indicates if the viewer awaits a keyframe, as it attached since the previous frame
+    bool needs_keyframe;
+    /// Output the socket did not accept yet, sent again once the socket is writable
+    char* backlog;
+    /// Offset of the first byte of backlog not sent yet
+    size_t backlog_start;
+    /// Offset of the end of the output in backlog
+    size_t backlog_end;
+    /// Size of backlog
+    size_t backlog_capacity;
+};
+
+/// Switches the monitoring of a process on and off, on a cache line of its own since every MPI call reads it
+struct __attribute__((aligned(MPIM_CACHE_LINE_SIZE))) MPIM_monitoring_switch_t
+{
+    /// Indicates if the MPI calls are monitored, the only field read by the calls while they are not
+    volatile int32_t enabled;
+    /// The state asked for by the last signal or command of the aggregator, applied by the next monitored MPI call
+    volatile int32_t requested;
+    /// The state applied last
+    volatile int32_t applied;
+};
+
+/// An MPI call recorded by the flight recorder
+struct MPIM_flight_event_t
+{
+    /// The time at which the event was recorded, in ticks of the clock source of the process
+    uint64_t timestamp;
+    /// The name of the file from which the MPI call is issued, a string literal
+    const char* file;
+    /// The line at which the MPI call is issued
+    int32_t line;
+    /// The type of the MPI call
+    int16_t type;
+    /// Indicates if the event was recorded before the call
+    bool before;
+    /// The slot of the calling thread among those of its process, MPIM_NO_SLOT for a thread without one
+    int8_t thread;
+    /// Number of MPI calls issued by the thread so far, this one included
+    uint64_t call_count;
+    /// The arguments of the call
+    struct MPIM_arguments_t arguments;
+};
+
+/// A line of a crash report, built without stdio so that it can be written from a signal handler
+struct MPIM_crash_line_t
+{
+    /// The text of the line, not NUL-terminated
+    char text[MPIM_CRASH_LINE_LENGTH];
+    /// The number of characters in text
+    int length;
+};
+
+/// A trace block being filled by a thread, or waiting for the trace writer
+struct MPIM_trace_block_buffer_t
+{
+    /// The next block waiting for the trace writer, or the next free block
+    struct MPIM_trace_block_buffer_t* next;
+    /// The stream that filled the block
+    uint16_t thread;
+    /// The number of events in the block
+    uint32_t event_count;
+    /// The number of bytes used in data
+    uint32_t length;
+    /// The time from which the first event of the block counts, in ticks since the start of the trace
+    uint64_t time;
+    /// The clock offset of the process when the block was handed over
+    double clock_offset;
+    /// The events
+    uint8_t data[MPIM_TRACE_BLOCK_LENGTH];
+};
+
+/// An entry of the callsite dictionary of a trace stream
+struct MPIM_trace_callsite_t
+{
+    /// Indicates if the entry is used
+    bool defined;
+    /// The return address of the call
+    uintptr_t address;
+    /// The line of the call
+    int line;
+    /// The routine called
+    enum MPIM_message_type_t type;
+    /// The index of the callsite in the block
+    uint32_t index;
+    /// The arguments of the last call at the callsite
+    struct MPIM_arguments_t arguments;
+};
+
+/// The trace of a thread
+struct MPIM_trace_stream_t
+{
+    /// The next stream of the process
+    struct MPIM_trace_stream_t* next;
+    /// The number of the stream in the process
+    uint16_t thread;
+    /// The block being filled
+    struct MPIM_trace_block_buffer_t* block;
+    /// The time of the last event, in ticks since the start of the trace
+    uint64_t previous_time;
+    /// The number of callsites defined in the block
+    uint32_t callsite_count;
+    /// The callsites defined in the block, an open-addressing hash table
+    struct MPIM_trace_callsite_t callsites[MPIM_TRACE_MAX_CALLSITES];
+};
+
+/// Describes a module loaded in the process, used to turn return addresses into position-independent callsites
+struct MPIM_module_t
+{
+    /// The address at which the module is loaded, offsets are computed relative to it
+    uintptr_t base;
+    /// The lowest address covered by the loadable segments of the module
+    uintptr_t low;
+    /// The address right past the highest address covered by the loadable segments of the module
+    uintptr_t high;
+    /// Identity of the module, a hash of its path that the processes agree on whatever the order in which they loaded their modules
+    uint32_t identity;
+    /// Path of the module
+    char name[MPIM_MAX_FILENAME_LENGTH];
+};
+
+/// Remembers which module contains a given return address
+struct MPIM_callsite_cache_entry_t
+{
+    /// The return address cached, 0 if the entry is unused
+    uintptr_t address;
+    /// Index of the module containing the return address, -1 if unknown
+    int module;
+};
+
+/// Remembers the symbolised version of a callsite on the aggregator
+struct MPIM_symbol_cache_entry_t
+{
+    /// Indicates if the entry holds a symbolised callsite
+    bool used;
+    /// Identity of the module containing the callsite
+    uint32_t module;
+    /// Offset of the callsite from the load base of its module
+    uint64_t offset;
+    /// The callsite symbolised, in the format of the cache
+    char symbol[MPIM_MAX_SYMBOL_LENGTH];
+};
+
+/// Formats in which addresses are symbolised
+enum MPIM_symbol_format_t { /// The source file of a callsite, or its function if no line table is available
+                            MPIM_SYMBOL_CALLSITE,
+                            /// The function of a stack frame, followed by its source file and line
+                            MPIM_SYMBOL_FRAME };
+
+/// What libbacktrace tells about an address
+struct MPIM_symbol_information_t
+{
+    /// The function containing the address, empty if unknown
+    char function[MPIM_MAX_SYMBOL_LENGTH];
+    /// The source file of the address, without its directory, empty if unknown
+    char file[MPIM_MAX_SYMBOL_LENGTH];
+    /// The line of the address in its source file
+    int line;
+};
+
+/// Tells when a process waits for its updates to reach the coordinator, chosen with the MPIM_FLUSH_POLICY environment variable
+enum MPIM_flush_policy_t { /// Never waits: updates reach the coordinator whenever MPI progresses them, which may be after the process blocks
+                           MPIM_FLUSH_NONE,
+                           /// Waits for the update announcing a blocking routine to reach the coordinator before entering the routine
+                           MPIM_FLUSH_BLOCKING,
+                           /// Waits for every update to reach the coordinator
+                           MPIM_FLUSH_ALL };
+
+/// Names of the flush policies, as given in the MPIM_FLUSH_POLICY environment variable
+const char* MPIM_flush_policy_name_t[] = {
+                                         "none",
+                                         "blocking",
+                                         "all" };
+
+/// Indicates which clock timestamps are read from
+enum MPIM_clock_source_t { /// The invariant time-stamp counter of x86 processors, calibrated during MPI_Init
+                           MPIM_CLOCK_SOURCE_TSC,
+                           /// clock_gettime with CLOCK_MONOTONIC_RAW, in nanoseconds
+                           MPIM_CLOCK_SOURCE_MONOTONIC_RAW,
+                           /// gettimeofday, in microseconds; not monotonic, kept for comparison
+                           MPIM_CLOCK_SOURCE_GETTIMEOFDAY };
+
+/// Contains the name of the clock sources, as given in the MPIM_CLOCK_SOURCE environment variable
+const char* MPIM_clock_source_name_t[] = {
+                                         "tsc",
+                                         "monotonic_raw",
+                                         "gettimeofday" };
+
+/// Describes how to convert the timestamps of a process into the time of the aggregator
+struct MPIM_clock_calibration_t
+{
+    /// Number of ticks per second of the clock source of the process
+    double ticks_per_second;
+    /// Offset to add to the local time to obtain the time of the aggregator, as of the last estimation
+    double offset;
+    /// Drift of the clock offset, in seconds per second, estimated from the last two estimations
+    double drift;
+    /// Local time at which the clock offset was last estimated
+    double reference;
+    /// Bound on the error of the clock offset estimated, in seconds, including the error of the drift over one synchronisation period
+    double error;
+};
+
+/// Progress of an estimation of the clock offset, advanced by one step per MPI call once the estimation is due
+struct MPIM_clock_estimation_t
+{
+    /// Number of exchanges over in the current estimation
+    int round;
+    /// Indicates if the request of the current exchange is issued and its answer awaited
+    bool waiting;
+    /// Sequence number of the request of the current exchange
+    uint32_t sequence;
+    /// Local time at which the request of the current exchange was issued
+    double start;
+    /// Offset sampled by the exchange with the shortest round trip so far
+    double best_offset;
+    /// Shortest round trip so far, negative if the aggregator answered no exchange yet
+    double best_round_trip;
+    /// Local time at the middle of the exchange with the shortest round trip, to which the offset sampled corresponds
+    double best_time;
+    /// Indicates if the rank of the process waits in the queue of the aggregator
+    bool queued;
+    /// Sequence number of the request issued when the process last joined the queue; the aggregator took it out of the queue once it answers this request or a later one
+    uint32_t queued_sequence;
+    /// Shortest round trip among the estimations kept, negative before the first one
+    double reference_round_trip;
+    /// Offset sampled by the first estimation kept, from which the drift is derived
+    double first_offset;
+    /// Local time to which the offset of the first estimation kept corresponds
+    double first_time;
+    /// Bound on the error of the offset of the first estimation kept, in seconds
+    double first_error;
+    /// Bound on the error of the drift, in seconds per second
+    double drift_error;
+};
+
+/// Exchanged between a process and the aggregator to estimate the offset between their clocks
+struct MPIM_clock_exchange_t
+{
+    /// Sequence number of the last request issued by the process
+    volatile uint32_t request;
+    /// Sequence number of the last request answered by the aggregator
+    volatile uint32_t response;
+    /// The time of the aggregator when it answered the last request
+    volatile double aggregator_time;
+    /// The calibration of the clock of the process, published after every estimation
+    struct MPIM_clock_calibration_t calibration;
+};
+
+/// Queue of the processes whose clock offset estimation request awaits an answer, lying in the clock window after the exchanges, so that the aggregator only looks at the processes waiting for it
+struct MPIM_clock_queue_t
+{
+    /// Number of places taken in the queue so far, incremented by the processes joining it
+    volatile uint64_t tail;
+    /// Rank of the process at each place of the queue, taken modulo the number of processes; 0 if the place is free or taken but not written yet. A process is queued at most once at a time, so one place per process is enough
+    volatile int32_t ranks[];
+};
+
+/// Caches the size of a datatype, so that MPI_Type_size is not called on every MPI call
+struct MPIM_datatype_cache_entry_t
+{
+    /// The datatype
+    MPI_Datatype datatype;
+    /// Its size, in bytes
+    int32_t size;
+    /// The value of MPIM_datatype_generation when the entry was filled, 0 for an empty entry
+    uint32_t generation;
+};
+
+/// Distribution of the durations of the calls to an MPI routine, by payload size and latency
+struct MPIM_histogram_t
+{
+    /// Number of calls per payload size bucket and latency bucket
+    uint64_t calls[MPIM_HISTOGRAM_SIZE_BUCKETS][MPIM_HISTOGRAM_LATENCY_BUCKETS];
+    /// Total payload per size bucket, in bytes
+    uint64_t bytes[MPIM_HISTOGRAM_SIZE_BUCKETS];
+    /// Total time spent in the calls per size bucket, in nanoseconds
+    uint64_t nanoseconds[MPIM_HISTOGRAM_SIZE_BUCKETS];
+};
+
+/// The MPI call a thread is currently in, watched for stalls
+struct MPIM_thread_state_t
+{
+    /// The thread
+    pthread_t thread;
+    /// Number of the MPI call the thread is in, as counted by MPIM_my_call_count, 0 if it is not in an MPI call
+    volatile uint64_t call_count;
+    /// Timestamp at which the thread entered that call
+    volatile uint64_t call_start;
+    /// Number of the last call whose stack was captured
+    uint64_t captured_call_count;
+    /// Number of frames captured by the signal handler, -1 while the capture is pending
+    volatile int depth;
+    /// Return addresses captured by the signal handler
+    void* frames[MPIM_STACK_MAX_DEPTH];
+};
+
+/// The stack of a stalled call, as sent to the aggregator
+struct MPIM_stack_t
+{
+    /// Number of the stalled MPI call, as counted by MPIM_my_call_count, 0 if no stack was captured
+    uint64_t call_count;
+    /// Number of frames
+    int32_t depth;
+    /// Frames, with the identity of the module in the 32 most significant bits, 0 if unknown, and the offset in that module in the others
+    uint64_t frames[MPIM_STACK_MAX_DEPTH];
+};
+
+/// Classes of waiting time told apart by the wait state analysis
+enum MPIM_wait_state_t { /// A receive waited for a send that started later
+                         MPIM_WAIT_LATE_SENDER,
+                         /// A synchronous send waited for a receive that started later
+                         MPIM_WAIT_LATE_RECEIVER,
+                         /// An N-to-N collective waited for the last process to enter it
+                         MPIM_WAIT_N_TO_N,
+                         /// Number of wait states
+                         MPIM_WAIT_STATE_COUNT };
+
+/// Names of the wait states, as printed in the wait state report
+const char* MPIM_wait_state_name_t[] = {
+                                       "Late sender",
+                                       "Late receiver",
+                                       "Wait at NxN" };
+
+/// Written by a sender into the window of the receiver before a point-to-point send is issued, so that the receiver can match it
+struct MPIM_send_stamp_t
+{
+    /// Number of the send among those from the sender to the receiver, 0 for an unused entry
+    uint64_t sequence;
+    /// Time at which the send started, in seconds in the clock of the aggregator
+    double time;
+    /// Tag of the message
+    int32_t tag;
+    /// Communicator of the message, as given by MPI_Comm_c2f
+    int32_t communicator;
+    /// Indicates if the send is synchronous, in which case the sender waits for the receive to start
+    uint8_t synchronous;
+    /// Set by the receiver once the stamp is matched with a receive
+    uint8_t consumed;
+};
+
+/// Written by every process into the window of the aggregator when it enters an N-to-N collective on MPI_COMM_WORLD
+struct MPIM_collective_arrival_t
+{
+    /// Number of the collective among the N-to-N collectives on MPI_COMM_WORLD issued by the process
+    uint64_t sequence;
+    /// Time at which the process entered the collective, in seconds in the clock of the aggregator
+    double time;
+};
+
+/// A value and a rank laid out as MPI_LONG_INT, so that MPI_MAXLOC accumulates it
+struct MPIM_long_int_t
+{
+    /// The value
+    long value;
+    /// The rank holding the value
+    int rank;
+};
+
+/// Waiting time caused by a process to the others, accumulated on the aggregator by the processes that measure it
+struct MPIM_wait_cause_t
+{
+    /// Waiting time caused per wait state, in nanoseconds
+    uint64_t nanoseconds[MPIM_WAIT_STATE_COUNT];
+    /// The process delayed the most, with the waiting time caused to it in nanoseconds, as measured by the process that measured the most
+    struct MPIM_long_int_t most_delayed;
+};
+
+/// A nonblocking receive posted by a thread, remembered until a completion call analyses it
+struct MPIM_wait_receive_t
+{
+    /// The request of the receive, MPI_REQUEST_NULL for an empty entry
+    MPI_Request request;
+    /// Time at which the receive was posted, in seconds in the clock of the aggregator
+    double posted;
+    /// Communicator of the receive, as given by MPI_Comm_c2f
+    int32_t communicator;
+    /// Source of the receive in its communicator, which may be MPI_ANY_SOURCE
+    int32_t source;
+    /// Tag of the receive, which may be MPI_ANY_TAG
+    int32_t tag;
+    /// The value of MPIM_wait_receive_generation when the receive was posted
+    uint32_t generation;
+};
+
+/// A nonblocking receive that a completion call may complete, found before MPI forgets its request
+struct MPIM_wait_pending_t
+{
+    /// Index of the request in the requests of the completion call
+    int index;
+    /// The receive
+    struct MPIM_wait_receive_t receive;
+};
+
+/// Caches the ranks in MPI_COMM_WORLD of the processes of a communicator, so that the group of a communicator is translated once
+struct MPIM_communicator_cache_entry_t
+{
+    /// The communicator, as given by MPI_Comm_c2f
+    int32_t communicator;
+    /// Number of ranks in world_ranks, 0 for an intercommunicator, whose ranks are not translated
+    int32_t size;
+    /// The value of MPIM_communicator_generation when the entry was filled, 0 for an empty entry
+    uint32_t generation;
+    /// The rank in MPI_COMM_WORLD of every rank of the communicator
+    int* world_ranks;
+};
+
+/// Lifecycle states of a persistent request
+enum MPIM_persistent_state_t { /// Created or completed, waiting to be started
+                               MPIM_PERSISTENT_INACTIVE,
+                               /// Started and not completed yet
+                               MPIM_PERSISTENT_ACTIVE,
+                               /// Freed with MPI_Request_free
+                               MPIM_PERSISTENT_FREED };
+
+/// Names of the lifecycle states of persistent requests, as printed in the persistent request report
+const char* MPIM_persistent_state_name_t[] = {
+                                             "inactive",
+                                             "active",
+                                             "freed" };
+
+/// A persistent request tracked from its creation to its release
+struct MPIM_persistent_request_t
+{
+    /// The request handle, only meaningful in the process that created it
+    MPI_Request request;
+    /// Rank of the process that created the request, filled in for the report
+    int32_t rank;
+    /// Message type of the routine that created the request
+    int32_t type;
+    /// Lifecycle state of the request
+    int32_t state;
+    /// Identity of the module containing the callsite creating the request
+    uint32_t module;
+    /// Offset of the callsite creating the request in its module
+    uint64_t offset;
+    /// Line of the callsite creating the request in its source file
+    int32_t line;
+    /// The arguments the request was created with
+    struct MPIM_arguments_t arguments;
+    /// Number of start and completion cycles the request went through
+    uint64_t cycles;
+    /// Timestamp of the last start of the request
+    uint64_t start;
+    /// Time from start to completion, in nanoseconds, summed over cycles
+    uint64_t nanoseconds;
+    /// Longest time from start to completion of a cycle, in nanoseconds
+    uint64_t max_nanoseconds;
+    /// Number of requests summed in the entry: 1 for a tracked request, the number of requests freed at the callsite for the sum of the freed requests
+    uint64_t requests;
+};
+
+/// An application window tracked from its creation to its release
+struct MPIM_rma_window_t
+{
+    /// The window handle, only meaningful in the process that created it
+    MPI_Win window;
+    /// Identifier of the window, as given by MPI_Win_c2f, which MPI may reuse once the window is freed
+    int32_t identifier;
+    /// Rank of the process that created the window, filled in for the report
+    int32_t rank;
+    /// MPIM_RMA_WINDOW_FREED if the window was freed with MPI_Win_free, MPIM_RMA_WINDOW_UNTRACKED if it stopped being tracked as monitoring was switched off meanwhile, 0 otherwise
+    int32_t freed;
+    /// Message type of the routine that created the window
+    int32_t type;
+    /// Identity of the module containing the callsite creating the window
+    uint32_t module;
+    /// Offset of the callsite creating the window in its module
+    uint64_t offset;
+    /// Line of the callsite creating the window in its source file
+    int32_t line;
+    /// The current synchronisation state of the window
+    struct MPIM_rma_epoch_t epoch;
+    /// Odd while a thread updates the window, so that readers copy its epoch without locking and writers exclude each other
+    uint32_t sequence;
+    /// Number of access epochs opened on the window
+    uint64_t epochs;
+    /// Number of operations issued on the window
+    uint64_t operations;
+    /// Size, in bytes, of the origin data of the operations issued on the window
+    uint64_t bytes;
+};
+
+/// Time spent in the MPI calls issued from a callsite
+struct MPIM_profile_callsite_t
+{
+    /// Identity of the module containing the callsite
+    uint32_t module;
+    /// Line of the callsite in its source file
+    int32_t line;
+    /// Offset of the callsite in its module
+    uint64_t offset;
+    /// Message type of the MPI routine called
+    int32_t type;
+    /// Number of processes that issued calls from this callsite
+    int32_t ranks;
+    /// Number of calls, summed over processes, 0 for an unused entry
+    uint64_t calls;
+    /// Time spent in the calls, in nanoseconds, summed over processes
+    uint64_t nanoseconds;
+    /// Minimum over processes of the time spent in the calls, in nanoseconds
+    uint64_t min_nanoseconds;
+    /// Maximum over processes of the time spent in the calls, in nanoseconds
+    uint64_t max_nanoseconds;
+};
+
+/// The callsites of a profile sorted by module and offset, so that the profiles of two processes can be merged in a single pass
+struct MPIM_profile_callsites_t
+{
+    /// Number of callsites
+    int32_t count;
+    /// Number of callsites that did not fit, summed over processes
+    int32_t dropped;
+    /// The callsites
+    struct MPIM_profile_callsite_t callsites[MPIM_PROFILE_MAX_CALLSITES];
+};
+
+/// Totals of a process; made of uint64_t only so that they are reduced as an array
+struct MPIM_profile_totals_t
+{
+    /// Time elapsed between the end of MPI_Init and the start of MPI_Finalize, in nanoseconds
+    uint64_t application_nanoseconds;
+    /// Time spent in MPI routines, in nanoseconds
+    uint64_t mpi_nanoseconds;
+    /// Number of calls per MPI routine
+    uint64_t calls[MPIM_MESSAGE_TYPE_COUNT];
+    /// Time spent per MPI routine, in nanoseconds
+    uint64_t nanoseconds[MPIM_MESSAGE_TYPE_COUNT];
+};
+
+/// The profile and histograms filled by one thread without synchronisation, merged into those of its process at MPI_Finalize
+struct MPIM_thread_profile_t
+{
+    /// Time spent by the thread in each MPI routine
+    struct MPIM_profile_totals_t totals;
+    /// Time spent by the thread at each callsite, as an open-addressing hash map keyed by module and offset
+    struct MPIM_profile_callsite_t callsites[MPIM_PROFILE_MAX_CALLSITES];
+    /// Whether some callsites did not fit in callsites
+    int callsites_dropped;
+    /// The histograms of the thread, one per message type
+    struct MPIM_histogram_t histograms[MPIM_MESSAGE_TYPE_COUNT];
+    /// The profile of the next thread of the process
+    struct MPIM_thread_profile_t* next;
 };
 
 ///////////////////////
@@ -408,1153 +991,6724 @@ struct MPIM_message_t
 int MPIM_my_rank;
 /// Number of processes in the global communicator
 int MPIM_my_comm_size;
+/// Number of slots reserved for each process in the window, one per thread issuing MPI calls
+int MPIM_threads_per_process = 1;
+/// Number of threads of this process that have issued an MPI call so far, those beyond MPIM_threads_per_process having no slot
+atomic_int MPIM_thread_count = 0;
+/// Index of the slot of the calling thread among those of its process, -1 until its first MPI call, MPIM_NO_SLOT if all slots were taken
+static __thread int MPIM_my_thread_slot = -1;
+/// Number of MPI calls issued by the calling thread so far
+static __thread uint64_t MPIM_my_call_count = 0;
+/// Total size, in bytes, of data sent by the calling thread in point-to-point communications
+static __thread size_t MPIM_my_total_data_sent = 0;
+/// Total size, in bytes, of data received by the calling thread in point-to-point communications
+static __thread size_t MPIM_my_total_data_received = 0;
+/// Time spent by the calling thread in the MPI calls it completed, in nanoseconds
+static __thread uint64_t MPIM_my_mpi_nanoseconds = 0;
+/// Timestamp at which the MPI routine currently issued by the calling thread was entered
+static __thread uint64_t MPIM_my_call_start = 0;
+/// Indicates if the MPI routine currently issued by the calling thread is monitored, so that its completion is only handled if its start was
+static __thread bool MPIM_my_call_monitored = false;
+/// Cache of the sizes of the datatypes used by the calling thread
+static __thread struct MPIM_datatype_cache_entry_t MPIM_datatype_cache[MPIM_DATATYPE_CACHE_SIZE];
+/// Incremented every time a datatype is freed, which invalidates the datatype caches since its handle may be reused
+atomic_uint MPIM_datatype_generation = 1;
+/// The histograms of this process, one per message type
+struct MPIM_histogram_t* MPIM_histograms = NULL;
+/// Time spent by this process in each MPI routine, merged from the thread profiles
+struct MPIM_profile_totals_t MPIM_profile_totals;
+/// Time spent by this process at each callsite, merged from the thread profiles, as an open-addressing hash map keyed by module and offset
+struct MPIM_profile_callsite_t MPIM_profile_callsites[MPIM_PROFILE_MAX_CALLSITES];
+/// Whether some callsites did not fit in MPIM_profile_callsites
+int MPIM_profile_callsites_dropped = 0;
+/// Timestamp at which MPI_Init completed
+uint64_t MPIM_profile_start = 0;
+/// The profile of the calling thread, allocated on its first completed call
+static __thread struct MPIM_thread_profile_t* MPIM_my_profile = NULL;
+/// The profiles of the threads of this process, linked through their next field
+struct MPIM_thread_profile_t* MPIM_thread_profiles = NULL;
+/// Protects MPIM_thread_profiles when a thread registers its profile
+pthread_mutex_t MPIM_thread_profiles_mutex = PTHREAD_MUTEX_INITIALIZER;
+/// Number of seconds after which a call is considered stalled and its stack is captured, 0 to disable stack capture
+double MPIM_stall_threshold = 0.0;
+/// The MPI call each thread of this process is in, one per thread slot
+struct MPIM_thread_state_t* MPIM_thread_states = NULL;
+/// The thread capturing the stacks of stalled calls
+pthread_t MPIM_watchdog_thread;
+/// The termination condition for the watchdog thread
+volatile bool MPIM_watchdog_end = false;
+/// MPI window through which stacks of stalled calls are sent to the aggregator
+MPI_Win MPIM_stack_window;
+/// The buffer behind the stack window, one stack per slot
+struct MPIM_stack_t* MPIM_stack_window_buffer = NULL;
+/// Cache of the stack frames symbolised by the aggregator
+struct MPIM_symbol_cache_entry_t MPIM_frame_cache[MPIM_SYMBOL_CACHE_SIZE];
+/// Indicates if the wait states of point-to-point and N-to-N collective calls are analysed, set with the MPIM_WAIT_STATES environment variable
+bool MPIM_wait_states_enabled = false;
+/// Number of ranks listed in the wait state report
+int MPIM_wait_states_top = MPIM_DEFAULT_WAIT_STATES_TOP;
+/// The group of MPI_COMM_WORLD, used to translate ranks of other communicators
+MPI_Group MPIM_world_group;
+/// MPI window through which senders stamp the messages they send, MPIM_WAIT_STAMP_RING stamps per sender
+MPI_Win MPIM_stamp_window;
+/// The buffer behind the stamp window
+struct MPIM_send_stamp_t* MPIM_stamp_window_buffer = NULL;
+/// Number of point-to-point sends issued by this process, per destination rank in MPI_COMM_WORLD
+uint64_t* MPIM_wait_send_counts = NULL;
+/// MPI window through which waiting times and collective arrivals are sent to the aggregator
+MPI_Win MPIM_wait_window;
+/// The buffer behind the wait window: the waiting time caused by every rank, followed by the collective arrivals
+struct MPIM_wait_cause_t* MPIM_wait_window_buffer = NULL;
+/// Waiting time measured by this process, per rank in MPI_COMM_WORLD: that rank made this process wait in the first half, this process made that rank wait in the second
+uint64_t* MPIM_wait_pair_nanoseconds = NULL;
+/// The nonblocking receives posted by the calling thread and not analysed yet, indexed by a hash of their request
+static __thread struct MPIM_wait_receive_t MPIM_wait_receives[MPIM_WAIT_RECEIVE_CACHE_SIZE];
+/// The nonblocking receives that the current completion call of the calling thread may complete
+static __thread struct MPIM_wait_pending_t MPIM_my_wait_pending[MPIM_WAIT_COMPLETION_MAX];
+/// Number of entries in MPIM_my_wait_pending
+static __thread int MPIM_my_wait_pending_count = 0;
+/// Incremented every time monitoring is switched on again, which invalidates the nonblocking receives remembered since they may have completed while it was off
+atomic_uint MPIM_wait_receive_generation = 1;
+/// Translations of communicator ranks into ranks in MPI_COMM_WORLD of the calling thread
+static __thread struct MPIM_communicator_cache_entry_t MPIM_communicator_cache[MPIM_COMMUNICATOR_CACHE_SIZE];
+/// Incremented every time a communicator is freed, which invalidates the communicator caches since its handle may be reused
+atomic_uint MPIM_communicator_generation = 1;
+/// Number of N-to-N collectives on MPI_COMM_WORLD issued by this process
+uint64_t MPIM_wait_collective_count = 0;
+/// Collective arrivals read back by a process once it completes an N-to-N collective on MPI_COMM_WORLD
+struct MPIM_collective_arrival_t* MPIM_wait_arrivals = NULL;
+/// Time at which the calling thread entered its current MPI call, in seconds in the clock of the aggregator
+static __thread double MPIM_my_wait_entry_time = 0.0;
+/// The persistent requests tracked in this process; the entry of a freed request, whose request is MPI_REQUEST_NULL, is reused by a later request
+struct MPIM_persistent_request_t MPIM_persistent_requests[MPIM_MAX_PERSISTENT_REQUESTS];
+/// Finds the tracked persistent request of a handle: index of the request plus one, 0 for an empty bucket, -1 for a removed one; buckets are read without locking
+int32_t MPIM_persistent_index[MPIM_PERSISTENT_INDEX_SIZE];
+/// Number of entries of MPIM_persistent_requests used so far, freed ones included
+atomic_int MPIM_persistent_request_count = 0;
+/// The entries of MPIM_persistent_requests freed and not reused yet, as a stack
+int32_t MPIM_persistent_free_entries[MPIM_MAX_PERSISTENT_REQUESTS];
+/// Number of entries in MPIM_persistent_free_entries
+int MPIM_persistent_free_entry_count = 0;
+/// The statistics of the freed persistent requests of this process, summed per callsite, routine and arguments
+struct MPIM_persistent_request_t MPIM_persistent_freed[MPIM_MAX_PERSISTENT_CALLSITES];
+/// Number of entries used in MPIM_persistent_freed
+int MPIM_persistent_freed_count = 0;
+/// Number of persistent requests not tracked because MPIM_persistent_requests was full, or whose statistics were lost at release because MPIM_persistent_freed was full
+int MPIM_persistent_requests_dropped = 0;
+/// Number of persistent requests of this process started and not completed yet
+atomic_uint MPIM_persistent_active_count = 0;
+/// Serialises the creations and releases of persistent requests when several threads issue MPI calls, starts and completions taking no lock
+pthread_mutex_t MPIM_persistent_mutex = PTHREAD_MUTEX_INITIALIZER;
+/// The application windows created in this process, in creation order; entries are never reused so that freed windows appear in the report
+struct MPIM_rma_window_t MPIM_rma_windows[MPIM_MAX_RMA_WINDOWS];
+/// Number of entries used in MPIM_rma_windows, stored with release semantics once the window appended is filled in
+atomic_int MPIM_rma_window_count = 0;
+/// Number of application windows not tracked because MPIM_rma_windows was full
+int MPIM_rma_windows_dropped = 0;
+/// Serialises the creations of windows when several threads issue MPI calls, the windows themselves being updated under their own sequence
+pthread_mutex_t MPIM_rma_mutex = PTHREAD_MUTEX_INITIALIZER;
+/// Serialises the reloads of the module table, which only happen when a callsite is met for the first time
+pthread_mutex_t MPIM_modules_mutex = PTHREAD_MUTEX_INITIALIZER;
 /// The thread that will run the monitoring on the master process
 pthread_t MPIM_manager_thread;
 /// MPI window in which the updates will be sent
 MPI_Win MPIM_my_window;
+/// Number of bytes skipped at the start of the window so that its slots start on a cache line
+MPI_Aint MPIM_window_padding = 0;
+/// When updates are flushed to the coordinator
+enum MPIM_flush_policy_t MPIM_flush_policy = MPIM_FLUSH_BLOCKING;
+/// Messages of the updates put by the thread, which MPI may read until the updates complete locally
+static __thread struct MPIM_message_t MPIM_my_outbox[MPIM_OUTBOX_SIZE];
+/// Number of messages of the outbox possibly still read by MPI
+static __thread int MPIM_my_outbox_count = 0;
 /// The actual buffer behind the window
 struct MPIM_message_t* MPIM_my_window_buffer_original = NULL;
-/// A copy of the buffer in which information is sent; that allows to make sure that reproducible reads can be performed on it
+/// A copy of the buffer in which information is sent, holding the last untorn version of every slot, so that a frame is displayed from stable data
 struct MPIM_message_t* MPIM_my_window_buffer_copy = NULL;
+/// Sequence number of the update held in every slot of MPIM_my_window_buffer_copy
+uint64_t* MPIM_snapshot_sequences = NULL;
+/// Summary of every slot of MPIM_my_window_buffer_copy
+struct MPIM_slot_summary_t* MPIM_slot_summaries = NULL;
+/// Number of slots displayed
+int MPIM_displayed_slot_count = 0;
+/// The slots displayed, kept up to date as slots are copied, so that printing the rows does not go through every slot
+struct MPIM_slot_list_t MPIM_displayed_slots;
+/// The slots displayed whose thread is inside an MPI call, the only ones whose stack can be printed
+struct MPIM_slot_list_t MPIM_calling_slots;
+/// Number of slots claimed by the threads of every process, in the window after the slots, so that the aggregator does not read the slots no thread uses
+int* MPIM_claimed_slot_counts = NULL;
+/// Number of slots displayed per message type, for updates sent before and after the call
+int MPIM_state_counts[MPIM_MESSAGE_TYPE_COUNT][2];
+/// Number of slots displayed per width, for every column, from which the widths of the columns are derived
+int MPIM_column_length_counts[MPIM_COLUMN_COUNT][MPIM_MAX_ARGUMENTS_LENGTH];
+/// Indicates for every process if one of its threads has called MPI_Finalize
+bool* MPIM_process_finalised = NULL;
+/// Number of processes one thread of which has called MPI_Finalize
+int MPIM_finalised_process_count = 0;
+/// Maximum number of threads displayed one per row
+int MPIM_display_rows = MPIM_DEFAULT_DISPLAY_ROWS;
+/// Socket on which the aggregator serves the live display to viewers, -1 if it prints the live display itself
+int MPIM_view_socket = -1;
+/// Path of MPIM_view_socket, removed once the run is over
+char MPIM_view_path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+/// The viewers attached
+struct MPIM_viewer_t MPIM_viewers[MPIM_MAX_VIEWERS];
+/// Size of the last keyframe serialised, from which the backlog allowed to the viewers is derived
+size_t MPIM_view_keyframe_size = 0;
+/// Number of viewers attached
+int MPIM_viewer_count = 0;
+/// Number of frames served to the viewers so far
+int MPIM_view_frame_count = 0;
+/// Slots copied since the previous frame, for the viewers and the snapshot file which already hold the others; NULL if neither is enabled
+int* MPIM_updated_slots = NULL;
+/// Number of slots in MPIM_updated_slots
+int MPIM_updated_slot_count = 0;
+/// Buffer in which the messages sent to the viewers are serialised, grown on demand
+char* MPIM_view_buffer = NULL;
+/// Size of MPIM_view_buffer
+size_t MPIM_view_buffer_capacity = 0;
+/// Number of bytes serialised in MPIM_view_buffer
+size_t MPIM_view_buffer_size = 0;
+/// Mapping of the file in which snapshots are published, NULL if disabled
+struct MPIM_published_header_t* MPIM_published = NULL;
+/// Size of the mapping of MPIM_published
+size_t MPIM_published_size = 0;
+/// The slots of the mapping of MPIM_published
+struct MPIM_published_slot_t* MPIM_published_slots = NULL;
+/// Number of frames published so far
+int MPIM_publish_frame_count = 0;
+/// Indicates if the flight recorder records MPI calls, which it does once crash reports are enabled
+bool MPIM_flight_recorder_enabled = false;
+/// The last MPI calls of this process
+struct MPIM_flight_event_t MPIM_flight_events[MPIM_FLIGHT_RECORDER_SIZE];
+/// Number of events recorded so far, the next one going to MPIM_flight_events[MPIM_flight_event_count % MPIM_FLIGHT_RECORDER_SIZE]
+atomic_uint_fast64_t MPIM_flight_event_count = 0;
+/// Path of the crash report of this process
+char MPIM_crash_path[MPIM_MAX_FILENAME_LENGTH];
+/// Indicates if the crash report was written, so that it is written once whatever the number of signals received
+atomic_bool MPIM_crash_dumped = false;
+/// The signals on which the crash report is written
+const int MPIM_crash_signals[MPIM_CRASH_SIGNAL_COUNT] = {SIGSEGV, SIGBUS, SIGABRT, SIGTERM};
+/// The handlers of MPIM_crash_signals installed before those of the monitor, to which the signals are handed over
+struct sigaction MPIM_crash_previous_actions[MPIM_CRASH_SIGNAL_COUNT];
+/// The stack on which the crash handlers run
+char MPIM_crash_stack[MPIM_CRASH_STACK_SIZE];
+/// Indicates if the MPI calls are traced
+bool MPIM_trace_enabled = false;
+/// Indicates if the trace blocks are compressed, which the MPIM_TRACE_COMPRESSION environment variable set to 0 disables
+bool MPIM_trace_compression = true;
+/// The trace file of this process
+int MPIM_trace_file = -1;
+/// The time at which the trace started, in ticks
+uint64_t MPIM_trace_start = 0;
+/// The trace stream of the calling thread, created on its first MPI call
+static __thread struct MPIM_trace_stream_t* MPIM_my_trace_stream = NULL;
+/// The trace streams of every thread of the process
+struct MPIM_trace_stream_t* MPIM_trace_streams = NULL;
+/// Number of trace streams created so far
+int MPIM_trace_stream_count = 0;
+/// The blocks waiting for the trace writer, oldest first
+struct MPIM_trace_block_buffer_t* MPIM_trace_pending_head = NULL;
+/// The last block waiting for the trace writer
+struct MPIM_trace_block_buffer_t* MPIM_trace_pending_tail = NULL;
+/// Number of blocks waiting for the trace writer
+int MPIM_trace_pending_count = 0;
+/// The blocks written, ready to be filled again
+struct MPIM_trace_block_buffer_t* MPIM_trace_free_blocks = NULL;
+/// Indicates if the trace writer must stop once the pending blocks are written
+bool MPIM_trace_stopping = false;
+/// Protects the streams, the pending and free blocks and MPIM_trace_stopping
+pthread_mutex_t MPIM_trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+/// Signalled when a block is handed over to the trace writer
+pthread_cond_t MPIM_trace_filled = PTHREAD_COND_INITIALIZER;
+/// Signalled when the trace writer has written a block
+pthread_cond_t MPIM_trace_drained = PTHREAD_COND_INITIALIZER;
+/// The thread compressing and writing the trace blocks
+pthread_t MPIM_trace_writer_thread;
+/// The monitoring switch of this process, on by default
+struct MPIM_monitoring_switch_t MPIM_monitoring = { 1, 1, 1 };
+/// MPI window exposing MPIM_monitoring, through which the aggregator relays its own switches to every process
+MPI_Win MPIM_monitoring_window;
+/// Makes sure a single thread applies a switch
+pthread_mutex_t MPIM_monitoring_mutex = PTHREAD_MUTEX_INITIALIZER;
+/// The signals switching the monitoring
+const int MPIM_monitoring_signals[MPIM_MONITORING_SIGNAL_COUNT] = {MPIM_MONITORING_ON_SIGNAL, MPIM_MONITORING_OFF_SIGNAL};
+/// The handlers of MPIM_monitoring_signals installed before those of the monitor, restored by MPI_Finalize
+struct sigaction MPIM_monitoring_previous_actions[MPIM_MONITORING_SIGNAL_COUNT];
+/// Indicates if the handlers of MPIM_monitoring_signals are installed
+bool MPIM_monitoring_signals_installed = false;
+/// The last switch relayed to every process by MPI process 0
+int32_t MPIM_monitoring_relayed = 1;
+/// Indicates if the manager of MPI process 0 relays the switches, which requires the application to have obtained MPI_THREAD_MULTIPLE; otherwise the next MPI call of MPI process 0 does
+bool MPIM_monitoring_manager_relays = false;
+/// The MPI routine each thread of this process is in while monitoring is off, one per thread slot, MPIM_MESSAGE_UNINITIALISED outside MPI
+int32_t* MPIM_unmonitored_calls = NULL;
+/// MPI window exposing MPIM_unmonitored_calls, read by the aggregator when it switches the monitoring on again
+MPI_Win MPIM_unmonitored_window;
+/// The MPIM_unmonitored_calls of every process, as read by the aggregator when it last switched the monitoring on
+int32_t* MPIM_unmonitored_snapshot = NULL;
+/// Time, in the clock of the aggregator, at which MPIM_unmonitored_snapshot was read
+double MPIM_unmonitored_snapshot_time = 0.0;
+/// Indicates if MPIM_unmonitored_snapshot was read and not applied to the slots yet
+bool MPIM_unmonitored_snapshot_pending = false;
+/// Written instead of MPIM_unmonitored_calls by the threads that have no slot
+int32_t MPIM_unmonitored_call_ignored = MPIM_MESSAGE_UNINITIALISED;
+/// Where the calling thread writes the MPI routine it is in while monitoring is off, its entry of MPIM_unmonitored_calls once it has a slot
+static __thread int32_t* MPIM_my_unmonitored_call = &MPIM_unmonitored_call_ignored;
+/// Protects MPIM_my_window_buffer_copy and the statistics derived from it while the manager updates them, as the metrics thread reads them too
+pthread_mutex_t MPIM_snapshot_mutex = PTHREAD_MUTEX_INITIALIZER;
+/// Socket on which the aggregator serves metrics, -1 if metrics are disabled
+int MPIM_metrics_socket = -1;
+/// The thread serving metrics on the aggregator
+pthread_t MPIM_metrics_thread;
+/// Copy of MPIM_my_window_buffer_copy from which metrics are rendered
+struct MPIM_message_t* MPIM_metrics_slots = NULL;
+/// Buffer in which metrics are rendered, grown on demand
+char* MPIM_metrics_buffer = NULL;
+/// Size of MPIM_metrics_buffer
+size_t MPIM_metrics_buffer_capacity = 0;
+/// Number of bytes rendered in MPIM_metrics_buffer
+size_t MPIM_metrics_buffer_size = 0;
+/// Source of the sequence numbers of the updates of this process
+atomic_uint_fast64_t MPIM_update_sequence = 0;
 /// The termination condition for the monitoring thread
 volatile bool MPIM_manager_end = false;
+/// The modules loaded in this process; only appended to, under MPIM_modules_mutex, so that it is read without locking
+struct MPIM_module_t MPIM_modules[MPIM_MAX_MODULES];
+/// Number of modules in MPIM_modules, stored with release semantics once the module appended is filled in
+atomic_int MPIM_module_count = 0;
+/// Cache translating return addresses into module indexes, so that the module table is scanned only once per callsite; one per thread so that it needs no locking
+static __thread struct MPIM_callsite_cache_entry_t MPIM_callsite_cache[MPIM_CALLSITE_CACHE_SIZE];
+/// MPI window through which clock offsets are estimated
+MPI_Win MPIM_clock_window;
+/// The buffer behind the clock window, one exchange per process followed by the queue
+struct MPIM_clock_exchange_t* MPIM_clock_window_buffer = NULL;
+/// The queue of the clock window, on the aggregator
+struct MPIM_clock_queue_t* MPIM_clock_queue = NULL;
+/// Number of places of the queue of the clock window served so far, by the manager thread
+uint64_t MPIM_clock_queue_head = 0;
+/// The clock source timestamps are read from
+enum MPIM_clock_source_t MPIM_clock_source = MPIM_CLOCK_SOURCE_MONOTONIC_RAW;
+/// The calibration of the clock of this process
+struct MPIM_clock_calibration_t MPIM_my_clock = { 1.0E9, 0.0, 0.0, 0.0, 0.0 };
+/// Timestamp at which the clock offset must be estimated again, read by every thread issuing MPI calls
+atomic_uint_fast64_t MPIM_clock_next_sync = 0;
+/// The estimation of the clock offset in progress, advanced by the thread holding MPIM_clock_mutex
+struct MPIM_clock_estimation_t MPIM_clock_estimation = { 0, false, 0, 0.0, 0.0, -1.0, 0.0, false, 0, -1.0, 0.0, 0.0, 0.0, 0.0 };
+/// Number of seconds between two estimations of the clock offset
+double MPIM_clock_sync_period = MPIM_DEFAULT_CLOCK_SYNC_PERIOD;
+/// Makes sure a single thread advances the estimation of the clock offset at a time, the others going on without waiting
+pthread_mutex_t MPIM_clock_mutex = PTHREAD_MUTEX_INITIALIZER;
+/// Cache of the callsites symbolised by the aggregator
+struct MPIM_symbol_cache_entry_t MPIM_symbol_cache[MPIM_SYMBOL_CACHE_SIZE];
+/// The libbacktrace state through which the aggregator reads the debugging information of its modules
+struct backtrace_state* MPIM_backtrace_state = NULL;
 
 ///////////////////////
 // FUNCTIONS NEEDED //
 /////////////////////
 
 /**
- * @brief Returns walltime in seconds.
- * @details This function is used as a substitute to MPI_Wtime when MPI_Init is not called yet.
- * @return The walltime, in seconds.
+ * @brief Reads the clock source.
+ * @details Timestamps stay integers on the processes issuing MPI calls, they are converted to seconds only when needed.
+ * @return The current timestamp, in ticks of the clock source.
+ **/
+static inline uint64_t MPIM_get_ticks()
+{
+    switch(MPIM_clock_source)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        case MPIM_CLOCK_SOURCE_TSC:
+            return __rdtsc();
+#endif
+        case MPIM_CLOCK_SOURCE_GETTIMEOFDAY:
+        {
+            struct timeval wtime;
+            gettimeofday(&wtime, NULL);
+            return (uint64_t)wtime.tv_sec * 1000000 + wtime.tv_usec;
+        }
+        default:
+        {
+            struct timespec wtime;
+            clock_gettime(CLOCK_MONOTONIC_RAW, &wtime);
+            return (uint64_t)wtime.tv_sec * 1000000000 + wtime.tv_nsec;
+        }
+    }
+}
+
+/**
+ * @brief Returns local time in seconds.
+ * @details This function is used as a substitute to MPI_Wtime when MPI_Init is not called yet. The origin of the local time depends on the clock source.
+ * @return The local time, in seconds.
  **/
 static double MPIM_get_time()
 {
-    struct timeval wtime;
-    gettimeofday(&wtime, NULL);
-    double wtime_second = wtime.tv_sec;
-    wtime_second += (wtime.tv_usec / 1000000.0);
-    return wtime_second;
+    return MPIM_get_ticks() / MPIM_my_clock.ticks_per_second;
 }
 
 /**
- * @brief Sleeps for a given duration.
- * @param[in] milliseconds The duration to sleep for, in milliseconds.
+ * @brief Indicates if the processor provides an invariant time-stamp counter, which ticks at a constant rate regardless of frequency scaling and sleep states.
+ * @return True if the time-stamp counter is invariant, false otherwise.
  **/
-static void MPIM_sleep(unsigned int milliseconds)
+static bool MPIM_clock_has_invariant_tsc()
 {
-    usleep(milliseconds * 1000);
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if(__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+    {
+        return (edx & (1 << 8)) != 0;
+    }
+#endif
+    return false;
 }
 
 /**
- * @brief Fills the filename field in the MPI monitoring message.
- * @param[inout] message The MPI monitoring message.
- * @param[in] file The name of the file from which the MPI call is issued.
+ * @brief Selects the clock source and calibrates it.
+ * @details The clock source can be forced with the MPIM_CLOCK_SOURCE environment variable. By default, the time-stamp counter is used if it is invariant, CLOCK_MONOTONIC_RAW otherwise. The time-stamp counter is calibrated against CLOCK_MONOTONIC_RAW.
  **/
-static void MPIM_message_set_name(struct MPIM_message_t* message, const char* file)
+static void MPIM_clock_calibrate()
 {
-    strncpy(message->file, file, MPIM_MAX_FILENAME_LENGTH);
-    message->file[MPIM_MAX_FILENAME_LENGTH-1] = '\0';
+    MPIM_clock_source = MPIM_clock_has_invariant_tsc() ? MPIM_CLOCK_SOURCE_TSC : MPIM_CLOCK_SOURCE_MONOTONIC_RAW;
+    const char* clock_source = getenv("MPIM_CLOCK_SOURCE");
+    if(clock_source != NULL)
+    {
+        for(int i = 0; i < (int)(sizeof(MPIM_clock_source_name_t) / sizeof(MPIM_clock_source_name_t[0])); i++)
+        {
+            if(strcmp(clock_source, MPIM_clock_source_name_t[i]) == 0)
+            {
+                MPIM_clock_source = (enum MPIM_clock_source_t)i;
+            }
+        }
+        if(MPIM_clock_source == MPIM_CLOCK_SOURCE_TSC && !MPIM_clock_has_invariant_tsc())
+        {
+            MPIM_clock_source = MPIM_CLOCK_SOURCE_MONOTONIC_RAW;
+        }
+    }
+
+    switch(MPIM_clock_source)
+    {
+        case MPIM_CLOCK_SOURCE_TSC:
+        {
+            enum MPIM_clock_source_t tsc = MPIM_clock_source;
+            MPIM_clock_source = MPIM_CLOCK_SOURCE_MONOTONIC_RAW;
+            uint64_t reference_start = MPIM_get_ticks();
+            MPIM_clock_source = tsc;
+            uint64_t tsc_start = MPIM_get_ticks();
+            usleep(MPIM_TSC_CALIBRATION_DURATION * 1000);
+            MPIM_clock_source = MPIM_CLOCK_SOURCE_MONOTONIC_RAW;
+            uint64_t reference_end = MPIM_get_ticks();
+            MPIM_clock_source = tsc;
+            uint64_t tsc_end = MPIM_get_ticks();
+            MPIM_my_clock.ticks_per_second = (tsc_end - tsc_start) * 1.0E9 / (reference_end - reference_start);
+            break;
+        }
+        case MPIM_CLOCK_SOURCE_GETTIMEOFDAY:
+            MPIM_my_clock.ticks_per_second = 1.0E6;
+            break;
+        default:
+            MPIM_my_clock.ticks_per_second = 1.0E9;
+            break;
+    }
 }
 
 /**
- * @brief Fills the arguments field in the MPI monitoring message.
- * @param[inout] message The MPI monitoring message.
- * @param[in] args The arguments passed to the MPI call issued.
+ * @brief Converts a timestamp of a process into the time of the aggregator.
+ * @param[in] calibration The calibration of the clock of the process.
+ * @param[in] timestamp The timestamp, in ticks of the clock source of the process.
+ * @return The time of the aggregator, in seconds.
  **/
-static void MPIM_message_set_args(struct MPIM_message_t* message, const char* args)
+static double MPIM_clock_to_aggregator_time(const struct MPIM_clock_calibration_t* calibration, uint64_t timestamp)
 {
-    strncpy(message->args, args, MPIM_MAX_ARGUMENTS_LENGTH);
-    message->args[MPIM_MAX_ARGUMENTS_LENGTH-1] = '\0';
+    double local = timestamp / calibration->ticks_per_second;
+    return local + calibration->offset + calibration->drift * (local - calibration->reference);
 }
 
 /**
- * @brief Propagates an update to the coordinator process
- * @param[in] message The message containing the update.
+ * @brief Converts a time of the aggregator into a timestamp of a process.
+ * @param[in] calibration The calibration of the clock of the process.
+ * @param[in] time The time of the aggregator, in seconds.
+ * @return The timestamp, in ticks of the clock source of the process.
  **/
-static void MPIM_send_update(struct MPIM_message_t* message, const char* file, int line, const char* args)
+static uint64_t MPIM_clock_from_aggregator_time(const struct MPIM_clock_calibration_t* calibration, double time)
 {
-    MPIM_message_set_name(message, file);
-    message->line = line;
-    message->walltime = MPIM_get_time();
-    MPIM_message_set_args(message, args);
-    MPI_Put(message, sizeof(struct MPIM_message_t), MPI_CHAR, 0, MPIM_my_rank, sizeof(struct MPIM_message_t), MPI_CHAR, MPIM_my_window);
+    double local = (time - calibration->offset + calibration->drift * calibration->reference) / (1.0 + calibration->drift);
+    return (local > 0.0) ? (uint64_t)(local * calibration->ticks_per_second) : 0;
 }
 
-static void MPIM_message(enum MPIM_message_temporality_t temporality, enum MPIM_message_type_t type, const char* file, int line, const char* args)
+/**
+ * @brief Sleeps for a given duration.
+ * @param[in] milliseconds The duration to sleep for, in milliseconds.
+ **/
+static void MPIM_sleep(unsigned int milliseconds)
 {
-    struct MPIM_message_t message;
-    message.type = type;
-    message.before = (temporality == MPIM_TEMPORALITY_BEFORE);
-    MPIM_send_update(&message, file, line, args);
+    usleep(milliseconds * 1000);
 }
 
-/////////////////////////////////////////
-// MPIM_ VERSIONS OF MPI ROUTINES //
-///////////////////////////////////////
+/**
+ * @brief Queues the rank of the process on the aggregator, so that its manager thread answers the request just issued.
+ * @details The place is taken with an atomic increment of the tail of the queue, then the rank is written there. Both are accumulates following the one issuing the request, so they land after it.
+ **/
+static void MPIM_clock_enqueue()
+{
+    struct MPIM_clock_estimation_t* estimation = &MPIM_clock_estimation;
+    MPI_Aint queue = MPIM_my_comm_size * sizeof(struct MPIM_clock_exchange_t);
+    uint64_t one = 1;
+    uint64_t position = 0;
+    MPI_Fetch_and_op(&one, &position, MPI_UINT64_T, 0, queue + offsetof(struct MPIM_clock_queue_t, tail), MPI_SUM, MPIM_clock_window);
+    MPI_Win_flush(0, MPIM_clock_window);
+    // The aggregator cannot answer before finding the rank in its queue, so the exchange starts from there
+    estimation->start = MPIM_get_time();
+    int32_t rank = MPIM_my_rank;
+    MPI_Accumulate(&rank, 1, MPI_INT32_T, 0, queue + offsetof(struct MPIM_clock_queue_t, ranks) + (position % MPIM_my_comm_size) * sizeof(int32_t), 1, MPI_INT32_T, MPI_REPLACE, MPIM_clock_window);
+    estimation->queued = true;
+    estimation->queued_sequence = estimation->sequence;
+}
 
 /**
- * @brief Prints an horizontal seperator, used in tables.
- * @param[in] routine_name_length The maximum length of the strings contained in the 'routine name' column.
- * @param[in] where_length The maximum length of the strings contained in the 'where' column.
- * @param[in] when_length The maximum length of the strings contained in the 'when' column.
+ * @brief Advances the estimation of the offset between the local clock and the clock of the aggregator by one step.
+ * @details An estimation is made of MPIM_CLOCK_SYNC_ROUNDS ping-pong exchanges with the aggregator, keeping the one with the shortest round trip. A step either issues the request of an exchange or checks once whether the aggregator answered it, each costing a single flush to the aggregator, or two when joining its queue: the step never waits for the manager thread to answer, so the MPI call taking it is not delayed by the frames of the aggregator. An exchange left unanswered for MPIM_CLOCK_SYNC_TIMEOUT seconds is abandoned.
+ * Since the answer is only seen by the next MPI call, periodic exchanges also last the time the application spends between its calls. An estimation is therefore kept only if its best round trip is within MPIM_CLOCK_SYNC_ROUND_TRIP_TOLERANCE of the shortest one kept so far, that of MPI_Init at first; otherwise the previous calibration goes on being extrapolated. The drift is derived from the first estimation kept, and only once its error, the sum of the errors of both offsets over the interval between them, is below MPIM_CLOCK_MAX_DRIFT_ERROR. The error bound published adds the error of the drift over one synchronisation period to the error of the offset. The aggregator has a null offset by definition.
+ * @return True once the estimation is over, false if more steps are needed.
  **/
-static void print_horizontal_separator(int routine_name_length, int where_length, int when_length)
+static bool MPIM_clock_step()
 {
-    printf("+-----+-");
-    for(int i = 0; i < routine_name_length; i++)
+    struct MPIM_clock_estimation_t* estimation = &MPIM_clock_estimation;
+    MPI_Aint displacement = MPIM_my_rank * sizeof(struct MPIM_clock_exchange_t);
+    if(!estimation->waiting)
     {
-        printf("-");
+        estimation->sequence++;
+        estimation->start = MPIM_get_time();
+        MPI_Accumulate(&estimation->sequence, 1, MPI_UINT32_T, 0, displacement + offsetof(struct MPIM_clock_exchange_t, request), 1, MPI_UINT32_T, MPI_REPLACE, MPIM_clock_window);
+        if(!estimation->queued)
+        {
+            MPIM_clock_enqueue();
+        }
+        MPI_Win_flush(0, MPIM_clock_window);
+        estimation->waiting = true;
+        return false;
     }
-    printf("-+-");
-    for(int i = 0; i < where_length; i++)
+
+    // MPI does not order the bytes read by a get, so the time of the aggregator is only read once the response shows it was written
+    uint32_t response = 0;
+    MPI_Get(&response, 1, MPI_UINT32_T, 0, displacement + offsetof(struct MPIM_clock_exchange_t, response), 1, MPI_UINT32_T, MPIM_clock_window);
+    MPI_Win_flush(0, MPIM_clock_window);
+    double end = MPIM_get_time();
+    if(estimation->queued && (int32_t)(response - estimation->queued_sequence) >= 0)
     {
-        printf("-");
+        estimation->queued = false;
     }
-    printf("-+-");
-    for(int i = 0; i < when_length; i++)
+    if(response == estimation->sequence)
     {
-        printf("-");
+        double aggregator_time = 0.0;
+        MPI_Get(&aggregator_time, 1, MPI_DOUBLE, 0, displacement + offsetof(struct MPIM_clock_exchange_t, aggregator_time), 1, MPI_DOUBLE, MPIM_clock_window);
+        MPI_Win_flush(0, MPIM_clock_window);
+        // The aggregator read its clock somewhere between the start and the end of the exchange
+        double round_trip = end - estimation->start;
+        if(estimation->best_round_trip < 0.0 || round_trip < estimation->best_round_trip)
+        {
+            estimation->best_offset = aggregator_time - (estimation->start + end) / 2.0;
+            estimation->best_round_trip = round_trip;
+            estimation->best_time = (estimation->start + end) / 2.0;
+        }
+    }
+    else if(estimation->queued && end - estimation->start <= MPIM_CLOCK_SYNC_TIMEOUT)
+    {
+        return false;
     }
-    printf("-----------+\n");
+    estimation->waiting = false;
+    estimation->round++;
+    if(estimation->round < MPIM_CLOCK_SYNC_ROUNDS)
+    {
+        return false;
+    }
+
+    estimation->round = 0;
+    double round_trip = estimation->best_round_trip;
+    estimation->best_round_trip = -1.0;
+    if(round_trip < 0.0 || (estimation->reference_round_trip >= 0.0 && round_trip > MPIM_CLOCK_SYNC_ROUND_TRIP_TOLERANCE * estimation->reference_round_trip))
+    {
+        // The aggregator did not answer, or the exchanges were slowed down: keep extrapolating from the previous calibration
+        return true;
+    }
+    double error = round_trip / 2.0;
+    if(estimation->reference_round_trip < 0.0)
+    {
+        estimation->reference_round_trip = round_trip;
+        estimation->first_offset = estimation->best_offset;
+        estimation->first_time = estimation->best_time;
+        estimation->first_error = error;
+    }
+    else
+    {
+        if(round_trip < estimation->reference_round_trip)
+        {
+            estimation->reference_round_trip = round_trip;
+        }
+        double interval = estimation->best_time - estimation->first_time;
+        if(interval > 0.0 && (estimation->first_error + error) / interval <= MPIM_CLOCK_MAX_DRIFT_ERROR)
+        {
+            MPIM_my_clock.drift = (estimation->best_offset - estimation->first_offset) / interval;
+            estimation->drift_error = (estimation->first_error + error) / interval;
+        }
+    }
+    MPIM_my_clock.offset = estimation->best_offset;
+    MPIM_my_clock.reference = estimation->best_time;
+    MPIM_my_clock.error = error + estimation->drift_error * MPIM_clock_sync_period;
+
+    // Publish the new calibration so that the aggregator converts timestamps accordingly
+    MPI_Put(&MPIM_my_clock, sizeof(struct MPIM_clock_calibration_t), MPI_BYTE, 0, displacement + offsetof(struct MPIM_clock_exchange_t, calibration), sizeof(struct MPIM_clock_calibration_t), MPI_BYTE, MPIM_clock_window);
+    MPI_Win_flush(0, MPIM_clock_window);
+    return true;
 }
 
 /**
- * @brief Updates the monitoring report.
- * @return This is a placeholder to fit the fork task prototype.
+ * @brief Schedules the next estimation of the clock offset, one synchronisation period from now.
  **/
-static void* MPIM_manager()
+static void MPIM_clock_schedule()
 {
-    // Every second, send updates
-    static double beginning = 0.0;
-    if(beginning == 0.0)
+    atomic_store_explicit(&MPIM_clock_next_sync, MPIM_get_ticks() + (uint64_t)(MPIM_clock_sync_period * MPIM_my_clock.ticks_per_second), memory_order_relaxed);
+}
+
+/**
+ * @brief Estimates the offset between the local clock and the clock of the aggregator at once, during the initialisation.
+ * @details The steps are chained without waiting for MPI calls, the manager thread of the aggregator answering within a millisecond.
+ **/
+static void MPIM_clock_synchronise()
+{
+    if(MPIM_my_rank != 0)
     {
-        beginning = MPIM_get_time();
+        while(!MPIM_clock_step())
+        {
+        }
     }
-    double past = MPIM_get_time();
-    double now = MPIM_get_time();
-    const double FPS = 4;
-    double refresh_time = 1.0 / FPS;
-    while(!MPIM_manager_end)
-    {
-        memcpy(MPIM_my_window_buffer_copy, MPIM_my_window_buffer_original, sizeof(struct MPIM_message_t) * MPIM_my_comm_size);
+    MPIM_clock_schedule();
+}
 
-        MPIM_manager_end = true;
-        for(int i = 0; i < MPIM_my_comm_size; i++)
+/**
+ * @brief Returns the timestamp to attach to a message.
+ * @details Once the synchronisation period has elapsed, the clock offset is estimated again to follow drift, the thread holding the clock mutex taking one step of the estimation per call; threads finding the mutex taken go on at once.
+ * @return The current timestamp, in ticks of the clock source.
+ **/
+static uint64_t MPIM_get_timestamp()
+{
+    uint64_t now = MPIM_get_ticks();
+    if(now >= atomic_load_explicit(&MPIM_clock_next_sync, memory_order_relaxed) && pthread_mutex_trylock(&MPIM_clock_mutex) == 0)
+    {
+        if(MPIM_my_rank == 0 || MPIM_clock_step())
         {
-            if(MPIM_my_window_buffer_copy[i].type != MPIM_MESSAGE_FINALISED)
-            {
-                MPIM_manager_end = false;
-            }
+            MPIM_clock_schedule();
         }
+        pthread_mutex_unlock(&MPIM_clock_mutex);
+        now = MPIM_get_ticks();
+    }
+    return now;
+}
 
-        // Clear the screen
-        MPIM_console_clear_screen();
-        MPIM_console_move_cursor_to(1, 1);
-
-        int current_max_routine_name_length = 0;
-        int temp_max_routine_name_length;
-        int current_max_where_length = 0;
-        int temp_max_where_length;
-        const int WHERE_LENGTH = 64;
-        char where[WHERE_LENGTH];
-        const int WHEN_LENGTH = 32;
-        char when[WHEN_LENGTH];
-        double elapsed;
-        int current_max_when_length = 0;
-        int temp_max_when_length;
-        for(int i = 0; i < MPIM_my_comm_size; i++)
+/**
+ * @brief Answers the pending clock offset estimation requests.
+ * @details This function is called by the manager thread of the aggregator. Only the processes found in the queue are looked at, so that checking for requests every MPIM_CLOCK_SERVE_PERIOD milliseconds does not cost a scan of every process. A place taken but not written yet stops the serving until the next check.
+ **/
+static void MPIM_clock_serve()
+{
+    uint64_t tail = MPIM_clock_queue->tail;
+    while(MPIM_clock_queue_head != tail)
+    {
+        volatile int32_t* place = &MPIM_clock_queue->ranks[MPIM_clock_queue_head % MPIM_my_comm_size];
+        int32_t rank = *place;
+        if(rank == 0)
         {
-            temp_max_routine_name_length = strlen(MPIM_routine_name_t[MPIM_my_window_buffer_copy[i].type]);
-            if(temp_max_routine_name_length > current_max_routine_name_length)
-            {
-                current_max_routine_name_length = temp_max_routine_name_length;
-            }
+            break;
+        }
+        *place = 0;
+        MPIM_clock_queue_head++;
+        if(MPIM_clock_window_buffer[rank].request != MPIM_clock_window_buffer[rank].response)
+        {
+            MPIM_clock_window_buffer[rank].aggregator_time = MPIM_get_time();
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+            MPIM_clock_window_buffer[rank].response = MPIM_clock_window_buffer[rank].request;
+        }
+    }
+}
 
-            snprintf(where, WHERE_LENGTH, "%s:%d", MPIM_my_window_buffer_copy[i].file, MPIM_my_window_buffer_copy[i].line);
-            temp_max_where_length = strlen(where);
-            if(temp_max_where_length > current_max_where_length)
-            {
-                current_max_where_length = temp_max_where_length;
-            }
+/**
+ * @brief Computes the identity of a module from its path.
+ * @details The identity is the 32-bit FNV-1a hash of the path, so that processes loading their modules in different orders still agree on it.
+ * @param[in] name The path of the module.
+ * @return The identity of the module, never 0 which stands for an unknown module.
+ **/
+static uint32_t MPIM_module_get_identity(const char* name)
+{
+    uint32_t hash = 2166136261u;
+    for(const char* c = name; *c != '\0'; c++)
+    {
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    }
+    return (hash == 0) ? 1 : hash;
+}
 
-            elapsed = fabs(now - MPIM_my_window_buffer_copy[i].walltime);
-            if(elapsed > 0.01)
-            {
-                snprintf(when, WHEN_LENGTH, "%.2f%s", elapsed, "s ago");
-            }
-            else
-            {
-                snprintf(when, WHEN_LENGTH, "%s", "just now");
-            }
-            temp_max_when_length = strlen(when);
-            if(temp_max_when_length > current_max_when_length)
-            {
-                current_max_when_length = temp_max_when_length;
-            }
+/**
+ * @brief Appends a loaded module to the module table, unless it is there already.
+ * @details This function is a callback for dl_iterate_phdr, called with MPIM_modules_mutex held.
+ * @param[in] info The description of the module.
+ * @param[in] size The size of the description.
+ * @param[in] data Unused.
+ * @return 0 to continue the iteration, 1 to stop it once the module table is full.
+ **/
+static int MPIM_module_register(struct dl_phdr_info* info, size_t size, void* data)
+{
+    (void)size;
+    (void)data;
+    int count = atomic_load_explicit(&MPIM_module_count, memory_order_relaxed);
+    if(count == MPIM_MAX_MODULES)
+    {
+        return 1;
+    }
+    struct MPIM_module_t* module = &MPIM_modules[count];
+    if(info->dlpi_name[0] == '\0')
+    {
+        // The main executable has no name in the list of modules
+        ssize_t length = readlink("/proc/self/exe", module->name, MPIM_MAX_FILENAME_LENGTH - 1);
+        module->name[(length < 0) ? 0 : length] = '\0';
+    }
+    else
+    {
+        strncpy(module->name, info->dlpi_name, MPIM_MAX_FILENAME_LENGTH);
+        module->name[MPIM_MAX_FILENAME_LENGTH-1] = '\0';
+    }
+    for(int i = 0; i < count; i++)
+    {
+        if(MPIM_modules[i].base == info->dlpi_addr && strcmp(MPIM_modules[i].name, module->name) == 0)
+        {
+            return 0;
         }
-
-        // Print header
-        printf("Runtime: %s%.2f seconds\n", (now - beginning) < 0.01 ? "<" : "", now - beginning);
-        print_horizontal_separator(current_max_routine_name_length, current_max_where_length, current_max_when_length);
-        printf("| %3s | %*s | %*s | %*s |\n", "Who", current_max_routine_name_length, "What", current_max_where_length, "Where", current_max_when_length + 10, "When");
-        print_horizontal_separator(current_max_routine_name_length, current_max_where_length, current_max_when_length);
-
-        // Print body
-        for(int i = 0; i < MPIM_my_comm_size; i++)
+    }
+    module->base = info->dlpi_addr;
+    module->low = UINTPTR_MAX;
+    module->high = 0;
+    for(int i = 0; i < info->dlpi_phnum; i++)
+    {
+        if(info->dlpi_phdr[i].p_type == PT_LOAD)
         {
-            elapsed = fabs(now - MPIM_my_window_buffer_copy[i].walltime);
-            if(elapsed > 0.01)
+            uintptr_t low = info->dlpi_addr + info->dlpi_phdr[i].p_vaddr;
+            uintptr_t high = low + info->dlpi_phdr[i].p_memsz;
+            if(low < module->low)
             {
-                snprintf(when, WHEN_LENGTH, "%.2f%s", elapsed, "s ago");
+                module->low = low;
             }
-            else
+            if(high > module->high)
             {
-                snprintf(when, WHEN_LENGTH, "%s", "just now");
+                module->high = high;
             }
-            snprintf(where, WHERE_LENGTH, "%s:%d", MPIM_my_window_buffer_copy[i].file, MPIM_my_window_buffer_copy[i].line);
-            printf("| %3d | %*s | %*s | %9s %*s |\n", i,
-                                            current_max_routine_name_length,
-                                            MPIM_routine_name_t[MPIM_my_window_buffer_copy[i].type],
-                                            current_max_where_length,
-                                            where,
-                                            (MPIM_my_window_buffer_copy[i].before) ? "started" : "completed",
-                                            current_max_when_length,
-                                            when);
         }
-
-        // Print footer
-        print_horizontal_separator(current_max_routine_name_length, current_max_where_length, current_max_when_length);
-
-        // Wait for 1 sec before next round
-        now = MPIM_get_time();
-        if((now - past) < refresh_time)
-        {
-            MPIM_sleep((refresh_time - (now - past)) * 1000);
-        }
-        past = now;
     }
-
-    return NULL;
+    module->identity = MPIM_module_get_identity(module->name);
+    atomic_store_explicit(&MPIM_module_count, count + 1, memory_order_release);
+    return 0;
 }
 
-int MPIM_Abort(MPI_Comm communicator, int error_code, char* file, int line, const char* args)
+/**
+ * @brief Appends the modules loaded since the last call to the module table.
+ * @details Entries are never removed nor overwritten, so that threads read the table without locking while it grows.
+ **/
+static void MPIM_modules_load()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ABORT, file, line, args);
-    int result = MPI_Abort(communicator, error_code);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ABORT, file, line, args);
-    return result;
+    pthread_mutex_lock(&MPIM_modules_mutex);
+    dl_iterate_phdr(MPIM_module_register, NULL);
+    pthread_mutex_unlock(&MPIM_modules_mutex);
 }
 
-int MPIM_Accumulate(const void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Op operation, MPI_Win window, char* file, int line, const char* args)
+/**
+ * @brief Finds the module containing an address.
+ * @details Modules are scanned from the most recently loaded, so that a library loaded where another was unloaded takes precedence.
+ * @param[in] address The address to locate.
+ * @return The index of the module in the module table, -1 if no module contains the address.
+ **/
+static int MPIM_module_find(uintptr_t address)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ACCUMULATE, file, line, args);
-    int result = MPI_Accumulate(origin_address, origin_count, origin_datatype, target_rank, target_displacement, target_count, target_datatype, operation, window);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ACCUMULATE, file, line, args);
-    return result;
+    for(int i = atomic_load_explicit(&MPIM_module_count, memory_order_acquire) - 1; i >= 0; i--)
+    {
+        if(MPIM_modules[i].low <= address && address < MPIM_modules[i].high)
+        {
+            return i;
+        }
+    }
+    return -1;
 }
 
-int MPIM_Allgather(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Finds the module containing an address, reloading the module table if the address belongs to a library loaded since.
+ * @param[in] address The address to locate.
+ * @return The index of the module in the module table, -1 if no module contains the address.
+ **/
+static int MPIM_module_locate(uintptr_t address)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ALLGATHER, file, line, args);
-    int result = MPI_Allgather(buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ALLGATHER, file, line, args);
-    return result;
+    int module = MPIM_module_find(address);
+    if(module == -1)
+    {
+        MPIM_modules_load();
+        module = MPIM_module_find(address);
+    }
+    return module;
 }
 
-int MPIM_Allgatherv(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Finds the module of this process that has a given identity.
+ * @details Only reads the module table, so that it can be called from a signal handler.
+ * @param[in] identity The identity of the module.
+ * @return The index of the module in the module table, -1 if this process has not loaded it.
+ **/
+static int MPIM_module_find_identity(uint32_t identity)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ALLGATHERV, file, line, args);
-    int result = MPI_Allgatherv(buffer_send, count_send, datatype_send, buffer_recv, counts_recv, displacements, datatype_recv, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ALLGATHERV, file, line, args);
-    return result;
+    for(int i = atomic_load_explicit(&MPIM_module_count, memory_order_acquire) - 1; i >= 0; i--)
+    {
+        if(MPIM_modules[i].identity == identity)
+        {
+            return i;
+        }
+    }
+    return -1;
 }
 
-int MPIM_Allreduce(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Fills the callsite fields in the MPI monitoring message.
+ * @details Only the identity of the module and the offset are recorded; symbolisation is left to the aggregator. The module containing a return address is looked up once and then cached.
+ * @param[inout] message The MPI monitoring message.
+ * @param[in] callsite The return address of the MPIM_ routine issuing the message.
+ **/
+static void MPIM_message_set_callsite(struct MPIM_message_t* message, const void* callsite)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ALLREDUCE, file, line, args);
-    int result = MPI_Allreduce(send_buffer, receive_buffer, count, datatype, operation, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ALLREDUCE, file, line, args);
-    return result;
+    uintptr_t address = (uintptr_t)callsite;
+    struct MPIM_callsite_cache_entry_t* entry = &MPIM_callsite_cache[(address >> 4) % MPIM_CALLSITE_CACHE_SIZE];
+    if(entry->address != address)
+    {
+        // The callsite may belong to a library loaded after MPI_Init
+        entry->address = address;
+        entry->module = MPIM_module_locate(address);
+    }
+    message->callsite_module = (entry->module == -1) ? 0 : MPIM_modules[entry->module].identity;
+    message->callsite_offset = (entry->module == -1) ? address : address - MPIM_modules[entry->module].base;
 }
 
-int MPIM_Alltoall(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Ignores the errors of libbacktrace, such as a module without debugging information, which only leave a symbol unknown.
+ * @param[in] data Unused.
+ * @param[in] message Unused.
+ * @param[in] error Unused.
+ **/
+static void MPIM_backtrace_error(void* data, const char* message, int error)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ALLTOALL, file, line, args);
-    int result = MPI_Alltoall(buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ALLTOALL, file, line, args);
-    return result;
+    (void)data;
+    (void)message;
+    (void)error;
 }
 
-int MPIM_Alltoallv(void* buffer_send, const int* counts_send, const int* displacements_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Keeps the source file, line and function of an address, as given by libbacktrace.
+ * @details This function is a callback for backtrace_pcinfo, called once per inlined function from the innermost; only the innermost one is kept.
+ * @param[out] data The struct MPIM_symbol_information_t to fill.
+ * @param[in] address Unused.
+ * @param[in] file The source file, NULL if unknown.
+ * @param[in] line The line in the source file.
+ * @param[in] function The function, NULL if unknown.
+ * @return 1, to stop at the innermost function.
+ **/
+static int MPIM_backtrace_line(void* data, uintptr_t address, const char* file, int line, const char* function)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ALLTOALLV, file, line, args);
-    int result = MPI_Alltoallv(buffer_send, counts_send, displacements_send, datatype_send, buffer_recv, counts_recv, displacements_recv, datatype_recv, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ALLTOALLV, file, line, args);
-    return result;
+    (void)address;
+    struct MPIM_symbol_information_t* information = data;
+    if(file != NULL)
+    {
+        const char* basename = strrchr(file, '/');
+        snprintf(information->file, MPIM_MAX_SYMBOL_LENGTH, "%s", (basename == NULL) ? file : basename + 1);
+        information->line = line;
+    }
+    if(function != NULL)
+    {
+        snprintf(information->function, MPIM_MAX_SYMBOL_LENGTH, "%s", function);
+    }
+    return 1;
 }
 
-int MPIM_Barrier(MPI_Comm comm, char* file, int line, const char* args)
+/**
+ * @brief Keeps the function of an address, as given by the symbol table when there is no line table.
+ * @details This function is a callback for backtrace_syminfo.
+ * @param[out] data The struct MPIM_symbol_information_t to fill.
+ * @param[in] address Unused.
+ * @param[in] symbol The symbol containing the address, NULL if unknown.
+ * @param[in] value Unused.
+ * @param[in] size Unused.
+ **/
+static void MPIM_backtrace_symbol(void* data, uintptr_t address, const char* symbol, uintptr_t value, uintptr_t size)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_BARRIER, file, line, args);
-    int result = MPI_Barrier(comm);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_BARRIER, file, line, args);
-    return result;
+    (void)address;
+    (void)value;
+    (void)size;
+    struct MPIM_symbol_information_t* information = data;
+    if(symbol != NULL)
+    {
+        snprintf(information->function, MPIM_MAX_SYMBOL_LENGTH, "%s", symbol);
+    }
 }
 
-int MPIM_Bcast(void* buffer, int count, MPI_Datatype datatype, int emitter_rank, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Symbolises an address of a module with libbacktrace, which reads the debugging information of the modules of this process without leaving it.
+ * @details The module is looked up by identity among those loaded by the aggregator, which must therefore have loaded it too.
+ * @param[in] format MPIM_SYMBOL_CALLSITE to give the source file, or the function if the source file cannot be found; MPIM_SYMBOL_FRAME to give "function() (file:line)".
+ * @param[in] identity The identity of the module containing the address.
+ * @param[in] offset The offset of the address from the load base of the module, a return address pointing past its call instruction.
+ * @param[out] symbol The buffer receiving the symbol.
+ * @param[in] symbol_length The size of the symbol buffer.
+ **/
+static void MPIM_address_symbolise(enum MPIM_symbol_format_t format, uint32_t identity, uint64_t offset, char* symbol, int symbol_length)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_BCAST, file, line, args);
-    int result = MPI_Bcast(buffer, count, datatype, emitter_rank, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_BCAST, file, line, args);
-    return result;
-}
+    int module = MPIM_module_find_identity(identity);
+    if(module == -1)
+    {
+        MPIM_modules_load();
+        module = MPIM_module_find_identity(identity);
+        if(module == -1)
+        {
+            snprintf(symbol, symbol_length, "module-%08" PRIx32 "+0x%" PRIx64, identity, offset);
+            return;
+        }
+    }
 
-int MPIM_Bsend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_BSEND, file, line, args);
-    int result = MPI_Bsend(buffer, count, type, dst, tag, comm);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_BSEND, file, line, args);
-    return result;
-}
+    // The return address points past the call instruction, step back into it to get the line of the call
+    struct MPIM_symbol_information_t information = { "", "", 0 };
+    uintptr_t address = MPIM_modules[module].base + offset - 1;
+    if(MPIM_backtrace_state != NULL)
+    {
+        backtrace_pcinfo(MPIM_backtrace_state, address, MPIM_backtrace_line, MPIM_backtrace_error, &information);
+        if(information.function[0] == '\0')
+        {
+            backtrace_syminfo(MPIM_backtrace_state, address, MPIM_backtrace_symbol, MPIM_backtrace_error, &information);
+        }
+    }
 
-int MPIM_Bsend_init(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_BSEND_INIT, file, line, args);
-    int result = MPI_Bsend_init(buffer, count, type, dst, tag, comm, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_BSEND_INIT, file, line, args);
-    return result;
+    const char* module_name = MPIM_modules[module].name;
+    const char* module_basename = strrchr(module_name, '/');
+    module_basename = (module_basename == NULL) ? module_name : module_basename + 1;
+    if(format == MPIM_SYMBOL_CALLSITE && information.file[0] != '\0')
+    {
+        snprintf(symbol, symbol_length, "%s", information.file);
+    }
+    else if(format == MPIM_SYMBOL_FRAME && information.function[0] != '\0' && information.file[0] != '\0')
+    {
+        snprintf(symbol, symbol_length, "%s() (%s:%d)", information.function, information.file, information.line);
+    }
+    else if(format == MPIM_SYMBOL_FRAME && information.function[0] != '\0')
+    {
+        snprintf(symbol, symbol_length, "%s() (%s)", information.function, module_basename);
+    }
+    else if(information.function[0] != '\0')
+    {
+        snprintf(symbol, symbol_length, "%s()", information.function);
+    }
+    else
+    {
+        snprintf(symbol, symbol_length, "%s+0x%" PRIx64, module_basename, offset);
+    }
 }
 
-int MPIM_Cancel(MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Symbolises an address through a cache.
+ * @param[inout] cache The cache, made of MPIM_SYMBOL_CACHE_SIZE entries, all holding symbols in the same format.
+ * @param[in] format The format of the symbols of the cache.
+ * @param[in] module The identity of the module containing the address.
+ * @param[in] offset The offset of the address in its module.
+ * @param[out] symbol A buffer of MPIM_MAX_SYMBOL_LENGTH characters, used only if the cache is full.
+ * @return The symbol.
+ **/
+static const char* MPIM_symbol_cache_get(struct MPIM_symbol_cache_entry_t* cache, enum MPIM_symbol_format_t format, uint32_t module, uint64_t offset, char* symbol)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_CANCEL, file, line, args);
-    int result = MPI_Cancel(request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_CANCEL, file, line, args);
-    return result; 
+    uint64_t hash = (offset * 0x9E3779B97F4A7C15ULL) ^ (uint64_t)module;
+    int bucket = (int)(hash % MPIM_SYMBOL_CACHE_SIZE);
+    for(int probe = 0; probe < MPIM_SYMBOL_CACHE_SIZE; probe++)
+    {
+        struct MPIM_symbol_cache_entry_t* entry = &cache[(bucket + probe) % MPIM_SYMBOL_CACHE_SIZE];
+        if(!entry->used)
+        {
+            entry->used = true;
+            entry->module = module;
+            entry->offset = offset;
+            MPIM_address_symbolise(format, entry->module, entry->offset, entry->symbol, MPIM_MAX_SYMBOL_LENGTH);
+        }
+        if(entry->module == module && entry->offset == offset)
+        {
+            return entry->symbol;
+        }
+    }
+
+    // The cache is full, symbolise without caching
+    MPIM_address_symbolise(format, module, offset, symbol, MPIM_MAX_SYMBOL_LENGTH);
+    return symbol;
 }
 
-int MPIM_Cart_coords(MPI_Comm communicator, int rank, int dimension_number, int* coords, char* file, int line, const char* args)
+/**
+ * @brief Writes the location of a callsite, in the form "where:line".
+ * @details Callsites are symbolised lazily, only once they are displayed, and the result is cached.
+ * @param[in] module The identity of the module containing the callsite, 0 if unknown.
+ * @param[in] offset The offset of the callsite in its module.
+ * @param[in] line The line of the callsite in its source file.
+ * @param[out] where The buffer receiving the location.
+ * @param[in] where_length The size of the where buffer.
+ **/
+static void MPIM_callsite_get_where(uint32_t module, uint64_t offset, int line, char* where, int where_length)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_CART_COORDS, file, line, args);
-    int result = MPI_Cart_coords(communicator, rank, dimension_number, coords);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_CART_COORDS, file, line, args);
-    return result;
+    if(module == 0)
+    {
+        snprintf(where, where_length, "-:%d", line);
+        return;
+    }
+
+    char symbol[MPIM_MAX_SYMBOL_LENGTH];
+    snprintf(where, where_length, "%s:%d", MPIM_symbol_cache_get(MPIM_symbol_cache, MPIM_SYMBOL_CALLSITE, module, offset, symbol), line);
 }
 
-int MPIM_Cart_create(MPI_Comm old_communicator, int dimension_number, const int* dimensions, const int* periods, int reorder, MPI_Comm* new_communicator, char* file, int line, const char* args)
+/**
+ * @brief Writes the location of the MPI call described by a message, in the form "where:line".
+ * @param[in] message The MPI monitoring message.
+ * @param[out] where The buffer receiving the location.
+ * @param[in] where_length The size of the where buffer.
+ **/
+static void MPIM_message_get_where(const struct MPIM_message_t* message, char* where, int where_length)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_CART_CREATE, file, line, args);
-    int result = MPI_Cart_create(old_communicator, dimension_number, dimensions, periods, reorder, new_communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_CART_CREATE, file, line, args);
-    return result;
+    MPIM_callsite_get_where(message->callsite_module, message->callsite_offset, message->line, where, where_length);
 }
 
-int MPIM_Cart_get(MPI_Comm communicator, int dimension_number, int* dimensions, int* periods, int* coords, char* file, int line, const char* args)
+/**
+ * @brief Gives the size of a datatype.
+ * @details Sizes are cached per thread, the cache being invalidated whenever a datatype is freed.
+ * @param[in] datatype The datatype, which can be MPI_DATATYPE_NULL.
+ * @return The size of the datatype in bytes, 0 for MPI_DATATYPE_NULL.
+ **/
+static inline int32_t MPIM_datatype_get_size(MPI_Datatype datatype)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_CART_GET, file, line, args);
-    int result = MPI_Cart_get(communicator, dimension_number, dimensions, periods, coords);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_CART_GET, file, line, args);
-    return result;
+    if(datatype == MPI_DATATYPE_NULL)
+    {
+        return 0;
+    }
+
+    unsigned int generation = atomic_load_explicit(&MPIM_datatype_generation, memory_order_relaxed);
+    struct MPIM_datatype_cache_entry_t* entry = &MPIM_datatype_cache[((uintptr_t)datatype >> 4) % MPIM_DATATYPE_CACHE_SIZE];
+    if(entry->generation != generation || entry->datatype != datatype)
+    {
+        int size = 0;
+        MPI_Type_size(datatype, &size);
+        entry->datatype = datatype;
+        entry->size = size;
+        entry->generation = generation;
+    }
+    return entry->size;
 }
 
-int MPIM_Cart_shift(MPI_Comm communicator, int direction, int displacement, int* source, int* destination, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of a routine for which no argument is recorded.
+ * @details Every field is zeroed, padding included, so that the arguments compare, trace and publish the same whatever the stack held; the other builders start from these.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_none()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_CART_SHIFT, file, line, args);
-    int result = MPI_Cart_shift(communicator, direction, displacement, source, destination);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_CART_SHIFT, file, line, args);
-    return result;
+    struct MPIM_arguments_t arguments;
+    memset(&arguments, 0, sizeof(arguments));
+    arguments.kind = MPIM_ARGUMENTS_NONE;
+    return arguments;
 }
 
-int MPIM_Comm_create(MPI_Comm old_communicator, MPI_Group group, MPI_Comm* new_communicator, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of a routine for which only the communicator is recorded.
+ * @param[in] communicator The communicator.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_communicator(MPI_Comm communicator)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_COMM_CREATE, file, line, args);
-    int result = MPI_Comm_create(old_communicator, group, new_communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_COMM_CREATE, file, line, args);
-    return result;
+    struct MPIM_arguments_t arguments = MPIM_arguments_none();
+    arguments.kind = MPIM_ARGUMENTS_COMMUNICATOR;
+    arguments.communicator = MPI_Comm_c2f(communicator);
+    return arguments;
 }
 
-int MPIM_Comm_get_name(MPI_Comm communicator, char* name, int* length, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of a point-to-point routine.
+ * @param[in] kind MPIM_ARGUMENTS_SEND or MPIM_ARGUMENTS_RECEIVE.
+ * @param[in] peer The destination or the source.
+ * @param[in] tag The tag.
+ * @param[in] communicator The communicator.
+ * @param[in] count The number of elements.
+ * @param[in] datatype The datatype of the elements.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_p2p(enum MPIM_arguments_kind_t kind, int peer, int tag, MPI_Comm communicator, int count, MPI_Datatype datatype)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_COMM_GET_NAME, file, line, args);
-    int result = MPI_Comm_get_name(communicator, name, length);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_COMM_GET_NAME, file, line, args);
-    return result;
+    struct MPIM_arguments_t arguments = MPIM_arguments_none();
+    arguments.kind = kind;
+    arguments.communicator = MPI_Comm_c2f(communicator);
+    arguments.count = count;
+    arguments.datatype_size = MPIM_datatype_get_size(datatype);
+    arguments.p2p.peer = peer;
+    arguments.p2p.tag = tag;
+    return arguments;
 }
 
-int MPIM_Comm_get_parent(MPI_Comm* parent, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of a point-to-point send routine.
+ * @param[in] destination The destination.
+ * @param[in] tag The tag.
+ * @param[in] communicator The communicator.
+ * @param[in] count The number of elements.
+ * @param[in] datatype The datatype of the elements.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_send(int destination, int tag, MPI_Comm communicator, int count, MPI_Datatype datatype)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_COMM_GET_PARENT, file, line, args);
-    int result = MPI_Comm_get_parent(parent);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_COMM_GET_PARENT, file, line, args);
-    return result;
+    return MPIM_arguments_p2p(MPIM_ARGUMENTS_SEND, destination, tag, communicator, count, datatype);
 }
 
-int MPIM_Comm_group(MPI_Comm communicator, MPI_Group* group, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of a point-to-point receive routine.
+ * @param[in] source The source.
+ * @param[in] tag The tag.
+ * @param[in] communicator The communicator.
+ * @param[in] count The number of elements.
+ * @param[in] datatype The datatype of the elements.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_receive(int source, int tag, MPI_Comm communicator, int count, MPI_Datatype datatype)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_COMM_GROUP, file, line, args);
-    int result = MPI_Comm_group(communicator, group);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_COMM_GROUP, file, line, args);
-    return result;
+    return MPIM_arguments_p2p(MPIM_ARGUMENTS_RECEIVE, source, tag, communicator, count, datatype);
 }
 
-int MPIM_Comm_rank(MPI_Comm communicator, int* rank, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of a combined send and receive routine.
+ * @param[in] destination The destination.
+ * @param[in] send_tag The tag of the message sent.
+ * @param[in] source The source.
+ * @param[in] receive_tag The tag of the message received.
+ * @param[in] communicator The communicator.
+ * @param[in] count The number of elements sent.
+ * @param[in] datatype The datatype of the elements sent.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_sendrecv(int destination, int send_tag, int source, int receive_tag, MPI_Comm communicator, int count, MPI_Datatype datatype)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_COMM_RANK, file, line, args);
-    int result = MPI_Comm_rank(communicator, rank);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_COMM_RANK, file, line, args);
-    return result;
+    struct MPIM_arguments_t arguments = MPIM_arguments_none();
+    arguments.kind = MPIM_ARGUMENTS_SENDRECV;
+    arguments.communicator = MPI_Comm_c2f(communicator);
+    arguments.count = count;
+    arguments.datatype_size = MPIM_datatype_get_size(datatype);
+    arguments.sendrecv.destination = destination;
+    arguments.sendrecv.send_tag = send_tag;
+    arguments.sendrecv.source = source;
+    arguments.sendrecv.receive_tag = receive_tag;
+    return arguments;
 }
 
-int MPIM_Comm_set_name(MPI_Comm communicator, const char* name, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of a collective routine without root.
+ * @param[in] communicator The communicator.
+ * @param[in] count The number of elements, MPIM_VARIABLE_COUNT if it differs from one process to the other.
+ * @param[in] datatype The datatype of the elements.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_collective(MPI_Comm communicator, int count, MPI_Datatype datatype)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_COMM_SET_NAME, file, line, args);
-    int result = MPI_Comm_set_name(communicator, name);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_COMM_SET_NAME, file, line, args);
-    return result;
+    struct MPIM_arguments_t arguments = MPIM_arguments_none();
+    arguments.kind = MPIM_ARGUMENTS_COLLECTIVE;
+    arguments.communicator = MPI_Comm_c2f(communicator);
+    arguments.count = count;
+    arguments.datatype_size = MPIM_datatype_get_size(datatype);
+    return arguments;
 }
 
-int MPIM_Comm_size(MPI_Comm communicator, int* size, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of a collective routine with a root.
+ * @param[in] root The root.
+ * @param[in] communicator The communicator.
+ * @param[in] count The number of elements, MPIM_VARIABLE_COUNT if it differs from one process to the other.
+ * @param[in] datatype The datatype of the elements.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_rooted_collective(int root, MPI_Comm communicator, int count, MPI_Datatype datatype)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_COMM_SIZE, file, line, args);
-    int result = MPI_Comm_size(communicator, size);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_COMM_SIZE, file, line, args);
-    return result;
+    struct MPIM_arguments_t arguments = MPIM_arguments_collective(communicator, count, datatype);
+    arguments.kind = MPIM_ARGUMENTS_ROOTED_COLLECTIVE;
+    arguments.collective.root = root;
+    return arguments;
 }
 
-int MPIM_Comm_spawn(const char* command, char** arguments, int max_process_number, MPI_Info info, int root, MPI_Comm intracommunicator, MPI_Comm* intercommunicator, int* error_codes, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of a one-sided communication routine, or of a synchronisation routine with a target.
+ * @param[in] target The target.
+ * @param[in] count The number of elements on the origin side, 0 for synchronisation routines.
+ * @param[in] datatype The datatype of the elements on the origin side, MPI_DATATYPE_NULL for synchronisation routines.
+ * @param[in] window The window.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_rma(int target, int count, MPI_Datatype datatype, MPI_Win window)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_COMM_SPAWN, file, line, args);
-    int result = MPI_Comm_spawn(command, arguments, max_process_number, info, root, intracommunicator, intercommunicator, error_codes);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_COMM_SPAWN, file, line, args);
-    return result;
+    struct MPIM_arguments_t arguments = MPIM_arguments_none();
+    arguments.kind = MPIM_ARGUMENTS_RMA;
+    arguments.count = count;
+    arguments.datatype_size = MPIM_datatype_get_size(datatype);
+    arguments.rma.target = target;
+    arguments.rma.window = MPI_Win_c2f(window);
+    return arguments;
 }
 
-int MPIM_Comm_split(MPI_Comm old_communicator, int colour, int key, MPI_Comm* new_communicator, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of a one-sided synchronisation routine covering every target of a window.
+ * @param[in] window The window.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_window(MPI_Win window)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_COMM_SPLIT, file, line, args);
-    int result = MPI_Comm_split(old_communicator, colour, key, new_communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_COMM_SPLIT, file, line, args);
-    return result;
+    return MPIM_arguments_rma(MPIM_WHOLE_WINDOW, 0, MPI_DATATYPE_NULL, window);
 }
 
-int MPIM_Dims_create(int process_number, int dimension_number, int* dimensions, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of the receive of a message matched beforehand.
+ * @details The source, tag and communicator are those of the matched message and are not known from the arguments.
+ * @param[in] count The number of elements.
+ * @param[in] datatype The datatype of the elements.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_matched_receive(int count, MPI_Datatype datatype)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_DIMS_CREATE, file, line, args);
-    int result = MPI_Dims_create(process_number, dimension_number, dimensions);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_DIMS_CREATE, file, line, args);
-    return result;
+    struct MPIM_arguments_t arguments = MPIM_arguments_none();
+    arguments.kind = MPIM_ARGUMENTS_MATCHED_RECEIVE;
+    arguments.count = count;
+    arguments.datatype_size = MPIM_datatype_get_size(datatype);
+    return arguments;
 }
 
-int MPIM_Exscan(void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Builds the arguments of a request completion routine.
+ * @param[in] count The number of requests.
+ * @return The arguments.
+ **/
+static inline struct MPIM_arguments_t MPIM_arguments_requests(int count)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_EXSCAN, file, line, args);
-    int result = MPI_Exscan(send_buffer, receive_buffer, count, datatype, operation, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_EXSCAN, file, line, args);
-    return result;
+    struct MPIM_arguments_t arguments = MPIM_arguments_none();
+    arguments.kind = MPIM_ARGUMENTS_REQUESTS;
+    arguments.count = count;
+    return arguments;
 }
 
-int MPIM_Finalize(char* file, int line)
+/**
+ * @brief Writes the name of a communicator.
+ * @param[in] communicator The identifier of the communicator, as given by MPI_Comm_c2f.
+ * @param[out] name The buffer receiving the name.
+ * @param[in] name_length The size of the name buffer.
+ **/
+static void MPIM_communicator_get_name(int32_t communicator, char* name, int name_length)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_FINALISED, file, line, "");
-    MPI_Win_unlock(0, MPIM_my_window);
-    MPI_Barrier(MPI_COMM_WORLD);
-    if(MPIM_my_rank == 0)
+    if(communicator == MPI_Comm_c2f(MPI_COMM_WORLD))
     {
-        pthread_join(MPIM_manager_thread, NULL);
+        snprintf(name, name_length, "world");
+    }
+    else if(communicator == MPI_Comm_c2f(MPI_COMM_SELF))
+    {
+        snprintf(name, name_length, "self");
+    }
+    else
+    {
+        snprintf(name, name_length, "#%d", communicator);
     }
-    MPI_Win_free(&MPIM_my_window);
-    return MPI_Finalize();
 }
 
-int MPIM_Gather(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Tells whether the arguments of a call record its communicator.
+ * @param[in] arguments The arguments.
+ * @return true if the communicator field is meaningful, false otherwise.
+ **/
+static bool MPIM_arguments_has_communicator(const struct MPIM_arguments_t* arguments)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_GATHER, file, line, args);
-    int result = MPI_Gather(buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_GATHER, file, line, args);
-    return result;
+    switch(arguments->kind)
+    {
+        case MPIM_ARGUMENTS_COMMUNICATOR:
+        case MPIM_ARGUMENTS_SEND:
+        case MPIM_ARGUMENTS_RECEIVE:
+        case MPIM_ARGUMENTS_SENDRECV:
+        case MPIM_ARGUMENTS_COLLECTIVE:
+        case MPIM_ARGUMENTS_ROOTED_COLLECTIVE:
+            return true;
+        default:
+            return false;
+    }
 }
 
-int MPIM_Gatherv(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Writes a rank, which may be a wildcard.
+ * @param[in] rank The rank.
+ * @param[out] text The buffer receiving the rank.
+ * @param[in] text_length The size of the text buffer.
+ **/
+static void MPIM_rank_get_name(int32_t rank, char* text, int text_length)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_GATHERV, file, line, args);
-    int result = MPI_Gatherv(buffer_send, count_send, datatype_send, buffer_recv, counts_recv, displacements, datatype_recv, root, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_GATHERV, file, line, args);
-    return result;
+    if(rank == MPI_ANY_SOURCE)
+    {
+        snprintf(text, text_length, "any");
+    }
+    else if(rank == MPI_PROC_NULL)
+    {
+        snprintf(text, text_length, "null");
+    }
+    else
+    {
+        snprintf(text, text_length, "%d", rank);
+    }
 }
 
-int MPIM_Get(void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Win window, char* file, int line, const char* args)
+/**
+ * @brief Writes a tag, which may be a wildcard.
+ * @param[in] tag The tag.
+ * @param[out] text The buffer receiving the tag.
+ * @param[in] text_length The size of the text buffer.
+ **/
+static void MPIM_tag_get_name(int32_t tag, char* text, int text_length)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_GET, file, line, args);
-    int result = MPI_Get(origin_address, origin_count, origin_datatype, target_rank, target_displacement, target_count, target_datatype, window);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_GET, file, line, args);
-    return result;
+    if(tag == MPI_ANY_TAG)
+    {
+        snprintf(text, text_length, "any");
+    }
+    else
+    {
+        snprintf(text, text_length, "%d", tag);
+    }
 }
 
-int MPIM_Get_address(const void* location, MPI_Aint* address, char* file, int line, const char* args)
+/**
+ * @brief Writes the data size described by arguments, in the form "count x size B".
+ * @param[in] arguments The arguments.
+ * @param[out] text The buffer receiving the data size.
+ * @param[in] text_length The size of the text buffer.
+ **/
+static void MPIM_arguments_get_data_size(const struct MPIM_arguments_t* arguments, char* text, int text_length)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_GET_ADDRESS, file, line, args);
-    int result = MPI_Get_address(location, address);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_GET_ADDRESS, file, line, args);
-    return result;
+    if(arguments->count == MPIM_VARIABLE_COUNT)
+    {
+        snprintf(text, text_length, "variable x %d B", arguments->datatype_size);
+    }
+    else
+    {
+        snprintf(text, text_length, "%d x %d B", arguments->count, arguments->datatype_size);
+    }
 }
 
-int MPIM_Get_count(const MPI_Status* status, MPI_Datatype datatype, int* count, char* file, int line, const char* args)
+/**
+ * @brief Writes an amount of bytes with a binary unit.
+ * @param[in] bytes The amount of bytes.
+ * @param[out] text The buffer receiving the amount.
+ * @param[in] text_length The size of the text buffer.
+ **/
+static void MPIM_bytes_get_text(uint64_t bytes, char* text, int text_length)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_GET_COUNT, file, line, args);
-    int result = MPI_Get_count(status, datatype, count);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_GET_COUNT, file, line, args);
-    return result;
+    const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+    int unit = 0;
+    while(bytes >= 1024 && bytes % 1024 == 0 && unit < 4)
+    {
+        bytes /= 1024;
+        unit++;
+    }
+    snprintf(text, text_length, "%llu %s", (unsigned long long)bytes, units[unit]);
 }
 
-int MPIM_Group_difference(MPI_Group group_a, MPI_Group group_b, MPI_Group* difference_group, char* file, int line, const char* args)
+/**
+ * @brief Writes the synchronisation state of a window, in the form "access lock exclusive, exposure none, 3 pending ops (96 B)".
+ * @param[in] epoch The synchronisation state.
+ * @param[out] text The buffer receiving the state.
+ * @param[in] text_length The size of the text buffer.
+ **/
+static void MPIM_rma_epoch_get_text(const struct MPIM_rma_epoch_t* epoch, char* text, int text_length)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_GROUP_DIFFERENCE, file, line, args);
-    int result = MPI_Group_difference(group_a, group_b, difference_group);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_GROUP_DIFFERENCE, file, line, args);
-    return result;
+    char access[32];
+    if(epoch->access == MPIM_RMA_ACCESS_NONE && epoch->exposure == MPIM_RMA_EXPOSURE_NONE && epoch->pending_operations == 0)
+    {
+        snprintf(text, text_length, "closed");
+        return;
+    }
+    if(epoch->locked_targets > 1)
+    {
+        snprintf(access, sizeof(access), "%s x%u", MPIM_rma_access_name_t[epoch->access], epoch->locked_targets);
+    }
+    else
+    {
+        snprintf(access, sizeof(access), "%s", MPIM_rma_access_name_t[epoch->access]);
+    }
+    if(epoch->pending_operations == 0)
+    {
+        snprintf(text, text_length, "access %s, exposure %s", access, MPIM_rma_exposure_name_t[epoch->exposure]);
+    }
+    else
+    {
+        char bytes[32];
+        MPIM_bytes_get_text(epoch->pending_bytes, bytes, sizeof(bytes));
+        snprintf(text, text_length, "access %s, exposure %s, %u pending op%s (%s)", access, MPIM_rma_exposure_name_t[epoch->exposure], epoch->pending_operations, (epoch->pending_operations > 1) ? "s" : "", bytes);
+    }
 }
 
-int MPIM_Group_incl(MPI_Group old_group, int rank_count, const int ranks[], MPI_Group* new_group, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_GROUP_INCL, file, line, args);
-    int result = MPI_Group_incl(old_group, rank_count, ranks, new_group);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_GROUP_INCL, file, line, args);
-    return result;
-}
-
-int MPIM_Group_intersection(MPI_Group group_a, MPI_Group group_b, MPI_Group* intersection_group, char* file, int line, const char* args)
+/**
+ * @brief Writes the description of the arguments of the MPI call held in a message, along with the number of MPI calls issued so far.
+ * @param[in] message The MPI monitoring message.
+ * @param[out] details The buffer receiving the description.
+ * @param[in] details_length The size of the details buffer.
+ **/
+static void MPIM_message_get_details(const struct MPIM_message_t* message, char* details, int details_length)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_GROUP_INTERSECTION, file, line, args);
-    int result = MPI_Group_intersection(group_a, group_b, intersection_group);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_GROUP_INTERSECTION, file, line, args);
-    return result;
-}
+    if(message->switched_off)
+    {
+        snprintf(details, details_length, "monitoring switched off");
+        return;
+    }
+    if(message->unmonitored)
+    {
+        snprintf(details, details_length, "entered while monitoring was off");
+        return;
+    }
+    const struct MPIM_arguments_t* arguments = &message->arguments;
+    char communicator[16];
+    char data_size[48];
+    char peer[16];
+    char tag[16];
+    char other_peer[16];
+    char other_tag[16];
+    char description[MPIM_MAX_ARGUMENTS_LENGTH] = "";
+    switch(arguments->kind)
+    {
+        case MPIM_ARGUMENTS_COMMUNICATOR:
+            MPIM_communicator_get_name(arguments->communicator, communicator, sizeof(communicator));
+            snprintf(description, MPIM_MAX_ARGUMENTS_LENGTH, "comm %s", communicator);
+            break;
+        case MPIM_ARGUMENTS_SEND:
+        case MPIM_ARGUMENTS_RECEIVE:
+            MPIM_communicator_get_name(arguments->communicator, communicator, sizeof(communicator));
+            MPIM_arguments_get_data_size(arguments, data_size, sizeof(data_size));
+            MPIM_rank_get_name(arguments->p2p.peer, peer, sizeof(peer));
+            MPIM_tag_get_name(arguments->p2p.tag, tag, sizeof(tag));
+            snprintf(description, MPIM_MAX_ARGUMENTS_LENGTH, "%s %s, tag %s, %s, comm %s", (arguments->kind == MPIM_ARGUMENTS_SEND) ? "to" : "from", peer, tag, data_size, communicator);
+            break;
+        case MPIM_ARGUMENTS_SENDRECV:
+            MPIM_communicator_get_name(arguments->communicator, communicator, sizeof(communicator));
+            MPIM_arguments_get_data_size(arguments, data_size, sizeof(data_size));
+            MPIM_rank_get_name(arguments->sendrecv.destination, peer, sizeof(peer));
+            MPIM_tag_get_name(arguments->sendrecv.send_tag, tag, sizeof(tag));
+            MPIM_rank_get_name(arguments->sendrecv.source, other_peer, sizeof(other_peer));
+            MPIM_tag_get_name(arguments->sendrecv.receive_tag, other_tag, sizeof(other_tag));
+            snprintf(description, MPIM_MAX_ARGUMENTS_LENGTH, "to %s tag %s, from %s tag %s, %s, comm %s", peer, tag, other_peer, other_tag, data_size, communicator);
+            break;
+        case MPIM_ARGUMENTS_COLLECTIVE:
+            MPIM_communicator_get_name(arguments->communicator, communicator, sizeof(communicator));
+            MPIM_arguments_get_data_size(arguments, data_size, sizeof(data_size));
+            snprintf(description, MPIM_MAX_ARGUMENTS_LENGTH, "%s, comm %s", data_size, communicator);
+            break;
+        case MPIM_ARGUMENTS_ROOTED_COLLECTIVE:
+            MPIM_communicator_get_name(arguments->communicator, communicator, sizeof(communicator));
+            MPIM_arguments_get_data_size(arguments, data_size, sizeof(data_size));
+            snprintf(description, MPIM_MAX_ARGUMENTS_LENGTH, "root %d, %s, comm %s", arguments->collective.root, data_size, communicator);
+            break;
+        case MPIM_ARGUMENTS_RMA:
+            if(arguments->rma.target == MPIM_WHOLE_WINDOW)
+            {
+                snprintf(description, MPIM_MAX_ARGUMENTS_LENGTH, "win #%d", arguments->rma.window);
+            }
+            else if(arguments->count == 0 && arguments->datatype_size == 0)
+            {
+                // Synchronisation routines such as MPI_Win_lock only have a target
+                snprintf(description, MPIM_MAX_ARGUMENTS_LENGTH, "target %d, win #%d", arguments->rma.target, arguments->rma.window);
+            }
+            else
+            {
+                MPIM_arguments_get_data_size(arguments, data_size, sizeof(data_size));
+                snprintf(description, MPIM_MAX_ARGUMENTS_LENGTH, "target %d, %s, win #%d", arguments->rma.target, data_size, arguments->rma.window);
+            }
+            if(message->epoch.tracked)
+            {
+                size_t length = strlen(description);
+                snprintf(description + length, MPIM_MAX_ARGUMENTS_LENGTH - length, ", epoch ");
+                length = strlen(description);
+                MPIM_rma_epoch_get_text(&message->epoch, description + length, MPIM_MAX_ARGUMENTS_LENGTH - length);
+            }
+            break;
+        case MPIM_ARGUMENTS_MATCHED_RECEIVE:
+            MPIM_arguments_get_data_size(arguments, data_size, sizeof(data_size));
+            snprintf(description, MPIM_MAX_ARGUMENTS_LENGTH, "matched message, %s", data_size);
+            break;
+        case MPIM_ARGUMENTS_REQUESTS:
+            snprintf(description, MPIM_MAX_ARGUMENTS_LENGTH, "%d request%s", arguments->count, (arguments->count > 1) ? "s" : "");
+            break;
+        default:
+            break;
+    }
 
-int MPIM_Group_rank(MPI_Group group, int* rank, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_GROUP_RANK, file, line, args);
-    int result = MPI_Group_rank(group, rank);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_GROUP_RANK, file, line, args);
-    return result;
-}
+    if(message->active_persistent_requests > 0)
+    {
+        size_t length = strlen(description);
+        snprintf(description + length, MPIM_MAX_ARGUMENTS_LENGTH - length, "%s%u persistent active", (length > 0) ? ", " : "", message->active_persistent_requests);
+    }
 
-int MPIM_Group_size(MPI_Group group, int* size, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_GROUP_SIZE, file, line, args);
-    int result = MPI_Group_size(group, size);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_GROUP_SIZE, file, line, args);
-    return result;
+    if(message->call_count == 0)
+    {
+        snprintf(details, details_length, "%s", description);
+    }
+    else if(description[0] == '\0')
+    {
+        snprintf(details, details_length, "call %llu", (unsigned long long)message->call_count);
+    }
+    else
+    {
+        snprintf(details, details_length, "call %llu: %s", (unsigned long long)message->call_count, description);
+    }
 }
 
-int MPIM_Group_union(MPI_Group group_a, MPI_Group group_b, MPI_Group* union_group, char* file, int line, const char* args)
+/**
+ * @brief Gives the slot of the calling thread in the window of the coordinator process.
+ * @details Threads are given a slot the first time they issue an MPI call. Threads beyond the number of slots per process get none rather than sharing one, since their puts to a shared slot would conflict; the first of them reports it.
+ * @return The index of the slot in the window, -1 if the thread has no slot.
+ **/
+static int MPIM_get_my_slot()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_GROUP_UNION, file, line, args);
-    int result = MPI_Group_union(group_a, group_b, union_group);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_GROUP_UNION, file, line, args);
-    return result;
+    if(MPIM_my_thread_slot == -1)
+    {
+        int thread_slot = atomic_fetch_add(&MPIM_thread_count, 1);
+        if(thread_slot >= MPIM_threads_per_process)
+        {
+            MPIM_my_thread_slot = MPIM_NO_SLOT;
+            if(thread_slot == MPIM_threads_per_process)
+            {
+                printf("MPI_monitor: process %d has more threads issuing MPI calls than its %d slots, raise MPIM_THREADS_PER_PROCESS to monitor the threads beyond.\n", MPIM_my_rank, MPIM_threads_per_process);
+            }
+        }
+        else
+        {
+            MPIM_my_thread_slot = thread_slot;
+            if(MPIM_thread_states != NULL)
+            {
+                MPIM_thread_states[MPIM_my_thread_slot].thread = pthread_self();
+            }
+            if(MPIM_unmonitored_calls != NULL)
+            {
+                MPIM_my_unmonitored_call = &MPIM_unmonitored_calls[MPIM_my_thread_slot];
+            }
+            // The aggregator reads the slots of the process up to the highest one claimed, which happens once per thread
+            int claimed_slot_count = thread_slot + 1;
+            MPI_Aint displacement = MPIM_window_padding + (MPI_Aint)MPIM_my_comm_size * MPIM_threads_per_process * sizeof(struct MPIM_message_t) + (MPI_Aint)MPIM_my_rank * sizeof(int);
+            MPI_Accumulate(&claimed_slot_count, 1, MPI_INT, 0, displacement, 1, MPI_INT, MPI_MAX, MPIM_my_window);
+            MPI_Win_flush(0, MPIM_my_window);
+        }
+    }
+    return (MPIM_my_thread_slot == MPIM_NO_SLOT) ? -1 : MPIM_my_rank * MPIM_threads_per_process + MPIM_my_thread_slot;
 }
 
-int MPIM_Iallgather(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Reports how many threads issued MPI calls without a slot, summed over the processes.
+ * @details Must be called collectively. Nothing is printed if every thread had a slot.
+ **/
+static void MPIM_slots_report()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IALLGATHER, file, line, args);
-    int result = MPI_Iallgather(buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IALLGATHER, file, line, args);
-    return result;
+    int local_count = atomic_load(&MPIM_thread_count) - MPIM_threads_per_process;
+    int overflow[2] = { (local_count > 0) ? local_count : 0, (local_count > 0) ? 1 : 0 };
+    int total[2] = { 0, 0 };
+    MPI_Reduce(overflow, total, 2, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    if(MPIM_my_rank == 0 && total[0] > 0)
+    {
+        printf("\nMPI_monitor: %d threads over %d processes issued MPI calls without a slot, as MPIM_THREADS_PER_PROCESS is %d; their calls were neither displayed nor checked for stalls.\n", total[0], total[1], MPIM_threads_per_process);
+    }
 }
 
-int MPIM_Iallgatherv(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Computes the checksum of a message, over every field before the checksum itself.
+ * @details Mixes whole 64-bit words, the unit that accumulates write atomically, so that it costs a few dozen multiplications per update.
+ * @param[in] message The message.
+ * @return The checksum.
+ **/
+static uint64_t MPIM_message_get_checksum(const struct MPIM_message_t* message)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IALLGATHERV, file, line, args);
-    int result = MPI_Iallgatherv(buffer_send, count_send, datatype_send, buffer_recv, counts_recv, displacements, datatype_recv, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IALLGATHERV, file, line, args);
-    return result;
+    uint64_t hash = 14695981039346656037ull;
+    for(size_t i = 0; i < offsetof(struct MPIM_message_t, checksum); i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, (const char*)message + i, sizeof(uint64_t));
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    return hash;
 }
 
-int MPIM_Iallreduce(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Propagates an update to the coordinator process
+ * @details The file name is not sent: the callsite identifies it and is symbolised by the aggregator.
+ * The message is written with an accumulate replacing the slot word by word rather than with a put: MPI applies the accumulates of a process to the same words in the order they were issued, so that an older update never overwrites a newer one, even when neither was flushed.
+ * The message is put from the outbox of the thread, since MPI may read it until the put completes locally; the outbox is flushed locally once full, so that at most MPIM_OUTBOX_SIZE updates are in flight.
+ * @param[in] message The message containing the update.
+ * @param[in] callsite The return address of the MPIM_ routine issuing the message.
+ * @param[in] line The line at which the MPI call is issued.
+ * @param[in] flush Indicates if the update must have reached the coordinator when returning.
+ **/
+static void MPIM_send_update(struct MPIM_message_t* message, const void* callsite, int line, bool flush)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IALLREDUCE, file, line, args);
-    int result = MPI_Iallreduce(send_buffer, receive_buffer, count, datatype, operation, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IALLREDUCE, file, line, args);
-    return result;
+    int slot = MPIM_get_my_slot();
+    if(slot == -1)
+    {
+        return;
+    }
+    MPIM_message_set_callsite(message, callsite);
+    message->line = line;
+    message->timestamp = MPIM_get_timestamp();
+    message->sequence = atomic_fetch_add_explicit(&MPIM_update_sequence, 1, memory_order_relaxed) + 1;
+    message->checksum = MPIM_message_get_checksum(message);
+    if(MPIM_my_outbox_count == MPIM_OUTBOX_SIZE)
+    {
+        MPI_Win_flush_local(0, MPIM_my_window);
+        MPIM_my_outbox_count = 0;
+    }
+    struct MPIM_message_t* outgoing = &MPIM_my_outbox[MPIM_my_outbox_count++];
+    *outgoing = *message;
+    MPI_Accumulate(outgoing, MPIM_MESSAGE_WORDS, MPI_UINT64_T, 0, MPIM_window_padding + (MPI_Aint)slot * sizeof(struct MPIM_message_t), MPIM_MESSAGE_WORDS, MPI_UINT64_T, MPI_REPLACE, MPIM_my_window);
+    if(flush)
+    {
+        // Remote completion implies local completion, the whole outbox is free again
+        MPI_Win_flush(0, MPIM_my_window);
+        MPIM_my_outbox_count = 0;
+    }
 }
 
-int MPIM_Ialltoall(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Gives the bucket in which a value falls, buckets being powers of two.
+ * @details Bucket 0 holds 0, bucket b holds the values in [2^(b-1), 2^b), the last bucket holding everything larger.
+ * @param[in] value The value.
+ * @param[in] bucket_count The number of buckets.
+ * @return The bucket index.
+ **/
+static inline int MPIM_histogram_get_bucket(uint64_t value, int bucket_count)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IALLTOALL, file, line, args);
-    int result = MPI_Ialltoall(buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IALLTOALL, file, line, args);
-    return result;
+    int bucket = (value == 0) ? 0 : 64 - __builtin_clzll(value);
+    return (bucket < bucket_count) ? bucket : bucket_count - 1;
 }
 
-int MPIM_Ialltoallv(void* buffer_send, const int* counts_send, const int* displacements_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Gives the profile of the calling thread, allocating and registering it on the first call.
+ * @details Only the registration takes a lock, so that threads never contend when recording their calls.
+ * @return The profile of the calling thread.
+ **/
+static struct MPIM_thread_profile_t* MPIM_get_my_profile()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IALLTOALLV, file, line, args);
-    int result = MPI_Ialltoallv(buffer_send, counts_send, displacements_send, datatype_send, buffer_recv, counts_recv, displacements_recv, datatype_recv, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IALLTOALLV, file, line, args);
-    return result;
+    if(MPIM_my_profile == NULL)
+    {
+        MPIM_my_profile = (struct MPIM_thread_profile_t*)calloc(1, sizeof(struct MPIM_thread_profile_t));
+        if(MPIM_my_profile == NULL)
+        {
+            printf("Failure in allocating the profile of a thread.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        pthread_mutex_lock(&MPIM_thread_profiles_mutex);
+        MPIM_my_profile->next = MPIM_thread_profiles;
+        MPIM_thread_profiles = MPIM_my_profile;
+        pthread_mutex_unlock(&MPIM_thread_profiles_mutex);
+    }
+    return MPIM_my_profile;
 }
 
-int MPIM_Ibarrier(MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Records the duration of a call in the histogram of its MPI routine.
+ * @details Only routines moving a known amount of data are recorded. Each thread records into the histograms of its own profile, so the counters are incremented without atomics; the profiles are merged during MPI_Finalize.
+ * @param[in] type The message type of the MPI routine.
+ * @param[in] arguments The arguments of the call.
+ * @param[in] nanoseconds The duration of the call, in nanoseconds.
+ **/
+static void MPIM_histogram_record(enum MPIM_message_type_t type, const struct MPIM_arguments_t* arguments, uint64_t nanoseconds)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IBARRIER, file, line, args);
-    int result = MPI_Ibarrier(communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IBARRIER, file, line, args);
-    return result;
-}
+    switch(arguments->kind)
+    {
+        case MPIM_ARGUMENTS_SEND:
+        case MPIM_ARGUMENTS_RECEIVE:
+        case MPIM_ARGUMENTS_SENDRECV:
+        case MPIM_ARGUMENTS_COLLECTIVE:
+        case MPIM_ARGUMENTS_ROOTED_COLLECTIVE:
+        case MPIM_ARGUMENTS_RMA:
+        case MPIM_ARGUMENTS_MATCHED_RECEIVE:
+            break;
+        default:
+            return;
+    }
+    if(arguments->count < 0)
+    {
+        return;
+    }
 
-int MPIM_Ibsend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IBSEND, file, line, args);
-    int result = MPI_Ibsend(buffer, count, type, dst, tag, comm, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IBSEND, file, line, args);
-    return result;
+    uint64_t bytes = (uint64_t)arguments->count * arguments->datatype_size;
+    int size_bucket = MPIM_histogram_get_bucket(bytes, MPIM_HISTOGRAM_SIZE_BUCKETS);
+    int latency_bucket = MPIM_histogram_get_bucket(nanoseconds / 1000, MPIM_HISTOGRAM_LATENCY_BUCKETS);
+    struct MPIM_histogram_t* histogram = &MPIM_get_my_profile()->histograms[type];
+    histogram->calls[size_bucket][latency_bucket]++;
+    histogram->bytes[size_bucket] += bytes;
+    histogram->nanoseconds[size_bucket] += nanoseconds;
 }
 
-int MPIM_Igather(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Gives the upper bound of the latency bucket below which a given fraction of the calls of a size bucket fall.
+ * @param[in] histogram The histogram.
+ * @param[in] size_bucket The size bucket.
+ * @param[in] calls The number of calls in that size bucket.
+ * @param[in] fraction The fraction of calls, between 0 and 1.
+ * @return The upper bound of the latency bucket, in microseconds, 0 if it is the last, open, bucket.
+ **/
+static uint64_t MPIM_histogram_get_percentile(const struct MPIM_histogram_t* histogram, int size_bucket, uint64_t calls, double fraction)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IGATHER, file, line, args);
-    int result = MPI_Igather(buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IGATHER, file, line, args);
-    return result;
+    uint64_t cumulated = 0;
+    for(int i = 0; i < MPIM_HISTOGRAM_LATENCY_BUCKETS - 1; i++)
+    {
+        cumulated += histogram->calls[size_bucket][i];
+        if(cumulated >= fraction * calls)
+        {
+            return 1ULL << i;
+        }
+    }
+    return 0;
 }
 
-int MPIM_Igatherv(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Writes the latency bucket upper bound given by MPIM_histogram_get_percentile.
+ * @param[in] microseconds The upper bound, 0 for the last, open, bucket.
+ * @param[out] text The buffer receiving the bound.
+ * @param[in] text_length The size of the text buffer.
+ **/
+static void MPIM_latency_get_text(uint64_t microseconds, char* text, int text_length)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IGATHERV, file, line, args);
-    int result = MPI_Igatherv(buffer_send, count_send, datatype_send, buffer_recv, counts_recv, displacements, datatype_recv, root, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IGATHERV, file, line, args);
-    return result;
+    if(microseconds == 0)
+    {
+        snprintf(text, text_length, ">= %.1f s", (1ULL << (MPIM_HISTOGRAM_LATENCY_BUCKETS - 2)) / 1.0E6);
+    }
+    else if(microseconds < 1000)
+    {
+        snprintf(text, text_length, "< %llu us", (unsigned long long)microseconds);
+    }
+    else
+    {
+        snprintf(text, text_length, "< %.1f ms", microseconds / 1000.0);
+    }
 }
 
-int MPIM_Init(int* argc, char*** argv, char* file, int line, const char* args)
+/**
+ * @brief Merges the histograms of all processes on process 0 and reports, for every MPI routine and payload size, the latency and effective bandwidth.
+ * @details Must be called collectively. If the environment variable MPIM_HISTOGRAM_FILE is set, the full histograms are also written to that file in CSV format.
+ **/
+static void MPIM_histograms_report()
 {
-    int result = MPI_Init(argc, argv);
-    MPI_Comm_rank(MPI_COMM_WORLD, &MPIM_my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &MPIM_my_comm_size);
-
-    MPI_Aint size;
+    int element_count = MPIM_MESSAGE_TYPE_COUNT * sizeof(struct MPIM_histogram_t) / sizeof(uint64_t);
     if(MPIM_my_rank == 0)
     {
-        size = sizeof(struct MPIM_message_t) * MPIM_my_comm_size;
-        MPIM_my_window_buffer_original = (struct MPIM_message_t*)malloc(size);
-        if(MPIM_my_window_buffer_original == NULL)
-        {
-            printf("Failure in allocating MPIM_my_window_buffer_original.\n");
-            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-        }
-        MPIM_my_window_buffer_copy = (struct MPIM_message_t*)malloc(size);
-        if(MPIM_my_window_buffer_copy == NULL)
-        {
-            printf("Failure in allocating MPIM_my_window_buffer_original copy.\n");
-            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-        }
-        for(int i = 0; i < MPIM_my_comm_size; i++)
-        {
-            MPIM_my_window_buffer_original[i].type = MPIM_MESSAGE_UNINITIALISED;
-            MPIM_my_window_buffer_original[i].before = false;
-            MPIM_my_window_buffer_original[i].walltime = MPIM_get_time();
-            MPIM_message_set_name(&MPIM_my_window_buffer_original[i], "-");
-            MPIM_my_window_buffer_original[i].line = 0;
-        }
+        MPI_Reduce(MPI_IN_PLACE, MPIM_histograms, element_count, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
     }
     else
     {
-        size = 0;
+        MPI_Reduce(MPIM_histograms, NULL, element_count, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+        return;
     }
 
-    MPI_Win_create(MPIM_my_window_buffer_original, size, sizeof(struct MPIM_message_t), MPI_INFO_NULL, MPI_COMM_WORLD, &MPIM_my_window);
-    MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, MPIM_my_window);
-
-    if(MPIM_my_rank == 0)
+    char lower[16];
+    char upper[16];
+    char size[40];
+    char median[16];
+    char tail[16];
+    printf("\nMPI_monitor: payload size and latency of the MPI calls, all processes merged\n");
+    printf("+--------------------------------+---------------------+------------+-------------+-------------+-----------------+\n");
+    printf("| %30s | %19s | %10s | %11s | %11s | %15s |\n", "Routine", "Payload size", "Calls", "Median", "99th pct", "Bandwidth");
+    printf("+--------------------------------+---------------------+------------+-------------+-------------+-----------------+\n");
+    for(int type = 0; type < MPIM_MESSAGE_TYPE_COUNT; type++)
     {
-        pthread_create(&MPIM_manager_thread, NULL, (void* (*)(void*))MPIM_manager, NULL);
-    }
-
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_INITIALISED, file, line, args);
+        const struct MPIM_histogram_t* histogram = &MPIM_histograms[type];
+        for(int size_bucket = 0; size_bucket < MPIM_HISTOGRAM_SIZE_BUCKETS; size_bucket++)
+        {
+            uint64_t calls = 0;
+            for(int latency_bucket = 0; latency_bucket < MPIM_HISTOGRAM_LATENCY_BUCKETS; latency_bucket++)
+            {
+                calls += histogram->calls[size_bucket][latency_bucket];
+            }
+            if(calls == 0)
+            {
+                continue;
+            }
 
-    // All wait for the process 0 to tell us the initialisation is complete and successful
-    MPI_Barrier(MPI_COMM_WORLD);
+            if(size_bucket == 0)
+            {
+                snprintf(size, sizeof(size), "0 B");
+            }
+            else if(size_bucket == MPIM_HISTOGRAM_SIZE_BUCKETS - 1)
+            {
+                MPIM_bytes_get_text(1ULL << (size_bucket - 1), lower, sizeof(lower));
+                snprintf(size, sizeof(size), ">= %s", lower);
+            }
+            else
+            {
+                MPIM_bytes_get_text(1ULL << (size_bucket - 1), lower, sizeof(lower));
+                MPIM_bytes_get_text(1ULL << size_bucket, upper, sizeof(upper));
+                snprintf(size, sizeof(size), "%s - %s", lower, upper);
+            }
+            MPIM_latency_get_text(MPIM_histogram_get_percentile(histogram, size_bucket, calls, 0.5), median, sizeof(median));
+            MPIM_latency_get_text(MPIM_histogram_get_percentile(histogram, size_bucket, calls, 0.99), tail, sizeof(tail));
+            double bandwidth = (histogram->nanoseconds[size_bucket] > 0) ? histogram->bytes[size_bucket] / (double)histogram->nanoseconds[size_bucket] * 1.0E3 : 0.0;
+            printf("| %30s | %19s | %10llu | %11s | %11s | %10.1f MB/s |\n", MPIM_routine_name_t[type], size, (unsigned long long)calls, median, tail, bandwidth);
+        }
+    }
+    printf("+--------------------------------+---------------------+------------+-------------+-------------+-----------------+\n");
 
-    return result;
+    const char* file_name = getenv("MPIM_HISTOGRAM_FILE");
+    if(file_name != NULL && file_name[0] != '\0')
+    {
+        FILE* file = fopen(file_name, "w");
+        if(file == NULL)
+        {
+            printf("MPI_monitor: cannot open the histogram file \"%s\".\n", file_name);
+            return;
+        }
+        fprintf(file, "routine,size_bucket_min_bytes,latency_bucket_min_us,calls\n");
+        for(int type = 0; type < MPIM_MESSAGE_TYPE_COUNT; type++)
+        {
+            for(int size_bucket = 0; size_bucket < MPIM_HISTOGRAM_SIZE_BUCKETS; size_bucket++)
+            {
+                for(int latency_bucket = 0; latency_bucket < MPIM_HISTOGRAM_LATENCY_BUCKETS; latency_bucket++)
+                {
+                    uint64_t calls = MPIM_histograms[type].calls[size_bucket][latency_bucket];
+                    if(calls > 0)
+                    {
+                        fprintf(file, "%s,%llu,%llu,%llu\n", MPIM_routine_name_t[type],
+                                (unsigned long long)((size_bucket == 0) ? 0 : 1ULL << (size_bucket - 1)),
+                                (unsigned long long)((latency_bucket == 0) ? 0 : 1ULL << (latency_bucket - 1)),
+                                (unsigned long long)calls);
+                    }
+                }
+            }
+        }
+        fclose(file);
+    }
 }
 
-int MPIM_Iprobe(int source, int tag, MPI_Comm communicator, int* flag, MPI_Status* status, char* file, int line, const char* args)
+/**
+ * @brief Finds the entry of a callsite in a callsite table, claiming an unused entry if the callsite has none.
+ * @param[in] callsites The table, of MPIM_PROFILE_MAX_CALLSITES entries.
+ * @param[in] module The identity of the module containing the callsite.
+ * @param[in] offset The offset of the callsite in its module.
+ * @param[in] line The line of the callsite in its source file.
+ * @param[in] type The message type of the MPI routine.
+ * @return The entry of the callsite, NULL if the table is full.
+ **/
+static struct MPIM_profile_callsite_t* MPIM_profile_callsite_get(struct MPIM_profile_callsite_t* callsites, uint32_t module, uint64_t offset, int line, int type)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IPROBE, file, line, args);
-    int result = MPI_Iprobe(source, tag, communicator, flag, status);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IPROBE, file, line, args);
-    return result;
+    uint64_t hash = (offset * 0x9E3779B97F4A7C15ULL) ^ (uint64_t)module;
+    int bucket = (int)(hash % MPIM_PROFILE_MAX_CALLSITES);
+    for(int probe = 0; probe < MPIM_PROFILE_MAX_CALLSITES; probe++)
+    {
+        struct MPIM_profile_callsite_t* entry = &callsites[(bucket + probe) % MPIM_PROFILE_MAX_CALLSITES];
+        if(entry->calls == 0)
+        {
+            entry->module = module;
+            entry->offset = offset;
+            entry->line = line;
+            entry->type = type;
+            entry->ranks = 1;
+            return entry;
+        }
+        if(entry->module == module && entry->offset == offset)
+        {
+            return entry;
+        }
+    }
+    return NULL;
 }
 
-int MPIM_Irecv(void* buffer, int count, MPI_Datatype datatype, int sender, int tag, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Records the duration of a call in the profile of the calling thread.
+ * @param[in] type The message type of the MPI routine.
+ * @param[in] module The identity of the module containing the callsite.
+ * @param[in] offset The offset of the callsite in its module.
+ * @param[in] line The line of the callsite in its source file.
+ * @param[in] nanoseconds The duration of the call, in nanoseconds.
+ **/
+static void MPIM_profile_record(enum MPIM_message_type_t type, uint32_t module, uint64_t offset, int line, uint64_t nanoseconds)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IRECV, file, line, args);
-    int result = MPI_Irecv(buffer, count, datatype, sender, tag, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IRECV, file, line, args);
-    return result;
-}
+    struct MPIM_thread_profile_t* profile = MPIM_get_my_profile();
+    profile->totals.calls[type]++;
+    profile->totals.nanoseconds[type] += nanoseconds;
 
-int MPIM_Ireduce(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, int root, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IREDUCE, file, line, args);
-    int result = MPI_Ireduce(send_buffer, receive_buffer, count, datatype, operation, root, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IREDUCE, file, line, args);
-    return result;
+    struct MPIM_profile_callsite_t* callsite = MPIM_profile_callsite_get(profile->callsites, module, offset, line, type);
+    if(callsite == NULL)
+    {
+        profile->callsites_dropped = 1;
+    }
+    else
+    {
+        callsite->calls++;
+        callsite->nanoseconds += nanoseconds;
+    }
 }
 
-int MPIM_Ireduce_scatter(const void* send_buffer, void* receive_buffer, int* counts, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Merges the profiles and histograms of the threads of this process into those of the process, and frees them.
+ * @details Called from MPI_Finalize, once the other threads are done with MPI.
+ **/
+static void MPIM_thread_profiles_merge()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IREDUCE_SCATTER, file, line, args);
-    int result = MPI_Ireduce_scatter(send_buffer, receive_buffer, counts, datatype, operation, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IREDUCE_SCATTER, file, line, args);
-    return result;
-}
+    struct MPIM_thread_profile_t* profile = MPIM_thread_profiles;
+    while(profile != NULL)
+    {
+        for(int type = 0; type < MPIM_MESSAGE_TYPE_COUNT; type++)
+        {
+            MPIM_profile_totals.calls[type] += profile->totals.calls[type];
+            MPIM_profile_totals.nanoseconds[type] += profile->totals.nanoseconds[type];
 
-int MPIM_Ireduce_scatter_block(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IREDUCE_SCATTER_BLOCK, file, line, args);
-    int result = MPI_Ireduce_scatter_block(send_buffer, receive_buffer, count, datatype, operation, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IREDUCE_SCATTER_BLOCK, file, line, args);
-    return result;
-}
+            struct MPIM_histogram_t* histogram = &MPIM_histograms[type];
+            for(int size_bucket = 0; size_bucket < MPIM_HISTOGRAM_SIZE_BUCKETS; size_bucket++)
+            {
+                for(int latency_bucket = 0; latency_bucket < MPIM_HISTOGRAM_LATENCY_BUCKETS; latency_bucket++)
+                {
+                    histogram->calls[size_bucket][latency_bucket] += profile->histograms[type].calls[size_bucket][latency_bucket];
+                }
+                histogram->bytes[size_bucket] += profile->histograms[type].bytes[size_bucket];
+                histogram->nanoseconds[size_bucket] += profile->histograms[type].nanoseconds[size_bucket];
+            }
+        }
 
-int MPIM_Irsend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_IRSEND, file, line, args);
-    int result = MPI_Irsend(buffer, count, type, dst, tag, comm, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_IRSEND, file, line, args);
-    return result;
-}
+        MPIM_profile_callsites_dropped |= profile->callsites_dropped;
+        for(int i = 0; i < MPIM_PROFILE_MAX_CALLSITES; i++)
+        {
+            const struct MPIM_profile_callsite_t* entry = &profile->callsites[i];
+            if(entry->calls == 0)
+            {
+                continue;
+            }
+            struct MPIM_profile_callsite_t* callsite = MPIM_profile_callsite_get(MPIM_profile_callsites, entry->module, entry->offset, entry->line, entry->type);
+            if(callsite == NULL)
+            {
+                MPIM_profile_callsites_dropped = 1;
+            }
+            else
+            {
+                callsite->calls += entry->calls;
+                callsite->nanoseconds += entry->nanoseconds;
+            }
+        }
 
-int MPIM_Iscatter(const void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ISCATTER, file, line, args);
-    int result = MPI_Iscatter(buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ISCATTER, file, line, args);
-    return result;
+        struct MPIM_thread_profile_t* next = profile->next;
+        free(profile);
+        profile = next;
+    }
+    MPIM_thread_profiles = NULL;
+    MPIM_my_profile = NULL;
 }
 
-int MPIM_Iscatterv(const void* buffer_send, const int counts_send[], const int displacements[], MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Orders profiled callsites by module and offset.
+ * @param[in] a The first callsite.
+ * @param[in] b The second callsite.
+ * @return A negative value, zero or a positive value if a is located before, at or after b.
+ **/
+static int MPIM_profile_callsite_compare_location(const void* a, const void* b)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ISCATTERV, file, line, args);
-    int result = MPI_Iscatterv(buffer_send, counts_send, displacements, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ISCATTERV, file, line, args);
-    return result;
+    const struct MPIM_profile_callsite_t* first = (const struct MPIM_profile_callsite_t*)a;
+    const struct MPIM_profile_callsite_t* second = (const struct MPIM_profile_callsite_t*)b;
+    if(first->module != second->module)
+    {
+        return (first->module < second->module) ? -1 : 1;
+    }
+    if(first->offset != second->offset)
+    {
+        return (first->offset < second->offset) ? -1 : 1;
+    }
+    return 0;
 }
 
-int MPIM_Isend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Orders profiled callsites by decreasing aggregate time.
+ * @param[in] a The first callsite.
+ * @param[in] b The second callsite.
+ * @return A negative value, zero or a positive value if a took more, as much or less time than b.
+ **/
+static int MPIM_profile_callsite_compare_time(const void* a, const void* b)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ISEND, file, line, args);
-    int result = MPI_Isend(buffer, count, type, dst, tag, comm, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ISEND, file, line, args);
-    return result;
+    const struct MPIM_profile_callsite_t* first = (const struct MPIM_profile_callsite_t*)a;
+    const struct MPIM_profile_callsite_t* second = (const struct MPIM_profile_callsite_t*)b;
+    if(first->nanoseconds != second->nanoseconds)
+    {
+        return (first->nanoseconds > second->nanoseconds) ? -1 : 1;
+    }
+    return MPIM_profile_callsite_compare_location(a, b);
 }
 
-int MPIM_Issend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Merges profiled callsites of different processes, used as a user-defined MPI reduction operation.
+ * @details Both operands are sorted by location, so a single pass merges them. Callsites that do not fit in the result are counted as dropped.
+ * @param[in] in The callsites of the processes in the first operand.
+ * @param[inout] inout The callsites of the processes in the second operand, replaced with the merged callsites.
+ * @param[in] length The number of profiles in each operand.
+ * @param[in] datatype The datatype of the profiles.
+ **/
+static void MPIM_profile_callsites_merge(void* in, void* inout, int* length, MPI_Datatype* datatype)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ISSEND, file, line, args);
-    int result = MPI_Issend(buffer, count, type, dst, tag, comm, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ISSEND, file, line, args);
-    return result;
-}
+    (void)datatype;
+    struct MPIM_profile_callsites_t* merged = (struct MPIM_profile_callsites_t*)malloc(sizeof(struct MPIM_profile_callsites_t));
+    if(merged == NULL)
+    {
+        printf("Failure in allocating the merged profile.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    for(int i = 0; i < *length; i++)
+    {
+        const struct MPIM_profile_callsites_t* first = &((const struct MPIM_profile_callsites_t*)in)[i];
+        struct MPIM_profile_callsites_t* second = &((struct MPIM_profile_callsites_t*)inout)[i];
+        int first_index = 0;
+        int second_index = 0;
+        merged->count = 0;
+        merged->dropped = first->dropped + second->dropped;
+        while(first_index < first->count || second_index < second->count)
+        {
+            int order;
+            if(first_index == first->count)
+            {
+                order = 1;
+            }
+            else if(second_index == second->count)
+            {
+                order = -1;
+            }
+            else
+            {
+                order = MPIM_profile_callsite_compare_location(&first->callsites[first_index], &second->callsites[second_index]);
+            }
 
-int MPIM_Op_create(MPI_User_function* user_function, int commutativity, MPI_Op* handle, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_OP_CREATE, file, line, args);
-    int result = MPI_Op_create(user_function, commutativity, handle);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_OP_CREATE, file, line, args);
-    return result;
+            if(merged->count == MPIM_PROFILE_MAX_CALLSITES)
+            {
+                merged->dropped++;
+            }
+            else if(order < 0)
+            {
+                merged->callsites[merged->count++] = first->callsites[first_index];
+            }
+            else if(order > 0)
+            {
+                merged->callsites[merged->count++] = second->callsites[second_index];
+            }
+            else
+            {
+                struct MPIM_profile_callsite_t callsite = first->callsites[first_index];
+                const struct MPIM_profile_callsite_t* other = &second->callsites[second_index];
+                callsite.ranks += other->ranks;
+                callsite.calls += other->calls;
+                callsite.nanoseconds += other->nanoseconds;
+                callsite.min_nanoseconds = (other->min_nanoseconds < callsite.min_nanoseconds) ? other->min_nanoseconds : callsite.min_nanoseconds;
+                callsite.max_nanoseconds = (other->max_nanoseconds > callsite.max_nanoseconds) ? other->max_nanoseconds : callsite.max_nanoseconds;
+                merged->callsites[merged->count++] = callsite;
+            }
+            if(order <= 0)
+            {
+                first_index++;
+            }
+            if(order >= 0)
+            {
+                second_index++;
+            }
+        }
+        memcpy(second, merged, offsetof(struct MPIM_profile_callsites_t, callsites) + merged->count * sizeof(struct MPIM_profile_callsite_t));
+    }
+    free(merged);
 }
 
-int MPIM_Op_free(MPI_Op* handle, char* file, int line, const char* args)
+/**
+ * @brief Prints the profile merged over all processes.
+ * @param[in] stream The stream to print to.
+ * @param[in] process_count The number of processes.
+ * @param[in] sum The totals summed over processes.
+ * @param[in] min The minimum totals over processes.
+ * @param[in] max The maximum totals over processes.
+ * @param[in] callsites The callsites merged over processes, sorted by decreasing aggregate time.
+ * @param[in] callsite_limit The maximum number of callsites printed.
+ **/
+static void MPIM_profile_print(FILE* stream, int process_count, const struct MPIM_profile_totals_t* sum, const struct MPIM_profile_totals_t* min, const struct MPIM_profile_totals_t* max, const struct MPIM_profile_callsites_t* callsites, int callsite_limit)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_OP_FREE, file, line, args);
-    int result = MPI_Op_free(handle);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_OP_FREE, file, line, args);
-    return result;
+    double mpi_total = (sum->mpi_nanoseconds > 0) ? (double)sum->mpi_nanoseconds : 1.0;
+    fprintf(stream, "\nMPI_monitor: profile of the MPI calls of %d processes, times in seconds per process\n", process_count);
+    fprintf(stream, "+--------------------------------+------------+------------+------------+\n");
+    fprintf(stream, "| %30s | %10s | %10s | %10s |\n", "", "Min", "Mean", "Max");
+    fprintf(stream, "+--------------------------------+------------+------------+------------+\n");
+    fprintf(stream, "| %30s | %10.3f | %10.3f | %10.3f |\n", "Application time", min->application_nanoseconds / 1.0E9, sum->application_nanoseconds / 1.0E9 / process_count, max->application_nanoseconds / 1.0E9);
+    fprintf(stream, "| %30s | %10.3f | %10.3f | %10.3f |\n", "MPI time", min->mpi_nanoseconds / 1.0E9, sum->mpi_nanoseconds / 1.0E9 / process_count, max->mpi_nanoseconds / 1.0E9);
+    fprintf(stream, "| %30s | %10s | %9.1f%% | %10s |\n", "MPI share", "", (sum->application_nanoseconds > 0) ? 100.0 * sum->mpi_nanoseconds / sum->application_nanoseconds : 0.0, "");
+    fprintf(stream, "+--------------------------------+------------+------------+------------+\n");
+
+    fprintf(stream, "\n+--------------------------------+--------------+------------+------------+------------+--------+\n");
+    fprintf(stream, "| %30s | %12s | %10s | %10s | %10s | %6s |\n", "Routine", "Calls", "Min", "Mean", "Max", "MPI %");
+    fprintf(stream, "+--------------------------------+--------------+------------+------------+------------+--------+\n");
+    for(int type = 0; type < MPIM_MESSAGE_TYPE_COUNT; type++)
+    {
+        if(sum->calls[type] > 0)
+        {
+            fprintf(stream, "| %30s | %12llu | %10.6f | %10.6f | %10.6f | %6.2f |\n", MPIM_routine_name_t[type], (unsigned long long)sum->calls[type],
+                    min->nanoseconds[type] / 1.0E9, sum->nanoseconds[type] / 1.0E9 / process_count, max->nanoseconds[type] / 1.0E9, 100.0 * sum->nanoseconds[type] / mpi_total);
+        }
+    }
+    fprintf(stream, "+--------------------------------+--------------+------------+------------+------------+--------+\n");
+
+    char where[MPIM_MAX_FILENAME_LENGTH];
+    int callsite_count = (callsites->count < callsite_limit) ? callsites->count : callsite_limit;
+    fprintf(stream, "\nTop %d callsites by aggregate time, min and max over the processes that issued them:\n", callsite_count);
+    fprintf(stream, "+------------------------------------------+--------------------------------+--------------+--------+------------+------------+------------+--------+\n");
+    fprintf(stream, "| %-40s | %30s | %12s | %6s | %10s | %10s | %10s | %6s |\n", "Callsite", "Routine", "Calls", "Ranks", "Min", "Mean", "Max", "MPI %");
+    fprintf(stream, "+------------------------------------------+--------------------------------+--------------+--------+------------+------------+------------+--------+\n");
+    for(int i = 0; i < callsite_count; i++)
+    {
+        const struct MPIM_profile_callsite_t* callsite = &callsites->callsites[i];
+        MPIM_callsite_get_where(callsite->module, callsite->offset, callsite->line, where, sizeof(where));
+        fprintf(stream, "| %-40.40s | %30s | %12llu | %6d | %10.6f | %10.6f | %10.6f | %6.2f |\n", where, MPIM_routine_name_t[callsite->type], (unsigned long long)callsite->calls, callsite->ranks,
+                callsite->min_nanoseconds / 1.0E9, callsite->nanoseconds / 1.0E9 / callsite->ranks, callsite->max_nanoseconds / 1.0E9, 100.0 * callsite->nanoseconds / mpi_total);
+    }
+    fprintf(stream, "+------------------------------------------+--------------------------------+--------------+--------+------------+------------+------------+--------+\n");
+    if(callsites->dropped > 0)
+    {
+        fprintf(stream, "%d callsites did not fit in the profile and only appear in the routine totals.\n", callsites->dropped);
+    }
 }
 
-int MPIM_Probe(int source, int tag, MPI_Comm communicator, MPI_Status* status, char* file, int line, const char* args)
+/**
+ * @brief Merges the profiles of all processes and reports them on process 0.
+ * @details Must be called collectively. Totals and callsites are reduced with nonblocking reductions on a private communicator, so that each process only merges the profiles of its children in the reduction tree. Process 0 prints the routine totals and the top callsites, the number of which is given by the environment variable MPIM_PROFILE_TOP, and writes the full profile, along with the time of every process, to the file given by the environment variable MPIM_PROFILE_FILE; an empty name disables the file.
+ * @param[in] end The timestamp at which MPI_Finalize was entered.
+ **/
+static void MPIM_profile_report(uint64_t end)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_PROBE, file, line, args);
-    int result = MPI_Probe(source, tag, communicator, status);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_PROBE, file, line, args);
-    return result;
-}
+    MPIM_profile_totals.application_nanoseconds = (uint64_t)((end - MPIM_profile_start) * 1.0E9 / MPIM_my_clock.ticks_per_second);
+    MPIM_profile_totals.mpi_nanoseconds = 0;
+    for(int type = 0; type < MPIM_MESSAGE_TYPE_COUNT; type++)
+    {
+        MPIM_profile_totals.mpi_nanoseconds += MPIM_profile_totals.nanoseconds[type];
+    }
 
-int MPIM_Put(const void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Win window, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_PUT, file, line, args);
-    int result = MPI_Put(origin_address, origin_count, origin_datatype, target_rank, target_displacement, target_count, target_datatype, window);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_PUT, file, line, args);
-    return result;
-}
+    struct MPIM_profile_callsites_t* local = (struct MPIM_profile_callsites_t*)malloc(sizeof(struct MPIM_profile_callsites_t));
+    struct MPIM_profile_callsites_t* merged = (struct MPIM_profile_callsites_t*)malloc(sizeof(struct MPIM_profile_callsites_t));
+    if(local == NULL || merged == NULL)
+    {
+        printf("Failure in allocating the profile.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    local->count = 0;
+    local->dropped = MPIM_profile_callsites_dropped;
+    for(int i = 0; i < MPIM_PROFILE_MAX_CALLSITES; i++)
+    {
+        if(MPIM_profile_callsites[i].calls > 0)
+        {
+            struct MPIM_profile_callsite_t* callsite = &local->callsites[local->count++];
+            *callsite = MPIM_profile_callsites[i];
+            callsite->min_nanoseconds = callsite->nanoseconds;
+            callsite->max_nanoseconds = callsite->nanoseconds;
+        }
+    }
+    qsort(local->callsites, local->count, sizeof(struct MPIM_profile_callsite_t), MPIM_profile_callsite_compare_location);
+
+    MPI_Comm communicator;
+    MPI_Comm_dup(MPI_COMM_WORLD, &communicator);
+    MPI_Datatype callsites_datatype;
+    MPI_Type_contiguous(sizeof(struct MPIM_profile_callsites_t), MPI_BYTE, &callsites_datatype);
+    MPI_Type_commit(&callsites_datatype);
+    MPI_Op merge;
+    MPI_Op_create(MPIM_profile_callsites_merge, 1, &merge);
+
+    struct MPIM_profile_totals_t sum;
+    struct MPIM_profile_totals_t min;
+    struct MPIM_profile_totals_t max;
+    uint64_t* process_times = NULL;
+    if(MPIM_my_rank == 0)
+    {
+        process_times = (uint64_t*)malloc(2 * MPIM_my_comm_size * sizeof(uint64_t));
+        if(process_times == NULL)
+        {
+            printf("Failure in allocating the process times.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+    }
+    int element_count = sizeof(struct MPIM_profile_totals_t) / sizeof(uint64_t);
+    MPI_Request requests[5];
+    MPI_Ireduce(&MPIM_profile_totals, &sum, element_count, MPI_UINT64_T, MPI_SUM, 0, communicator, &requests[0]);
+    MPI_Ireduce(&MPIM_profile_totals, &min, element_count, MPI_UINT64_T, MPI_MIN, 0, communicator, &requests[1]);
+    MPI_Ireduce(&MPIM_profile_totals, &max, element_count, MPI_UINT64_T, MPI_MAX, 0, communicator, &requests[2]);
+    MPI_Ireduce(local, merged, 1, callsites_datatype, merge, 0, communicator, &requests[3]);
+    MPI_Igather(&MPIM_profile_totals, 2, MPI_UINT64_T, process_times, 2, MPI_UINT64_T, 0, communicator, &requests[4]);
+    MPI_Waitall(5, requests, MPI_STATUSES_IGNORE);
+
+    MPI_Op_free(&merge);
+    MPI_Type_free(&callsites_datatype);
+    MPI_Comm_free(&communicator);
 
-int MPIM_Recv(void* buffer, int count, MPI_Datatype type, int source, int tag, MPI_Comm comm, MPI_Status* status, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_RECV, file, line, args);
-    int result = MPI_Recv(buffer, count, type, source, tag, comm, status);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_RECV, file, line, args);
-    return result;
-}
+    if(MPIM_my_rank == 0)
+    {
+        qsort(merged->callsites, merged->count, sizeof(struct MPIM_profile_callsite_t), MPIM_profile_callsite_compare_time);
+        int top = MPIM_DEFAULT_PROFILE_TOP;
+        const char* top_variable = getenv("MPIM_PROFILE_TOP");
+        if(top_variable != NULL && atoi(top_variable) >= 0)
+        {
+            top = atoi(top_variable);
+        }
+        MPIM_profile_print(stdout, MPIM_my_comm_size, &sum, &min, &max, merged, top);
 
-int MPIM_Recv_init(void* buffer, int count, MPI_Datatype datatype, int sender, int tag, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_RECV_INIT, file, line, args);
-    int result = MPI_Recv_init(buffer, count, datatype, sender, tag, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_RECV_INIT, file, line, args);
-    return result;
+        const char* file_name = getenv("MPIM_PROFILE_FILE");
+        if(file_name == NULL)
+        {
+            file_name = MPIM_DEFAULT_PROFILE_FILE;
+        }
+        if(file_name[0] != '\0')
+        {
+            FILE* file = fopen(file_name, "w");
+            if(file == NULL)
+            {
+                printf("MPI_monitor: cannot open the profile file \"%s\".\n", file_name);
+            }
+            else
+            {
+                MPIM_profile_print(file, MPIM_my_comm_size, &sum, &min, &max, merged, merged->count);
+                fprintf(file, "\nTime of every process, in seconds:\n%6s %14s %14s %8s\n", "Rank", "Application", "MPI", "MPI %");
+                for(int i = 0; i < MPIM_my_comm_size; i++)
+                {
+                    uint64_t application_nanoseconds = process_times[2 * i];
+                    uint64_t mpi_nanoseconds = process_times[2 * i + 1];
+                    fprintf(file, "%6d %14.6f %14.6f %8.2f\n", i, application_nanoseconds / 1.0E9, mpi_nanoseconds / 1.0E9, (application_nanoseconds > 0) ? 100.0 * mpi_nanoseconds / application_nanoseconds : 0.0);
+                }
+                fclose(file);
+                printf("MPI_monitor: full profile written to \"%s\".\n", file_name);
+            }
+        }
+        free(process_times);
+    }
+    free(local);
+    free(merged);
 }
 
-int MPIM_Reduce(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, int root, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Reads the stall threshold and gives the thread support MPI must be initialised with.
+ * @details Stacks of stalled calls are sent by a helper thread while the stalled thread is inside MPI, which requires MPI_THREAD_MULTIPLE. It is therefore requested whenever the environment variable MPIM_STALL_THRESHOLD gives a positive number of seconds.
+ * @param[in] required The thread support required by the application.
+ * @return The thread support to request.
+ **/
+static int MPIM_stall_get_required_thread_support(int required)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_REDUCE, file, line, args);
-    int result = MPI_Reduce(send_buffer, receive_buffer, count, datatype, operation, root, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_REDUCE, file, line, args);
-    return result;
+    const char* stall_threshold = getenv("MPIM_STALL_THRESHOLD");
+    if(stall_threshold != NULL && atof(stall_threshold) > 0.0)
+    {
+        MPIM_stall_threshold = atof(stall_threshold);
+        return MPI_THREAD_MULTIPLE;
+    }
+    return required;
 }
 
-int MPIM_Reduce_scatter(const void* send_buffer, void* receive_buffer, int* counts, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Captures the stack of the thread receiving the signal, sent by the watchdog thread.
+ * @details backtrace is warmed up during initialisation so that it does not allocate memory here.
+ * @param[in] signal The signal received.
+ **/
+static void MPIM_stack_capture_handler(int signal)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_REDUCE_SCATTER, file, line, args);
-    int result = MPI_Reduce_scatter(send_buffer, receive_buffer, counts, datatype, operation, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_REDUCE_SCATTER, file, line, args);
-    return result;
+    (void)signal;
+    if(MPIM_my_thread_slot >= 0)
+    {
+        struct MPIM_thread_state_t* state = &MPIM_thread_states[MPIM_my_thread_slot];
+        state->depth = backtrace(state->frames, MPIM_STACK_MAX_DEPTH);
+    }
 }
 
-int MPIM_Reduce_scatter_block(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Captures the stack of a stalled thread and sends it to the aggregator.
+ * @param[in] thread_slot The slot of the stalled thread among those of its process.
+ * @param[in] call_count The number of the stalled call.
+ **/
+static void MPIM_stack_send(int thread_slot, uint64_t call_count)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_REDUCE_SCATTER_BLOCK, file, line, args);
-    int result = MPI_Reduce_scatter_block(send_buffer, receive_buffer, count, datatype, operation, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_REDUCE_SCATTER_BLOCK, file, line, args);
-    return result;
-}
+    struct MPIM_thread_state_t* state = &MPIM_thread_states[thread_slot];
+    state->depth = -1;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if(pthread_kill(state->thread, MPIM_STACK_SIGNAL) != 0)
+    {
+        return;
+    }
+    for(int i = 0; i < MPIM_WATCHDOG_PERIOD && state->depth == -1; i++)
+    {
+        MPIM_sleep(1);
+    }
+    if(state->depth <= MPIM_STACK_SKIPPED_FRAMES || state->call_count != call_count)
+    {
+        // The thread did not answer in time, or the call completed in the meantime
+        return;
+    }
 
-int MPIM_Rsend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_RSEND, file, line, args);
-    int result = MPI_Rsend(buffer, count, type, dst, tag, comm);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_RSEND, file, line, args);
-    return result;
+    struct MPIM_stack_t stack;
+    stack.call_count = call_count;
+    stack.depth = state->depth - MPIM_STACK_SKIPPED_FRAMES;
+    for(int i = 0; i < stack.depth; i++)
+    {
+        uintptr_t address = (uintptr_t)state->frames[MPIM_STACK_SKIPPED_FRAMES + i];
+        int module = MPIM_module_locate(address);
+        stack.frames[i] = (module == -1) ? 0 : ((uint64_t)MPIM_modules[module].identity << 32) | ((address - MPIM_modules[module].base) & UINT32_MAX);
+    }
+    int slot = MPIM_my_rank * MPIM_threads_per_process + thread_slot;
+    int size = offsetof(struct MPIM_stack_t, frames) + stack.depth * sizeof(uint64_t);
+    MPI_Put(&stack, size, MPI_BYTE, 0, (MPI_Aint)slot * sizeof(struct MPIM_stack_t), size, MPI_BYTE, MPIM_stack_window);
+    MPI_Win_flush(0, MPIM_stack_window);
 }
 
-int MPIM_Rsend_init(const void* buffer, int count, MPI_Datatype datatype, int recipient, int tag, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Watches the threads of this process and sends the stack of those stalled in an MPI call for longer than the stall threshold.
+ * @details The stack of a given call is sent only once.
+ **/
+static void* MPIM_watchdog()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_RSEND_INIT, file, line, args);
-    int result = MPI_Rsend_init(buffer, count, datatype, recipient, tag, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_RSEND_INIT, file, line, args);
-    return result;
+    uint64_t threshold = (uint64_t)(MPIM_stall_threshold * MPIM_my_clock.ticks_per_second);
+    while(!MPIM_watchdog_end)
+    {
+        int thread_count = atomic_load(&MPIM_thread_count);
+        thread_count = (thread_count < MPIM_threads_per_process) ? thread_count : MPIM_threads_per_process;
+        for(int i = 0; i < thread_count; i++)
+        {
+            struct MPIM_thread_state_t* state = &MPIM_thread_states[i];
+            uint64_t call_count = state->call_count;
+            if(call_count != 0 && call_count != state->captured_call_count && MPIM_get_ticks() - state->call_start > threshold)
+            {
+                state->captured_call_count = call_count;
+                MPIM_stack_send(i, call_count);
+            }
+        }
+        MPIM_sleep(MPIM_WATCHDOG_PERIOD);
+    }
+    return NULL;
 }
 
-int MPIM_Scan(void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, char* file, int line, const char* args)
+/**
+ * @brief Starts capturing the stacks of stalled calls, if a stall threshold was given and MPI provides MPI_THREAD_MULTIPLE.
+ * @details Must be called collectively, the window receiving the stacks is created in any case.
+ **/
+static void MPIM_stall_initialise()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_SCAN, file, line, args);
-    int result = MPI_Scan(send_buffer, receive_buffer, count, datatype, operation, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_SCAN, file, line, args);
-    return result;
-}
+    int slot_count = MPIM_my_comm_size * MPIM_threads_per_process;
+    MPI_Aint size = 0;
+    if(MPIM_my_rank == 0)
+    {
+        size = sizeof(struct MPIM_stack_t) * slot_count;
+        MPIM_stack_window_buffer = (struct MPIM_stack_t*)calloc(slot_count, sizeof(struct MPIM_stack_t));
+        if(MPIM_stack_window_buffer == NULL)
+        {
+            printf("Failure in allocating MPIM_stack_window_buffer.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+    }
+    MPI_Win_create(MPIM_stack_window_buffer, size, 1, MPI_INFO_NULL, MPI_COMM_WORLD, &MPIM_stack_window);
+    MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, MPIM_stack_window);
 
-int MPIM_Scatter(const void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_SCATTER, file, line, args);
-    int result = MPI_Scatter(buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_SCATTER, file, line, args);
-    return result;
-}
+    MPIM_thread_states = (struct MPIM_thread_state_t*)calloc(MPIM_threads_per_process, sizeof(struct MPIM_thread_state_t));
+    if(MPIM_thread_states == NULL)
+    {
+        printf("Failure in allocating MPIM_thread_states.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    MPIM_thread_states[0].thread = pthread_self();
 
-int MPIM_Scatterv(const void* buffer_send, const int counts_send[], const int displacements[], MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_SCATTERV, file, line, args);
-    int result = MPI_Scatterv(buffer_send, counts_send, displacements, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_SCATTERV, file, line, args);
-    return result;
+    int provided;
+    MPI_Query_thread(&provided);
+    if(MPIM_stall_threshold > 0.0 && provided < MPI_THREAD_MULTIPLE)
+    {
+        if(MPIM_my_rank == 0)
+        {
+            printf("MPI_monitor: MPI does not provide MPI_THREAD_MULTIPLE, stacks of stalled calls will not be captured.\n");
+        }
+        MPIM_stall_threshold = 0.0;
+    }
+    if(MPIM_stall_threshold > 0.0)
+    {
+        // The first call to backtrace loads the unwinder, which cannot be done from a signal handler
+        void* frame;
+        backtrace(&frame, 1);
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = MPIM_stack_capture_handler;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(MPIM_STACK_SIGNAL, &action, NULL);
+        pthread_create(&MPIM_watchdog_thread, NULL, (void* (*)(void*))MPIM_watchdog, NULL);
+    }
 }
 
-int MPIM_Send(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, char* file, int line, const char* args)
+/**
+ * @brief Stops capturing the stacks of stalled calls and frees the stack window.
+ * @details Must be called collectively.
+ **/
+static void MPIM_stall_finalise()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_SEND, file, line, args);
-    int result = MPI_Send(buffer, count, type, dst, tag, comm);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_SEND, file, line, args);
-    return result;
+    if(MPIM_stall_threshold > 0.0)
+    {
+        MPIM_watchdog_end = true;
+        pthread_join(MPIM_watchdog_thread, NULL);
+    }
+    MPI_Win_unlock(0, MPIM_stack_window);
+    MPI_Win_free(&MPIM_stack_window);
+    free(MPIM_stack_window_buffer);
+    free(MPIM_thread_states);
 }
 
-int MPIM_Send_init(const void* buffer, int count, MPI_Datatype datatype, int recipient, int tag, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Reads the wait state settings and creates the windows through which wait states are analysed.
+ * @details Must be called collectively. Nothing is created unless the MPIM_WAIT_STATES environment variable of process 0 is set to a non-zero value.
+ **/
+static void MPIM_wait_states_initialise()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_SEND_INIT, file, line, args);
-    int result = MPI_Send_init(buffer, count, datatype, recipient, tag, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_SEND_INIT, file, line, args);
-    return result;
-}
+    // Every process must agree, as the windows are created collectively
+    int enabled = 0;
+    if(MPIM_my_rank == 0)
+    {
+        const char* wait_states = getenv("MPIM_WAIT_STATES");
+        enabled = (wait_states != NULL && atoi(wait_states) != 0);
+    }
+    MPI_Bcast(&enabled, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPIM_wait_states_enabled = enabled;
+    if(!MPIM_wait_states_enabled)
+    {
+        return;
+    }
 
-int MPIM_Sendrecv(const void* buffer_send, int count_send, MPI_Datatype datatype_send, int recipient, int tag_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int sender, int tag_recv, MPI_Comm communicator, MPI_Status* status, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_SENDRECV, file, line, args);
-    int result = MPI_Sendrecv(buffer_send, count_send, datatype_send, recipient, tag_send, buffer_recv, count_recv, datatype_recv, sender, tag_recv, communicator, status);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_SENDRECV, file, line, args);
-    return result;
-}
+    const char* wait_states_top = getenv("MPIM_WAIT_STATES_TOP");
+    if(wait_states_top != NULL && atoi(wait_states_top) > 0)
+    {
+        MPIM_wait_states_top = atoi(wait_states_top);
+    }
 
-int MPIM_Sendrecv_replace(void* buffer, int count_send, MPI_Datatype datatype_send, int recipient, int tag_send, int sender, int tag_recv, MPI_Comm communicator, MPI_Status* status, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_SENDRECV_REPLACE, file, line, args);
-    int result = MPI_Sendrecv_replace(buffer, count_send, datatype_send, recipient, tag_send, sender, tag_recv, communicator, status);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_SENDRECV_REPLACE, file, line, args);
-    return result;
-}
+    MPI_Comm_group(MPI_COMM_WORLD, &MPIM_world_group);
+    MPIM_wait_send_counts = (uint64_t*)calloc(MPIM_my_comm_size, sizeof(uint64_t));
+    MPIM_wait_pair_nanoseconds = (uint64_t*)calloc(2 * MPIM_my_comm_size, sizeof(uint64_t));
+    MPIM_wait_arrivals = (struct MPIM_collective_arrival_t*)calloc(MPIM_my_comm_size, sizeof(struct MPIM_collective_arrival_t));
+    MPIM_stamp_window_buffer = (struct MPIM_send_stamp_t*)calloc(MPIM_my_comm_size * MPIM_WAIT_STAMP_RING, sizeof(struct MPIM_send_stamp_t));
+    if(MPIM_wait_send_counts == NULL || MPIM_wait_pair_nanoseconds == NULL || MPIM_wait_arrivals == NULL || MPIM_stamp_window_buffer == NULL)
+    {
+        printf("Failure in allocating the wait state buffers.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    MPI_Win_create(MPIM_stamp_window_buffer, sizeof(struct MPIM_send_stamp_t) * MPIM_my_comm_size * MPIM_WAIT_STAMP_RING, 1, MPI_INFO_NULL, MPI_COMM_WORLD, &MPIM_stamp_window);
+    MPI_Win_lock_all(0, MPIM_stamp_window);
 
-int MPIM_Ssend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_SSEND, file, line, args);
-    int result = MPI_Ssend(buffer, count, type, dst, tag, comm);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_SSEND, file, line, args);
-    return result;
+    MPI_Aint size = 0;
+    if(MPIM_my_rank == 0)
+    {
+        size = sizeof(struct MPIM_wait_cause_t) * MPIM_my_comm_size + sizeof(struct MPIM_collective_arrival_t) * MPIM_WAIT_ARRIVAL_RING * MPIM_my_comm_size;
+        MPIM_wait_window_buffer = (struct MPIM_wait_cause_t*)calloc(size, 1);
+        if(MPIM_wait_window_buffer == NULL)
+        {
+            printf("Failure in allocating MPIM_wait_window_buffer.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+    }
+    MPI_Win_create(MPIM_wait_window_buffer, size, 1, MPI_INFO_NULL, MPI_COMM_WORLD, &MPIM_wait_window);
+    MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, MPIM_wait_window);
 }
 
-int MPIM_Ssend_init(const void* buffer, int count, MPI_Datatype datatype, int recipient, int tag, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Gives the displacement, in the wait window, of the arrival of a process in an N-to-N collective.
+ * @param[in] sequence The number of the collective.
+ * @param[in] rank The rank of the process.
+ * @return The displacement in bytes.
+ **/
+static MPI_Aint MPIM_wait_arrival_get_displacement(uint64_t sequence, int rank)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_SSEND_INIT, file, line, args);
-    int result = MPI_Ssend_init(buffer, count, datatype, recipient, tag, communicator, request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_SSEND_INIT, file, line, args);
-    return result;
+    return sizeof(struct MPIM_wait_cause_t) * MPIM_my_comm_size + sizeof(struct MPIM_collective_arrival_t) * ((sequence % MPIM_WAIT_ARRIVAL_RING) * MPIM_my_comm_size + rank);
 }
 
-int MPIM_Start(MPI_Request* request, char* file, int line, const char* args)
+/**
+ * @brief Gives the rank in MPI_COMM_WORLD of a rank in a communicator.
+ * @details The group of a communicator is translated once per thread, into a cache invalidated whenever a communicator is freed.
+ * @param[in] communicator The communicator, as given by MPI_Comm_c2f.
+ * @param[in] rank The rank in the communicator.
+ * @return The rank in MPI_COMM_WORLD, -1 for wildcards, MPI_PROC_NULL and ranks of intercommunicators.
+ **/
+static int MPIM_get_world_rank(int32_t communicator, int rank)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_START, file, line, args);
-    int result = MPI_Start(request);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_START, file, line, args);
-    return result;
-}
+    if(rank == MPI_ANY_SOURCE || rank == MPI_PROC_NULL || rank < 0)
+    {
+        return -1;
+    }
+    if(communicator == MPI_Comm_c2f(MPI_COMM_WORLD))
+    {
+        return rank;
+    }
 
-int MPIM_Startall(int count, MPI_Request requests[], char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_STARTALL, file, line, args);
-    int result = MPI_Startall(count, requests);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_STARTALL, file, line, args);
-    return result;
+    unsigned int generation = atomic_load_explicit(&MPIM_communicator_generation, memory_order_relaxed);
+    struct MPIM_communicator_cache_entry_t* entry = &MPIM_communicator_cache[(uint32_t)communicator % MPIM_COMMUNICATOR_CACHE_SIZE];
+    if(entry->generation != generation || entry->communicator != communicator)
+    {
+        free(entry->world_ranks);
+        entry->world_ranks = NULL;
+        entry->size = 0;
+        entry->communicator = communicator;
+        entry->generation = generation;
+
+        MPI_Comm comm = MPI_Comm_f2c(communicator);
+        int is_intercommunicator = 0;
+        MPI_Comm_test_inter(comm, &is_intercommunicator);
+        int size = 0;
+        MPI_Comm_size(comm, &size);
+        int* ranks = (int*)malloc(2 * sizeof(int) * size);
+        if(!is_intercommunicator && ranks != NULL)
+        {
+            for(int i = 0; i < size; i++)
+            {
+                ranks[i] = i;
+            }
+            MPI_Group group;
+            MPI_Comm_group(comm, &group);
+            MPI_Group_translate_ranks(group, size, ranks, MPIM_world_group, ranks + size);
+            MPI_Group_free(&group);
+            memmove(ranks, ranks + size, sizeof(int) * size);
+            entry->world_ranks = ranks;
+            entry->size = size;
+        }
+        else
+        {
+            free(ranks);
+        }
+    }
+    if(rank >= entry->size || entry->world_ranks[rank] == MPI_UNDEFINED)
+    {
+        return -1;
+    }
+    return entry->world_ranks[rank];
 }
 
-int MPIM_Test(MPI_Request* request, int* flag, MPI_Status* status, char* file, int line, const char* args)
+/**
+ * @brief Adds waiting time to the totals of the aggregator.
+ * @details The waiting time is accumulated into the entry of the causing rank on the aggregator. The total of the pair, as measured by this process, competes through MPI_MAXLOC for the process the causing rank delayed the most, so the aggregator holds one entry per rank rather than one per pair.
+ * @param[in] state The wait state.
+ * @param[in] waiting_rank The rank, in MPI_COMM_WORLD, of the process that waited.
+ * @param[in] causing_rank The rank, in MPI_COMM_WORLD, of the process that made it wait.
+ * @param[in] seconds The waiting time, in seconds.
+ **/
+static void MPIM_wait_states_add(enum MPIM_wait_state_t state, int waiting_rank, int causing_rank, double seconds)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TEST, file, line, args);
-    int result = MPI_Test(request, flag, status);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TEST, file, line, args);
-    return result;
+    uint64_t nanoseconds = (seconds > 0.0) ? (uint64_t)(seconds * 1.0E9) : 0;
+    if(nanoseconds == 0 || waiting_rank == causing_rank)
+    {
+        return;
+    }
+    uint64_t* pair = (waiting_rank == MPIM_my_rank) ? &MPIM_wait_pair_nanoseconds[causing_rank] : &MPIM_wait_pair_nanoseconds[MPIM_my_comm_size + waiting_rank];
+    struct MPIM_long_int_t most_delayed;
+    most_delayed.value = (long)__atomic_add_fetch(pair, nanoseconds, __ATOMIC_RELAXED);
+    most_delayed.rank = waiting_rank;
+
+    MPI_Aint displacement = sizeof(struct MPIM_wait_cause_t) * (MPI_Aint)causing_rank;
+    MPI_Accumulate(&nanoseconds, 1, MPI_UINT64_T, 0, displacement + offsetof(struct MPIM_wait_cause_t, nanoseconds) + sizeof(uint64_t) * state, 1, MPI_UINT64_T, MPI_SUM, MPIM_wait_window);
+    MPI_Accumulate(&most_delayed, 1, MPI_LONG_INT, 0, displacement + offsetof(struct MPIM_wait_cause_t, most_delayed), 1, MPI_LONG_INT, MPI_MAXLOC, MPIM_wait_window);
+    MPI_Win_flush_local(0, MPIM_wait_window);
 }
 
-int MPIM_Test_cancelled(const MPI_Status* status, int* flag, char* file, int line, const char* args)
+/**
+ * @brief Stamps point-to-point sends and publishes the arrival in N-to-N collectives on MPI_COMM_WORLD, before the MPI routine is issued.
+ * @param[in] type The message type of the MPI routine.
+ * @param[in] arguments The arguments of the call.
+ * @param[in] now The current timestamp, in ticks of the clock source.
+ **/
+static void MPIM_wait_states_before(enum MPIM_message_type_t type, const struct MPIM_arguments_t* arguments, uint64_t now)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TEST_CANCELLED, file, line, args);
-    int result = MPI_Test_cancelled(status, flag);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TEST_CANCELLED, file, line, args);
-    return result;
+    MPIM_my_wait_entry_time = MPIM_clock_to_aggregator_time(&MPIM_my_clock, now);
+    if((arguments->kind == MPIM_ARGUMENTS_SEND || arguments->kind == MPIM_ARGUMENTS_SENDRECV) && !(MPIM_routine_attributes_t[type] & MPIM_ROUTINE_PERSISTENT))
+    {
+        int peer = (arguments->kind == MPIM_ARGUMENTS_SEND) ? arguments->p2p.peer : arguments->sendrecv.destination;
+        int destination = MPIM_get_world_rank(arguments->communicator, peer);
+        if(destination < 0)
+        {
+            return;
+        }
+        struct MPIM_send_stamp_t stamp;
+        stamp.sequence = __atomic_add_fetch(&MPIM_wait_send_counts[destination], 1, __ATOMIC_RELAXED);
+        stamp.time = MPIM_my_wait_entry_time;
+        stamp.tag = (arguments->kind == MPIM_ARGUMENTS_SEND) ? arguments->p2p.tag : arguments->sendrecv.send_tag;
+        stamp.communicator = arguments->communicator;
+        stamp.synchronous = (type == MPIM_MESSAGE_SSEND);
+        stamp.consumed = 0;
+        MPI_Aint displacement = sizeof(struct MPIM_send_stamp_t) * ((MPI_Aint)MPIM_my_rank * MPIM_WAIT_STAMP_RING + stamp.sequence % MPIM_WAIT_STAMP_RING);
+        MPI_Put(&stamp, sizeof(struct MPIM_send_stamp_t), MPI_BYTE, destination, displacement, sizeof(struct MPIM_send_stamp_t), MPI_BYTE, MPIM_stamp_window);
+        // The stamp must have reached the receiver before the message can
+        MPI_Win_flush(destination, MPIM_stamp_window);
+    }
+    else if((MPIM_routine_attributes_t[type] & MPIM_ROUTINE_N_TO_N) && arguments->communicator == MPI_Comm_c2f(MPI_COMM_WORLD))
+    {
+        // Collectives on a communicator are issued in the same order by all its processes, so their numbers match
+        struct MPIM_collective_arrival_t arrival;
+        arrival.sequence = ++MPIM_wait_collective_count;
+        arrival.time = MPIM_my_wait_entry_time;
+        MPI_Put(&arrival, sizeof(struct MPIM_collective_arrival_t), MPI_BYTE, 0, MPIM_wait_arrival_get_displacement(arrival.sequence, MPIM_my_rank), sizeof(struct MPIM_collective_arrival_t), MPI_BYTE, MPIM_wait_window);
+        MPI_Win_flush(0, MPIM_wait_window);
+    }
 }
 
-int MPIM_Testall(int count, MPI_Request* requests, int* flag, MPI_Status* statuses, char* file, int line, const char* args)
+/**
+ * @brief Matches a completed receive with the send that it received, and marks that send as matched.
+ * @details A receive is matched with the oldest unmatched stamp of its sender bearing the same communicator and tag, which is the order in which MPI matches messages.
+ * @param[in] source The rank of the sender in MPI_COMM_WORLD.
+ * @param[in] communicator The communicator of the receive, as given by MPI_Comm_c2f.
+ * @param[in] tag The tag of the receive, which may be MPI_ANY_TAG.
+ * @return The stamp of the send, NULL if none matches.
+ **/
+static struct MPIM_send_stamp_t* MPIM_wait_stamp_match(int source, int32_t communicator, int tag)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TESTALL, file, line, args);
-    int result = MPI_Testall(count, requests, flag, statuses);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TESTALL, file, line, args);
-    return result;
+    struct MPIM_send_stamp_t* stamps = &MPIM_stamp_window_buffer[source * MPIM_WAIT_STAMP_RING];
+    struct MPIM_send_stamp_t* matched = NULL;
+    for(int i = 0; i < MPIM_WAIT_STAMP_RING; i++)
+    {
+        uint64_t sequence = __atomic_load_n(&stamps[i].sequence, __ATOMIC_ACQUIRE);
+        if(sequence != 0 && !stamps[i].consumed && stamps[i].communicator == communicator && (tag == MPI_ANY_TAG || stamps[i].tag == tag) && (matched == NULL || sequence < matched->sequence))
+        {
+            matched = &stamps[i];
+        }
+    }
+    if(matched != NULL)
+    {
+        matched->consumed = 1;
+    }
+    return matched;
 }
 
-int MPIM_Testany(int count, MPI_Request* requests, int* index, int* flag, MPI_Status* status, char* file, int line, const char* args)
+/**
+ * @brief Classifies the waiting time of a completed receive or N-to-N collective on MPI_COMM_WORLD.
+ * @details A receive waited for a late sender if the send started after the receive, otherwise a synchronous sender waited for a late receiver.
+ * In an N-to-N collective, every process waits for the last one to enter it.
+ * Nonblocking receives are classified by MPIM_wait_states_complete instead, once a completion call completes them.
+ * @param[in] type The message type of the MPI routine.
+ * @param[in] arguments The arguments of the call, wildcards being resolved for MPI_Recv.
+ * @param[in] now The current timestamp, in ticks of the clock source.
+ **/
+static void MPIM_wait_states_after(enum MPIM_message_type_t type, const struct MPIM_arguments_t* arguments, uint64_t now)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TESTANY, file, line, args);
-    int result = MPI_Testany(count, requests, index, flag, status);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TESTANY, file, line, args);
-    return result;
+    double start = MPIM_my_wait_entry_time;
+    double end = MPIM_clock_to_aggregator_time(&MPIM_my_clock, now);
+    if(type == MPIM_MESSAGE_RECV || arguments->kind == MPIM_ARGUMENTS_SENDRECV)
+    {
+        int peer = (arguments->kind == MPIM_ARGUMENTS_RECEIVE) ? arguments->p2p.peer : arguments->sendrecv.source;
+        int tag = (arguments->kind == MPIM_ARGUMENTS_RECEIVE) ? arguments->p2p.tag : arguments->sendrecv.receive_tag;
+        int source = MPIM_get_world_rank(arguments->communicator, peer);
+        if(source < 0)
+        {
+            return;
+        }
+        struct MPIM_send_stamp_t* matched = MPIM_wait_stamp_match(source, arguments->communicator, tag);
+        if(matched == NULL)
+        {
+            return;
+        }
+        if(matched->time > start)
+        {
+            MPIM_wait_states_add(MPIM_WAIT_LATE_SENDER, MPIM_my_rank, source, ((matched->time < end) ? matched->time : end) - start);
+        }
+        else if(matched->synchronous)
+        {
+            MPIM_wait_states_add(MPIM_WAIT_LATE_RECEIVER, source, MPIM_my_rank, start - matched->time);
+        }
+    }
+    else if((MPIM_routine_attributes_t[type] & MPIM_ROUTINE_N_TO_N) && arguments->communicator == MPI_Comm_c2f(MPI_COMM_WORLD))
+    {
+        // Every process published its arrival before entering, so all arrivals are there once the collective completes
+        MPI_Get(MPIM_wait_arrivals, sizeof(struct MPIM_collective_arrival_t) * MPIM_my_comm_size, MPI_BYTE, 0, MPIM_wait_arrival_get_displacement(MPIM_wait_collective_count, 0), sizeof(struct MPIM_collective_arrival_t) * MPIM_my_comm_size, MPI_BYTE, MPIM_wait_window);
+        MPI_Win_flush(0, MPIM_wait_window);
+        int last = -1;
+        for(int i = 0; i < MPIM_my_comm_size; i++)
+        {
+            if(MPIM_wait_arrivals[i].sequence != MPIM_wait_collective_count)
+            {
+                // A process already went MPIM_WAIT_ARRIVAL_RING collectives further, the arrivals of this one are lost
+                return;
+            }
+            if(last == -1 || MPIM_wait_arrivals[i].time > MPIM_wait_arrivals[last].time)
+            {
+                last = i;
+            }
+        }
+        MPIM_wait_states_add(MPIM_WAIT_N_TO_N, MPIM_my_rank, last, MPIM_wait_arrivals[last].time - start);
+    }
 }
 
-int MPIM_Testsome(int count, MPI_Request* requests, int* index_count, int* indexes, MPI_Status* statuses, char* file, int line, const char* args)
+/**
+ * @brief Gives the entry of the cache of nonblocking receives of the calling thread in which a request falls.
+ * @param[in] request The request.
+ * @return The entry, which may hold another request.
+ **/
+static inline struct MPIM_wait_receive_t* MPIM_wait_receive_get_entry(MPI_Request request)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TESTSOME, file, line, args);
-    int result = MPI_Testsome(count, requests, index_count, indexes, statuses);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TESTSOME, file, line, args);
-    return result;
+    return &MPIM_wait_receives[((uintptr_t)request >> 4) % MPIM_WAIT_RECEIVE_CACHE_SIZE];
 }
 
-int MPIM_Type_commit(MPI_Datatype* datatype, char* file, int line, const char* args)
+/**
+ * @brief Remembers a nonblocking receive once posted, until a completion call completes it.
+ * @param[in] arguments The arguments of the receive.
+ * @param[in] request The request of the receive.
+ **/
+static void MPIM_wait_states_post(const struct MPIM_arguments_t* arguments, MPI_Request request)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_COMMIT, file, line, args);
-    int result = MPI_Type_commit(datatype);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_COMMIT, file, line, args);
-    return result;
+    if(!MPIM_wait_states_enabled || request == MPI_REQUEST_NULL || arguments->p2p.peer == MPI_PROC_NULL)
+    {
+        return;
+    }
+    struct MPIM_wait_receive_t* receive = MPIM_wait_receive_get_entry(request);
+    receive->request = request;
+    receive->posted = MPIM_my_wait_entry_time;
+    receive->communicator = arguments->communicator;
+    receive->source = arguments->p2p.peer;
+    receive->tag = arguments->p2p.tag;
+    receive->generation = atomic_load_explicit(&MPIM_wait_receive_generation, memory_order_relaxed);
 }
 
-int MPIM_Type_contiguous(int count, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args)
+/**
+ * @brief Finds the nonblocking receives among the requests of a completion call, before MPI forgets the requests it completes.
+ * @param[in] count The number of requests.
+ * @param[in] requests The requests.
+ **/
+static void MPIM_wait_states_prepare(int count, const MPI_Request requests[])
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_CONTIGUOUS, file, line, args);
-    int result = MPI_Type_contiguous(count, old_datatype, new_datatype);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_CONTIGUOUS, file, line, args);
-    return result;
+    MPIM_my_wait_pending_count = 0;
+    if(!MPIM_wait_states_enabled)
+    {
+        return;
+    }
+    unsigned int generation = atomic_load_explicit(&MPIM_wait_receive_generation, memory_order_relaxed);
+    for(int i = 0; i < count && MPIM_my_wait_pending_count < MPIM_WAIT_COMPLETION_MAX; i++)
+    {
+        struct MPIM_wait_receive_t* receive = MPIM_wait_receive_get_entry(requests[i]);
+        if(requests[i] != MPI_REQUEST_NULL && receive->request == requests[i] && receive->generation == generation)
+        {
+            struct MPIM_wait_pending_t* pending = &MPIM_my_wait_pending[MPIM_my_wait_pending_count++];
+            pending->index = i;
+            pending->receive = *receive;
+        }
+    }
 }
 
-int MPIM_Type_create_hindexed(int block_count, int* block_lengths, MPI_Aint* displacements, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args)
+/**
+ * @brief Classifies the waiting time of the nonblocking receives completed by a completion call.
+ * @details Every completed receive is matched with its send as a blocking receive is. A synchronous send started before the receive was posted waited for a late receiver.
+ * A waiting call that completed sends started after it entered waited for late senders; the waiting time up to the start of each send is charged to its sender, less the time already charged to the senders that started before, so that waiting once for several senders is counted once.
+ * @param[in] type The message type of the completion call.
+ * @param[in] count The number of requests completed.
+ * @param[in] indices The indices of the requests completed, NULL if the first count requests were completed.
+ * @param[in] statuses The statuses of the requests completed, in the same order, which may be MPI_STATUSES_IGNORE.
+ **/
+static void MPIM_wait_states_complete(enum MPIM_message_type_t type, int count, const int indices[], const MPI_Status statuses[])
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_CREATE_HINDEXED, file, line, args);
-    int result = MPI_Type_create_hindexed(block_count, block_lengths, displacements, old_datatype, new_datatype);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_CREATE_HINDEXED, file, line, args);
-    return result;
-}
+    if(MPIM_my_wait_pending_count == 0)
+    {
+        return;
+    }
+    double start = MPIM_my_wait_entry_time;
+    double end = MPIM_clock_to_aggregator_time(&MPIM_my_clock, MPIM_get_ticks());
+    bool waiting = (MPIM_routine_attributes_t[type] & MPIM_ROUTINE_BLOCKING);
+    bool has_statuses = (statuses != MPI_STATUSES_IGNORE && statuses != MPI_STATUS_IGNORE);
+
+    // The senders that started after the call entered, sorted by the time at which they started
+    int late_count = 0;
+    int late_sources[MPIM_WAIT_COMPLETION_MAX];
+    double late_times[MPIM_WAIT_COMPLETION_MAX];
+    for(int i = 0; i < count; i++)
+    {
+        int index = (indices == NULL) ? i : indices[i];
+        const struct MPIM_wait_pending_t* pending = NULL;
+        for(int j = 0; j < MPIM_my_wait_pending_count && pending == NULL; j++)
+        {
+            if(MPIM_my_wait_pending[j].index == index)
+            {
+                pending = &MPIM_my_wait_pending[j];
+            }
+        }
+        if(pending == NULL)
+        {
+            continue;
+        }
+        struct MPIM_wait_receive_t* receive = MPIM_wait_receive_get_entry(pending->receive.request);
+        if(receive->request == pending->receive.request)
+        {
+            receive->request = MPI_REQUEST_NULL;
+        }
 
-int MPIM_Type_create_hindexed_block(int block_count, int block_length, MPI_Aint* displacements, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_CREATE_HINDEXED_BLOCK, file, line, args);
-    int result = MPI_Type_create_hindexed_block(block_count, block_length, displacements, old_datatype, new_datatype);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_CREATE_HINDEXED_BLOCK, file, line, args);
-    return result;
+        // Wildcards are resolved by the status, without which the sender is unknown
+        int peer = pending->receive.source;
+        int tag = pending->receive.tag;
+        if(has_statuses)
+        {
+            peer = statuses[i].MPI_SOURCE;
+            tag = statuses[i].MPI_TAG;
+        }
+        int source = MPIM_get_world_rank(pending->receive.communicator, peer);
+        if(source < 0)
+        {
+            continue;
+        }
+        struct MPIM_send_stamp_t* matched = MPIM_wait_stamp_match(source, pending->receive.communicator, tag);
+        if(matched == NULL)
+        {
+            continue;
+        }
+        if(matched->time < pending->receive.posted && matched->synchronous)
+        {
+            MPIM_wait_states_add(MPIM_WAIT_LATE_RECEIVER, source, MPIM_my_rank, pending->receive.posted - matched->time);
+        }
+        else if(waiting && matched->time > start)
+        {
+            int position = late_count++;
+            while(position > 0 && late_times[position - 1] > matched->time)
+            {
+                late_times[position] = late_times[position - 1];
+                late_sources[position] = late_sources[position - 1];
+                position--;
+            }
+            late_times[position] = matched->time;
+            late_sources[position] = source;
+        }
+    }
+    MPIM_my_wait_pending_count = 0;
+
+    double charged = start;
+    for(int i = 0; i < late_count && charged < end; i++)
+    {
+        double until = (late_times[i] < end) ? late_times[i] : end;
+        MPIM_wait_states_add(MPIM_WAIT_LATE_SENDER, MPIM_my_rank, late_sources[i], until - charged);
+        charged = until;
+    }
 }
 
-int MPIM_Type_create_hvector(int block_count, int block_length, MPI_Aint stride, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_CREATE_HVECTOR, file, line, args);
-    int result = MPI_Type_create_hvector(block_count, block_length, stride, old_datatype, new_datatype);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_CREATE_HVECTOR, file, line, args);
-    return result;
+/**
+ * @brief Prints the ranks causing the most waiting time to other ranks, with the wait states making it up and the rank they delay the most.
+ * @details This function is called by the aggregator, which reads the waiting times from its own window buffer, holding one entry per rank, so that it takes time linear in the number of ranks.
+ **/
+static void MPIM_wait_states_print()
+{
+    int rank_count = MPIM_my_comm_size;
+    const volatile struct MPIM_wait_cause_t* causes = MPIM_wait_window_buffer;
+    uint64_t* totals = (uint64_t*)malloc(rank_count * sizeof(uint64_t));
+    if(totals == NULL)
+    {
+        return;
+    }
+    for(int causing = 0; causing < rank_count; causing++)
+    {
+        totals[causing] = 0;
+        for(int state = 0; state < MPIM_WAIT_STATE_COUNT; state++)
+        {
+            totals[causing] += causes[causing].nanoseconds[state];
+        }
+    }
+
+    printf("\nRanks causing the most waiting time to other ranks, in seconds:\n");
+    printf("+--------+------------+--------------+---------------+-------------+-------------------------+\n");
+    printf("| %6s | %10s | %12s | %13s | %11s | %23s |\n", "Rank", "Total", MPIM_wait_state_name_t[MPIM_WAIT_LATE_SENDER], MPIM_wait_state_name_t[MPIM_WAIT_LATE_RECEIVER], MPIM_wait_state_name_t[MPIM_WAIT_N_TO_N], "Most delayed rank");
+    printf("+--------+------------+--------------+---------------+-------------+-------------------------+\n");
+    for(int listed = 0; listed < MPIM_wait_states_top; listed++)
+    {
+        // Selection of the next rank, the list being short
+        int top = -1;
+        for(int causing = 0; causing < rank_count; causing++)
+        {
+            if(totals[causing] > 0 && (top == -1 || totals[causing] > totals[top]))
+            {
+                top = causing;
+            }
+        }
+        if(top == -1)
+        {
+            break;
+        }
+        const volatile struct MPIM_wait_cause_t* cause = &causes[top];
+        char delayed[32];
+        snprintf(delayed, sizeof(delayed), "%d (%.6f)", cause->most_delayed.rank, cause->most_delayed.value / 1.0E9);
+        printf("| %6d | %10.6f | %12.6f | %13.6f | %11.6f | %23s |\n", top, totals[top] / 1.0E9, cause->nanoseconds[MPIM_WAIT_LATE_SENDER] / 1.0E9, cause->nanoseconds[MPIM_WAIT_LATE_RECEIVER] / 1.0E9, cause->nanoseconds[MPIM_WAIT_N_TO_N] / 1.0E9, delayed);
+        totals[top] = 0;
+    }
+    printf("+--------+------------+--------------+---------------+-------------+-------------------------+\n");
+
+    free(totals);
+}
+
+/**
+ * @brief Frees the wait state windows, process 0 then printing the final wait state report.
+ * @details Must be called collectively, once the manager thread has stopped.
+ **/
+static void MPIM_wait_states_finalise()
+{
+    if(!MPIM_wait_states_enabled)
+    {
+        return;
+    }
+    MPI_Win_unlock_all(MPIM_stamp_window);
+    MPI_Win_free(&MPIM_stamp_window);
+    MPI_Win_unlock(0, MPIM_wait_window);
+    // Freeing the window completes the waiting times accumulated by every process
+    MPI_Win_free(&MPIM_wait_window);
+    if(MPIM_my_rank == 0)
+    {
+        printf("\nMPI_monitor: wait states of %d processes", MPIM_my_comm_size);
+        MPIM_wait_states_print();
+    }
+    MPI_Group_free(&MPIM_world_group);
+    free(MPIM_stamp_window_buffer);
+    free(MPIM_wait_window_buffer);
+    free(MPIM_wait_send_counts);
+    free(MPIM_wait_pair_nanoseconds);
+    free(MPIM_wait_arrivals);
+}
+
+/**
+ * @brief Locks a table of the process if several threads may issue MPI calls.
+ * @param[in] mutex The mutex protecting the table.
+ * @return Indicates if the table was locked, to be passed to MPIM_table_unlock.
+ **/
+static bool MPIM_table_lock(pthread_mutex_t* mutex)
+{
+    bool shared = (MPIM_threads_per_process > 1);
+    if(shared)
+    {
+        pthread_mutex_lock(mutex);
+    }
+    return shared;
+}
+
+/**
+ * @brief Unlocks a table of the process.
+ * @param[in] mutex The mutex protecting the table.
+ * @param[in] shared Indicates if the table was locked, as returned by MPIM_table_lock.
+ **/
+static void MPIM_table_unlock(pthread_mutex_t* mutex, bool shared)
+{
+    if(shared)
+    {
+        pthread_mutex_unlock(mutex);
+    }
+}
+
+/**
+ * @brief Gathers fixed-size records from all processes on process 0.
+ * @details Must be called collectively.
+ * @param[in] records The records of the calling process.
+ * @param[in] count The number of records of the calling process.
+ * @param[in] record_size The size of a record, in bytes.
+ * @param[out] total The number of records over all processes, set on every process.
+ * @return The records of all processes in rank order on process 0, to be freed by the caller; NULL on other processes or if there is no record.
+ **/
+static void* MPIM_gather_records(const void* records, int count, size_t record_size, int* total)
+{
+    int* process_counts = NULL;
+    int* displacements = NULL;
+    char* gathered = NULL;
+    MPI_Allreduce(&count, total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if(*total == 0)
+    {
+        return NULL;
+    }
+
+    MPI_Datatype record_datatype;
+    MPI_Type_contiguous(record_size, MPI_BYTE, &record_datatype);
+    MPI_Type_commit(&record_datatype);
+    if(MPIM_my_rank == 0)
+    {
+        process_counts = (int*)malloc(MPIM_my_comm_size * sizeof(int));
+        displacements = (int*)malloc(MPIM_my_comm_size * sizeof(int));
+        gathered = (char*)malloc(*total * record_size);
+        if(process_counts == NULL || displacements == NULL || gathered == NULL)
+        {
+            printf("Failure in allocating the gathered records.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+    }
+    MPI_Gather(&count, 1, MPI_INT, process_counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if(MPIM_my_rank == 0)
+    {
+        displacements[0] = 0;
+        for(int i = 1; i < MPIM_my_comm_size; i++)
+        {
+            displacements[i] = displacements[i - 1] + process_counts[i - 1];
+        }
+    }
+    MPI_Gatherv(records, count, record_datatype, gathered, process_counts, displacements, record_datatype, 0, MPI_COMM_WORLD);
+    MPI_Type_free(&record_datatype);
+    free(process_counts);
+    free(displacements);
+    return gathered;
+}
+
+/**
+ * @brief Gives the first bucket of the persistent request index in which a handle is looked for.
+ * @param[in] request The request handle.
+ * @return The index of the bucket.
+ **/
+static int MPIM_persistent_get_bucket(MPI_Request request)
+{
+    // Handles are pointers in some implementations and integers in others
+    uint64_t key = 0;
+    memcpy(&key, &request, (sizeof(MPI_Request) < sizeof(key)) ? sizeof(MPI_Request) : sizeof(key));
+    return (int)((key * 0x9E3779B97F4A7C15ULL) >> 32) % MPIM_PERSISTENT_INDEX_SIZE;
+}
+
+/**
+ * @brief Finds the bucket of the persistent request index holding a handle.
+ * @details Takes no lock: buckets are read with acquire semantics, after the request they point to is filled in. A request being created or freed concurrently is never the one looked for, since MPI forbids using a handle before its creation returns or after its release; an entry being reused only ever holds either handle, as it is read and written atomically.
+ * @param[in] request The request handle.
+ * @return The index of the bucket, -1 if the handle is not a tracked persistent request.
+ **/
+static int MPIM_persistent_find(MPI_Request request)
+{
+    int bucket = MPIM_persistent_get_bucket(request);
+    for(int probe = 0; probe < MPIM_PERSISTENT_INDEX_SIZE; probe++)
+    {
+        int candidate = (bucket + probe) % MPIM_PERSISTENT_INDEX_SIZE;
+        int32_t entry = __atomic_load_n(&MPIM_persistent_index[candidate], __ATOMIC_ACQUIRE);
+        if(entry == 0)
+        {
+            return -1;
+        }
+        if(entry > 0 && __atomic_load_n(&MPIM_persistent_requests[entry - 1].request, __ATOMIC_RELAXED) == request)
+        {
+            return candidate;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Starts tracking a persistent request once it is created.
+ * @param[in] type The message type of the routine that created the request.
+ * @param[in] arguments The arguments the request was created with.
+ * @param[in] callsite The return address of the MPIM_ routine that created the request.
+ * @param[in] line The line at which the request was created.
+ * @param[in] request The request handle.
+ **/
+static void MPIM_persistent_create(enum MPIM_message_type_t type, const struct MPIM_arguments_t* arguments, const void* callsite, int line, MPI_Request request)
+{
+    struct MPIM_message_t located;
+    MPIM_message_set_callsite(&located, callsite);
+
+    bool shared = MPIM_table_lock(&MPIM_persistent_mutex);
+    int count = atomic_load_explicit(&MPIM_persistent_request_count, memory_order_relaxed);
+    int index = count;
+    if(MPIM_persistent_free_entry_count > 0)
+    {
+        index = MPIM_persistent_free_entries[--MPIM_persistent_free_entry_count];
+    }
+    else if(count == MPIM_MAX_PERSISTENT_REQUESTS)
+    {
+        MPIM_persistent_requests_dropped++;
+        MPIM_table_unlock(&MPIM_persistent_mutex, shared);
+        return;
+    }
+    else
+    {
+        atomic_store_explicit(&MPIM_persistent_request_count, count + 1, memory_order_relaxed);
+    }
+    struct MPIM_persistent_request_t* entry = &MPIM_persistent_requests[index];
+    entry->type = type;
+    entry->state = MPIM_PERSISTENT_INACTIVE;
+    entry->module = located.callsite_module;
+    entry->offset = located.callsite_offset;
+    entry->line = line;
+    entry->arguments = *arguments;
+    entry->cycles = 0;
+    entry->start = 0;
+    entry->nanoseconds = 0;
+    entry->max_nanoseconds = 0;
+    entry->requests = 1;
+    __atomic_store_n(&entry->request, request, __ATOMIC_RELAXED);
+
+    // Removed buckets are reused, the index holding at most half as many requests as buckets
+    int bucket = MPIM_persistent_get_bucket(request);
+    while(MPIM_persistent_index[bucket] > 0)
+    {
+        bucket = (bucket + 1) % MPIM_PERSISTENT_INDEX_SIZE;
+    }
+    __atomic_store_n(&MPIM_persistent_index[bucket], index + 1, __ATOMIC_RELEASE);
+    MPIM_table_unlock(&MPIM_persistent_mutex, shared);
+}
+
+/**
+ * @brief Marks persistent requests as started.
+ * @details Requests that are not tracked persistent requests are ignored. Nothing is allocated, whatever the number of requests. No lock is taken: MPI forbids two threads from using the same request at once, so the entry of a request is only updated by the thread using it.
+ * @param[in] count The number of requests.
+ * @param[in] requests The request handles.
+ **/
+static void MPIM_persistent_start(int count, const MPI_Request requests[])
+{
+    if(atomic_load_explicit(&MPIM_persistent_request_count, memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    uint64_t now = MPIM_get_ticks();
+    for(int i = 0; i < count; i++)
+    {
+        int bucket = MPIM_persistent_find(requests[i]);
+        if(bucket != -1)
+        {
+            struct MPIM_persistent_request_t* entry = &MPIM_persistent_requests[MPIM_persistent_index[bucket] - 1];
+            if(entry->state != MPIM_PERSISTENT_ACTIVE)
+            {
+                atomic_fetch_add_explicit(&MPIM_persistent_active_count, 1, memory_order_relaxed);
+            }
+            entry->state = MPIM_PERSISTENT_ACTIVE;
+            entry->start = now;
+        }
+    }
+}
+
+/**
+ * @brief Marks persistent requests as completed, ending their current cycle.
+ * @details Completion routines leave the handle of a persistent request unchanged, whereas those of other requests are set to MPI_REQUEST_NULL and are ignored. No lock is taken, as when starting requests.
+ * @param[in] count The number of requests completed.
+ * @param[in] requests The request handles passed to the completion routine.
+ * @param[in] indices The indices of the completed requests in requests, NULL if the first count requests completed.
+ **/
+static void MPIM_persistent_complete(int count, const MPI_Request requests[], const int indices[])
+{
+    if(atomic_load_explicit(&MPIM_persistent_request_count, memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    uint64_t now = MPIM_get_ticks();
+    for(int i = 0; i < count; i++)
+    {
+        MPI_Request request = requests[(indices == NULL) ? i : indices[i]];
+        int bucket = (request == MPI_REQUEST_NULL) ? -1 : MPIM_persistent_find(request);
+        if(bucket == -1)
+        {
+            continue;
+        }
+        struct MPIM_persistent_request_t* entry = &MPIM_persistent_requests[MPIM_persistent_index[bucket] - 1];
+        if(entry->state == MPIM_PERSISTENT_ACTIVE)
+        {
+            uint64_t nanoseconds = (uint64_t)((now - entry->start) * 1.0E9 / MPIM_my_clock.ticks_per_second);
+            entry->state = MPIM_PERSISTENT_INACTIVE;
+            entry->cycles++;
+            entry->nanoseconds += nanoseconds;
+            if(nanoseconds > entry->max_nanoseconds)
+            {
+                entry->max_nanoseconds = nanoseconds;
+            }
+            atomic_fetch_sub_explicit(&MPIM_persistent_active_count, 1, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Adds the statistics of a freed persistent request to the sum of the requests freed at the same callsite, with the same routine and arguments.
+ * @details Called with MPIM_persistent_mutex held.
+ * @param[in] entry The freed request.
+ **/
+static void MPIM_persistent_fold(const struct MPIM_persistent_request_t* entry)
+{
+    struct MPIM_persistent_request_t* sum = NULL;
+    for(int i = 0; i < MPIM_persistent_freed_count && sum == NULL; i++)
+    {
+        struct MPIM_persistent_request_t* candidate = &MPIM_persistent_freed[i];
+        if(candidate->module == entry->module && candidate->offset == entry->offset && candidate->type == entry->type && memcmp(&candidate->arguments, &entry->arguments, sizeof(struct MPIM_arguments_t)) == 0)
+        {
+            sum = candidate;
+        }
+    }
+    if(sum == NULL)
+    {
+        if(MPIM_persistent_freed_count == MPIM_MAX_PERSISTENT_CALLSITES)
+        {
+            MPIM_persistent_requests_dropped++;
+            return;
+        }
+        sum = &MPIM_persistent_freed[MPIM_persistent_freed_count++];
+        *sum = *entry;
+        sum->request = MPI_REQUEST_NULL;
+        sum->state = MPIM_PERSISTENT_FREED;
+        return;
+    }
+    sum->requests++;
+    sum->cycles += entry->cycles;
+    sum->nanoseconds += entry->nanoseconds;
+    if(entry->max_nanoseconds > sum->max_nanoseconds)
+    {
+        sum->max_nanoseconds = entry->max_nanoseconds;
+    }
+}
+
+/**
+ * @brief Stops tracking the persistent request of a bucket of the index.
+ * @details The handle may be reused by MPI for another request afterwards, so it is removed from the index. The statistics of the request are added to those of the requests freed at its callsite, for the report, and its entry is left for a later request. Called with MPIM_persistent_mutex held.
+ * @param[in] bucket The bucket holding the request.
+ **/
+static void MPIM_persistent_release(int bucket)
+{
+    struct MPIM_persistent_request_t* entry = &MPIM_persistent_requests[MPIM_persistent_index[bucket] - 1];
+    if(entry->state == MPIM_PERSISTENT_ACTIVE)
+    {
+        atomic_fetch_sub_explicit(&MPIM_persistent_active_count, 1, memory_order_relaxed);
+    }
+    entry->state = MPIM_PERSISTENT_FREED;
+    __atomic_store_n(&MPIM_persistent_index[bucket], -1, __ATOMIC_RELEASE);
+    MPIM_persistent_fold(entry);
+    __atomic_store_n(&entry->request, MPI_REQUEST_NULL, __ATOMIC_RELAXED);
+    MPIM_persistent_free_entries[MPIM_persistent_free_entry_count++] = (int32_t)(entry - MPIM_persistent_requests);
+}
+
+/**
+ * @brief Stops tracking a persistent request as it is freed.
+ * @param[in] request The request handle, which may not be a persistent request.
+ **/
+static void MPIM_persistent_free(MPI_Request request)
+{
+    if(atomic_load_explicit(&MPIM_persistent_request_count, memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    bool shared = MPIM_table_lock(&MPIM_persistent_mutex);
+    int bucket = MPIM_persistent_find(request);
+    if(bucket != -1)
+    {
+        MPIM_persistent_release(bucket);
+    }
+    MPIM_table_unlock(&MPIM_persistent_mutex, shared);
+}
+
+/**
+ * @brief Stops tracking every persistent request, as monitoring is switched on again.
+ * @details The requests may have been started, completed or freed while monitoring was off, and their handles reused. Their statistics so far are added to those of the requests freed at their callsite, and later calls on them are ignored.
+ **/
+static void MPIM_persistent_forget()
+{
+    if(atomic_load_explicit(&MPIM_persistent_request_count, memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    bool shared = MPIM_table_lock(&MPIM_persistent_mutex);
+    for(int bucket = 0; bucket < MPIM_PERSISTENT_INDEX_SIZE; bucket++)
+    {
+        if(MPIM_persistent_index[bucket] > 0)
+        {
+            MPIM_persistent_release(bucket);
+        }
+    }
+    MPIM_table_unlock(&MPIM_persistent_mutex, shared);
+}
+
+/// Hooks of the HOOKED and COMPLETING routines of MPIM_ROUTINES, given the arguments recorded, the callsite, the line and the arguments of the call once MPI returned successfully
+#define MPIM_hook_Bsend_init(arguments, callsite, line, buffer, count, datatype, destination, tag, communicator, request) MPIM_persistent_create(MPIM_MESSAGE_BSEND_INIT, arguments, callsite, line, *(request))
+#define MPIM_hook_Recv_init(arguments, callsite, line, buffer, count, datatype, source, tag, communicator, request) MPIM_persistent_create(MPIM_MESSAGE_RECV_INIT, arguments, callsite, line, *(request))
+#define MPIM_hook_Rsend_init(arguments, callsite, line, buffer, count, datatype, destination, tag, communicator, request) MPIM_persistent_create(MPIM_MESSAGE_RSEND_INIT, arguments, callsite, line, *(request))
+#define MPIM_hook_Send_init(arguments, callsite, line, buffer, count, datatype, destination, tag, communicator, request) MPIM_persistent_create(MPIM_MESSAGE_SEND_INIT, arguments, callsite, line, *(request))
+#define MPIM_hook_Ssend_init(arguments, callsite, line, buffer, count, datatype, destination, tag, communicator, request) MPIM_persistent_create(MPIM_MESSAGE_SSEND_INIT, arguments, callsite, line, *(request))
+#define MPIM_hook_Start(arguments, callsite, line, request) MPIM_persistent_start(1, request)
+#define MPIM_hook_Startall(arguments, callsite, line, count, requests) MPIM_persistent_start(count, requests)
+#define MPIM_hook_Irecv(arguments, callsite, line, buffer, count, datatype, source, tag, communicator, request) MPIM_wait_states_post(arguments, *(request))
+#define MPIM_hook_Test(arguments, callsite, line, request, flag, status) do { MPIM_persistent_complete(*(flag) ? 1 : 0, request, NULL); MPIM_wait_states_complete(MPIM_MESSAGE_TEST, *(flag) ? 1 : 0, NULL, status); } while(0)
+#define MPIM_hook_Testall(arguments, callsite, line, count, requests, flag, statuses) do { MPIM_persistent_complete(*(flag) ? (count) : 0, requests, NULL); MPIM_wait_states_complete(MPIM_MESSAGE_TESTALL, *(flag) ? (count) : 0, NULL, statuses); } while(0)
+#define MPIM_hook_Testany(arguments, callsite, line, count, requests, index, flag, status) do { MPIM_persistent_complete((*(flag) && *(index) != MPI_UNDEFINED) ? 1 : 0, requests, index); MPIM_wait_states_complete(MPIM_MESSAGE_TESTANY, (*(flag) && *(index) != MPI_UNDEFINED) ? 1 : 0, index, status); } while(0)
+#define MPIM_hook_Testsome(arguments, callsite, line, count, requests, index_count, indices, statuses) do { MPIM_persistent_complete((*(index_count) == MPI_UNDEFINED) ? 0 : *(index_count), requests, indices); MPIM_wait_states_complete(MPIM_MESSAGE_TESTSOME, (*(index_count) == MPI_UNDEFINED) ? 0 : *(index_count), indices, statuses); } while(0)
+#define MPIM_hook_Wait(arguments, callsite, line, request, status) do { MPIM_persistent_complete(1, request, NULL); MPIM_wait_states_complete(MPIM_MESSAGE_WAIT, 1, NULL, status); } while(0)
+#define MPIM_hook_Waitall(arguments, callsite, line, count, requests, statuses) do { MPIM_persistent_complete(count, requests, NULL); MPIM_wait_states_complete(MPIM_MESSAGE_WAITALL, count, NULL, statuses); } while(0)
+#define MPIM_hook_Waitany(arguments, callsite, line, count, requests, index, status) do { MPIM_persistent_complete((*(index) == MPI_UNDEFINED) ? 0 : 1, requests, index); MPIM_wait_states_complete(MPIM_MESSAGE_WAITANY, (*(index) == MPI_UNDEFINED) ? 0 : 1, index, status); } while(0)
+#define MPIM_hook_Waitsome(arguments, callsite, line, count, requests, index_count, indices, statuses) do { MPIM_persistent_complete((*(index_count) == MPI_UNDEFINED) ? 0 : *(index_count), requests, indices); MPIM_wait_states_complete(MPIM_MESSAGE_WAITSOME, (*(index_count) == MPI_UNDEFINED) ? 0 : *(index_count), indices, statuses); } while(0)
+/// Pre-hooks of the COMPLETING routines of MPIM_ROUTINES, given the arguments of the call before MPI completes its requests and forgets the handles of those that are not persistent
+#define MPIM_prehook_Test(request, flag, status) MPIM_wait_states_prepare(1, request)
+#define MPIM_prehook_Testall(count, requests, flag, statuses) MPIM_wait_states_prepare(count, requests)
+#define MPIM_prehook_Testany(count, requests, index, flag, status) MPIM_wait_states_prepare(count, requests)
+#define MPIM_prehook_Testsome(count, requests, index_count, indices, statuses) MPIM_wait_states_prepare(count, requests)
+#define MPIM_prehook_Wait(request, status) MPIM_wait_states_prepare(1, request)
+#define MPIM_prehook_Waitall(count, requests, statuses) MPIM_wait_states_prepare(count, requests)
+#define MPIM_prehook_Waitany(count, requests, index, status) MPIM_wait_states_prepare(count, requests)
+#define MPIM_prehook_Waitsome(count, requests, index_count, indices, statuses) MPIM_wait_states_prepare(count, requests)
+
+/**
+ * @brief Orders persistent requests by decreasing time from start to completion, then by decreasing number of cycles.
+ * @param[in] a The first request.
+ * @param[in] b The second request.
+ * @return A negative value if a comes first, a positive value if b comes first, 0 otherwise.
+ **/
+static int MPIM_persistent_compare_time(const void* a, const void* b)
+{
+    const struct MPIM_persistent_request_t* request_a = (const struct MPIM_persistent_request_t*)a;
+    const struct MPIM_persistent_request_t* request_b = (const struct MPIM_persistent_request_t*)b;
+    if(request_a->nanoseconds != request_b->nanoseconds)
+    {
+        return (request_a->nanoseconds > request_b->nanoseconds) ? -1 : 1;
+    }
+    if(request_a->cycles != request_b->cycles)
+    {
+        return (request_a->cycles > request_b->cycles) ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Gathers the persistent requests of all processes, process 0 printing those that took the longest to complete.
+ * @details Must be called collectively. Nothing is printed if no process created a persistent request.
+ **/
+static void MPIM_persistent_report()
+{
+    int dropped = 0;
+    int total = 0;
+    MPI_Reduce(&MPIM_persistent_requests_dropped, &dropped, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    // The requests still tracked, followed by the sums of the freed ones
+    int count = 0;
+    struct MPIM_persistent_request_t* local = (struct MPIM_persistent_request_t*)malloc(sizeof(struct MPIM_persistent_request_t) * (MPIM_MAX_PERSISTENT_REQUESTS + MPIM_MAX_PERSISTENT_CALLSITES));
+    if(local == NULL)
+    {
+        printf("Failure in allocating the persistent request report.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    for(int i = 0; i < MPIM_persistent_request_count; i++)
+    {
+        if(MPIM_persistent_requests[i].request != MPI_REQUEST_NULL)
+        {
+            local[count++] = MPIM_persistent_requests[i];
+        }
+    }
+    for(int i = 0; i < MPIM_persistent_freed_count; i++)
+    {
+        local[count++] = MPIM_persistent_freed[i];
+    }
+    for(int i = 0; i < count; i++)
+    {
+        local[i].rank = MPIM_my_rank;
+    }
+    struct MPIM_persistent_request_t* requests = (struct MPIM_persistent_request_t*)MPIM_gather_records(local, count, sizeof(struct MPIM_persistent_request_t), &total);
+    free(local);
+
+    if(MPIM_my_rank == 0 && (total > 0 || dropped > 0))
+    {
+        int top = MPIM_DEFAULT_PERSISTENT_TOP;
+        const char* top_variable = getenv("MPIM_PERSISTENT_TOP");
+        if(top_variable != NULL && atoi(top_variable) >= 0)
+        {
+            top = atoi(top_variable);
+        }
+        uint64_t states[3] = { 0, 0, 0 };
+        for(int i = 0; i < total; i++)
+        {
+            states[requests[i].state] += requests[i].requests;
+        }
+        if(total > 0)
+        {
+            qsort(requests, total, sizeof(struct MPIM_persistent_request_t), MPIM_persistent_compare_time);
+        }
+
+        printf("\nMPI_monitor: %llu persistent requests over %d processes, %llu still active, %llu never freed", (unsigned long long)(states[MPIM_PERSISTENT_INACTIVE] + states[MPIM_PERSISTENT_ACTIVE] + states[MPIM_PERSISTENT_FREED]), MPIM_my_comm_size,
+               (unsigned long long)states[MPIM_PERSISTENT_ACTIVE], (unsigned long long)(states[MPIM_PERSISTENT_ACTIVE] + states[MPIM_PERSISTENT_INACTIVE]));
+        if(dropped > 0)
+        {
+            printf(", %d more not tracked as the table of %d requests per process, or of %d callsites of freed requests, was full", dropped, MPIM_MAX_PERSISTENT_REQUESTS, MPIM_MAX_PERSISTENT_CALLSITES);
+        }
+        printf("\nTime from start to completion, in seconds, the requests freed at a callsite being summed:\n");
+        printf("+------------------------------------------+--------+--------------------------------+------------------------------------------+----------+------------+------------+------------+----------+\n");
+        printf("| %-40s | %6s | %30s | %-40s | %8s | %10s | %10s | %10s | %8s |\n", "Callsite", "Rank", "Routine", "Arguments", "Requests", "Cycles", "Mean", "Max", "State");
+        printf("+------------------------------------------+--------+--------------------------------+------------------------------------------+----------+------------+------------+------------+----------+\n");
+        for(int i = 0; i < total && i < top; i++)
+        {
+            const struct MPIM_persistent_request_t* request = &requests[i];
+            char where[MPIM_MAX_FILENAME_LENGTH];
+            char arguments[MPIM_MAX_ARGUMENTS_LENGTH];
+            struct MPIM_message_t message;
+            message.switched_off = false;
+            message.unmonitored = false;
+            message.arguments = request->arguments;
+            message.call_count = 0;
+            message.active_persistent_requests = 0;
+            message.epoch.tracked = 0;
+            MPIM_callsite_get_where(request->module, request->offset, request->line, where, sizeof(where));
+            MPIM_message_get_details(&message, arguments, sizeof(arguments));
+            printf("| %-40.40s | %6d | %30s | %-40.40s | %8llu | %10llu | %10.6f | %10.6f | %8s |\n", where, request->rank, MPIM_routine_name_t[request->type], arguments, (unsigned long long)request->requests, (unsigned long long)request->cycles,
+                   (request->cycles > 0) ? request->nanoseconds / 1.0E9 / request->cycles : 0.0, request->max_nanoseconds / 1.0E9, MPIM_persistent_state_name_t[request->state]);
+        }
+        printf("+------------------------------------------+--------+--------------------------------+------------------------------------------+----------+------------+------------+------------+----------+\n");
+    }
+    free(requests);
+}
+
+/**
+ * @brief Indicates if a window belongs to the monitor rather than to the application.
+ * @details The windows of the monitor are used through the MPI routines themselves and never reach the wrappers; they are excluded all the same so that their traffic can never be mistaken for that of the application.
+ * @param[in] window The window.
+ * @return true if the window belongs to the monitor, false otherwise.
+ **/
+static bool MPIM_rma_window_is_internal(MPI_Win window)
+{
+    return window == MPIM_my_window || (MPIM_wait_states_enabled && (window == MPIM_stamp_window || window == MPIM_wait_window));
+}
+
+/**
+ * @brief Finds the tracked window with a given identifier.
+ * @details Takes no lock: windows are only appended to the table, and its count is loaded with acquire semantics. Freed windows are skipped since MPI may reuse their identifier.
+ * @param[in] identifier The identifier of the window, as given by MPI_Win_c2f.
+ * @return The window, NULL if it is not tracked.
+ **/
+static struct MPIM_rma_window_t* MPIM_rma_find(int32_t identifier)
+{
+    for(int i = atomic_load_explicit(&MPIM_rma_window_count, memory_order_acquire) - 1; i >= 0; i--)
+    {
+        if(MPIM_rma_windows[i].identifier == identifier && !__atomic_load_n(&MPIM_rma_windows[i].freed, __ATOMIC_RELAXED))
+        {
+            return &MPIM_rma_windows[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Starts updating a window, waiting for the thread updating it, if any, to finish.
+ * @details The sequence of the window is made odd, so that only the threads using the same window ever wait for each other.
+ * @param[inout] entry The window.
+ **/
+static void MPIM_rma_window_begin_update(struct MPIM_rma_window_t* entry)
+{
+    uint32_t sequence = __atomic_load_n(&entry->sequence, __ATOMIC_RELAXED);
+    while((sequence & 1) != 0 || !__atomic_compare_exchange_n(&entry->sequence, &sequence, sequence + 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        sched_yield();
+        sequence = __atomic_load_n(&entry->sequence, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Ends the update of a window started with MPIM_rma_window_begin_update, making its sequence even again.
+ * @param[inout] entry The window.
+ **/
+static void MPIM_rma_window_end_update(struct MPIM_rma_window_t* entry)
+{
+    __atomic_store_n(&entry->sequence, entry->sequence + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Starts tracking a window once it is created.
+ * @param[in] type The message type of the routine that created the window.
+ * @param[in] callsite The return address of the MPIM_ routine that created the window.
+ * @param[in] line The line at which the window was created.
+ * @param[in] window The window.
+ **/
+static void MPIM_rma_window_create(enum MPIM_message_type_t type, const void* callsite, int line, MPI_Win window)
+{
+    if(MPIM_rma_window_is_internal(window))
+    {
+        return;
+    }
+    struct MPIM_message_t located;
+    MPIM_message_set_callsite(&located, callsite);
+
+    bool shared = MPIM_table_lock(&MPIM_rma_mutex);
+    int count = atomic_load_explicit(&MPIM_rma_window_count, memory_order_relaxed);
+    if(count == MPIM_MAX_RMA_WINDOWS)
+    {
+        MPIM_rma_windows_dropped++;
+        MPIM_table_unlock(&MPIM_rma_mutex, shared);
+        return;
+    }
+    struct MPIM_rma_window_t* entry = &MPIM_rma_windows[count];
+    memset(entry, 0, sizeof(struct MPIM_rma_window_t));
+    entry->window = window;
+    entry->identifier = MPI_Win_c2f(window);
+    entry->type = type;
+    entry->module = located.callsite_module;
+    entry->offset = located.callsite_offset;
+    entry->line = line;
+    entry->epoch.tracked = 1;
+    entry->epoch.access = MPIM_RMA_ACCESS_NONE;
+    entry->epoch.exposure = MPIM_RMA_EXPOSURE_NONE;
+    atomic_store_explicit(&MPIM_rma_window_count, count + 1, memory_order_release);
+    MPIM_table_unlock(&MPIM_rma_mutex, shared);
+}
+
+/**
+ * @brief Accounts for a one-sided operation issued on a window, pending until a synchronisation completes it.
+ * @param[in] arguments The arguments of the operation.
+ **/
+static void MPIM_rma_operation(const struct MPIM_arguments_t* arguments)
+{
+    if(atomic_load_explicit(&MPIM_rma_window_count, memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    uint64_t bytes = (arguments->count > 0) ? (uint64_t)arguments->count * arguments->datatype_size : 0;
+    struct MPIM_rma_window_t* entry = MPIM_rma_find(arguments->rma.window);
+    if(entry != NULL)
+    {
+        MPIM_rma_window_begin_update(entry);
+        struct MPIM_rma_epoch_t* epoch = &entry->epoch;
+        if(epoch->pending_operations == 0)
+        {
+            epoch->pending_target = arguments->rma.target;
+        }
+        else if(epoch->pending_target != arguments->rma.target)
+        {
+            epoch->pending_target = MPIM_WHOLE_WINDOW;
+        }
+        epoch->pending_operations++;
+        epoch->pending_bytes += bytes;
+        entry->operations++;
+        entry->bytes += bytes;
+        MPIM_rma_window_end_update(entry);
+    }
+}
+
+/// Synchronisations changing the epochs of a window
+enum MPIM_rma_synchronisation_t { /// MPI_Win_fence, the detail being the assertion
+                                  MPIM_RMA_FENCE,
+                                  /// MPI_Win_lock, the detail being the lock type
+                                  MPIM_RMA_LOCK,
+                                  /// MPI_Win_unlock
+                                  MPIM_RMA_UNLOCK,
+                                  /// MPI_Win_lock_all
+                                  MPIM_RMA_LOCK_ALL,
+                                  /// MPI_Win_unlock_all
+                                  MPIM_RMA_UNLOCK_ALL,
+                                  /// MPI_Win_flush and its variants, covering one target or every target
+                                  MPIM_RMA_FLUSH,
+                                  /// MPI_Win_start
+                                  MPIM_RMA_START,
+                                  /// MPI_Win_complete
+                                  MPIM_RMA_COMPLETE,
+                                  /// MPI_Win_post
+                                  MPIM_RMA_POST,
+                                  /// MPI_Win_wait, or MPI_Win_test once it succeeds
+                                  MPIM_RMA_WAIT };
+
+/**
+ * @brief Updates the epochs of a window after a synchronisation routine returns.
+ * @details Pending operations are counted per window rather than per target: a synchronisation covering a single target only completes them if they all went to that target.
+ * @param[in] synchronisation The synchronisation.
+ * @param[in] arguments The arguments of the synchronisation routine, holding the window and the target.
+ * @param[in] detail The assertion of MPI_Win_fence or the lock type of MPI_Win_lock, ignored otherwise.
+ **/
+static void MPIM_rma_synchronise(enum MPIM_rma_synchronisation_t synchronisation, const struct MPIM_arguments_t* arguments, int detail)
+{
+    if(atomic_load_explicit(&MPIM_rma_window_count, memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    struct MPIM_rma_window_t* entry = MPIM_rma_find(arguments->rma.window);
+    if(entry == NULL)
+    {
+        return;
+    }
+    MPIM_rma_window_begin_update(entry);
+    struct MPIM_rma_epoch_t* epoch = &entry->epoch;
+    int32_t target = arguments->rma.target;
+    if((synchronisation == MPIM_RMA_FENCE || synchronisation == MPIM_RMA_UNLOCK || synchronisation == MPIM_RMA_UNLOCK_ALL || synchronisation == MPIM_RMA_FLUSH || synchronisation == MPIM_RMA_COMPLETE) &&
+       (target == MPIM_WHOLE_WINDOW || target == epoch->pending_target))
+    {
+        epoch->pending_operations = 0;
+        epoch->pending_bytes = 0;
+    }
+    switch(synchronisation)
+    {
+        case MPIM_RMA_FENCE:
+            if(detail & MPI_MODE_NOSUCCEED)
+            {
+                epoch->access = MPIM_RMA_ACCESS_NONE;
+                epoch->exposure = MPIM_RMA_EXPOSURE_NONE;
+            }
+            else
+            {
+                epoch->access = MPIM_RMA_ACCESS_FENCE;
+                epoch->exposure = MPIM_RMA_EXPOSURE_FENCE;
+                entry->epochs++;
+            }
+            break;
+        case MPIM_RMA_LOCK:
+            epoch->access = (detail == MPI_LOCK_EXCLUSIVE) ? MPIM_RMA_ACCESS_LOCK_EXCLUSIVE : MPIM_RMA_ACCESS_LOCK_SHARED;
+            epoch->locked_targets++;
+            entry->epochs++;
+            break;
+        case MPIM_RMA_UNLOCK:
+            if(epoch->locked_targets > 0)
+            {
+                epoch->locked_targets--;
+            }
+            if(epoch->locked_targets == 0)
+            {
+                epoch->access = MPIM_RMA_ACCESS_NONE;
+            }
+            break;
+        case MPIM_RMA_LOCK_ALL:
+            epoch->access = MPIM_RMA_ACCESS_LOCK_ALL;
+            entry->epochs++;
+            break;
+        case MPIM_RMA_START:
+            epoch->access = MPIM_RMA_ACCESS_START;
+            entry->epochs++;
+            break;
+        case MPIM_RMA_UNLOCK_ALL:
+        case MPIM_RMA_COMPLETE:
+            epoch->access = MPIM_RMA_ACCESS_NONE;
+            break;
+        case MPIM_RMA_POST:
+            epoch->exposure = MPIM_RMA_EXPOSURE_POST;
+            break;
+        case MPIM_RMA_WAIT:
+            epoch->exposure = MPIM_RMA_EXPOSURE_NONE;
+            break;
+        default:
+            break;
+    }
+    MPIM_rma_window_end_update(entry);
+}
+
+/**
+ * @brief Stops tracking a window as it is freed.
+ * @details The window stays in the table for the report, with the epochs it had when freed.
+ * @param[in] window The window.
+ **/
+static void MPIM_rma_window_free(MPI_Win window)
+{
+    if(atomic_load_explicit(&MPIM_rma_window_count, memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    struct MPIM_rma_window_t* entry = MPIM_rma_find(MPI_Win_c2f(window));
+    if(entry != NULL)
+    {
+        __atomic_store_n(&entry->freed, MPIM_RMA_WINDOW_FREED, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Stops tracking the windows not freed yet, as monitoring is switched on again.
+ * @details A window may have been freed while monitoring was off, and its identifier reused, and its epochs went on unseen. The windows stay in the report as untracked.
+ **/
+static void MPIM_rma_forget()
+{
+    int count = atomic_load_explicit(&MPIM_rma_window_count, memory_order_acquire);
+    for(int i = 0; i < count; i++)
+    {
+        if(__atomic_load_n(&MPIM_rma_windows[i].freed, __ATOMIC_RELAXED) == 0)
+        {
+            __atomic_store_n(&MPIM_rma_windows[i].freed, MPIM_RMA_WINDOW_UNTRACKED, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * @brief Copies the synchronisation state of the window of a one-sided routine.
+ * @details Takes no lock: the copy is retried until the sequence of the window shows that no thread updated it meanwhile.
+ * @param[in] arguments The arguments of the routine.
+ * @param[out] epoch The synchronisation state, not tracked if the window is not.
+ **/
+static void MPIM_rma_get_epoch(const struct MPIM_arguments_t* arguments, struct MPIM_rma_epoch_t* epoch)
+{
+    epoch->tracked = 0;
+    if(arguments->kind != MPIM_ARGUMENTS_RMA || atomic_load_explicit(&MPIM_rma_window_count, memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    const struct MPIM_rma_window_t* entry = MPIM_rma_find(arguments->rma.window);
+    if(entry == NULL)
+    {
+        return;
+    }
+    uint32_t sequence;
+    do
+    {
+        sequence = __atomic_load_n(&entry->sequence, __ATOMIC_ACQUIRE);
+        *epoch = entry->epoch;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while((sequence & 1) != 0 || sequence != __atomic_load_n(&entry->sequence, __ATOMIC_RELAXED));
+}
+
+/// Hooks of the window creation routines, the window being their last parameter
+#define MPIM_hook_Win_allocate(arguments, callsite, line, size, displacement_unit, info, communicator, base, window) MPIM_rma_window_create(MPIM_MESSAGE_WIN_ALLOCATE, callsite, line, *(window))
+#define MPIM_hook_Win_allocate_shared(arguments, callsite, line, size, displacement_unit, info, communicator, base, window) MPIM_rma_window_create(MPIM_MESSAGE_WIN_ALLOCATE_SHARED, callsite, line, *(window))
+#define MPIM_hook_Win_create(arguments, callsite, line, base, size, displacement_unit, info, communicator, window) MPIM_rma_window_create(MPIM_MESSAGE_WIN_CREATE, callsite, line, *(window))
+#define MPIM_hook_Win_create_dynamic(arguments, callsite, line, info, communicator, window) MPIM_rma_window_create(MPIM_MESSAGE_WIN_CREATE_DYNAMIC, callsite, line, *(window))
+/// Hooks of the one-sided operations, whose recorded arguments hold the window, the target and the data size
+#define MPIM_hook_Accumulate(arguments, ...) MPIM_rma_operation(arguments)
+#define MPIM_hook_Compare_and_swap(arguments, ...) MPIM_rma_operation(arguments)
+#define MPIM_hook_Fetch_and_op(arguments, ...) MPIM_rma_operation(arguments)
+#define MPIM_hook_Get(arguments, ...) MPIM_rma_operation(arguments)
+#define MPIM_hook_Get_accumulate(arguments, ...) MPIM_rma_operation(arguments)
+#define MPIM_hook_Put(arguments, ...) MPIM_rma_operation(arguments)
+#define MPIM_hook_Raccumulate(arguments, ...) MPIM_rma_operation(arguments)
+#define MPIM_hook_Rget(arguments, ...) MPIM_rma_operation(arguments)
+#define MPIM_hook_Rget_accumulate(arguments, ...) MPIM_rma_operation(arguments)
+#define MPIM_hook_Rput(arguments, ...) MPIM_rma_operation(arguments)
+/// Hooks of the one-sided synchronisation routines
+#define MPIM_hook_Win_complete(arguments, ...) MPIM_rma_synchronise(MPIM_RMA_COMPLETE, arguments, 0)
+#define MPIM_hook_Win_fence(arguments, callsite, line, assertion, window) MPIM_rma_synchronise(MPIM_RMA_FENCE, arguments, assertion)
+#define MPIM_hook_Win_flush(arguments, ...) MPIM_rma_synchronise(MPIM_RMA_FLUSH, arguments, 0)
+#define MPIM_hook_Win_flush_all(arguments, ...) MPIM_rma_synchronise(MPIM_RMA_FLUSH, arguments, 0)
+#define MPIM_hook_Win_flush_local(arguments, ...) MPIM_rma_synchronise(MPIM_RMA_FLUSH, arguments, 0)
+#define MPIM_hook_Win_flush_local_all(arguments, ...) MPIM_rma_synchronise(MPIM_RMA_FLUSH, arguments, 0)
+#define MPIM_hook_Win_lock(arguments, callsite, line, lock_type, rank, assertion, window) MPIM_rma_synchronise(MPIM_RMA_LOCK, arguments, lock_type)
+#define MPIM_hook_Win_lock_all(arguments, ...) MPIM_rma_synchronise(MPIM_RMA_LOCK_ALL, arguments, 0)
+#define MPIM_hook_Win_post(arguments, ...) MPIM_rma_synchronise(MPIM_RMA_POST, arguments, 0)
+#define MPIM_hook_Win_start(arguments, ...) MPIM_rma_synchronise(MPIM_RMA_START, arguments, 0)
+#define MPIM_hook_Win_test(arguments, callsite, line, window, flag) do { if(*(flag)) { MPIM_rma_synchronise(MPIM_RMA_WAIT, arguments, 0); } } while(0)
+#define MPIM_hook_Win_unlock(arguments, ...) MPIM_rma_synchronise(MPIM_RMA_UNLOCK, arguments, 0)
+#define MPIM_hook_Win_unlock_all(arguments, ...) MPIM_rma_synchronise(MPIM_RMA_UNLOCK_ALL, arguments, 0)
+#define MPIM_hook_Win_wait(arguments, ...) MPIM_rma_synchronise(MPIM_RMA_WAIT, arguments, 0)
+
+/**
+ * @brief Orders windows by decreasing amount of data moved, then by decreasing number of operations.
+ * @param[in] a The first window.
+ * @param[in] b The second window.
+ * @return A negative value if a comes first, a positive value if b comes first, 0 otherwise.
+ **/
+static int MPIM_rma_compare_bytes(const void* a, const void* b)
+{
+    const struct MPIM_rma_window_t* window_a = (const struct MPIM_rma_window_t*)a;
+    const struct MPIM_rma_window_t* window_b = (const struct MPIM_rma_window_t*)b;
+    if(window_a->bytes != window_b->bytes)
+    {
+        return (window_a->bytes > window_b->bytes) ? -1 : 1;
+    }
+    if(window_a->operations != window_b->operations)
+    {
+        return (window_a->operations > window_b->operations) ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Gathers the application windows of all processes, process 0 printing their epochs and traffic, and those never freed.
+ * @details Must be called collectively. Nothing is printed if no process created a window.
+ **/
+static void MPIM_rma_report()
+{
+    int dropped = 0;
+    int total = 0;
+    MPI_Reduce(&MPIM_rma_windows_dropped, &dropped, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    for(int i = 0; i < MPIM_rma_window_count; i++)
+    {
+        MPIM_rma_windows[i].rank = MPIM_my_rank;
+    }
+    struct MPIM_rma_window_t* windows = (struct MPIM_rma_window_t*)MPIM_gather_records(MPIM_rma_windows, MPIM_rma_window_count, sizeof(struct MPIM_rma_window_t), &total);
+
+    if(MPIM_my_rank == 0 && (total > 0 || dropped > 0))
+    {
+        int open = 0;
+        int untracked = 0;
+        for(int i = 0; i < total; i++)
+        {
+            if(!windows[i].freed)
+            {
+                open++;
+            }
+            else if(windows[i].freed == MPIM_RMA_WINDOW_UNTRACKED)
+            {
+                untracked++;
+            }
+        }
+        if(total > 0)
+        {
+            qsort(windows, total, sizeof(struct MPIM_rma_window_t), MPIM_rma_compare_bytes);
+        }
+
+        printf("\nMPI_monitor: %d application windows over %d processes, %d never freed", total, MPIM_my_comm_size, open);
+        if(untracked > 0)
+        {
+            printf(", %d untracked once monitoring was switched off", untracked);
+        }
+        if(dropped > 0)
+        {
+            printf(", %d more not tracked as the table of %d windows per process was full", dropped, MPIM_MAX_RMA_WINDOWS);
+        }
+        printf("\n+------------------------------------------+--------+--------------------------------+--------+------------+------------+--------------+------------------------------------------------------------+\n");
+        printf("| %-40s | %6s | %30s | %6s | %10s | %10s | %12s | %-58s |\n", "Callsite", "Rank", "Routine", "Window", "Epochs", "Operations", "Data", "Epoch at the end");
+        printf("+------------------------------------------+--------+--------------------------------+--------+------------+------------+--------------+------------------------------------------------------------+\n");
+        for(int i = 0; i < total; i++)
+        {
+            const struct MPIM_rma_window_t* window = &windows[i];
+            char where[MPIM_MAX_FILENAME_LENGTH];
+            char bytes[32];
+            char state[MPIM_MAX_ARGUMENTS_LENGTH];
+            MPIM_callsite_get_where(window->module, window->offset, window->line, where, sizeof(where));
+            MPIM_bytes_get_text(window->bytes, bytes, sizeof(bytes));
+            if(window->freed == MPIM_RMA_WINDOW_UNTRACKED)
+            {
+                snprintf(state, sizeof(state), "untracked since monitoring was switched off");
+            }
+            else if(window->freed)
+            {
+                snprintf(state, sizeof(state), "freed");
+            }
+            else
+            {
+                MPIM_rma_epoch_get_text(&window->epoch, state, sizeof(state));
+            }
+            printf("| %-40.40s | %6d | %30s | %6d | %10llu | %10llu | %12s | %-58.58s |\n", where, window->rank, MPIM_routine_name_t[window->type], window->identifier, (unsigned long long)window->epochs,
+                   (unsigned long long)window->operations, bytes, state);
+        }
+        printf("+------------------------------------------+--------+--------------------------------+--------+------------+------------+--------------+------------------------------------------------------------+\n");
+    }
+    free(windows);
+}
+
+/**
+ * @brief Records an MPI call in the flight recorder of this process.
+ * @details Threads claim entries with an atomic increment, so concurrent calls never wait for each other; an entry being overwritten while dumped may be garbled, which only affects the oldest ones.
+ * @param[in] message The message describing the call.
+ * @param[in] file The name of the file from which the MPI call is issued.
+ * @param[in] line The line at which the MPI call is issued.
+ **/
+static void MPIM_flight_record(const struct MPIM_message_t* message, const char* file, int line)
+{
+    uint64_t index = atomic_fetch_add_explicit(&MPIM_flight_event_count, 1, memory_order_relaxed);
+    struct MPIM_flight_event_t* event = &MPIM_flight_events[index % MPIM_FLIGHT_RECORDER_SIZE];
+    event->timestamp = MPIM_get_ticks();
+    event->file = file;
+    event->line = line;
+    event->type = message->type;
+    event->before = message->before;
+    event->thread = MPIM_my_thread_slot;
+    event->call_count = message->call_count;
+    event->arguments = message->arguments;
+}
+
+/**
+ * @brief Appends a string to a line of the crash report, truncating it if the line is full.
+ * @details Only uses async-signal-safe operations, as do all the functions writing the crash report.
+ * @param[in,out] line The line.
+ * @param[in] text The string.
+ **/
+static void MPIM_crash_append_text(struct MPIM_crash_line_t* line, const char* text)
+{
+    for(int i = 0; text[i] != '\0' && line->length < MPIM_CRASH_LINE_LENGTH; i++)
+    {
+        line->text[line->length++] = text[i];
+    }
+}
+
+/**
+ * @brief Appends an integer, in decimal, to a line of the crash report.
+ * @param[in,out] line The line.
+ * @param[in] value The integer.
+ **/
+static void MPIM_crash_append_integer(struct MPIM_crash_line_t* line, int64_t value)
+{
+    char digits[24];
+    int count = 0;
+    uint64_t magnitude = (value < 0) ? -(uint64_t)value : (uint64_t)value;
+    do
+    {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while(magnitude > 0);
+    if(value < 0)
+    {
+        digits[count++] = '-';
+    }
+    char text[24];
+    for(int i = 0; i < count; i++)
+    {
+        text[i] = digits[count - 1 - i];
+    }
+    text[count] = '\0';
+    MPIM_crash_append_text(line, text);
+}
+
+/**
+ * @brief Appends an integer, in hexadecimal, to a line of the crash report.
+ * @param[in,out] line The line.
+ * @param[in] value The integer.
+ **/
+static void MPIM_crash_append_hexadecimal(struct MPIM_crash_line_t* line, uint64_t value)
+{
+    char text[20] = "0x";
+    int count = 2;
+    for(int shift = 60; shift >= 0; shift -= 4)
+    {
+        int digit = (value >> shift) & 0xF;
+        if(digit != 0 || count > 2 || shift == 0)
+        {
+            text[count++] = "0123456789abcdef"[digit];
+        }
+    }
+    text[count] = '\0';
+    MPIM_crash_append_text(line, text);
+}
+
+/**
+ * @brief Writes a line of the crash report, and empties it.
+ * @param[in] file The file descriptor of the crash report.
+ * @param[in,out] line The line.
+ **/
+static void MPIM_crash_write_line(int file, struct MPIM_crash_line_t* line)
+{
+    if(line->length == MPIM_CRASH_LINE_LENGTH)
+    {
+        line->length--;
+    }
+    line->text[line->length++] = '\n';
+    ssize_t written = write(file, line->text, line->length);
+    (void)written;
+    line->length = 0;
+}
+
+/**
+ * @brief Appends the time elapsed since the end of MPI_Init at a timestamp of this process, in microseconds.
+ * @param[in,out] line The line.
+ * @param[in] timestamp The timestamp, in ticks of the clock source of this process.
+ **/
+static void MPIM_crash_append_time(struct MPIM_crash_line_t* line, uint64_t timestamp)
+{
+    MPIM_crash_append_text(line, "+");
+    MPIM_crash_append_integer(line, (int64_t)(((double)timestamp - (double)MPIM_profile_start) * 1.0E6 / MPIM_my_clock.ticks_per_second));
+    MPIM_crash_append_text(line, " us");
+}
+
+/**
+ * @brief Appends the raw arguments of an MPI call, which cannot be formatted with MPIM_message_get_details in a signal handler.
+ * @param[in,out] line The line.
+ * @param[in] arguments The arguments.
+ **/
+static void MPIM_crash_append_arguments(struct MPIM_crash_line_t* line, const struct MPIM_arguments_t* arguments)
+{
+    enum MPIM_arguments_kind_t kind = arguments->kind;
+    if(kind == MPIM_ARGUMENTS_SEND || kind == MPIM_ARGUMENTS_RECEIVE)
+    {
+        MPIM_crash_append_text(line, (kind == MPIM_ARGUMENTS_SEND) ? ", to " : ", from ");
+        MPIM_crash_append_integer(line, arguments->p2p.peer);
+        MPIM_crash_append_text(line, ", tag ");
+        MPIM_crash_append_integer(line, arguments->p2p.tag);
+    }
+    else if(kind == MPIM_ARGUMENTS_RMA)
+    {
+        MPIM_crash_append_text(line, ", target ");
+        MPIM_crash_append_integer(line, arguments->rma.target);
+        MPIM_crash_append_text(line, ", win #");
+        MPIM_crash_append_integer(line, arguments->rma.window);
+    }
+    if(kind != MPIM_ARGUMENTS_NONE && kind != MPIM_ARGUMENTS_COMMUNICATOR && kind != MPIM_ARGUMENTS_REQUESTS)
+    {
+        MPIM_crash_append_text(line, ", ");
+        MPIM_crash_append_integer(line, arguments->count);
+        MPIM_crash_append_text(line, " x ");
+        MPIM_crash_append_integer(line, arguments->datatype_size);
+        MPIM_crash_append_text(line, " B");
+    }
+    if(kind != MPIM_ARGUMENTS_NONE && kind != MPIM_ARGUMENTS_RMA && kind != MPIM_ARGUMENTS_REQUESTS && kind != MPIM_ARGUMENTS_MATCHED_RECEIVE)
+    {
+        MPIM_crash_append_text(line, ", comm #");
+        MPIM_crash_append_integer(line, arguments->communicator);
+    }
+    else if(kind == MPIM_ARGUMENTS_REQUESTS)
+    {
+        MPIM_crash_append_text(line, ", ");
+        MPIM_crash_append_integer(line, arguments->count);
+        MPIM_crash_append_text(line, " requests");
+    }
+}
+
+/**
+ * @brief Writes the crash report of this process: the events of its flight recorder and, on the aggregator, the last snapshot of every slot.
+ * @details Called from signal handlers, so only async-signal-safe functions are used: no stdio, no allocation, no symbolisation. Callsites of the snapshot are given as module and offset, to be passed to addr2line.
+ * @param[in] reason What happened, written at the top of the report.
+ * @param[in] code The signal or error code, written after the reason.
+ **/
+static void MPIM_crash_dump(const char* reason, int code)
+{
+    int file = open(MPIM_crash_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(file == -1)
+    {
+        return;
+    }
+    struct MPIM_crash_line_t line;
+    line.length = 0;
+    MPIM_crash_append_text(&line, "MPI_monitor crash report of process ");
+    MPIM_crash_append_integer(&line, MPIM_my_rank);
+    MPIM_crash_append_text(&line, ": ");
+    MPIM_crash_append_text(&line, reason);
+    MPIM_crash_append_text(&line, " ");
+    MPIM_crash_append_integer(&line, code);
+    MPIM_crash_append_text(&line, " at ");
+    MPIM_crash_append_time(&line, MPIM_get_ticks());
+    MPIM_crash_write_line(file, &line);
+
+    uint64_t count = atomic_load_explicit(&MPIM_flight_event_count, memory_order_relaxed);
+    uint64_t first = (count > MPIM_FLIGHT_RECORDER_SIZE) ? count - MPIM_FLIGHT_RECORDER_SIZE : 0;
+    MPIM_crash_append_text(&line, "Last ");
+    MPIM_crash_append_integer(&line, count - first);
+    MPIM_crash_append_text(&line, " MPI events of the process, oldest first:");
+    MPIM_crash_write_line(file, &line);
+    for(uint64_t i = first; i < count; i++)
+    {
+        const struct MPIM_flight_event_t* event = &MPIM_flight_events[i % MPIM_FLIGHT_RECORDER_SIZE];
+        MPIM_crash_append_text(&line, "  ");
+        MPIM_crash_append_time(&line, event->timestamp);
+        MPIM_crash_append_text(&line, ", thread ");
+        MPIM_crash_append_integer(&line, event->thread);
+        MPIM_crash_append_text(&line, ", call ");
+        MPIM_crash_append_integer(&line, event->call_count);
+        MPIM_crash_append_text(&line, ": ");
+        MPIM_crash_append_text(&line, (event->type >= 0 && event->type < MPIM_MESSAGE_TYPE_COUNT) ? MPIM_routine_name_t[event->type] : "?");
+        MPIM_crash_append_text(&line, event->before ? " started at " : " completed at ");
+        MPIM_crash_append_text(&line, (event->file != NULL) ? event->file : "?");
+        MPIM_crash_append_text(&line, ":");
+        MPIM_crash_append_integer(&line, event->line);
+        MPIM_crash_append_arguments(&line, &event->arguments);
+        MPIM_crash_write_line(file, &line);
+    }
+
+    if(MPIM_my_rank == 0 && MPIM_my_window_buffer_copy != NULL)
+    {
+        MPIM_crash_append_text(&line, "Last snapshot of the aggregator, one line per thread:");
+        MPIM_crash_write_line(file, &line);
+        for(int i = 0; i < MPIM_my_comm_size * MPIM_threads_per_process; i++)
+        {
+            const struct MPIM_message_t* message = &MPIM_my_window_buffer_copy[i];
+            if((i % MPIM_threads_per_process) != 0 && message->type == MPIM_MESSAGE_UNINITIALISED)
+            {
+                continue;
+            }
+            MPIM_crash_append_text(&line, "  ");
+            MPIM_crash_append_integer(&line, i / MPIM_threads_per_process);
+            MPIM_crash_append_text(&line, ".");
+            MPIM_crash_append_integer(&line, i % MPIM_threads_per_process);
+            MPIM_crash_append_text(&line, ", call ");
+            MPIM_crash_append_integer(&line, message->call_count);
+            MPIM_crash_append_text(&line, ": ");
+            MPIM_crash_append_text(&line, MPIM_routine_name_t[message->type]);
+            MPIM_crash_append_text(&line, message->before ? " started at " : " completed at ");
+            int module = MPIM_module_find_identity(message->callsite_module);
+            if(module != -1)
+            {
+                MPIM_crash_append_text(&line, MPIM_modules[module].name);
+                MPIM_crash_append_text(&line, "+");
+            }
+            MPIM_crash_append_hexadecimal(&line, message->callsite_offset);
+            MPIM_crash_append_text(&line, " line ");
+            MPIM_crash_append_integer(&line, message->line);
+            MPIM_crash_append_arguments(&line, &message->arguments);
+            MPIM_crash_write_line(file, &line);
+        }
+    }
+    close(file);
+}
+
+/**
+ * @brief Writes the crash report when a fatal signal is received, then hands the signal over to the handler installed before.
+ * @param[in] signal The signal received.
+ **/
+static void MPIM_crash_handler(int signal)
+{
+    if(!atomic_exchange(&MPIM_crash_dumped, true))
+    {
+        MPIM_crash_dump("received signal", signal);
+    }
+    for(int i = 0; i < MPIM_CRASH_SIGNAL_COUNT; i++)
+    {
+        if(MPIM_crash_signals[i] == signal)
+        {
+            sigaction(signal, &MPIM_crash_previous_actions[i], NULL);
+        }
+    }
+    raise(signal);
+}
+
+/**
+ * @brief Starts the flight recorder and installs the crash handlers, if the MPIM_CRASH_DIRECTORY environment variable gives the directory of the crash reports.
+ **/
+static void MPIM_crash_initialise()
+{
+    const char* directory = getenv("MPIM_CRASH_DIRECTORY");
+    if(directory == NULL || directory[0] == '\0')
+    {
+        return;
+    }
+    snprintf(MPIM_crash_path, MPIM_MAX_FILENAME_LENGTH, "%s/mpim_crash.%d.txt", directory, MPIM_my_rank);
+
+    // Stack overflows are reported too, the handler running on a stack of its own on the thread that initialised MPI
+    stack_t stack;
+    stack.ss_sp = MPIM_crash_stack;
+    stack.ss_size = MPIM_CRASH_STACK_SIZE;
+    stack.ss_flags = 0;
+    sigaltstack(&stack, NULL);
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = MPIM_crash_handler;
+    action.sa_flags = SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    for(int i = 0; i < MPIM_CRASH_SIGNAL_COUNT; i++)
+    {
+        sigaction(MPIM_crash_signals[i], &action, &MPIM_crash_previous_actions[i]);
+    }
+    MPIM_flight_recorder_enabled = true;
+}
+
+/**
+ * @brief Appends an unsigned varint to a trace block.
+ * @param[in,out] stream The stream whose block receives the varint.
+ * @param[in] value The integer.
+ **/
+static inline void MPIM_trace_write_varint(struct MPIM_trace_stream_t* stream, uint64_t value)
+{
+    uint8_t* data = stream->block->data;
+    while(value >= 0x80)
+    {
+        data[stream->block->length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    data[stream->block->length++] = (uint8_t)value;
+}
+
+/**
+ * @brief Appends a signed varint to a trace block.
+ * @param[in,out] stream The stream whose block receives the varint.
+ * @param[in] value The integer.
+ **/
+static inline void MPIM_trace_write_signed_varint(struct MPIM_trace_stream_t* stream, int64_t value)
+{
+    MPIM_trace_write_varint(stream, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+/**
+ * @brief Gives the number of 32-bit integers of the union of the arguments that are meaningful for a kind of arguments.
+ * @param[in] kind The kind of arguments.
+ * @return The number of integers, starting with the first one of the union.
+ **/
+static inline int MPIM_trace_arguments_words(enum MPIM_arguments_kind_t kind)
+{
+    switch(kind)
+    {
+        case MPIM_ARGUMENTS_SEND:
+        case MPIM_ARGUMENTS_RECEIVE:
+        case MPIM_ARGUMENTS_RMA:
+            return 2;
+        case MPIM_ARGUMENTS_SENDRECV:
+            return 4;
+        case MPIM_ARGUMENTS_ROOTED_COLLECTIVE:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Compares the arguments of two MPI calls, field by field as the unused ones may hold anything.
+ * @param[in] first The arguments of the first call.
+ * @param[in] second The arguments of the second call.
+ * @return true if the arguments are the same, false otherwise.
+ **/
+static inline bool MPIM_trace_arguments_equal(const struct MPIM_arguments_t* first, const struct MPIM_arguments_t* second)
+{
+    if(first->kind != second->kind || first->communicator != second->communicator || first->count != second->count || first->datatype_size != second->datatype_size)
+    {
+        return false;
+    }
+    // The members of the union are all made of consecutive 32-bit integers
+    const int32_t* first_values = &first->sendrecv.destination;
+    const int32_t* second_values = &second->sendrecv.destination;
+    for(int i = 0; i < MPIM_trace_arguments_words(first->kind); i++)
+    {
+        if(first_values[i] != second_values[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Appends an unsigned varint to a compressed payload.
+ * @param[out] compressed The compressed payload.
+ * @param[in,out] length The length of the compressed payload, in bytes.
+ * @param[in] value The integer.
+ **/
+static inline void MPIM_trace_compress_varint(uint8_t* compressed, size_t* length, uint64_t value)
+{
+    while(value >= 0x80)
+    {
+        compressed[(*length)++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    compressed[(*length)++] = (uint8_t)value;
+}
+
+/**
+ * @brief Compresses the payload of a trace block with a greedy LZ77 search over a hash table of the last positions of every 4-byte sequence.
+ * @param[in] raw The payload.
+ * @param[in] raw_length The length of the payload, in bytes.
+ * @param[out] compressed The buffer receiving the compressed payload, of raw_length + MPIM_TRACE_COMPRESSION_SLACK bytes.
+ * @return The length of the compressed payload, in bytes, or SIZE_MAX if it would not be shorter than the payload.
+ **/
+static size_t MPIM_trace_compress(const uint8_t* raw, size_t raw_length, uint8_t* compressed)
+{
+    static uint32_t last_positions[MPIM_TRACE_HASH_SIZE];
+    memset(last_positions, 0xFF, sizeof(last_positions));
+    size_t length = 0;
+    size_t literal_start = 0;
+    size_t position = 0;
+    while(position + MPIM_TRACE_MIN_MATCH <= raw_length)
+    {
+        uint32_t sequence;
+        memcpy(&sequence, raw + position, sizeof(sequence));
+        uint32_t hash = (sequence * 2654435761u) >> (32 - MPIM_TRACE_HASH_BITS);
+        uint32_t candidate = last_positions[hash];
+        last_positions[hash] = (uint32_t)position;
+        if(candidate == UINT32_MAX || memcmp(raw + candidate, raw + position, MPIM_TRACE_MIN_MATCH) != 0)
+        {
+            position++;
+            continue;
+        }
+        size_t match_length = MPIM_TRACE_MIN_MATCH;
+        while(position + match_length < raw_length && raw[candidate + match_length] == raw[position + match_length])
+        {
+            match_length++;
+        }
+        if(length + (position - literal_start) + MPIM_TRACE_COMPRESSION_SLACK / 2 > raw_length)
+        {
+            return SIZE_MAX;
+        }
+        MPIM_trace_compress_varint(compressed, &length, position - literal_start);
+        memcpy(compressed + length, raw + literal_start, position - literal_start);
+        length += position - literal_start;
+        MPIM_trace_compress_varint(compressed, &length, match_length - MPIM_TRACE_MIN_MATCH);
+        MPIM_trace_compress_varint(compressed, &length, position - candidate);
+        position += match_length;
+        literal_start = position;
+    }
+    if(length + (raw_length - literal_start) + MPIM_TRACE_COMPRESSION_SLACK / 2 > raw_length)
+    {
+        return SIZE_MAX;
+    }
+    MPIM_trace_compress_varint(compressed, &length, raw_length - literal_start);
+    memcpy(compressed + length, raw + literal_start, raw_length - literal_start);
+    return length + raw_length - literal_start;
+}
+
+/**
+ * @brief Writes all the bytes of a buffer to the trace file, giving up on the trace if the file cannot be written.
+ * @param[in] data The buffer.
+ * @param[in] length The length of the buffer, in bytes.
+ **/
+static void MPIM_trace_write(const void* data, size_t length)
+{
+    const uint8_t* cursor = (const uint8_t*)data;
+    while(length > 0 && MPIM_trace_file != -1)
+    {
+        ssize_t written = write(MPIM_trace_file, cursor, length);
+        if(written == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if(written <= 0)
+        {
+            printf("MPI_monitor: cannot write the trace of process %d (%s), the run goes on without it.\n", MPIM_my_rank, strerror(errno));
+            close(MPIM_trace_file);
+            MPIM_trace_file = -1;
+            return;
+        }
+        cursor += written;
+        length -= written;
+    }
+}
+
+/**
+ * @brief Compresses and writes the trace blocks filled by the threads of the process, until the trace is finalised.
+ * @details Blocks are written whole, header and payload in a single buffer, so that a process killed while writing leaves at most one torn block at the end of the file.
+ **/
+static void* MPIM_trace_writer()
+{
+    uint8_t* buffer = (uint8_t*)malloc(sizeof(struct MPIM_trace_block_t) + MPIM_TRACE_BLOCK_LENGTH + MPIM_TRACE_COMPRESSION_SLACK);
+    if(buffer == NULL)
+    {
+        printf("Failure in allocating the trace writer buffer.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    pthread_mutex_lock(&MPIM_trace_mutex);
+    for(;;)
+    {
+        while(MPIM_trace_pending_head == NULL && !MPIM_trace_stopping)
+        {
+            pthread_cond_wait(&MPIM_trace_filled, &MPIM_trace_mutex);
+        }
+        struct MPIM_trace_block_buffer_t* block = MPIM_trace_pending_head;
+        if(block == NULL)
+        {
+            break;
+        }
+        MPIM_trace_pending_head = block->next;
+        if(MPIM_trace_pending_head == NULL)
+        {
+            MPIM_trace_pending_tail = NULL;
+        }
+        MPIM_trace_pending_count--;
+        pthread_mutex_unlock(&MPIM_trace_mutex);
+
+        struct MPIM_trace_block_t header;
+        header.magic = MPIM_TRACE_BLOCK_MAGIC;
+        header.thread = block->thread;
+        header.flags = 0;
+        header.event_count = block->event_count;
+        header.raw_length = block->length;
+        header.time = block->time;
+        header.clock_offset = block->clock_offset;
+        uint8_t* payload = buffer + sizeof(header);
+        size_t stored_length = SIZE_MAX;
+        if(MPIM_trace_compression)
+        {
+            stored_length = MPIM_trace_compress(block->data, block->length, payload);
+        }
+        if(stored_length != SIZE_MAX)
+        {
+            header.flags = MPIM_TRACE_BLOCK_COMPRESSED;
+        }
+        else
+        {
+            stored_length = block->length;
+            memcpy(payload, block->data, block->length);
+        }
+        header.stored_length = (uint32_t)stored_length;
+        header.checksum = MPIM_trace_checksum(payload, stored_length);
+        memcpy(buffer, &header, sizeof(header));
+        MPIM_trace_write(buffer, sizeof(header) + stored_length);
+
+        pthread_mutex_lock(&MPIM_trace_mutex);
+        block->next = MPIM_trace_free_blocks;
+        MPIM_trace_free_blocks = block;
+        pthread_cond_broadcast(&MPIM_trace_drained);
+    }
+    pthread_mutex_unlock(&MPIM_trace_mutex);
+    free(buffer);
+    return NULL;
+}
+
+/**
+ * @brief Hands the block of a stream over to the trace writer and gives the stream an empty one, waiting if too many blocks are pending already.
+ * @param[in,out] stream The stream.
+ **/
+static void MPIM_trace_submit(struct MPIM_trace_stream_t* stream)
+{
+    struct MPIM_trace_block_buffer_t* block = stream->block;
+    block->clock_offset = MPIM_my_clock.offset;
+    pthread_mutex_lock(&MPIM_trace_mutex);
+    block->next = NULL;
+    if(MPIM_trace_pending_tail == NULL)
+    {
+        MPIM_trace_pending_head = block;
+    }
+    else
+    {
+        MPIM_trace_pending_tail->next = block;
+    }
+    MPIM_trace_pending_tail = block;
+    MPIM_trace_pending_count++;
+    pthread_cond_signal(&MPIM_trace_filled);
+    // Losing events would make the trace unusable, so a thread outpacing the disk waits for it
+    while(MPIM_trace_free_blocks == NULL && MPIM_trace_pending_count >= MPIM_TRACE_MAX_PENDING_BLOCKS)
+    {
+        pthread_cond_wait(&MPIM_trace_drained, &MPIM_trace_mutex);
+    }
+    block = MPIM_trace_free_blocks;
+    if(block != NULL)
+    {
+        MPIM_trace_free_blocks = block->next;
+    }
+    pthread_mutex_unlock(&MPIM_trace_mutex);
+    if(block == NULL)
+    {
+        block = (struct MPIM_trace_block_buffer_t*)malloc(sizeof(struct MPIM_trace_block_buffer_t));
+        if(block == NULL)
+        {
+            printf("Failure in allocating a trace block.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+    }
+    block->thread = stream->thread;
+    block->event_count = 0;
+    block->length = 0;
+    block->time = stream->previous_time;
+    stream->block = block;
+    // Every block defines its callsites anew, so that it can be decoded on its own
+    memset(stream->callsites, 0, sizeof(stream->callsites));
+    stream->callsite_count = 0;
+}
+
+/**
+ * @brief Gets the trace stream of the calling thread, creating it on its first MPI call.
+ * @return The stream.
+ **/
+static struct MPIM_trace_stream_t* MPIM_trace_get_stream()
+{
+    if(MPIM_my_trace_stream == NULL)
+    {
+        struct MPIM_trace_stream_t* stream = (struct MPIM_trace_stream_t*)calloc(1, sizeof(struct MPIM_trace_stream_t));
+        struct MPIM_trace_block_buffer_t* block = (struct MPIM_trace_block_buffer_t*)malloc(sizeof(struct MPIM_trace_block_buffer_t));
+        if(stream == NULL || block == NULL)
+        {
+            printf("Failure in allocating a trace stream.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        pthread_mutex_lock(&MPIM_trace_mutex);
+        stream->thread = MPIM_trace_stream_count++;
+        stream->next = MPIM_trace_streams;
+        MPIM_trace_streams = stream;
+        pthread_mutex_unlock(&MPIM_trace_mutex);
+        block->thread = stream->thread;
+        block->event_count = 0;
+        block->length = 0;
+        block->time = 0;
+        stream->block = block;
+        MPIM_my_trace_stream = stream;
+    }
+    return MPIM_my_trace_stream;
+}
+
+/**
+ * @brief Records an MPI call in the trace of the calling thread.
+ * @details Only the callsite and, if they differ from those of the previous call there, the arguments are recorded, next to the time elapsed since the previous event: a call repeated in a loop usually takes 4 bytes before compression.
+ * @param[in] message The message describing the call.
+ * @param[in] callsite The callsite of the call.
+ * @param[in] file The name of the file from which the MPI call is issued.
+ * @param[in] line The line at which the MPI call is issued.
+ **/
+static void MPIM_trace_record(const struct MPIM_message_t* message, const void* callsite, const char* file, int line)
+{
+    struct MPIM_trace_stream_t* stream = MPIM_trace_get_stream();
+    if(stream->block->length > MPIM_TRACE_BLOCK_LENGTH - MPIM_TRACE_MAX_EVENT_LENGTH || stream->callsite_count == MPIM_TRACE_MAX_CALLSITES / 2)
+    {
+        MPIM_trace_submit(stream);
+    }
+    uint64_t time = MPIM_get_ticks() - MPIM_trace_start;
+
+    uintptr_t address = (uintptr_t)callsite;
+    uint32_t bucket = (uint32_t)(((address >> 2) ^ (uint32_t)line * 2654435761u ^ message->type) % MPIM_TRACE_MAX_CALLSITES);
+    struct MPIM_trace_callsite_t* entry = &stream->callsites[bucket];
+    while(entry->defined && (entry->address != address || entry->line != line || entry->type != message->type))
+    {
+        bucket = (bucket + 1) % MPIM_TRACE_MAX_CALLSITES;
+        entry = &stream->callsites[bucket];
+    }
+    bool defined = entry->defined;
+    bool arguments_follow = !defined || !MPIM_trace_arguments_equal(&entry->arguments, &message->arguments);
+    if(!defined)
+    {
+        entry->defined = true;
+        entry->address = address;
+        entry->line = line;
+        entry->type = message->type;
+        entry->index = stream->callsite_count++;
+    }
+    MPIM_trace_write_varint(stream, ((uint64_t)entry->index << 2) | (message->before << 1) | arguments_follow);
+    if(!defined)
+    {
+        struct MPIM_message_t located;
+        MPIM_message_set_callsite(&located, callsite);
+        size_t file_length = strnlen(file, MPIM_TRACE_MAX_FILE_LENGTH);
+        MPIM_trace_write_varint(stream, message->type);
+        MPIM_trace_write_varint(stream, line);
+        MPIM_trace_write_varint(stream, located.callsite_module);
+        MPIM_trace_write_varint(stream, located.callsite_offset);
+        MPIM_trace_write_varint(stream, file_length);
+        memcpy(stream->block->data + stream->block->length, file, file_length);
+        stream->block->length += file_length;
+    }
+    MPIM_trace_write_signed_varint(stream, (int64_t)(time - stream->previous_time));
+    stream->previous_time = time;
+    if(arguments_follow)
+    {
+        const struct MPIM_arguments_t* arguments = &message->arguments;
+        entry->arguments = *arguments;
+        MPIM_trace_write_varint(stream, arguments->kind);
+        MPIM_trace_write_signed_varint(stream, arguments->communicator);
+        MPIM_trace_write_signed_varint(stream, arguments->count);
+        MPIM_trace_write_signed_varint(stream, arguments->datatype_size);
+        const int32_t* values = &arguments->sendrecv.destination;
+        for(int i = 0; i < MPIM_trace_arguments_words(arguments->kind); i++)
+        {
+            MPIM_trace_write_signed_varint(stream, values[i]);
+        }
+    }
+    stream->block->event_count++;
+}
+
+/**
+ * @brief Opens the trace of this process and starts its writer, if the MPIM_TRACE_DIRECTORY environment variable gives the directory of the traces.
+ **/
+static void MPIM_trace_initialise()
+{
+    const char* directory = getenv("MPIM_TRACE_DIRECTORY");
+    if(directory == NULL || directory[0] == '\0')
+    {
+        return;
+    }
+    const char* compression = getenv("MPIM_TRACE_COMPRESSION");
+    MPIM_trace_compression = (compression == NULL || atoi(compression) != 0);
+    char path[MPIM_MAX_FILENAME_LENGTH];
+    snprintf(path, MPIM_MAX_FILENAME_LENGTH, "%s/mpim_trace.%d.bin", directory, MPIM_my_rank);
+    MPIM_trace_file = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(MPIM_trace_file == -1)
+    {
+        printf("MPI_monitor: cannot create the trace %s (%s), the run goes on without it.\n", path, strerror(errno));
+        return;
+    }
+
+    MPIM_trace_start = MPIM_get_ticks();
+    struct MPIM_trace_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = MPIM_TRACE_MAGIC;
+    header.version = MPIM_TRACE_VERSION;
+    header.rank = MPIM_my_rank;
+    header.comm_size = MPIM_my_comm_size;
+    header.world_communicator = MPI_Comm_c2f(MPI_COMM_WORLD);
+    header.name_count = MPIM_MESSAGE_TYPE_COUNT;
+    for(int i = 0; i < MPIM_MESSAGE_TYPE_COUNT; i++)
+    {
+        header.names_length += strlen(MPIM_routine_name_t[i]) + 1;
+    }
+    header.ticks_per_second = MPIM_my_clock.ticks_per_second;
+    header.start = MPIM_trace_start;
+    MPIM_trace_write(&header, sizeof(header));
+    for(int i = 0; i < MPIM_MESSAGE_TYPE_COUNT; i++)
+    {
+        MPIM_trace_write(MPIM_routine_name_t[i], strlen(MPIM_routine_name_t[i]) + 1);
+    }
+    if(MPIM_trace_file == -1)
+    {
+        return;
+    }
+    MPIM_trace_enabled = true;
+    pthread_create(&MPIM_trace_writer_thread, NULL, (void* (*)(void*))MPIM_trace_writer, NULL);
+}
+
+/**
+ * @brief Hands the partially filled blocks of every thread over to the trace writer, waits for it to write them and closes the trace.
+ **/
+static void MPIM_trace_finalise()
+{
+    if(!MPIM_trace_enabled)
+    {
+        return;
+    }
+    MPIM_trace_enabled = false;
+    pthread_mutex_lock(&MPIM_trace_mutex);
+    struct MPIM_trace_stream_t* streams = MPIM_trace_streams;
+    pthread_mutex_unlock(&MPIM_trace_mutex);
+    for(struct MPIM_trace_stream_t* stream = streams; stream != NULL; stream = stream->next)
+    {
+        if(stream->block->event_count > 0)
+        {
+            MPIM_trace_submit(stream);
+        }
+    }
+    pthread_mutex_lock(&MPIM_trace_mutex);
+    MPIM_trace_stopping = true;
+    pthread_cond_signal(&MPIM_trace_filled);
+    pthread_mutex_unlock(&MPIM_trace_mutex);
+    pthread_join(MPIM_trace_writer_thread, NULL);
+    if(MPIM_trace_file != -1)
+    {
+        close(MPIM_trace_file);
+        MPIM_trace_file = -1;
+    }
+    while(MPIM_trace_streams != NULL)
+    {
+        struct MPIM_trace_stream_t* stream = MPIM_trace_streams;
+        MPIM_trace_streams = stream->next;
+        free(stream->block);
+        free(stream);
+    }
+    while(MPIM_trace_free_blocks != NULL)
+    {
+        struct MPIM_trace_block_buffer_t* block = MPIM_trace_free_blocks;
+        MPIM_trace_free_blocks = block->next;
+        free(block);
+    }
+}
+
+/**
+ * @brief Restores the handlers installed before MPIM_crash_initialise.
+ **/
+static void MPIM_crash_finalise()
+{
+    if(!MPIM_flight_recorder_enabled)
+    {
+        return;
+    }
+    for(int i = 0; i < MPIM_CRASH_SIGNAL_COUNT; i++)
+    {
+        sigaction(MPIM_crash_signals[i], &MPIM_crash_previous_actions[i], NULL);
+    }
+    MPIM_flight_recorder_enabled = false;
+}
+
+/**
+ * @brief Switches the monitoring of this process on or off, on MPIM_MONITORING_ON_SIGNAL and MPIM_MONITORING_OFF_SIGNAL respectively.
+ * @details Switching on takes effect at once. Switching off is only requested, so that the next MPI call tells the aggregator the process is no longer monitored.
+ * @param[in] signal The signal received.
+ **/
+static void MPIM_monitoring_handler(int signal)
+{
+    MPIM_monitoring.requested = (signal == MPIM_MONITORING_ON_SIGNAL);
+    if(signal == MPIM_MONITORING_ON_SIGNAL)
+    {
+        MPIM_monitoring.enabled = 1;
+    }
+}
+
+/**
+ * @brief Sends a switch of the aggregator to every other process.
+ * @details Called by MPI process 0 only. The requested state is written before the enabled flag, so that a process switched on never reads a stale request to switch off.
+ * @param[in] enabled 1 to switch the monitoring on, 0 to switch it off.
+ **/
+static void MPIM_monitoring_relay(int32_t enabled)
+{
+    for(int i = 1; i < MPIM_my_comm_size; i++)
+    {
+        MPI_Put(&enabled, 1, MPI_INT32_T, i, offsetof(struct MPIM_monitoring_switch_t, requested), 1, MPI_INT32_T, MPIM_monitoring_window);
+    }
+    MPI_Win_flush_all(MPIM_monitoring_window);
+    if(enabled)
+    {
+        for(int i = 1; i < MPIM_my_comm_size; i++)
+        {
+            MPI_Put(&enabled, 1, MPI_INT32_T, i, offsetof(struct MPIM_monitoring_switch_t, enabled), 1, MPI_INT32_T, MPIM_monitoring_window);
+        }
+        MPI_Win_flush_all(MPIM_monitoring_window);
+    }
+}
+
+/**
+ * @brief Relays a switch received by MPI process 0 to every process, reading the MPI routine every thread is in when switching on.
+ * @details Called by MPI process 0 only, from the manager thread or from an MPI call of the application. The routines read are left for MPIM_monitoring_publish_unmonitored to show the calls entered while monitoring was off; MPIM_snapshot_mutex is held meanwhile, as the manager applies them.
+ * @param[in] requested 1 to switch the monitoring on, 0 to switch it off.
+ **/
+static void MPIM_monitoring_switch_job(int32_t requested)
+{
+    MPIM_monitoring_relayed = requested;
+    MPIM_monitoring_relay(requested);
+    if(requested)
+    {
+        pthread_mutex_lock(&MPIM_snapshot_mutex);
+        for(int i = 0; i < MPIM_my_comm_size; i++)
+        {
+            MPI_Get(&MPIM_unmonitored_snapshot[i * MPIM_threads_per_process], MPIM_threads_per_process, MPI_INT32_T, i, 0, MPIM_threads_per_process, MPI_INT32_T, MPIM_unmonitored_window);
+        }
+        MPI_Win_flush_all(MPIM_unmonitored_window);
+        MPIM_unmonitored_snapshot_time = MPIM_get_time();
+        MPIM_unmonitored_snapshot_pending = true;
+        pthread_mutex_unlock(&MPIM_snapshot_mutex);
+    }
+}
+
+/**
+ * @brief Relays the switches received by MPI process 0 to every process, from the manager thread.
+ * @details Called by the manager between two frames when the application obtained MPI_THREAD_MULTIPLE, so that a switch does not wait for an application thread of MPI process 0 to enter MPI.
+ **/
+static void MPIM_monitoring_serve()
+{
+    int32_t requested = MPIM_monitoring.requested;
+    if(requested != MPIM_monitoring_relayed)
+    {
+        MPIM_monitoring_switch_job(requested);
+    }
+}
+
+/**
+ * @brief Forgets what was learnt before the monitoring was switched off, as the calls made meanwhile were not followed.
+ * @details Communicators, datatypes, requests and windows may have been freed while monitoring was off and their handles reused, so the caches of communicators, datatypes and nonblocking receives are invalidated, and the persistent requests and windows are no longer tracked.
+ **/
+static void MPIM_monitoring_forget()
+{
+    atomic_fetch_add(&MPIM_communicator_generation, 1);
+    atomic_fetch_add(&MPIM_datatype_generation, 1);
+    atomic_fetch_add(&MPIM_wait_receive_generation, 1);
+    MPIM_persistent_forget();
+    MPIM_rma_forget();
+}
+
+/**
+ * @brief Applies the last switch requested by a signal or by the aggregator.
+ * @details Once switched on again, the caches filled before the switch off are forgotten, the clock offset is estimated anew, as it drifted meanwhile, and every thread publishes a fresh update on its next call. Unless the manager relays them, the switches applied by MPI process 0 are relayed to every process.
+ * @return true if the calling thread switched the monitoring off, in which case its call is the last one published, false otherwise.
+ **/
+static bool MPIM_monitoring_apply()
+{
+    bool switched_off = false;
+    pthread_mutex_lock(&MPIM_monitoring_mutex);
+    int32_t requested = MPIM_monitoring.requested;
+    if(requested != MPIM_monitoring.applied)
+    {
+        MPIM_monitoring.applied = requested;
+        if(requested)
+        {
+            MPIM_monitoring_forget();
+            MPIM_monitoring.enabled = 1;
+            atomic_store_explicit(&MPIM_clock_next_sync, 0, memory_order_relaxed);
+        }
+        else
+        {
+            MPIM_monitoring.enabled = 0;
+            switched_off = true;
+        }
+        if(MPIM_my_rank == 0 && !MPIM_monitoring_manager_relays && requested != MPIM_monitoring_relayed)
+        {
+            MPIM_monitoring_switch_job(requested);
+        }
+    }
+    pthread_mutex_unlock(&MPIM_monitoring_mutex);
+    return switched_off;
+}
+
+/**
+ * @brief Creates the windows through which the aggregator relays its switches and reads the routines entered while monitoring was off, and installs the handlers of the switching signals.
+ * @details Must be called collectively. Setting the MPIM_ENABLED environment variable to 0 switches the monitoring off from the first MPI call after MPI_Init. The signals are left to the application if it handles them already.
+ **/
+static void MPIM_monitoring_initialise()
+{
+    const char* enabled = getenv("MPIM_ENABLED");
+    if(enabled != NULL && atoi(enabled) == 0)
+    {
+        MPIM_monitoring.requested = 0;
+    }
+    MPIM_monitoring_relayed = MPIM_monitoring.requested;
+    MPI_Win_create(&MPIM_monitoring, sizeof(struct MPIM_monitoring_switch_t), 1, MPI_INFO_NULL, MPI_COMM_WORLD, &MPIM_monitoring_window);
+    MPIM_unmonitored_calls = (int32_t*)calloc(MPIM_threads_per_process, sizeof(int32_t));
+    if(MPIM_unmonitored_calls == NULL)
+    {
+        printf("Failure in allocating MPIM_unmonitored_calls.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    // The thread initialising MPI has the first slot
+    MPIM_my_unmonitored_call = &MPIM_unmonitored_calls[0];
+    MPI_Win_create(MPIM_unmonitored_calls, sizeof(int32_t) * MPIM_threads_per_process, sizeof(int32_t), MPI_INFO_NULL, MPI_COMM_WORLD, &MPIM_unmonitored_window);
+    if(MPIM_my_rank == 0)
+    {
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, MPIM_monitoring_window);
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, MPIM_unmonitored_window);
+        MPIM_unmonitored_snapshot = (int32_t*)malloc(sizeof(int32_t) * MPIM_my_comm_size * MPIM_threads_per_process);
+        if(MPIM_unmonitored_snapshot == NULL)
+        {
+            printf("Failure in allocating MPIM_unmonitored_snapshot.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        // The thread level of the application is kept, the manager only issues MPI calls if it allows them
+        int provided;
+        MPI_Query_thread(&provided);
+        MPIM_monitoring_manager_relays = (provided == MPI_THREAD_MULTIPLE);
+        if(!MPIM_monitoring_manager_relays && enabled != NULL)
+        {
+            printf("MPI_monitor: cannot relay switches as soon as they are received without MPI_THREAD_MULTIPLE, they will wait for an MPI call of process 0.\n");
+        }
+    }
+
+    for(int i = 0; i < MPIM_MONITORING_SIGNAL_COUNT; i++)
+    {
+        sigaction(MPIM_monitoring_signals[i], NULL, &MPIM_monitoring_previous_actions[i]);
+        if(MPIM_monitoring_previous_actions[i].sa_handler != SIG_DFL)
+        {
+            if(MPIM_my_rank == 0)
+            {
+                printf("MPI_monitor: cannot switch the monitoring with signals %d and %d, already handled, the run goes on without them.\n", MPIM_MONITORING_ON_SIGNAL, MPIM_MONITORING_OFF_SIGNAL);
+            }
+            return;
+        }
+    }
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = MPIM_monitoring_handler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    for(int i = 0; i < MPIM_MONITORING_SIGNAL_COUNT; i++)
+    {
+        sigaction(MPIM_monitoring_signals[i], &action, NULL);
+    }
+    MPIM_monitoring_signals_installed = true;
+}
+
+/**
+ * @brief Frees the windows of the switches and restores the handlers installed before MPIM_monitoring_initialise.
+ * @details Must be called collectively.
+ **/
+static void MPIM_monitoring_finalise()
+{
+    if(MPIM_my_rank == 0)
+    {
+        MPI_Win_unlock_all(MPIM_monitoring_window);
+        MPI_Win_unlock_all(MPIM_unmonitored_window);
+    }
+    MPI_Win_free(&MPIM_monitoring_window);
+    MPI_Win_free(&MPIM_unmonitored_window);
+    free(MPIM_unmonitored_calls);
+    MPIM_unmonitored_calls = NULL;
+    MPIM_my_unmonitored_call = &MPIM_unmonitored_call_ignored;
+    free(MPIM_unmonitored_snapshot);
+    MPIM_unmonitored_snapshot = NULL;
+    if(MPIM_monitoring_signals_installed)
+    {
+        for(int i = 0; i < MPIM_MONITORING_SIGNAL_COUNT; i++)
+        {
+            sigaction(MPIM_monitoring_signals[i], &MPIM_monitoring_previous_actions[i], NULL);
+        }
+        MPIM_monitoring_signals_installed = false;
+    }
+}
+
+static void MPIM_message(enum MPIM_message_temporality_t temporality, enum MPIM_message_type_t type, const void* callsite, const char* file, int line, const struct MPIM_arguments_t* arguments)
+{
+    bool switched_off = false;
+    if(temporality == MPIM_TEMPORALITY_BEFORE)
+    {
+        if(__builtin_expect(MPIM_monitoring.requested != MPIM_monitoring.applied, 0))
+        {
+            switched_off = MPIM_monitoring_apply() && type != MPIM_MESSAGE_FINALISED;
+        }
+        // The aggregator waits for every process to call MPI_Finalize, which is thus published whatever the switch
+        MPIM_my_call_monitored = (MPIM_monitoring.enabled && !switched_off) || type == MPIM_MESSAGE_FINALISED;
+        if(!MPIM_my_call_monitored && !switched_off)
+        {
+            return;
+        }
+    }
+    else if(!MPIM_my_call_monitored)
+    {
+        return;
+    }
+
+    struct MPIM_message_t message;
+    uint64_t nanoseconds = 0;
+    message.type = type;
+    message.before = (temporality == MPIM_TEMPORALITY_BEFORE);
+    message.switched_off = switched_off;
+    message.unmonitored = false;
+    message.arguments = *arguments;
+    if(message.before)
+    {
+        MPIM_my_call_count++;
+    }
+    else
+    {
+        uint64_t end = MPIM_get_ticks();
+        nanoseconds = (uint64_t)((end - MPIM_my_call_start) * 1.0E9 / MPIM_my_clock.ticks_per_second);
+        if(type != MPIM_MESSAGE_INITIALISED && type != MPIM_MESSAGE_INIT_THREAD)
+        {
+            MPIM_my_mpi_nanoseconds += nanoseconds;
+        }
+        if(MPIM_wait_states_enabled)
+        {
+            MPIM_wait_states_after(type, arguments, end);
+        }
+        MPIM_histogram_record(type, arguments, nanoseconds);
+        if(MPIM_stall_threshold > 0.0 && MPIM_my_thread_slot >= 0)
+        {
+            MPIM_thread_states[MPIM_my_thread_slot].call_count = 0;
+        }
+    }
+    if(!message.before && (arguments->kind == MPIM_ARGUMENTS_SEND || arguments->kind == MPIM_ARGUMENTS_RECEIVE || arguments->kind == MPIM_ARGUMENTS_SENDRECV || arguments->kind == MPIM_ARGUMENTS_MATCHED_RECEIVE))
+    {
+        size_t data_size = (arguments->count > 0) ? (size_t)arguments->count * arguments->datatype_size : 0;
+        if(arguments->kind == MPIM_ARGUMENTS_SEND || arguments->kind == MPIM_ARGUMENTS_SENDRECV)
+        {
+            MPIM_my_total_data_sent += data_size;
+        }
+        if(arguments->kind != MPIM_ARGUMENTS_SEND)
+        {
+            MPIM_my_total_data_received += data_size;
+        }
+    }
+    message.call_count = MPIM_my_call_count;
+    message.active_persistent_requests = atomic_load_explicit(&MPIM_persistent_active_count, memory_order_relaxed);
+    MPIM_rma_get_epoch(arguments, &message.epoch);
+    message.total_data_sent = MPIM_my_total_data_sent;
+    message.total_data_received = MPIM_my_total_data_received;
+    message.mpi_nanoseconds = MPIM_my_mpi_nanoseconds;
+    if(switched_off)
+    {
+        // Published as completed, so that the thread is not reported stuck in a call that is no longer followed
+        message.before = false;
+        MPIM_send_update(&message, callsite, line, true);
+        return;
+    }
+    if(MPIM_flight_recorder_enabled)
+    {
+        MPIM_flight_record(&message, file, line);
+    }
+    if(MPIM_trace_enabled)
+    {
+        MPIM_trace_record(&message, callsite, file, line);
+    }
+    if(MPIM_routine_attributes_t[type] & MPIM_ROUTINE_LOCAL)
+    {
+        // Local queries never wait on other processes, publishing them would only add an RMA operation to a call that takes nanoseconds
+        MPIM_message_set_callsite(&message, callsite);
+        message.line = line;
+    }
+    else
+    {
+        // A process blocked in MPI may not progress its pending puts, so the update announcing the blocking call is flushed first
+        bool flush = (MPIM_flush_policy == MPIM_FLUSH_ALL) || (MPIM_flush_policy == MPIM_FLUSH_BLOCKING && message.before && (MPIM_routine_attributes_t[type] & MPIM_ROUTINE_BLOCKING));
+        MPIM_send_update(&message, callsite, line, flush);
+    }
+    if(message.before)
+    {
+        if(MPIM_wait_states_enabled)
+        {
+            MPIM_wait_states_before(type, arguments, MPIM_get_ticks());
+        }
+        // Started once the update is sent, so that the histograms and profile only account for the MPI routine itself
+        MPIM_my_call_start = MPIM_get_ticks();
+        if(MPIM_stall_threshold > 0.0 && MPIM_my_thread_slot >= 0)
+        {
+            struct MPIM_thread_state_t* state = &MPIM_thread_states[MPIM_my_thread_slot];
+            state->call_start = MPIM_my_call_start;
+            __atomic_store_n(&state->call_count, MPIM_my_call_count, __ATOMIC_RELEASE);
+        }
+    }
+    else if(type != MPIM_MESSAGE_INITIALISED && type != MPIM_MESSAGE_INIT_THREAD)
+    {
+        MPIM_profile_record(type, message.callsite_module, message.callsite_offset, line, nanoseconds);
+    }
+}
+
+/////////////////////////////////////////
+// MPIM_ VERSIONS OF MPI ROUTINES //
+///////////////////////////////////////
+
+/**
+ * @brief Prints an horizontal seperator, used in tables.
+ * @param[in] who_length The maximum length of the strings contained in the 'who' column.
+ * @param[in] routine_name_length The maximum length of the strings contained in the 'routine name' column.
+ * @param[in] where_length The maximum length of the strings contained in the 'where' column.
+ * @param[in] when_length The maximum length of the strings contained in the 'when' column.
+ * @param[in] details_length The maximum length of the strings contained in the 'details' column.
+ **/
+static void print_horizontal_separator(int who_length, int routine_name_length, int where_length, int when_length, int details_length)
+{
+    printf("+-");
+    for(int i = 0; i < who_length; i++)
+    {
+        printf("-");
+    }
+    printf("-+-");
+    for(int i = 0; i < routine_name_length; i++)
+    {
+        printf("-");
+    }
+    printf("-+-");
+    for(int i = 0; i < where_length; i++)
+    {
+        printf("-");
+    }
+    printf("-+-");
+    for(int i = 0; i < when_length; i++)
+    {
+        printf("-");
+    }
+    printf("-----------+-");
+    for(int i = 0; i < details_length; i++)
+    {
+        printf("-");
+    }
+    printf("-+\n");
+}
+
+/**
+ * @brief Allocates an empty slot list.
+ * @param[out] list The list.
+ * @param[in] slot_count The number of slots.
+ **/
+static void MPIM_slot_list_initialise(struct MPIM_slot_list_t* list, int slot_count)
+{
+    list->slots = (int*)malloc(slot_count * sizeof(int));
+    list->positions = (int*)malloc(slot_count * sizeof(int));
+    if(list->slots == NULL || list->positions == NULL)
+    {
+        printf("Failure in allocating a slot list.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    memset(list->positions, 0xFF, slot_count * sizeof(int));
+    list->count = 0;
+}
+
+/**
+ * @brief Adds a slot to a slot list or removes it, the last slot of the list taking the place of a slot removed.
+ * @param[in,out] list The list.
+ * @param[in] slot The slot.
+ * @param[in] member Indicates if the slot must be in the list.
+ **/
+static void MPIM_slot_list_set(struct MPIM_slot_list_t* list, int slot, bool member)
+{
+    int position = list->positions[slot];
+    if(member && position == -1)
+    {
+        list->positions[slot] = list->count;
+        list->slots[list->count++] = slot;
+    }
+    else if(!member && position != -1)
+    {
+        int last = list->slots[--list->count];
+        list->slots[position] = last;
+        list->positions[last] = position;
+        list->positions[slot] = -1;
+    }
+}
+
+/**
+ * @brief Orders slots by increasing index.
+ * @param[in] a The first slot.
+ * @param[in] b The second slot.
+ * @return A negative value if a comes first, a positive value if b comes first, 0 otherwise.
+ **/
+static int MPIM_slot_compare_index(const void* a, const void* b)
+{
+    return *(const int*)a - *(const int*)b;
+}
+
+/**
+ * @brief Sorts the slots of a slot list by increasing index, updating their positions.
+ * @param[in,out] list The list.
+ **/
+static void MPIM_slot_list_sort(struct MPIM_slot_list_t* list)
+{
+    qsort(list->slots, list->count, sizeof(int), MPIM_slot_compare_index);
+    for(int i = 0; i < list->count; i++)
+    {
+        list->positions[list->slots[i]] = i;
+    }
+}
+
+/**
+ * @brief Indicates if a slot of the window must be displayed.
+ * @details The slot of the first thread of each process is always displayed, the slots of other threads only once they have issued an MPI call.
+ * @param[in] slot The index of the slot.
+ * @return True if the slot must be displayed, false otherwise.
+ **/
+static bool MPIM_slot_is_displayed(int slot)
+{
+    return (slot % MPIM_threads_per_process) == 0 || MPIM_my_window_buffer_copy[slot].type != MPIM_MESSAGE_UNINITIALISED;
+}
+
+/**
+ * @brief Writes the identifier of the thread owning a slot, in the form "rank" for the first thread of a process and "rank.thread" for the others.
+ * @param[in] slot The index of the slot.
+ * @param[out] who The buffer receiving the identifier.
+ * @param[in] who_length The size of the who buffer.
+ **/
+static void MPIM_slot_get_who(int slot, char* who, int who_length)
+{
+    int rank = slot / MPIM_threads_per_process;
+    int thread = slot % MPIM_threads_per_process;
+    if(thread == 0)
+    {
+        snprintf(who, who_length, "%d", rank);
+    }
+    else
+    {
+        snprintf(who, who_length, "%d.%d", rank, thread);
+    }
+}
+
+/**
+ * @brief Gives the time, in the clock of the aggregator, at which the message held in a slot was created.
+ * @param[in] slot The index of the slot.
+ * @return The time of the aggregator, in seconds.
+ **/
+static double MPIM_slot_get_time(int slot)
+{
+    return MPIM_clock_to_aggregator_time(&MPIM_clock_window_buffer[slot / MPIM_threads_per_process].calibration, MPIM_my_window_buffer_copy[slot].timestamp);
+}
+
+/**
+ * @brief Tells whether the stack of a slot was captured during the call it currently displays.
+ * @param[in] slot The slot.
+ * @return true if the stack is available, false otherwise.
+ **/
+static bool MPIM_slot_has_stack(int slot)
+{
+    const struct MPIM_message_t* message = &MPIM_my_window_buffer_copy[slot];
+    const struct MPIM_stack_t* stack = &MPIM_stack_window_buffer[slot];
+    return message->before && stack->depth > 0 && stack->call_count == message->call_count;
+}
+
+/**
+ * @brief Prints the stacks of stalled calls, each distinct stack being printed once along with the calls sharing it.
+ * @details Only the slots of MPIM_calling_slots are looked at, in the order of their index.
+ **/
+static void MPIM_stacks_print()
+{
+    char who[24];
+    char symbol[MPIM_MAX_SYMBOL_LENGTH];
+    int stalled_count = 0;
+    int* stalled = (int*)malloc((MPIM_calling_slots.count + 1) * sizeof(int));
+    bool* printed = (bool*)calloc(MPIM_calling_slots.count + 1, sizeof(bool));
+    if(stalled == NULL || printed == NULL)
+    {
+        free(stalled);
+        free(printed);
+        return;
+    }
+    for(int i = 0; i < MPIM_calling_slots.count; i++)
+    {
+        if(MPIM_slot_has_stack(MPIM_calling_slots.slots[i]))
+        {
+            stalled[stalled_count++] = MPIM_calling_slots.slots[i];
+        }
+    }
+    qsort(stalled, stalled_count, sizeof(int), MPIM_slot_compare_index);
+    for(int i = 0; i < stalled_count; i++)
+    {
+        if(printed[i])
+        {
+            continue;
+        }
+
+        const struct MPIM_stack_t* stack = &MPIM_stack_window_buffer[stalled[i]];
+        int sharing_count = 0;
+        for(int j = i; j < stalled_count; j++)
+        {
+            const struct MPIM_stack_t* other = &MPIM_stack_window_buffer[stalled[j]];
+            if(!printed[j] && other->depth == stack->depth && memcmp(other->frames, stack->frames, stack->depth * sizeof(uint64_t)) == 0)
+            {
+                printed[j] = true;
+                sharing_count++;
+            }
+        }
+
+        printf("\nStack of %d stalled call%s (", sharing_count, (sharing_count > 1) ? "s" : "");
+        int listed_count = 0;
+        for(int j = i; j < stalled_count && listed_count < sharing_count; j++)
+        {
+            const struct MPIM_stack_t* other = &MPIM_stack_window_buffer[stalled[j]];
+            if(printed[j] && other->depth == stack->depth && memcmp(other->frames, stack->frames, stack->depth * sizeof(uint64_t)) == 0)
+            {
+                if(listed_count < MPIM_STACK_MAX_LISTED_CALLS)
+                {
+                    MPIM_slot_get_who(stalled[j], who, sizeof(who));
+                    printf("%s%s", (listed_count > 0) ? ", " : "", who);
+                }
+                listed_count++;
+            }
+        }
+        if(sharing_count > MPIM_STACK_MAX_LISTED_CALLS)
+        {
+            printf(", and %d more", sharing_count - MPIM_STACK_MAX_LISTED_CALLS);
+        }
+        printf("):\n");
+        for(int frame = 0; frame < stack->depth; frame++)
+        {
+            uint32_t module = (uint32_t)(stack->frames[frame] >> 32);
+            uint64_t offset = stack->frames[frame] & UINT32_MAX;
+            if(module == 0)
+            {
+                printf("    #%-2d ??\n", frame);
+            }
+            else
+            {
+                printf("    #%-2d %s\n", frame, MPIM_symbol_cache_get(MPIM_frame_cache, MPIM_SYMBOL_FRAME, module, offset, symbol));
+            }
+        }
+    }
+    free(stalled);
+    free(printed);
+}
+
+/**
+ * @brief Adds the summary of a slot to the statistics of the slots displayed, or removes it.
+ * @param[in] summary The summary of the slot.
+ * @param[in] increment 1 to add the slot, -1 to remove it.
+ **/
+static void MPIM_slot_summary_count(const struct MPIM_slot_summary_t* summary, int increment)
+{
+    if(!summary->displayed)
+    {
+        return;
+    }
+    MPIM_displayed_slot_count += increment;
+    MPIM_state_counts[summary->type][summary->before ? 0 : 1] += increment;
+    for(int i = 0; i < MPIM_COLUMN_COUNT; i++)
+    {
+        MPIM_column_length_counts[i][summary->lengths[i]] += increment;
+    }
+}
+
+/**
+ * @brief Gives the width of a text in the live display, bounded to fit the column statistics.
+ * @param[in] text The text.
+ * @return The width.
+ **/
+static uint16_t MPIM_column_get_length(const char* text)
+{
+    size_t length = strlen(text);
+    return (length < MPIM_MAX_ARGUMENTS_LENGTH) ? length : MPIM_MAX_ARGUMENTS_LENGTH - 1;
+}
+
+/**
+ * @brief Gives the width of a column, that of its widest slot displayed.
+ * @param[in] column The column.
+ * @param[in] minimum The minimum width, that of the column header.
+ * @return The width.
+ **/
+static int MPIM_column_get_width(enum MPIM_column_t column, int minimum)
+{
+    for(int length = MPIM_MAX_ARGUMENTS_LENGTH - 1; length > minimum; length--)
+    {
+        if(MPIM_column_length_counts[column][length] > 0)
+        {
+            return length;
+        }
+    }
+    return minimum;
+}
+
+/**
+ * @brief Updates the summary of a slot once a new version of it is copied, along with the statistics derived from the summaries.
+ * @param[in] slot The slot.
+ **/
+static void MPIM_slot_summarise(int slot)
+{
+    struct MPIM_slot_summary_t* summary = &MPIM_slot_summaries[slot];
+    const struct MPIM_message_t* message = &MPIM_my_window_buffer_copy[slot];
+    char text[MPIM_MAX_ARGUMENTS_LENGTH];
+    MPIM_slot_summary_count(summary, -1);
+    summary->displayed = MPIM_slot_is_displayed(slot);
+    summary->before = message->before;
+    summary->type = message->type;
+    MPIM_slot_get_who(slot, text, MPIM_WHO_LENGTH);
+    summary->lengths[MPIM_COLUMN_WHO] = MPIM_column_get_length(text);
+    summary->lengths[MPIM_COLUMN_WHAT] = MPIM_column_get_length(MPIM_routine_name_t[message->type]);
+    MPIM_message_get_where(message, text, MPIM_WHERE_LENGTH);
+    summary->lengths[MPIM_COLUMN_WHERE] = MPIM_column_get_length(text);
+    MPIM_message_get_details(message, text, MPIM_MAX_ARGUMENTS_LENGTH);
+    summary->lengths[MPIM_COLUMN_DETAILS] = MPIM_column_get_length(text);
+    MPIM_slot_summary_count(summary, 1);
+    MPIM_slot_list_set(&MPIM_displayed_slots, slot, summary->displayed);
+    MPIM_slot_list_set(&MPIM_calling_slots, slot, summary->displayed && summary->before);
+
+    // A process is finalised as soon as one of its threads has called MPI_Finalize
+    int rank = slot / MPIM_threads_per_process;
+    if(message->type == MPIM_MESSAGE_FINALISED && !MPIM_process_finalised[rank])
+    {
+        MPIM_process_finalised[rank] = true;
+        MPIM_finalised_process_count++;
+    }
+}
+
+/**
+ * @brief Lists a slot among those updated since the previous frame, unless it is already.
+ * @param[in] slot The slot.
+ **/
+static void MPIM_slot_mark_updated(int slot)
+{
+    if(MPIM_updated_slots != NULL && !MPIM_slot_summaries[slot].updated)
+    {
+        MPIM_slot_summaries[slot].updated = true;
+        MPIM_updated_slots[MPIM_updated_slot_count++] = slot;
+    }
+}
+
+/**
+ * @brief Copies a slot from the window into MPIM_my_window_buffer_copy if it was updated since the previous frame, and updates its summary.
+ * @details MPI orders neither the words written by one accumulate nor those of accumulates to different words, so a copy taken while an update lands may mix two updates. The copy is only kept when its checksum matches and its sequence number is newer than the one of the previous copy, the sequence numbers of a slot only growing.
+ * An unchanged slot is only read for its sequence number. A slot still torn after MPIM_SNAPSHOT_RETRIES attempts keeps its previous version until the next frame.
+ * @param[in] slot The slot.
+ **/
+static void MPIM_snapshot_slot(int slot)
+{
+    struct MPIM_message_t* original = &MPIM_my_window_buffer_original[slot];
+    // UINT64_MAX until the first copy of the slot, which accepts any sequence number
+    uint64_t last = MPIM_snapshot_sequences[slot];
+    for(int attempt = 0; attempt < MPIM_SNAPSHOT_RETRIES; attempt++)
+    {
+        uint64_t sequence = __atomic_load_n(&original->sequence, __ATOMIC_ACQUIRE);
+        if(sequence == last || (last != UINT64_MAX && sequence < last))
+        {
+            return;
+        }
+        struct MPIM_message_t candidate;
+        memcpy(&candidate, original, sizeof(struct MPIM_message_t));
+        if(candidate.checksum == MPIM_message_get_checksum(&candidate) && (last == UINT64_MAX || candidate.sequence > last))
+        {
+            MPIM_my_window_buffer_copy[slot] = candidate;
+            MPIM_snapshot_sequences[slot] = candidate.sequence;
+            MPIM_slot_summarise(slot);
+            MPIM_slot_mark_updated(slot);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Copies the slots updated since the previous frame from the window into MPIM_my_window_buffer_copy, and updates their summaries.
+ * @details The first frame copies every slot. Later ones only read the slots of each process up to the highest one claimed by its threads, as told by MPIM_claimed_slot_counts, so that the slots of threads that do not exist are never read; with one thread per process, they are all of them.
+ * @param[in] slot_count The number of slots.
+ **/
+static void MPIM_snapshot_slots(int slot_count)
+{
+    static bool first_frame = true;
+    if(first_frame)
+    {
+        for(int i = 0; i < slot_count; i++)
+        {
+            MPIM_snapshot_slot(i);
+        }
+        first_frame = false;
+        return;
+    }
+    for(int rank = 0; rank < MPIM_my_comm_size; rank++)
+    {
+        int claimed_slot_count = __atomic_load_n(&MPIM_claimed_slot_counts[rank], __ATOMIC_ACQUIRE);
+        if(claimed_slot_count > MPIM_threads_per_process)
+        {
+            claimed_slot_count = MPIM_threads_per_process;
+        }
+        for(int i = rank * MPIM_threads_per_process; i < rank * MPIM_threads_per_process + claimed_slot_count; i++)
+        {
+            MPIM_snapshot_slot(i);
+        }
+    }
+}
+
+/**
+ * @brief Shows the threads that were inside an MPI routine entered while monitoring was off when it was switched on, whose last update is that of an earlier call.
+ * @details Called by the manager with MPIM_snapshot_mutex held. Only MPIM_my_window_buffer_copy is changed, the sequence number of the slots being kept, so that the next update of the thread replaces it. The routine is shown as entered when the monitoring was switched on, as the actual time is unknown, with neither callsite nor arguments.
+ **/
+static void MPIM_monitoring_publish_unmonitored()
+{
+    MPIM_unmonitored_snapshot_pending = false;
+    int slot_count = MPIM_my_comm_size * MPIM_threads_per_process;
+    for(int slot = 0; slot < slot_count; slot++)
+    {
+        int32_t type = MPIM_unmonitored_snapshot[slot];
+        struct MPIM_message_t* message = &MPIM_my_window_buffer_copy[slot];
+        if(type <= MPIM_MESSAGE_UNINITIALISED || type >= MPIM_MESSAGE_TYPE_COUNT || message->before)
+        {
+            continue;
+        }
+        message->type = (enum MPIM_message_type_t)type;
+        message->before = true;
+        message->switched_off = false;
+        message->unmonitored = true;
+        message->callsite_module = 0;
+        message->callsite_offset = 0;
+        message->line = 0;
+        message->timestamp = MPIM_clock_from_aggregator_time(&MPIM_clock_window_buffer[slot / MPIM_threads_per_process].calibration, MPIM_unmonitored_snapshot_time);
+        message->arguments = MPIM_arguments_none();
+        message->epoch.tracked = 0;
+        MPIM_slot_summarise(slot);
+        MPIM_slot_mark_updated(slot);
+    }
+}
+
+/**
+ * @brief Orders the states of the live display by decreasing number of threads.
+ * @param[in] a The first state, an index in the flattened MPIM_state_counts.
+ * @param[in] b The second state, an index in the flattened MPIM_state_counts.
+ * @return A negative value if a comes first, a positive value if b comes first, 0 otherwise.
+ **/
+static int MPIM_state_compare_count(const void* a, const void* b)
+{
+    const int* counts = &MPIM_state_counts[0][0];
+    return counts[*(const int*)b] - counts[*(const int*)a];
+}
+
+/**
+ * @brief Prints the horizontal separator of the table of states.
+ * @param[in] what_length The width of the routine column.
+ **/
+static void MPIM_states_print_separator(int what_length)
+{
+    printf("+-");
+    for(int i = 0; i < what_length; i++)
+    {
+        printf("-");
+    }
+    printf("-+-----------+------------+\n");
+}
+
+/**
+ * @brief Prints the number of threads in every state, a state being an MPI routine either started or completed.
+ * @details Used instead of one row per thread for large jobs, its cost only depends on the number of routines.
+ **/
+static void MPIM_states_print()
+{
+    int states[MPIM_MESSAGE_TYPE_COUNT * 2];
+    int state_count = 0;
+    const int* counts = &MPIM_state_counts[0][0];
+    for(int i = 0; i < MPIM_MESSAGE_TYPE_COUNT * 2; i++)
+    {
+        if(counts[i] > 0)
+        {
+            states[state_count++] = i;
+        }
+    }
+    qsort(states, state_count, sizeof(int), MPIM_state_compare_count);
+
+    int what_length = MPIM_column_get_width(MPIM_COLUMN_WHAT, 4);
+    printf("%d threads displayed, grouped by state as there are more than %d:\n", MPIM_displayed_slot_count, MPIM_display_rows);
+    MPIM_states_print_separator(what_length);
+    printf("| %*s | %9s | %10s |\n", what_length, "What", "State", "Threads");
+    MPIM_states_print_separator(what_length);
+    for(int i = 0; i < state_count; i++)
+    {
+        printf("| %*s | %9s | %10d |\n", what_length, MPIM_routine_name_t[states[i] / 2], (states[i] % 2 == 0) ? "started" : "completed", counts[states[i]]);
+    }
+    MPIM_states_print_separator(what_length);
+}
+
+/**
+ * @brief Makes room for a number of bytes at the end of the message being serialised for the viewers.
+ * @param[in] size The number of bytes.
+ * @return The address at which the bytes are to be written.
+ **/
+static char* MPIM_view_reserve(size_t size)
+{
+    if(MPIM_view_buffer_size + size > MPIM_view_buffer_capacity)
+    {
+        size_t capacity = (MPIM_view_buffer_capacity == 0) ? 4096 : MPIM_view_buffer_capacity;
+        while(MPIM_view_buffer_size + size > capacity)
+        {
+            capacity *= 2;
+        }
+        char* buffer = (char*)realloc(MPIM_view_buffer, capacity);
+        if(buffer == NULL)
+        {
+            printf("Failure in allocating MPIM_view_buffer.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        MPIM_view_buffer = buffer;
+        MPIM_view_buffer_capacity = capacity;
+    }
+    char* position = MPIM_view_buffer + MPIM_view_buffer_size;
+    MPIM_view_buffer_size += size;
+    return position;
+}
+
+/**
+ * @brief Appends bytes to the message being serialised for the viewers.
+ * @param[in] data The bytes.
+ * @param[in] size The number of bytes.
+ **/
+static void MPIM_view_append(const void* data, size_t size)
+{
+    memcpy(MPIM_view_reserve(size), data, size);
+}
+
+/**
+ * @brief Starts the serialisation of a message for the viewers, whose header is completed by MPIM_view_end_message.
+ * @param[in] kind The kind of message.
+ **/
+static void MPIM_view_begin_message(enum MPIM_view_message_kind_t kind)
+{
+    MPIM_view_buffer_size = 0;
+    struct MPIM_view_header_t header;
+    header.magic = MPIM_VIEW_MAGIC;
+    header.version = MPIM_VIEW_VERSION;
+    header.kind = kind;
+    header.length = 0;
+    MPIM_view_append(&header, sizeof(struct MPIM_view_header_t));
+}
+
+/**
+ * @brief Completes the header of the message serialised for the viewers with the length of its payload.
+ **/
+static void MPIM_view_end_message()
+{
+    struct MPIM_view_header_t* header = (struct MPIM_view_header_t*)MPIM_view_buffer;
+    header->length = MPIM_view_buffer_size - sizeof(struct MPIM_view_header_t);
+}
+
+/**
+ * @brief Writes bytes to the socket of a viewer, as many as it accepts without blocking.
+ * @param[in] socket The socket.
+ * @param[in] data The bytes.
+ * @param[in] size The number of bytes.
+ * @return The number of bytes written, -1 if the socket failed.
+ **/
+static ssize_t MPIM_view_write(int socket, const char* data, size_t size)
+{
+    size_t written = 0;
+    while(written < size)
+    {
+        ssize_t result = send(socket, data + written, size - written, MSG_NOSIGNAL);
+        if(result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        if(result <= 0)
+        {
+            return -1;
+        }
+        written += result;
+    }
+    return written;
+}
+
+/**
+ * @brief Sends the message serialised to a viewer, queueing what its socket does not accept at once behind its backlog.
+ * @details Viewer sockets are nonblocking, so that a slow viewer never delays the aggregator; its backlog is sent by MPIM_view_resume as the socket drains. A viewer whose backlog would exceed MPIM_VIEW_BACKLOG_KEYFRAMES keyframes, and MPIM_VIEW_MIN_BACKLOG bytes, is detached instead.
+ * @param[in] index The index of the viewer in MPIM_viewers.
+ * @return true if the message was sent or queued, false if the viewer must be detached.
+ **/
+static bool MPIM_view_send(int index)
+{
+    struct MPIM_viewer_t* viewer = &MPIM_viewers[index];
+    size_t sent = 0;
+    if(viewer->backlog_start == viewer->backlog_end)
+    {
+        ssize_t result = MPIM_view_write(viewer->socket, MPIM_view_buffer, MPIM_view_buffer_size);
+        if(result < 0)
+        {
+            return false;
+        }
+        sent = result;
+    }
+    if(sent == MPIM_view_buffer_size)
+    {
+        return true;
+    }
+
+    size_t remaining = MPIM_view_buffer_size - sent;
+    size_t backlog_size = viewer->backlog_end - viewer->backlog_start;
+    size_t bound = MPIM_VIEW_BACKLOG_KEYFRAMES * MPIM_view_keyframe_size;
+    if(backlog_size + remaining > ((bound > MPIM_VIEW_MIN_BACKLOG) ? bound : MPIM_VIEW_MIN_BACKLOG))
+    {
+        return false;
+    }
+    memmove(viewer->backlog, viewer->backlog + viewer->backlog_start, backlog_size);
+    viewer->backlog_start = 0;
+    viewer->backlog_end = backlog_size;
+    if(backlog_size + remaining > viewer->backlog_capacity)
+    {
+        size_t capacity = (viewer->backlog_capacity == 0) ? 65536 : viewer->backlog_capacity;
+        while(backlog_size + remaining > capacity)
+        {
+            capacity *= 2;
+        }
+        char* backlog = (char*)realloc(viewer->backlog, capacity);
+        if(backlog == NULL)
+        {
+            return false;
+        }
+        viewer->backlog = backlog;
+        viewer->backlog_capacity = capacity;
+    }
+    memcpy(viewer->backlog + viewer->backlog_end, MPIM_view_buffer + sent, remaining);
+    viewer->backlog_end += remaining;
+    return true;
+}
+
+/**
+ * @brief Detaches a viewer, the last viewer taking its index.
+ * @param[in] index The index of the viewer in MPIM_viewers.
+ **/
+static void MPIM_view_detach(int index)
+{
+    close(MPIM_viewers[index].socket);
+    free(MPIM_viewers[index].backlog);
+    MPIM_viewer_count--;
+    MPIM_viewers[index] = MPIM_viewers[MPIM_viewer_count];
+}
+
+/**
+ * @brief Sends the backlog of the viewers whose socket became writable, detaching those whose socket failed.
+ * @param[in] timeout The number of milliseconds to wait for a socket to become writable, 0 to only send what the sockets accept at once.
+ * @return The number of viewers left with a backlog.
+ **/
+static int MPIM_view_resume(int timeout)
+{
+    struct pollfd descriptors[MPIM_MAX_VIEWERS];
+    int indices[MPIM_MAX_VIEWERS];
+    int descriptor_count = 0;
+    for(int i = 0; i < MPIM_viewer_count; i++)
+    {
+        if(MPIM_viewers[i].backlog_start != MPIM_viewers[i].backlog_end)
+        {
+            descriptors[descriptor_count].fd = MPIM_viewers[i].socket;
+            descriptors[descriptor_count].events = POLLOUT;
+            descriptors[descriptor_count].revents = 0;
+            indices[descriptor_count++] = i;
+        }
+    }
+    if(descriptor_count == 0 || poll(descriptors, descriptor_count, timeout) <= 0)
+    {
+        return descriptor_count;
+    }
+
+    // Backwards, since detaching a viewer moves the last one to its index
+    int backlog_count = descriptor_count;
+    for(int i = descriptor_count - 1; i >= 0; i--)
+    {
+        struct MPIM_viewer_t* viewer = &MPIM_viewers[indices[i]];
+        if(descriptors[i].revents == 0)
+        {
+            continue;
+        }
+        ssize_t result = (descriptors[i].revents & POLLOUT) ? MPIM_view_write(viewer->socket, viewer->backlog + viewer->backlog_start, viewer->backlog_end - viewer->backlog_start) : -1;
+        if(result < 0)
+        {
+            MPIM_view_detach(indices[i]);
+            backlog_count--;
+            continue;
+        }
+        viewer->backlog_start += result;
+        if(viewer->backlog_start == viewer->backlog_end)
+        {
+            viewer->backlog_start = 0;
+            viewer->backlog_end = 0;
+            backlog_count--;
+        }
+    }
+    return backlog_count;
+}
+
+/**
+ * @brief Attaches the viewers waiting on the socket, and sends them the names of the routines.
+ **/
+static void MPIM_view_accept()
+{
+    while(MPIM_viewer_count < MPIM_MAX_VIEWERS)
+    {
+        int viewer = accept4(MPIM_view_socket, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(viewer == -1)
+        {
+            return;
+        }
+        memset(&MPIM_viewers[MPIM_viewer_count], 0, sizeof(struct MPIM_viewer_t));
+        MPIM_viewers[MPIM_viewer_count].socket = viewer;
+        MPIM_viewers[MPIM_viewer_count].needs_keyframe = true;
+        MPIM_viewer_count++;
+
+        MPIM_view_begin_message(MPIM_VIEW_NAMES);
+        uint32_t name_count = MPIM_MESSAGE_TYPE_COUNT;
+        MPIM_view_append(&name_count, sizeof(uint32_t));
+        for(int i = 0; i < MPIM_MESSAGE_TYPE_COUNT; i++)
+        {
+            MPIM_view_append(MPIM_routine_name_t[i], strlen(MPIM_routine_name_t[i]) + 1);
+        }
+        MPIM_view_end_message();
+        if(!MPIM_view_send(MPIM_viewer_count - 1))
+        {
+            MPIM_view_detach(MPIM_viewer_count - 1);
+        }
+    }
+}
+
+/**
+ * @brief Serialises a frame for the viewers.
+ * @param[in] keyframe true to serialise every slot, false to serialise the slots updated since the previous frame only.
+ * @param[in] now The current time of the aggregator.
+ * @param[in] beginning The time at which the aggregator started.
+ * @param[in] max_clock_error The largest error bound on the clock offsets of the processes.
+ **/
+static void MPIM_view_serialise_frame(bool keyframe, double now, double beginning, double max_clock_error)
+{
+    int slot_count = MPIM_my_comm_size * MPIM_threads_per_process;
+    MPIM_view_begin_message(MPIM_VIEW_FRAME);
+    struct MPIM_view_frame_t frame;
+    memset(&frame, 0, sizeof(struct MPIM_view_frame_t));
+    frame.slot_count = slot_count;
+    frame.threads_per_process = MPIM_threads_per_process;
+    frame.row_count = keyframe ? slot_count : MPIM_updated_slot_count;
+    frame.keyframe = keyframe;
+    frame.runtime = now - beginning;
+    frame.clock_error = max_clock_error;
+    snprintf(frame.flush_policy, MPIM_VIEW_FLUSH_POLICY_LENGTH, "%s", MPIM_flush_policy_name_t[MPIM_flush_policy]);
+    MPIM_view_append(&frame, sizeof(struct MPIM_view_frame_t));
+
+    char where[MPIM_WHERE_LENGTH];
+    char details[MPIM_MAX_ARGUMENTS_LENGTH];
+    for(uint32_t i = 0; i < frame.row_count; i++)
+    {
+        int slot = keyframe ? (int)i : MPIM_updated_slots[i];
+        const struct MPIM_message_t* message = &MPIM_my_window_buffer_copy[slot];
+        MPIM_message_get_where(message, where, MPIM_WHERE_LENGTH);
+        MPIM_message_get_details(message, details, MPIM_MAX_ARGUMENTS_LENGTH);
+        struct MPIM_view_row_t row;
+        memset(&row, 0, sizeof(struct MPIM_view_row_t));
+        row.slot = slot;
+        row.type = message->type;
+        row.time = MPIM_slot_get_time(slot) - beginning;
+        row.sent_bytes = message->total_data_sent;
+        row.received_bytes = message->total_data_received;
+        if(MPIM_arguments_has_communicator(&message->arguments))
+        {
+            MPIM_communicator_get_name(message->arguments.communicator, row.communicator, MPIM_VIEW_COMMUNICATOR_LENGTH);
+        }
+        row.before = message->before;
+        row.displayed = MPIM_slot_summaries[slot].displayed;
+        row.where_length = strlen(where);
+        row.details_length = strlen(details);
+        MPIM_view_append(&row, sizeof(struct MPIM_view_row_t));
+        MPIM_view_append(where, row.where_length);
+        MPIM_view_append(details, row.details_length);
+    }
+    MPIM_view_end_message();
+    if(keyframe)
+    {
+        MPIM_view_keyframe_size = MPIM_view_buffer_size;
+    }
+}
+
+/**
+ * @brief Serves the current frame to the viewers attached, instead of printing the live display.
+ * @details Viewers that just attached, and all viewers every MPIM_VIEW_KEYFRAME_PERIOD frames, receive every slot; others only receive the slots updated since the previous frame, so serving a frame costs in proportion to the number of updates.
+ * @param[in] now The current time of the aggregator.
+ * @param[in] beginning The time at which the aggregator started.
+ * @param[in] max_clock_error The largest error bound on the clock offsets of the processes.
+ **/
+static void MPIM_view_serve(double now, double beginning, double max_clock_error)
+{
+    MPIM_view_accept();
+    bool keyframe_due = (MPIM_view_frame_count % MPIM_VIEW_KEYFRAME_PERIOD) == 0;
+    MPIM_view_frame_count++;
+
+    // Keyframes first, then deltas, each serialised once whatever the number of viewers receiving it
+    for(int pass = 0; pass < 2; pass++)
+    {
+        bool keyframe = (pass == 0);
+        bool serialised = false;
+        int viewer = 0;
+        while(viewer < MPIM_viewer_count)
+        {
+            if((keyframe_due || MPIM_viewers[viewer].needs_keyframe) != keyframe)
+            {
+                viewer++;
+                continue;
+            }
+            if(!serialised)
+            {
+                MPIM_view_serialise_frame(keyframe, now, beginning, max_clock_error);
+                serialised = true;
+            }
+            if(MPIM_view_send(viewer))
+            {
+                viewer++;
+            }
+            else
+            {
+                MPIM_view_detach(viewer);
+            }
+        }
+    }
+    for(int i = 0; i < MPIM_viewer_count; i++)
+    {
+        MPIM_viewers[i].needs_keyframe = false;
+    }
+}
+
+/**
+ * @brief Tells the viewers attached that the run is over, and removes the socket.
+ * @details Viewers are given MPIM_VIEW_END_MILLISECONDS to read their backlog, the end message included.
+ **/
+static void MPIM_view_finalise()
+{
+    MPIM_view_begin_message(MPIM_VIEW_END);
+    MPIM_view_end_message();
+    int viewer = 0;
+    while(viewer < MPIM_viewer_count)
+    {
+        if(MPIM_view_send(viewer))
+        {
+            viewer++;
+        }
+        else
+        {
+            MPIM_view_detach(viewer);
+        }
+    }
+    double deadline = MPIM_get_time() + MPIM_VIEW_END_MILLISECONDS * 1.0E-3;
+    double now = MPIM_get_time();
+    while(now < deadline && MPIM_view_resume((int)((deadline - now) * 1.0E3) + 1) > 0)
+    {
+        now = MPIM_get_time();
+    }
+    while(MPIM_viewer_count > 0)
+    {
+        MPIM_view_detach(MPIM_viewer_count - 1);
+    }
+    close(MPIM_view_socket);
+    MPIM_view_socket = -1;
+    unlink(MPIM_view_path);
+    free(MPIM_view_buffer);
+}
+
+/**
+ * @brief Opens the socket on which the aggregator serves the live display to viewers, if the MPIM_VIEW_SOCKET environment variable gives its path.
+ * @details If the socket cannot be opened, the aggregator prints the live display itself.
+ **/
+static void MPIM_view_initialise()
+{
+    const char* path = getenv("MPIM_VIEW_SOCKET");
+    if(path == NULL || path[0] == '\0')
+    {
+        return;
+    }
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(struct sockaddr_un));
+    address.sun_family = AF_UNIX;
+    if(strlen(path) >= sizeof(address.sun_path))
+    {
+        printf("MPI_monitor: the viewer socket path \"%s\" is too long, the live display is printed instead.\n", path);
+        return;
+    }
+    strcpy(address.sun_path, path);
+
+    // A socket left behind by a run that did not finalise would make bind fail; anything else at that path is left untouched
+    struct stat status;
+    if(lstat(path, &status) == 0 && S_ISSOCK(status.st_mode))
+    {
+        unlink(path);
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(listener == -1 || bind(listener, (struct sockaddr*)&address, sizeof(struct sockaddr_un)) != 0 || listen(listener, MPIM_MAX_VIEWERS) != 0)
+    {
+        printf("MPI_monitor: cannot serve viewers on \"%s\" (%s), the live display is printed instead.\n", path, strerror(errno));
+        if(listener != -1)
+        {
+            close(listener);
+        }
+        return;
+    }
+    strcpy(MPIM_view_path, path);
+    MPIM_view_socket = listener;
+}
+
+/**
+ * @brief Writes a slot into the snapshot file, as a seqlock writer.
+ * @param[in] slot The slot.
+ * @param[in] beginning The time at which the aggregator started.
+ **/
+static void MPIM_publish_slot(int slot, double beginning)
+{
+    struct MPIM_published_slot_t* published = &MPIM_published_slots[slot];
+    const struct MPIM_message_t* message = &MPIM_my_window_buffer_copy[slot];
+    uint64_t sequence = published->sequence + 1;
+    __atomic_store_n(&published->sequence, sequence, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    published->type = message->type;
+    published->before = message->before;
+    published->displayed = MPIM_slot_summaries[slot].displayed;
+    published->time = MPIM_slot_get_time(slot) - beginning;
+    published->call_count = message->call_count;
+    published->mpi_nanoseconds = message->mpi_nanoseconds;
+    published->sent_bytes = message->total_data_sent;
+    published->received_bytes = message->total_data_received;
+    MPIM_message_get_where(message, published->where, MPIM_PUBLISHED_WHERE_LENGTH);
+    MPIM_message_get_details(message, published->details, MPIM_PUBLISHED_DETAILS_LENGTH);
+    __atomic_store_n(&published->sequence, sequence + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Publishes the current frame into the snapshot file.
+ * @details Only the slots updated since the previous frame are written, except every MPIM_PUBLISH_REFRESH_PERIOD frames where every slot is, so that the times of the others follow the clock offsets estimated meanwhile.
+ * @param[in] now The current time of the aggregator.
+ * @param[in] beginning The time at which the aggregator started.
+ * @param[in] max_clock_error The largest error bound on the clock offsets of the processes.
+ **/
+static void MPIM_publish_frame(double now, double beginning, double max_clock_error)
+{
+    uint64_t generation = MPIM_published->generation + 1;
+    __atomic_store_n(&MPIM_published->generation, generation, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    if(MPIM_publish_frame_count % MPIM_PUBLISH_REFRESH_PERIOD == 0)
+    {
+        for(int i = 0; i < MPIM_my_comm_size * MPIM_threads_per_process; i++)
+        {
+            MPIM_publish_slot(i, beginning);
+        }
+    }
+    else
+    {
+        for(int i = 0; i < MPIM_updated_slot_count; i++)
+        {
+            MPIM_publish_slot(MPIM_updated_slots[i], beginning);
+        }
+    }
+    MPIM_publish_frame_count++;
+    MPIM_published->runtime = now - beginning;
+    MPIM_published->clock_error = max_clock_error;
+    MPIM_published->finished = MPIM_manager_end;
+    __atomic_store_n(&MPIM_published->generation, generation + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Unmaps the snapshot file, which is left in place with the last frame of the run for post-mortem inspection.
+ **/
+static void MPIM_publish_finalise()
+{
+    munmap(MPIM_published, MPIM_published_size);
+    MPIM_published = NULL;
+    MPIM_published_slots = NULL;
 }
 
-int MPIM_Type_create_indexed_block(int block_count, int block_length, int* displacements, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_CREATE_INDEXED_BLOCK, file, line, args);
-    int result = MPI_Type_create_indexed_block(block_count, block_length, displacements, old_datatype, new_datatype);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_CREATE_INDEXED_BLOCK, file, line, args);
-    return result;
+/**
+ * @brief Creates the file in which the aggregator publishes its snapshots, if the MPIM_SNAPSHOT_FILE environment variable gives its path.
+ * @details If the file cannot be created, the run goes on without it.
+ * @param[in] slot_count The number of slots.
+ **/
+static void MPIM_publish_initialise(int slot_count)
+{
+    const char* path = getenv("MPIM_SNAPSHOT_FILE");
+    if(path == NULL || path[0] == '\0')
+    {
+        return;
+    }
+    // Slots are aligned on cache lines, so that a reader copying one slot does not share its line with the writer of the next one
+    size_t names_offset = sizeof(struct MPIM_published_header_t);
+    size_t slots_offset = names_offset + MPIM_MESSAGE_TYPE_COUNT * MPIM_PUBLISHED_NAME_LENGTH;
+    slots_offset = (slots_offset + 63) / 64 * 64;
+    size_t size = slots_offset + slot_count * sizeof(struct MPIM_published_slot_t);
+
+    int file = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    void* mapping = MAP_FAILED;
+    if(file != -1 && ftruncate(file, size) == 0)
+    {
+        mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    }
+    if(mapping == MAP_FAILED)
+    {
+        printf("MPI_monitor: cannot publish snapshots in \"%s\" (%s), the run goes on without them.\n", path, strerror(errno));
+        if(file != -1)
+        {
+            close(file);
+        }
+        return;
+    }
+    close(file);
+
+    // The file is zeroed by ftruncate, the magic number is written last so that readers only trust a complete layout
+    MPIM_published = (struct MPIM_published_header_t*)mapping;
+    MPIM_published_size = size;
+    MPIM_published->version = MPIM_PUBLISHED_VERSION;
+    MPIM_published->slot_size = sizeof(struct MPIM_published_slot_t);
+    MPIM_published->names_offset = names_offset;
+    MPIM_published->name_count = MPIM_MESSAGE_TYPE_COUNT;
+    MPIM_published->slot_count = slot_count;
+    MPIM_published->slots_offset = slots_offset;
+    MPIM_published->threads_per_process = MPIM_threads_per_process;
+    char* names = (char*)mapping + names_offset;
+    for(int i = 0; i < MPIM_MESSAGE_TYPE_COUNT; i++)
+    {
+        snprintf(names + i * MPIM_PUBLISHED_NAME_LENGTH, MPIM_PUBLISHED_NAME_LENGTH, "%s", MPIM_routine_name_t[i]);
+    }
+    MPIM_published_slots = (struct MPIM_published_slot_t*)((char*)mapping + slots_offset);
+    __atomic_store_n(&MPIM_published->magic, MPIM_PUBLISHED_MAGIC, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Appends formatted text to the metrics being rendered, growing their buffer as needed.
+ * @param[in] format The format, as in printf.
+ **/
+static void MPIM_metrics_printf(const char* format, ...)
+{
+    while(true)
+    {
+        va_list arguments;
+        va_start(arguments, format);
+        int length = vsnprintf(MPIM_metrics_buffer + MPIM_metrics_buffer_size, MPIM_metrics_buffer_capacity - MPIM_metrics_buffer_size, format, arguments);
+        va_end(arguments);
+        if(length < 0)
+        {
+            return;
+        }
+        if(MPIM_metrics_buffer_size + length < MPIM_metrics_buffer_capacity)
+        {
+            MPIM_metrics_buffer_size += length;
+            return;
+        }
+        size_t capacity = (MPIM_metrics_buffer_capacity == 0) ? 4096 : 2 * MPIM_metrics_buffer_capacity;
+        while(MPIM_metrics_buffer_size + length >= capacity)
+        {
+            capacity *= 2;
+        }
+        char* buffer = (char*)realloc(MPIM_metrics_buffer, capacity);
+        if(buffer == NULL)
+        {
+            printf("Failure in allocating MPIM_metrics_buffer.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        MPIM_metrics_buffer = buffer;
+        MPIM_metrics_buffer_capacity = capacity;
+    }
+}
+
+/**
+ * @brief Renders the metrics, in the Prometheus text format, from a copy of the slots taken at the last frame.
+ * @details The slots are copied under MPIM_snapshot_mutex and rendered outside it, so that a scrape holds the manager for a memcpy at most.
+ **/
+static void MPIM_metrics_render()
+{
+    int slot_count = MPIM_my_comm_size * MPIM_threads_per_process;
+    pthread_mutex_lock(&MPIM_snapshot_mutex);
+    memcpy(MPIM_metrics_slots, MPIM_my_window_buffer_copy, slot_count * sizeof(struct MPIM_message_t));
+    int finalised_process_count = MPIM_finalised_process_count;
+    pthread_mutex_unlock(&MPIM_snapshot_mutex);
+    double now = MPIM_get_time();
+
+    MPIM_metrics_buffer_size = 0;
+    MPIM_metrics_printf("# HELP mpim_processes Number of MPI processes.\n# TYPE mpim_processes gauge\nmpim_processes %d\n", MPIM_my_comm_size);
+    MPIM_metrics_printf("# HELP mpim_finalised_processes Number of MPI processes that have called MPI_Finalize.\n# TYPE mpim_finalised_processes gauge\nmpim_finalised_processes %d\n", finalised_process_count);
+
+    // Per thread, threads that have not issued any MPI call apart from the first one of each process being left out
+    const char* names[] = {"mpim_calls_total", "mpim_mpi_seconds_total", "mpim_sent_bytes_total", "mpim_received_bytes_total", "mpim_call_age_seconds", "mpim_call_info"};
+    const char* helps[] = {"Number of MPI calls issued by the thread.",
+                           "Time spent by the thread in completed MPI calls.",
+                           "Size of the data sent by the thread in point-to-point communications.",
+                           "Size of the data received by the thread in point-to-point communications.",
+                           "Time elapsed since the thread entered or left its current MPI call.",
+                           "Current MPI call of the thread, always 1."};
+    for(int metric = 0; metric < (int)(sizeof(names) / sizeof(names[0])); metric++)
+    {
+        MPIM_metrics_printf("# HELP %s %s\n# TYPE %s %s\n", names[metric], helps[metric], names[metric], (metric < 4) ? "counter" : "gauge");
+        for(int i = 0; i < slot_count; i++)
+        {
+            const struct MPIM_message_t* message = &MPIM_metrics_slots[i];
+            if((i % MPIM_threads_per_process) != 0 && message->type == MPIM_MESSAGE_UNINITIALISED)
+            {
+                continue;
+            }
+            int rank = i / MPIM_threads_per_process;
+            MPIM_metrics_printf("%s{rank=\"%d\",thread=\"%d\"", names[metric], rank, i % MPIM_threads_per_process);
+            switch(metric)
+            {
+                case 0:
+                    MPIM_metrics_printf("} %" PRIu64 "\n", message->call_count);
+                    break;
+                case 1:
+                    MPIM_metrics_printf("} %.9f\n", message->mpi_nanoseconds * 1.0E-9);
+                    break;
+                case 2:
+                    MPIM_metrics_printf("} %zu\n", message->total_data_sent);
+                    break;
+                case 3:
+                    MPIM_metrics_printf("} %zu\n", message->total_data_received);
+                    break;
+                case 4:
+                    MPIM_metrics_printf("} %.6f\n", now - MPIM_clock_to_aggregator_time(&MPIM_clock_window_buffer[rank].calibration, message->timestamp));
+                    break;
+                default:
+                    MPIM_metrics_printf(",routine=\"%s\",state=\"%s\"} 1\n", MPIM_routine_name_t[message->type], message->before ? "started" : "completed");
+                    break;
+            }
+        }
+    }
+
+    // Per routine, from the same copy
+    int counts[MPIM_MESSAGE_TYPE_COUNT][2];
+    memset(counts, 0, sizeof(counts));
+    for(int i = 0; i < slot_count; i++)
+    {
+        if((i % MPIM_threads_per_process) == 0 || MPIM_metrics_slots[i].type != MPIM_MESSAGE_UNINITIALISED)
+        {
+            counts[MPIM_metrics_slots[i].type][MPIM_metrics_slots[i].before ? 0 : 1]++;
+        }
+    }
+    MPIM_metrics_printf("# HELP mpim_threads Number of threads whose current MPI call is the routine, per state.\n# TYPE mpim_threads gauge\n");
+    for(int type = 0; type < MPIM_MESSAGE_TYPE_COUNT; type++)
+    {
+        for(int state = 0; state < 2; state++)
+        {
+            if(counts[type][state] > 0)
+            {
+                MPIM_metrics_printf("mpim_threads{routine=\"%s\",state=\"%s\"} %d\n", MPIM_routine_name_t[type], (state == 0) ? "started" : "completed", counts[type][state]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Answers a scrape of the metrics endpoint.
+ * @details Clients get a second to send their request and read the answer, so that a stalled client only holds the metrics thread, never the manager.
+ * @param[in] client The socket of the client.
+ **/
+static void MPIM_metrics_answer(int client)
+{
+    struct timeval timeout = {1, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(struct timeval));
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(struct timeval));
+
+    // Only the request line matters, the headers are read so that closing the socket does not reset the connection
+    char request[MPIM_METRICS_REQUEST_LENGTH];
+    size_t received = 0;
+    while(received < MPIM_METRICS_REQUEST_LENGTH - 1)
+    {
+        ssize_t result = recv(client, request + received, MPIM_METRICS_REQUEST_LENGTH - 1 - received, 0);
+        if(result <= 0)
+        {
+            break;
+        }
+        received += result;
+        request[received] = '\0';
+        if(strstr(request, "\r\n\r\n") != NULL)
+        {
+            break;
+        }
+    }
+    request[received] = '\0';
+
+    char header[MPIM_METRICS_REQUEST_LENGTH];
+    const char* body = "Not found, metrics are served on /metrics.\n";
+    size_t body_size = strlen(body);
+    const char* status = "404 Not Found";
+    if(strncmp(request, "GET /metrics ", 13) == 0 || strncmp(request, "GET /metrics?", 13) == 0)
+    {
+        MPIM_metrics_render();
+        body = MPIM_metrics_buffer;
+        body_size = MPIM_metrics_buffer_size;
+        status = "200 OK";
+    }
+    int header_size = snprintf(header, MPIM_METRICS_REQUEST_LENGTH, "HTTP/1.0 %s\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n", status, body_size);
+    if(send(client, header, header_size, MSG_NOSIGNAL) == header_size)
+    {
+        size_t sent = 0;
+        while(sent < body_size)
+        {
+            ssize_t result = send(client, body + sent, body_size - sent, MSG_NOSIGNAL);
+            if(result <= 0)
+            {
+                break;
+            }
+            sent += result;
+        }
+    }
+    close(client);
 }
 
-int MPIM_Type_create_struct(int block_count, const int block_lengths[], const MPI_Aint displacements[], MPI_Datatype block_types[], MPI_Datatype* new_datatype, char* file, int line, const char* args)
+/**
+ * @brief Serves the metrics endpoint until every process has called MPI_Finalize.
+ * @return This is a placeholder to fit the fork task prototype.
+ **/
+static void* MPIM_metrics_server()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_CREATE_STRUCT, file, line, args);
-    int result = MPI_Type_create_struct(block_count, block_lengths, displacements, block_types, new_datatype);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_CREATE_STRUCT, file, line, args);
-    return result;
+    struct pollfd listener = {MPIM_metrics_socket, POLLIN, 0};
+    while(!MPIM_manager_end)
+    {
+        if(poll(&listener, 1, MPIM_METRICS_POLL_PERIOD) > 0)
+        {
+            int client = accept4(MPIM_metrics_socket, NULL, NULL, SOCK_CLOEXEC);
+            if(client != -1)
+            {
+                MPIM_metrics_answer(client);
+            }
+        }
+    }
+    close(MPIM_metrics_socket);
+    MPIM_metrics_socket = -1;
+    free(MPIM_metrics_buffer);
+    free(MPIM_metrics_slots);
+    return NULL;
 }
 
-int MPIM_Type_create_subarray(int dim_count, const int array_element_counts[], const int subarray_element_counts[], const int subarray_coordinates[], int order, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args)
+/**
+ * @brief Opens the metrics endpoint on the loopback interface, if the MPIM_METRICS_PORT environment variable gives its port.
+ * @details If the port cannot be bound, the run goes on without metrics.
+ * @param[in] slot_count The number of slots.
+ **/
+static void MPIM_metrics_initialise(int slot_count)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_CREATE_SUBARRAY, file, line, args);
-    int result = MPI_Type_create_subarray(dim_count, array_element_counts, subarray_element_counts, subarray_coordinates, order, old_datatype, new_datatype);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_CREATE_SUBARRAY, file, line, args);
-    return result;
-}
+    const char* port = getenv("MPIM_METRICS_PORT");
+    if(port == NULL || atoi(port) <= 0 || atoi(port) > 65535)
+    {
+        return;
+    }
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(struct sockaddr_in));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(atoi(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    if(listener != -1)
+    {
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(int));
+    }
+    if(listener == -1 || bind(listener, (struct sockaddr*)&address, sizeof(struct sockaddr_in)) != 0 || listen(listener, MPIM_METRICS_BACKLOG) != 0)
+    {
+        printf("MPI_monitor: cannot serve metrics on port %s (%s), the run goes on without them.\n", port, strerror(errno));
+        if(listener != -1)
+        {
+            close(listener);
+        }
+        return;
+    }
 
-int MPIM_Type_free(MPI_Datatype* datatype, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_FREE, file, line, args);
-    int result = MPI_Type_free(datatype);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_FREE, file, line, args);
-    return result;
+    MPIM_metrics_slots = (struct MPIM_message_t*)aligned_alloc(MPIM_CACHE_LINE_SIZE, slot_count * sizeof(struct MPIM_message_t));
+    if(MPIM_metrics_slots == NULL)
+    {
+        printf("Failure in allocating MPIM_metrics_slots.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    MPIM_metrics_socket = listener;
 }
 
-int MPIM_Type_get_extent(MPI_Datatype datatype, MPI_Aint* lower_bound, MPI_Aint* extent, char* file, int line, const char* args)
+/**
+ * @brief Prints the live display on the standard output of the aggregator.
+ * @details Only goes through the slots displayed, and only when they are few enough to be printed one per row, and through the slots inside a call for their stacks.
+ * @param[in] now The current time of the aggregator.
+ * @param[in] beginning The time at which the aggregator started.
+ * @param[in] max_clock_error The largest error bound on the clock offsets of the processes.
+ **/
+static void MPIM_display_print(double now, double beginning, double max_clock_error)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_GET_EXTENT, file, line, args);
-    int result = MPI_Type_get_extent(datatype, lower_bound, extent);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_GET_EXTENT, file, line, args);
-    return result;
+    // Clear the screen
+    MPIM_console_clear_screen();
+    MPIM_console_move_cursor_to(1, 1);
+
+    printf("Runtime: %s%.2f seconds (clock error bound: %.3f ms, flush policy: %s)\n", (now - beginning) < 0.01 ? "<" : "", now - beginning, max_clock_error * 1000.0, MPIM_flush_policy_name_t[MPIM_flush_policy]);
+
+    if(MPIM_displayed_slot_count > MPIM_display_rows)
+    {
+        MPIM_states_print();
+    }
+    else
+    {
+        char who[MPIM_WHO_LENGTH];
+        char where[MPIM_WHERE_LENGTH];
+        const int WHEN_LENGTH = 32;
+        char when[WHEN_LENGTH];
+        double elapsed;
+        char details[MPIM_MAX_ARGUMENTS_LENGTH];
+        int current_max_who_length = MPIM_column_get_width(MPIM_COLUMN_WHO, 3);
+        int current_max_routine_name_length = MPIM_column_get_width(MPIM_COLUMN_WHAT, 0);
+        int current_max_where_length = MPIM_column_get_width(MPIM_COLUMN_WHERE, 0);
+        int current_max_details_length = MPIM_column_get_width(MPIM_COLUMN_DETAILS, 7);
+        int current_max_when_length = 0;
+        int temp_max_when_length;
+        // Rows are printed in the order of the slots, the list being short as it holds at most MPIM_display_rows slots
+        MPIM_slot_list_sort(&MPIM_displayed_slots);
+        // Ages change every frame, they are the only column measured on the rows themselves
+        for(int row = 0; row < MPIM_displayed_slots.count; row++)
+        {
+            int i = MPIM_displayed_slots.slots[row];
+
+            // Ages are exact up to the clock error bound, negative ones can only come from that error
+            elapsed = now - MPIM_slot_get_time(i);
+            if(elapsed > 0.01)
+            {
+                snprintf(when, WHEN_LENGTH, "%.2f%s", elapsed, "s ago");
+            }
+            else
+            {
+                snprintf(when, WHEN_LENGTH, "%s", "just now");
+            }
+            temp_max_when_length = strlen(when);
+            if(temp_max_when_length > current_max_when_length)
+            {
+                current_max_when_length = temp_max_when_length;
+            }
+        }
+
+        // Print header
+        print_horizontal_separator(current_max_who_length, current_max_routine_name_length, current_max_where_length, current_max_when_length, current_max_details_length);
+        printf("| %*s | %*s | %*s | %*s | %-*s |\n", current_max_who_length, "Who", current_max_routine_name_length, "What", current_max_where_length, "Where", current_max_when_length + 10, "When", current_max_details_length, "Details");
+        print_horizontal_separator(current_max_who_length, current_max_routine_name_length, current_max_where_length, current_max_when_length, current_max_details_length);
+
+        // Print body
+        for(int row = 0; row < MPIM_displayed_slots.count; row++)
+        {
+            int i = MPIM_displayed_slots.slots[row];
+            MPIM_slot_get_who(i, who, MPIM_WHO_LENGTH);
+            elapsed = now - MPIM_slot_get_time(i);
+            if(elapsed > 0.01)
+            {
+                snprintf(when, WHEN_LENGTH, "%.2f%s", elapsed, "s ago");
+            }
+            else
+            {
+                snprintf(when, WHEN_LENGTH, "%s", "just now");
+            }
+            MPIM_message_get_where(&MPIM_my_window_buffer_copy[i], where, MPIM_WHERE_LENGTH);
+            MPIM_message_get_details(&MPIM_my_window_buffer_copy[i], details, MPIM_MAX_ARGUMENTS_LENGTH);
+            printf("| %*s | %*s | %*s | %9s %*s | %-*s |\n", current_max_who_length, who,
+                                            current_max_routine_name_length,
+                                            MPIM_routine_name_t[MPIM_my_window_buffer_copy[i].type],
+                                            current_max_where_length,
+                                            where,
+                                            (MPIM_my_window_buffer_copy[i].before) ? "started" : "completed",
+                                            current_max_when_length,
+                                            when,
+                                            current_max_details_length,
+                                            details);
+        }
+
+        // Print footer
+        print_horizontal_separator(current_max_who_length, current_max_routine_name_length, current_max_where_length, current_max_when_length, current_max_details_length);
+    }
+    if(MPIM_stall_threshold > 0.0)
+    {
+        MPIM_stacks_print();
+    }
+    if(MPIM_wait_states_enabled)
+    {
+        MPIM_wait_states_print();
+    }
 }
 
-int MPIM_Type_indexed(int block_count, int* block_lengths, const int displacements[], MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args)
+/**
+ * @brief Updates the monitoring report.
+ * @return This is a placeholder to fit the fork task prototype.
+ **/
+static void* MPIM_manager()
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_INDEXED, file, line, args);
-    int result = MPI_Type_indexed(block_count, block_lengths, displacements, old_datatype, new_datatype);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_INDEXED, file, line, args);
-    return result;
+    // Every second, send updates
+    static double beginning = 0.0;
+    if(beginning == 0.0)
+    {
+        beginning = MPIM_get_time();
+    }
+    double past = MPIM_get_time();
+    double now = MPIM_get_time();
+    const double FPS = 4;
+    double refresh_time = 1.0 / FPS;
+    while(!MPIM_manager_end)
+    {
+        int slot_count = MPIM_my_comm_size * MPIM_threads_per_process;
+        pthread_mutex_lock(&MPIM_snapshot_mutex);
+        MPIM_snapshot_slots(slot_count);
+        if(MPIM_unmonitored_snapshot_pending)
+        {
+            MPIM_monitoring_publish_unmonitored();
+        }
+        pthread_mutex_unlock(&MPIM_snapshot_mutex);
+        MPIM_manager_end = (MPIM_finalised_process_count == MPIM_my_comm_size);
+
+        double max_clock_error = 0.0;
+        for(int i = 0; i < MPIM_my_comm_size; i++)
+        {
+            if(MPIM_clock_window_buffer[i].calibration.error > max_clock_error)
+            {
+                max_clock_error = MPIM_clock_window_buffer[i].calibration.error;
+            }
+        }
+        if(MPIM_view_socket != -1)
+        {
+            MPIM_view_serve(now, beginning, max_clock_error);
+        }
+        else
+        {
+            MPIM_display_print(now, beginning, max_clock_error);
+        }
+        if(MPIM_published != NULL)
+        {
+            MPIM_publish_frame(now, beginning, max_clock_error);
+        }
+        for(int i = 0; i < MPIM_updated_slot_count; i++)
+        {
+            MPIM_slot_summaries[MPIM_updated_slots[i]].updated = false;
+        }
+        MPIM_updated_slot_count = 0;
+
+        // Wait for the next round, answering clock requests and relaying switches in the meantime
+        now = MPIM_get_time();
+        while((now - past) < refresh_time)
+        {
+            MPIM_clock_serve();
+            if(MPIM_monitoring_manager_relays)
+            {
+                MPIM_monitoring_serve();
+            }
+            if(MPIM_view_socket != -1)
+            {
+                MPIM_view_resume(0);
+            }
+            MPIM_sleep(MPIM_CLOCK_SERVE_PERIOD);
+            now = MPIM_get_time();
+        }
+        past = now;
+    }
+    if(MPIM_view_socket != -1)
+    {
+        MPIM_view_finalise();
+    }
+    if(MPIM_published != NULL)
+    {
+        MPIM_publish_finalise();
+    }
+    free(MPIM_updated_slots);
+    MPIM_updated_slots = NULL;
+
+    return NULL;
 }
 
-int MPIM_Type_vector(int block_count, int block_length, int stride, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args)
-{
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_VECTOR, file, line, args);
-    int result = MPI_Type_vector(block_count, block_length, stride, old_datatype, new_datatype);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_VECTOR, file, line, args);
-    return result;
+/// Forwards a call to MPI without monitoring it while the monitoring is switched off; the thread only writes which routine it is in, for the aggregator to show if the monitoring is switched on meanwhile
+#define MPIM_FORWARD_IF_SWITCHED_OFF(TYPE, return_type, call) \
+if(__builtin_expect(!MPIM_monitoring.enabled, 0)) \
+{ \
+    *MPIM_my_unmonitored_call = MPIM_MESSAGE_##TYPE; \
+    return_type unmonitored_result = call; \
+    *MPIM_my_unmonitored_call = MPIM_MESSAGE_UNINITIALISED; \
+    return unmonitored_result; \
+}
+/// Defines the MPIM version of an MPI routine whose wrapper is generated: the call is reported to the coordinator before and after being forwarded to MPI, or only forwarded while the monitoring is switched off
+#define MPIM_DEFINE_GENERATED(TYPE, Name, return_type, parameters, forwarded, recorded) \
+return_type MPIM_##Name(MPIM_UNPACK parameters, char* file, int line) \
+{ \
+    MPIM_FORWARD_IF_SWITCHED_OFF(TYPE, return_type, MPI_##Name forwarded) \
+    struct MPIM_arguments_t arguments = recorded; \
+    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_##TYPE, MPIM_CALLSITE, file, line, &arguments); \
+    return_type result = MPI_##Name forwarded; \
+    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_##TYPE, MPIM_CALLSITE, file, line, &arguments); \
+    return result; \
 }
+/// Calls a hook once its arguments are expanded, so that the forwarded arguments of a routine are passed one by one
+#define MPIM_CALL_HOOK(hook, ...) hook(__VA_ARGS__)
+/// Defines the MPIM version of an MPI routine whose wrapper is generated and calls the MPIM_hook_ macro of the routine once MPI returns successfully; while the monitoring is switched off, the call is only forwarded and the hook is not called
+#define MPIM_DEFINE_HOOKED(TYPE, Name, return_type, parameters, forwarded, recorded) \
+return_type MPIM_##Name(MPIM_UNPACK parameters, char* file, int line) \
+{ \
+    MPIM_FORWARD_IF_SWITCHED_OFF(TYPE, return_type, MPI_##Name forwarded) \
+    struct MPIM_arguments_t arguments = recorded; \
+    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_##TYPE, MPIM_CALLSITE, file, line, &arguments); \
+    return_type result = MPI_##Name forwarded; \
+    if(result == MPI_SUCCESS) \
+    { \
+        MPIM_CALL_HOOK(MPIM_hook_##Name, &arguments, MPIM_CALLSITE, line, MPIM_UNPACK forwarded); \
+    } \
+    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_##TYPE, MPIM_CALLSITE, file, line, &arguments); \
+    return result; \
+}
+/// Defines the MPIM version of an MPI routine completing requests, whose wrapper is generated and calls the MPIM_prehook_ macro of the routine before forwarding it and its MPIM_hook_ macro once MPI returns successfully; while the monitoring is switched off, the call is only forwarded and neither hook is called
+#define MPIM_DEFINE_COMPLETING(TYPE, Name, return_type, parameters, forwarded, recorded) \
+return_type MPIM_##Name(MPIM_UNPACK parameters, char* file, int line) \
+{ \
+    MPIM_FORWARD_IF_SWITCHED_OFF(TYPE, return_type, MPI_##Name forwarded) \
+    struct MPIM_arguments_t arguments = recorded; \
+    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_##TYPE, MPIM_CALLSITE, file, line, &arguments); \
+    MPIM_CALL_HOOK(MPIM_prehook_##Name, MPIM_UNPACK forwarded); \
+    return_type result = MPI_##Name forwarded; \
+    if(result == MPI_SUCCESS) \
+    { \
+        MPIM_CALL_HOOK(MPIM_hook_##Name, &arguments, MPIM_CALLSITE, line, MPIM_UNPACK forwarded); \
+    } \
+    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_##TYPE, MPIM_CALLSITE, file, line, &arguments); \
+    return result; \
+}
+/// Hand-written MPIM versions are defined below
+#define MPIM_DEFINE_CUSTOM(...)
+/// Hand-written MPIM versions are defined below
+#define MPIM_DEFINE_CUSTOM_NULLARY(...)
+/// Expands an entry of MPIM_ROUTINES into the definition of its MPIM version, if generated
+#define MPIM_DEFINE_ROUTINE(TYPE, Name, return_type, attributes, implementation, parameters, forwarded, recorded) MPIM_DEFINE_##implementation(TYPE, Name, return_type, parameters, forwarded, recorded)
 
-int MPIM_Wait(MPI_Request* request, MPI_Status* status, char* file, int line, const char* args)
+MPIM_ROUTINES(MPIM_DEFINE_ROUTINE)
+
+int MPIM_Finalize(char* file, int line)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WAIT, file, line, args);
-    int result = MPI_Wait(request, status);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WAIT, file, line, args);
+    uint64_t end = MPIM_get_ticks();
+    struct MPIM_arguments_t arguments = MPIM_arguments_none();
+    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_FINALISED, MPIM_CALLSITE, file, line, &arguments);
+    MPI_Win_unlock(0, MPIM_my_window);
+    MPI_Win_unlock(0, MPIM_clock_window);
+    MPI_Barrier(MPI_COMM_WORLD);
+    if(MPIM_my_rank == 0)
+    {
+        pthread_join(MPIM_manager_thread, NULL);
+        if(MPIM_metrics_socket != -1)
+        {
+            pthread_join(MPIM_metrics_thread, NULL);
+        }
+    }
+    MPIM_stall_finalise();
+    MPIM_slots_report();
+    MPIM_wait_states_finalise();
+    MPIM_persistent_report();
+    MPIM_rma_report();
+    MPI_Win_free(&MPIM_my_window);
+    MPI_Win_free(&MPIM_clock_window);
+    MPIM_monitoring_finalise();
+    MPIM_thread_profiles_merge();
+    MPIM_histograms_report();
+    free(MPIM_histograms);
+    MPIM_profile_report(end);
+    MPIM_trace_finalise();
+    int result = MPI_Finalize();
+    MPIM_crash_finalise();
     return result;
 }
 
-int MPIM_Waitall(int count, MPI_Request requests[], MPI_Status statuses[], char* file, int line, const char* args)
+/**
+ * @brief Sets up the monitoring once MPI is initialised, and publishes the completion of the initialisation routine.
+ * @param[in] thread_support The level of thread support provided by MPI.
+ * @param[in] type The type of the initialisation routine called.
+ * @param[in] callsite The callsite of the initialisation routine.
+ * @param[in] file The name of the file from which the initialisation routine is issued.
+ * @param[in] line The line at which the initialisation routine is issued.
+ **/
+static void MPIM_initialise(int thread_support, enum MPIM_message_type_t type, const void* callsite, const char* file, int line)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WAITALL, file, line, args);
-    int result = MPI_Waitall(count, requests, statuses);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WAITALL, file, line, args);
-    return result;
+    MPIM_clock_calibrate();
+    MPIM_modules_load();
+    MPI_Comm_rank(MPI_COMM_WORLD, &MPIM_my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &MPIM_my_comm_size);
+
+    // Every process must agree on the number of slots per process, as it defines the layout of the window
+    if(thread_support >= MPI_THREAD_SERIALIZED)
+    {
+        MPIM_threads_per_process = MPIM_DEFAULT_THREADS_PER_PROCESS;
+        const char* threads_per_process = getenv("MPIM_THREADS_PER_PROCESS");
+        if(threads_per_process != NULL && atoi(threads_per_process) > 0)
+        {
+            MPIM_threads_per_process = atoi(threads_per_process);
+        }
+    }
+    MPI_Bcast(&MPIM_threads_per_process, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    // The thread initialising MPI gets the first slot of its process
+    MPIM_my_thread_slot = 0;
+    atomic_store(&MPIM_thread_count, 1);
+
+    MPIM_histograms = (struct MPIM_histogram_t*)calloc(MPIM_MESSAGE_TYPE_COUNT, sizeof(struct MPIM_histogram_t));
+    if(MPIM_histograms == NULL)
+    {
+        printf("Failure in allocating MPIM_histograms.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+
+    // The window is allocated by MPI, which can then register it with the network for RDMA, but may not align it on a cache line
+    int slot_count = MPIM_my_comm_size * MPIM_threads_per_process;
+    MPI_Aint size = (MPIM_my_rank == 0) ? sizeof(struct MPIM_message_t) * slot_count + sizeof(int) * MPIM_my_comm_size + MPIM_CACHE_LINE_SIZE : 0;
+    char* window_base = NULL;
+    // Updates only rely on the ordering of the accumulates replacing the same words, which MPI keeps by default
+    MPI_Info info;
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "accumulate_ordering", "waw");
+    MPI_Win_allocate(size, 1, info, MPI_COMM_WORLD, &window_base, &MPIM_my_window);
+    MPI_Info_free(&info);
+    if(MPIM_my_rank == 0)
+    {
+        MPIM_window_padding = (MPI_Aint)(-(uintptr_t)window_base & (MPIM_CACHE_LINE_SIZE - 1));
+        MPIM_my_window_buffer_original = (struct MPIM_message_t*)(window_base + MPIM_window_padding);
+        MPIM_claimed_slot_counts = (int*)(MPIM_my_window_buffer_original + slot_count);
+    }
+    MPI_Bcast(&MPIM_window_padding, 1, MPI_AINT, 0, MPI_COMM_WORLD);
+    if(MPIM_my_rank == 0)
+    {
+        MPIM_my_window_buffer_copy = (struct MPIM_message_t*)aligned_alloc(MPIM_CACHE_LINE_SIZE, size);
+        if(MPIM_my_window_buffer_copy == NULL)
+        {
+            printf("Failure in allocating MPIM_my_window_buffer_original copy.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        // No update carries UINT64_MAX, so that the first frame copies every slot
+        MPIM_snapshot_sequences = (uint64_t*)malloc(slot_count * sizeof(uint64_t));
+        if(MPIM_snapshot_sequences == NULL)
+        {
+            printf("Failure in allocating MPIM_snapshot_sequences.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        memset(MPIM_snapshot_sequences, 0xFF, slot_count * sizeof(uint64_t));
+        MPIM_slot_summaries = (struct MPIM_slot_summary_t*)calloc(slot_count, sizeof(struct MPIM_slot_summary_t));
+        MPIM_process_finalised = (bool*)calloc(MPIM_my_comm_size, sizeof(bool));
+        if(MPIM_slot_summaries == NULL || MPIM_process_finalised == NULL)
+        {
+            printf("Failure in allocating the slot summaries.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        const char* display_rows = getenv("MPIM_DISPLAY_ROWS");
+        if(display_rows != NULL && atoi(display_rows) >= 0)
+        {
+            MPIM_display_rows = atoi(display_rows);
+        }
+        MPIM_view_initialise();
+        MPIM_metrics_initialise(slot_count);
+        MPIM_publish_initialise(slot_count);
+        if(MPIM_view_socket != -1 || MPIM_published != NULL)
+        {
+            MPIM_updated_slots = (int*)malloc(slot_count * sizeof(int));
+            if(MPIM_updated_slots == NULL)
+            {
+                printf("Failure in allocating MPIM_updated_slots.\n");
+                MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+            }
+        }
+        MPIM_slot_list_initialise(&MPIM_displayed_slots, slot_count);
+        MPIM_slot_list_initialise(&MPIM_calling_slots, slot_count);
+        // The thread initialising MPI claims the first slot of every process
+        for(int i = 0; i < MPIM_my_comm_size; i++)
+        {
+            MPIM_claimed_slot_counts[i] = 1;
+        }
+        for(int i = 0; i < slot_count; i++)
+        {
+            MPIM_my_window_buffer_original[i].sequence = 0;
+            MPIM_my_window_buffer_original[i].type = MPIM_MESSAGE_UNINITIALISED;
+            MPIM_my_window_buffer_original[i].before = false;
+            MPIM_my_window_buffer_original[i].timestamp = MPIM_get_ticks();
+            MPIM_my_window_buffer_original[i].callsite_module = 0;
+            MPIM_my_window_buffer_original[i].callsite_offset = 0;
+            MPIM_my_window_buffer_original[i].line = 0;
+            MPIM_my_window_buffer_original[i].arguments = MPIM_arguments_none();
+            MPIM_my_window_buffer_original[i].call_count = 0;
+            MPIM_my_window_buffer_original[i].active_persistent_requests = 0;
+            MPIM_my_window_buffer_original[i].epoch.tracked = 0;
+            MPIM_my_window_buffer_original[i].total_data_sent = 0;
+            MPIM_my_window_buffer_original[i].total_data_received = 0;
+            MPIM_my_window_buffer_original[i].mpi_nanoseconds = 0;
+            MPIM_my_window_buffer_original[i].checksum = MPIM_message_get_checksum(&MPIM_my_window_buffer_original[i]);
+        }
+    }
+    // No process may put its first update before the slots are initialised
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, MPIM_my_window);
+    const char* flush_policy = getenv("MPIM_FLUSH_POLICY");
+    if(flush_policy != NULL)
+    {
+        for(int i = 0; i < (int)(sizeof(MPIM_flush_policy_name_t) / sizeof(MPIM_flush_policy_name_t[0])); i++)
+        {
+            if(strcmp(flush_policy, MPIM_flush_policy_name_t[i]) == 0)
+            {
+                MPIM_flush_policy = (enum MPIM_flush_policy_t)i;
+            }
+        }
+    }
+
+    MPI_Aint clock_size = 0;
+    if(MPIM_my_rank == 0)
+    {
+        clock_size = sizeof(struct MPIM_clock_exchange_t) * MPIM_my_comm_size + sizeof(struct MPIM_clock_queue_t) + sizeof(int32_t) * MPIM_my_comm_size;
+        MPIM_clock_window_buffer = (struct MPIM_clock_exchange_t*)calloc(1, clock_size);
+        if(MPIM_clock_window_buffer == NULL)
+        {
+            printf("Failure in allocating MPIM_clock_window_buffer.\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+        MPIM_clock_queue = (struct MPIM_clock_queue_t*)(MPIM_clock_window_buffer + MPIM_my_comm_size);
+        // Until processes publish their own calibration, their timestamps are converted as those of the aggregator
+        for(int i = 0; i < MPIM_my_comm_size; i++)
+        {
+            MPIM_clock_window_buffer[i].calibration = MPIM_my_clock;
+        }
+    }
+    MPI_Win_create(MPIM_clock_window_buffer, clock_size, 1, MPI_INFO_NULL, MPI_COMM_WORLD, &MPIM_clock_window);
+    MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, MPIM_clock_window);
+
+    const char* clock_sync_period = getenv("MPIM_CLOCK_SYNC_PERIOD");
+    if(clock_sync_period != NULL && atof(clock_sync_period) > 0.0)
+    {
+        MPIM_clock_sync_period = atof(clock_sync_period);
+    }
+
+    MPIM_stall_initialise();
+    MPIM_wait_states_initialise();
+    MPIM_crash_initialise();
+    MPIM_trace_initialise();
+    MPIM_monitoring_initialise();
+
+    if(MPIM_my_rank == 0)
+    {
+        MPIM_backtrace_state = backtrace_create_state(NULL, 1, MPIM_backtrace_error, NULL);
+        pthread_create(&MPIM_manager_thread, NULL, (void* (*)(void*))MPIM_manager, NULL);
+        if(MPIM_metrics_socket != -1)
+        {
+            pthread_create(&MPIM_metrics_thread, NULL, (void* (*)(void*))MPIM_metrics_server, NULL);
+        }
+    }
+
+    // The manager thread is running, it can answer the first clock offset estimation
+    MPIM_clock_synchronise();
+
+    struct MPIM_arguments_t arguments = MPIM_arguments_none();
+    MPIM_my_call_monitored = true;
+    MPIM_message(MPIM_TEMPORALITY_AFTER, type, callsite, file, line, &arguments);
+
+    // All wait for the process 0 to tell us the initialisation is complete and successful
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPIM_profile_start = MPIM_get_ticks();
 }
 
-int MPIM_Waitany(int count, MPI_Request requests[], int* index, MPI_Status* status, char* file, int line, const char* args)
+int MPIM_Init(int* argc, char*** argv, char* file, int line)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WAITANY, file, line, args);
-    int result = MPI_Waitany(count, requests, index, status);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WAITANY, file, line, args);
+    int result;
+    int required = MPIM_stall_get_required_thread_support(MPI_THREAD_SINGLE);
+    if(required == MPI_THREAD_SINGLE)
+    {
+        result = MPI_Init(argc, argv);
+    }
+    else
+    {
+        int provided;
+        result = MPI_Init_thread(argc, argv, required, &provided);
+    }
+    MPIM_initialise(MPI_THREAD_SINGLE, MPIM_MESSAGE_INITIALISED, MPIM_CALLSITE, file, line);
     return result;
 }
 
-int MPIM_Waitsome(int request_count, MPI_Request requests[], int* index_count, int indices[], MPI_Status statuses[], char* file, int line, const char* args)
+int MPIM_Init_thread(int* argc, char*** argv, int required, int* provided, char* file, int line)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WAITSOME, file, line, args);
-    int result = MPI_Waitsome(request_count, requests, index_count, indices, statuses);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WAITSOME, file, line, args);
+    int result = MPI_Init_thread(argc, argv, MPIM_stall_get_required_thread_support(required), provided);
+    MPIM_initialise(*provided, MPIM_MESSAGE_INIT_THREAD, MPIM_CALLSITE, file, line);
     return result;
 }
 
-int MPIM_Win_allocate(MPI_Aint size, int displacement_unit, MPI_Info info, MPI_Comm communicator, void* base, MPI_Win* window, char* file, int line, const char* args)
+int MPIM_Recv(void* buffer, int count, MPI_Datatype type, int source, int tag, MPI_Comm comm, MPI_Status* status, char* file, int line)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WIN_ALLOCATE, file, line, args);
-    int result = MPI_Win_allocate(size, displacement_unit, info, communicator, base, window);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WIN_ALLOCATE, file, line, args);
+    MPIM_FORWARD_IF_SWITCHED_OFF(RECV, int, MPI_Recv(buffer, count, type, source, tag, comm, status))
+    MPI_Status ignored_status;
+    MPI_Status* actual_status = (status == MPI_STATUS_IGNORE) ? &ignored_status : status;
+    struct MPIM_arguments_t arguments = MPIM_arguments_receive(source, tag, comm, count, type);
+    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_RECV, MPIM_CALLSITE, file, line, &arguments);
+    int result = MPI_Recv(buffer, count, type, source, tag, comm, actual_status);
+    // Wildcards are resolved once the message is received, so that the completion shows the actual sender and the receive can be matched with its send
+    if(result == MPI_SUCCESS)
+    {
+        arguments.p2p.peer = actual_status->MPI_SOURCE;
+        arguments.p2p.tag = actual_status->MPI_TAG;
+    }
+    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_RECV, MPIM_CALLSITE, file, line, &arguments);
     return result;
 }
 
-int MPIM_Win_attach(MPI_Win window, void* base, MPI_Aint size, char* file, int line, const char* args)
+int MPIM_Abort(MPI_Comm communicator, int error_code, char* file, int line)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WIN_ATTACH, file, line, args);
-    int result = MPI_Win_attach(window, base, size);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WIN_ATTACH, file, line, args);
+    struct MPIM_arguments_t arguments = MPIM_arguments_communicator(communicator);
+    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_ABORT, MPIM_CALLSITE, file, line, &arguments);
+    // The processes killed by MPI_Abort may receive SIGTERM, the report of the aborting process is written first and kept
+    if(MPIM_flight_recorder_enabled && !atomic_exchange(&MPIM_crash_dumped, true))
+    {
+        MPIM_crash_dump("MPI_Abort called with error code", error_code);
+    }
+    // The blocks still in memory would be lost with the process
+    MPIM_trace_finalise();
+    int result = MPI_Abort(communicator, error_code);
+    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_ABORT, MPIM_CALLSITE, file, line, &arguments);
     return result;
 }
 
-int MPIM_Win_create(void* base, MPI_Aint size, int displacement_unit, MPI_Info info, MPI_Comm communicator, MPI_Win* window, char* file, int line, const char* args)
+int MPIM_Request_free(MPI_Request* request, char* file, int line)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WIN_CREATE, file, line, args);
-    int result = MPI_Win_create(base, size, displacement_unit, info, communicator, window);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WIN_CREATE, file, line, args);
+    MPIM_FORWARD_IF_SWITCHED_OFF(REQUEST_FREE, int, MPI_Request_free(request))
+    struct MPIM_arguments_t arguments = MPIM_arguments_requests(1);
+    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_REQUEST_FREE, MPIM_CALLSITE, file, line, &arguments);
+    // MPI_Request_free sets the handle to MPI_REQUEST_NULL, so the request is forgotten beforehand
+    MPIM_persistent_free(*request);
+    int result = MPI_Request_free(request);
+    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_REQUEST_FREE, MPIM_CALLSITE, file, line, &arguments);
     return result;
 }
 
-int MPIM_Win_create_dynamic(MPI_Info info, MPI_Comm communicator, MPI_Win* window, char* file, int line, const char* args)
+int MPIM_Comm_free(MPI_Comm* communicator, char* file, int line)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WIN_CREATE_DYNAMIC, file, line, args);
-    int result = MPI_Win_create_dynamic(info, communicator, window);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WIN_CREATE_DYNAMIC, file, line, args);
+    MPIM_FORWARD_IF_SWITCHED_OFF(COMM_FREE, int, MPI_Comm_free(communicator))
+    struct MPIM_arguments_t arguments = MPIM_arguments_communicator(*communicator);
+    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_COMM_FREE, MPIM_CALLSITE, file, line, &arguments);
+    int result = MPI_Comm_free(communicator);
+    atomic_fetch_add(&MPIM_communicator_generation, 1);
+    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_COMM_FREE, MPIM_CALLSITE, file, line, &arguments);
     return result;
 }
 
-int MPIM_Win_detach(MPI_Win window, const void* base, char* file, int line, const char* args)
+int MPIM_Type_free(MPI_Datatype* datatype, char* file, int line)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WIN_DETACH, file, line, args);
-    int result = MPI_Win_detach(window, base);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WIN_DETACH, file, line, args);
+    MPIM_FORWARD_IF_SWITCHED_OFF(TYPE_FREE, int, MPI_Type_free(datatype))
+    struct MPIM_arguments_t arguments = MPIM_arguments_none();
+    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_TYPE_FREE, MPIM_CALLSITE, file, line, &arguments);
+    int result = MPI_Type_free(datatype);
+    atomic_fetch_add(&MPIM_datatype_generation, 1);
+    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_TYPE_FREE, MPIM_CALLSITE, file, line, &arguments);
     return result;
 }
 
-int MPIM_Win_free(MPI_Win* window, char* file, int line, const char* args)
+int MPIM_Win_free(MPI_Win* window, char* file, int line)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WIN_FREE, file, line, args);
+    MPIM_FORWARD_IF_SWITCHED_OFF(WIN_FREE, int, MPI_Win_free(window))
+    struct MPIM_arguments_t arguments = MPIM_arguments_window(*window);
+    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WIN_FREE, MPIM_CALLSITE, file, line, &arguments);
+    // MPI_Win_free sets the handle to MPI_WIN_NULL, so the window is recorded as freed beforehand
+    MPIM_rma_window_free(*window);
     int result = MPI_Win_free(window);
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WIN_FREE, file, line, args);
+    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WIN_FREE, MPIM_CALLSITE, file, line, &arguments);
     return result;
 }
 
-double MPIM_Wtime(char* file, int line, const char* args)
+double MPIM_Wtime(char* file, int line)
 {
-    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WTIME, file, line, args);
+    MPIM_FORWARD_IF_SWITCHED_OFF(WTIME, double, MPI_Wtime())
+    struct MPIM_arguments_t arguments = MPIM_arguments_none();
+    MPIM_message(MPIM_TEMPORALITY_BEFORE, MPIM_MESSAGE_WTIME, MPIM_CALLSITE, file, line, &arguments);
     double result = MPI_Wtime();
-    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WTIME, file, line, args);
+    MPIM_message(MPIM_TEMPORALITY_AFTER, MPIM_MESSAGE_WTIME, MPIM_CALLSITE, file, line, &arguments);
     return result;
 }
\ No newline at end of file
@@ -6,344 +6,398 @@
 #define MPI_MONITOR_H_INCLUDED
 
 #include <mpi.h>
+#include "mpi_monitor_routines.h"
 
 /////////////////////////////////////////
 // MPIM versionS OF MPI ROUTINES //
 ///////////////////////////////////////
 
-int MPIM_Abort(MPI_Comm communicator, int error_code, char* file, int line, const char* args);
-int MPIM_Accumulate(const void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Op operation, MPI_Win window, char* file, int line, const char* args);
-int MPIM_Allgather(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Allgatherv(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Allreduce(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Alltoall(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Alltoallv(void* buffer_send, const int* counts_send, const int* displacements_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Barrier(MPI_Comm comm, char* file, int line, const char* args);
-int MPIM_Bcast(void* buffer, int count, MPI_Datatype datatype, int emitter_rank, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Bsend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, char* file, int line, const char* args);
-int MPIM_Bsend_init(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Cancel(MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Cart_coords(MPI_Comm communicator, int rank, int dimension_number, int* coords, char* file, int line, const char* args);
-int MPIM_Cart_create(MPI_Comm old_communicator, int dimension_number, const int* dimensions, const int* periods, int reorder, MPI_Comm* new_communicator, char* file, int line, const char* args);
-int MPIM_Cart_get(MPI_Comm communicator, int dimension_number, int* dimensions, int* periods, int* coords, char* file, int line, const char* args);
-int MPIM_Cart_shift(MPI_Comm communicator, int direction, int displacement, int* source, int* destination, char* file, int line, const char* args);
-int MPIM_Comm_create(MPI_Comm old_communicator, MPI_Group group, MPI_Comm* new_communicator, char* file, int line, const char* args);
-int MPIM_Comm_get_name(MPI_Comm communicator, char* name, int* length, char* file, int line, const char* args);
-int MPIM_Comm_get_parent(MPI_Comm* parent, char* file, int line, const char* args);
-int MPIM_Comm_group(MPI_Comm communicator, MPI_Group* group, char* file, int line, const char* args);
-int MPIM_Comm_rank(MPI_Comm communicator, int* rank, char* file, int line, const char* args);
-int MPIM_Comm_set_name(MPI_Comm communicator, const char* name, char* file, int line, const char* args);
-int MPIM_Comm_size(MPI_Comm communicator, int* size, char* file, int line, const char* args);
-int MPIM_Comm_spawn(const char* command, char** arguments, int max_process_number, MPI_Info info, int root, MPI_Comm intracommunicator, MPI_Comm* intercommunicator, int* error_codes, char* file, int line, const char* args);
-int MPIM_Comm_split(MPI_Comm old_communicator, int colour, int key, MPI_Comm* new_communicator, char* file, int line, const char* args);
-int MPIM_Dims_create(int process_number, int dimension_number, int* dimensions, char* file, int line, const char* args);
-int MPIM_Exscan(void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Finalize(char* file, int line);
-int MPIM_Gather(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Gatherv(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Get(void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Win window, char* file, int line, const char* args);
-int MPIM_Get_address(const void* location, MPI_Aint* address, char* file, int line, const char* args);
-int MPIM_Get_count(const MPI_Status* status, MPI_Datatype datatype, int* count, char* file, int line, const char* args);
-int MPIM_Group_difference(MPI_Group group_a, MPI_Group group_b, MPI_Group* difference_group, char* file, int line, const char* args);
-int MPIM_Group_incl(MPI_Group old_group, int rank_count, const int ranks[], MPI_Group* new_group, char* file, int line, const char* args);
-int MPIM_Group_intersection(MPI_Group group_a, MPI_Group group_b, MPI_Group* intersection_group, char* file, int line, const char* args);
-int MPIM_Group_rank(MPI_Group group, int* rank, char* file, int line, const char* args);
-int MPIM_Group_size(MPI_Group group, int* size, char* file, int line, const char* args);
-int MPIM_Group_union(MPI_Group group_a, MPI_Group group_b, MPI_Group* union_group, char* file, int line, const char* args);
-int MPIM_Iallgather(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Iallgatherv(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Iallreduce(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Ialltoall(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Ialltoallv(void* buffer_send, const int* counts_send, const int* displacements_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Ibarrier(MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Ibsend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Igather(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Igatherv(void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Init(int* argc, char*** argv, char* file, int line, const char* args);
-int MPIM_Iprobe(int source, int tag, MPI_Comm communicator, int* flag, MPI_Status* status, char* file, int line, const char* args);
-int MPIM_Irecv(void* buffer, int count, MPI_Datatype datatype, int sender, int tag, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Ireduce(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, int root, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Ireduce_scatter(const void* send_buffer, void* receive_buffer, int* counts, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Ireduce_scatter_block(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Irsend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Iscatter(const void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Iscatterv(const void* buffer_send, const int counts_send[], const int displacements[], MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Isend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Issend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Op_create(MPI_User_function* user_function, int commutativity, MPI_Op* handle, char* file, int line, const char* args);
-int MPIM_Op_free(MPI_Op* handle, char* file, int line, const char* args);
-int MPIM_Probe(int source, int tag, MPI_Comm communicator, MPI_Status* status, char* file, int line, const char* args);
-int MPIM_Put(const void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Win window, char* file, int line, const char* args);
-int MPIM_Recv(void* buffer, int count, MPI_Datatype type, int source, int tag, MPI_Comm comm, MPI_Status* status, char* file, int line, const char* args);
-int MPIM_Recv_init(void* buffer, int count, MPI_Datatype datatype, int sender, int tag, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Reduce(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, int root, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Reduce_scatter(const void* send_buffer, void* receive_buffer, int* counts, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Reduce_scatter_block(const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Rsend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, char* file, int line, const char* args);
-int MPIM_Rsend_init(const void* buffer, int count, MPI_Datatype datatype, int recipient, int tag, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Scan(void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Scatter(const void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Scatterv(const void* buffer_send, const int counts_send[], const int displacements[], MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, char* file, int line, const char* args);
-int MPIM_Send(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, char* file, int line, const char* args);
-int MPIM_Send_init(const void* buffer, int count, MPI_Datatype datatype, int recipient, int tag, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Sendrecv(const void* buffer_send, int count_send, MPI_Datatype datatype_send, int recipient, int tag_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int sender, int tag_recv, MPI_Comm communicator, MPI_Status* status, char* file, int line, const char* args);
-int MPIM_Sendrecv_replace(void* buffer, int count_send, MPI_Datatype datatype_send, int recipient, int tag_send, int sender, int tag_recv, MPI_Comm communicator, MPI_Status* status, char* file, int line, const char* args);
-int MPIM_Ssend(void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, char* file, int line, const char* args);
-int MPIM_Ssend_init(const void* buffer, int count, MPI_Datatype datatype, int recipient, int tag, MPI_Comm communicator, MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Start(MPI_Request* request, char* file, int line, const char* args);
-int MPIM_Startall(int count, MPI_Request requests[], char* file, int line, const char* args);
-int MPIM_Test(MPI_Request* request, int* flag, MPI_Status* status, char* file, int line, const char* args);
-int MPIM_Test_cancelled(const MPI_Status* status, int* flag, char* file, int line, const char* args);
-int MPIM_Testall(int count, MPI_Request* requests, int* flag, MPI_Status* statuses, char* file, int line, const char* args);
-int MPIM_Testany(int count, MPI_Request* requests, int* index, int* flag, MPI_Status* status, char* file, int line, const char* args);
-int MPIM_Testsome(int count, MPI_Request* requests, int* index_count, int* indexes, MPI_Status* statuses, char* file, int line, const char* args);
-int MPIM_Type_commit(MPI_Datatype* datatype, char* file, int line, const char* args);
-int MPIM_Type_contiguous(int count, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args);
-int MPIM_Type_create_hindexed(int block_count, int* block_lengths, MPI_Aint* displacements, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args);
-int MPIM_Type_create_hindexed_block(int block_count, int block_length, MPI_Aint* displacements, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args);
-int MPIM_Type_create_hvector(int block_count, int block_length, MPI_Aint stride, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args);
-int MPIM_Type_create_indexed_block(int block_count, int block_length, int* displacements, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args);
-int MPIM_Type_create_struct(int block_count, const int block_lengths[], const MPI_Aint displacements[], MPI_Datatype block_types[], MPI_Datatype* new_datatype, char* file, int line, const char* args);
-int MPIM_Type_create_subarray(int dim_count, const int array_element_counts[], const int subarray_element_counts[], const int subarray_coordinates[], int order, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args);
-int MPIM_Type_free(MPI_Datatype* datatype, char* file, int line, const char* args);
-int MPIM_Type_get_extent(MPI_Datatype datatype, MPI_Aint* lower_bound, MPI_Aint* extent, char* file, int line, const char* args);
-int MPIM_Type_indexed(int block_count, int* block_lengths, const int displacements[], MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args);
-int MPIM_Type_vector(int block_count, int block_length, int stride, MPI_Datatype old_datatype, MPI_Datatype* new_datatype, char* file, int line, const char* args);
-int MPIM_Wait(MPI_Request* request, MPI_Status* status, char* file, int line, const char* args);
-int MPIM_Waitall(int count, MPI_Request requests[], MPI_Status statuses[], char* file, int line, const char* args);
-int MPIM_Waitany(int count, MPI_Request requests[], int* index, MPI_Status* status, char* file, int line, const char* args);
-int MPIM_Waitsome(int request_count, MPI_Request requests[], int* index_count, int indices[], MPI_Status statuses[], char* file, int line, const char* args);
-int MPIM_Win_allocate(MPI_Aint size, int displacement_unit, MPI_Info info, MPI_Comm communicator, void* base, MPI_Win* window, char* file, int line, const char* args);
-int MPIM_Win_attach(MPI_Win window, void* base, MPI_Aint size, char* file, int line, const char* args);
-int MPIM_Win_create(void* base, MPI_Aint size, int displacement_unit, MPI_Info info, MPI_Comm communicator, MPI_Win* window, char* file, int line, const char* args);
-int MPIM_Win_create_dynamic(MPI_Info info, MPI_Comm communicator, MPI_Win* window, char* file, int line, const char* args);
-int MPIM_Win_detach(MPI_Win window, const void* base, char* file, int line, const char* args);
-int MPIM_Win_free(MPI_Win* window, char* file, int line, const char* args);
-double MPIM_Wtime(char* file, int line, const char* args);
+/// Declares the MPIM version of an MPI routine taking parameters
+#define MPIM_DECLARE_GENERATED(Name, return_type, parameters) return_type MPIM_##Name(MPIM_UNPACK parameters, char* file, int line);
+/// Declares the MPIM version of an MPI routine taking parameters
+#define MPIM_DECLARE_HOOKED(Name, return_type, parameters) return_type MPIM_##Name(MPIM_UNPACK parameters, char* file, int line);
+/// Declares the MPIM version of an MPI routine taking parameters
+#define MPIM_DECLARE_COMPLETING(Name, return_type, parameters) return_type MPIM_##Name(MPIM_UNPACK parameters, char* file, int line);
+/// Declares the MPIM version of an MPI routine taking parameters
+#define MPIM_DECLARE_CUSTOM(Name, return_type, parameters) return_type MPIM_##Name(MPIM_UNPACK parameters, char* file, int line);
+/// Declares the MPIM version of an MPI routine taking no parameter
+#define MPIM_DECLARE_CUSTOM_NULLARY(Name, return_type, parameters) return_type MPIM_##Name(char* file, int line);
+/// Expands an entry of MPIM_ROUTINES into the prototype of its MPIM version
+#define MPIM_DECLARE_ROUTINE(TYPE, Name, return_type, attributes, implementation, parameters, ...) MPIM_DECLARE_##implementation(Name, return_type, parameters)
+
+MPIM_ROUTINES(MPIM_DECLARE_ROUTINE)
+
+///////////////////////////////////////
+// COMPILE-TIME MONITORING SELECTION //
+///////////////////////////////////////
+
+/// Nothing is redirected, the application runs without the monitor
+#define MPIM_LEVEL_OFF 0
+/// Only the routines that may block are redirected, enough to see where processes hang
+#define MPIM_LEVEL_HANGS 1
+/// Every routine but the local queries is redirected, enough for the profile and the wait states
+#define MPIM_LEVEL_PROFILE 2
+/// Every routine is redirected
+#define MPIM_LEVEL_TRACE 3
+#ifndef MPI_MONITOR_LEVEL
+/// The monitoring level of the translation unit, one of the MPIM_LEVEL_ values, which can be set on the command line, for instance -DMPI_MONITOR_LEVEL=MPIM_LEVEL_HANGS
+#define MPI_MONITOR_LEVEL MPIM_LEVEL_TRACE
+#endif
+
+/// Point-to-point communications
+#define MPIM_CLASS_P2P 0x01
+/// Collectives, including the creation of communicators
+#define MPIM_CLASS_COLLECTIVE 0x02
+/// One-sided communications and synchronisations
+#define MPIM_CLASS_RMA 0x04
+/// Local queries
+#define MPIM_CLASS_LOCAL 0x08
+/// Starts, tests and waits of requests
+#define MPIM_CLASS_COMPLETION 0x10
+/// Every class
+#define MPIM_CLASS_ALL 0x1F
+#ifndef MPI_MONITOR_CLASSES
+/// The classes of routines monitored in the translation unit, a combination of the MPIM_CLASS_ values, which can be set on the command line, for instance -DMPI_MONITOR_CLASSES=MPIM_CLASS_COLLECTIVE
+#define MPI_MONITOR_CLASSES MPIM_CLASS_ALL
+#endif
+
+/// Gives the classes of a routine from its MPIM_ROUTINE_ attributes, 0 for the routines managing communicators, groups, datatypes and requests
+#define MPIM_ROUTINE_CLASSES(attributes) ((((attributes) & MPIM_ROUTINE_P2P) ? MPIM_CLASS_P2P : 0) | \
+                                          (((attributes) & MPIM_ROUTINE_COLLECTIVE) ? MPIM_CLASS_COLLECTIVE : 0) | \
+                                          (((attributes) & MPIM_ROUTINE_RMA) ? MPIM_CLASS_RMA : 0) | \
+                                          (((attributes) & MPIM_ROUTINE_LOCAL) ? MPIM_CLASS_LOCAL : 0) | \
+                                          ((((attributes) & (MPIM_ROUTINE_P2P | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_RMA | MPIM_ROUTINE_LOCAL)) == 0 && ((attributes) & (MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_NONBLOCKING))) ? MPIM_CLASS_COMPLETION : 0))
+
+/**
+ * @brief Tells if a routine is redirected to its MPIM version in this translation unit, given its MPIM_ROUTINE_ attributes.
+ * @details The routines of no class are always redirected, as they keep the caches of the monitor coherent and are never on a hot path. The result is a constant expression, so the redirection macros compile into a direct call to either version.
+ **/
+#define MPIM_MONITORED(attributes) (MPIM_ROUTINE_CLASSES(attributes) == 0 || \
+                                    ((MPIM_ROUTINE_CLASSES(attributes) & (MPI_MONITOR_CLASSES)) != 0 && \
+                                     ((MPI_MONITOR_LEVEL) >= MPIM_LEVEL_TRACE || \
+                                      ((MPI_MONITOR_LEVEL) >= MPIM_LEVEL_PROFILE && !((attributes) & MPIM_ROUTINE_LOCAL)) || \
+                                      ((attributes) & MPIM_ROUTINE_BLOCKING))))
+
+/// Expands an entry of MPIM_ROUTINES into the constant holding its attributes
+#define MPIM_DECLARE_ATTRIBUTES(TYPE, Name, return_type, attributes, ...) MPIM_ATTRIBUTES_##Name = (attributes),
+
+/// The attributes of every routine, named after it, so that the redirection macros can find them
+enum MPIM_routine_attributes_t { MPIM_ROUTINES(MPIM_DECLARE_ATTRIBUTES) };
+
+/// Calls the MPIM version of a routine if it is monitored, and the MPI version otherwise; MPI_##Name is not expanded again, being the name of the macro being replaced
+#define MPIM_REDIRECT(Name, ...) (MPIM_MONITORED(MPIM_ATTRIBUTES_##Name) ? MPIM_##Name(__VA_ARGS__, __FILE__, __LINE__) : MPI_##Name(__VA_ARGS__))
+/// Calls the MPIM version of a routine taking no parameter if it is monitored, and the MPI version otherwise
+#define MPIM_REDIRECT_NULLARY(Name) (MPIM_MONITORED(MPIM_ATTRIBUTES_##Name) ? MPIM_##Name(__FILE__, __LINE__) : MPI_##Name())
 
 //////////////////////////////////////////////
 // DEFINES TO BYPASS ORIGINAL MPI ROUTINES //
 ////////////////////////////////////////////
 
-#ifndef MPI_MONITOR_NO_SUBSTITUTION
-/// Redirects calls from MPI_Abort to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Abort(...) MPIM_Abort(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Accumulate to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Accumulate(...) MPIM_Accumulate(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Allgather to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Allgather(...) MPIM_Allgather(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Allgatherv to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Allgatherv(...) MPIM_Allgatherv(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Allreduce to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Allreduce(...) MPIM_Allreduce(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Alltoall to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Alltoall(...) MPIM_Alltoall(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Alltoallv to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Alltoallv(...) MPIM_Alltoallv(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Barrier to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Barrier(...) MPIM_Barrier(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Bsend to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Bcast(...) MPIM_Bcast(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Bsend to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Bsend(...) MPIM_Bsend(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Bsend_init to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Bsend_init(...) MPIM_Bsend_init(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Cancel to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Cancel(...) MPIM_Cancel(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Card_coords to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Card_coords(...) MPIM_Cart_coords(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Card_create to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Card_create(...) MPIM_Cart_create(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Card_get to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Card_get(...) MPIM_Cart_get(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Card_shift to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Card_shift(...) MPIM_Cart_shift(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Comm_create to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Comm_create(...) MPIM_Comm_create(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Comm_get_name to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Comm_get_name(...) MPIM_Comm_get_name(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Comm_get_parent to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Comm_get_parent(...) MPIM_Comm_get_parent(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Comm_group to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Comm_group(...) MPIM_Comm_group(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Comm_rank to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Comm_rank(...) MPIM_Comm_rank(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Comm_set_name to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Comm_set_name(...) MPIM_Comm_set_name(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Comm_size to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Comm_size(...) MPIM_Comm_size(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Comm_spawn to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Comm_spawn(...) MPIM_Comm_spawn(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Comm_split to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Comm_split(...) MPIM_Comm_split(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Dims_create to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Dims_create(...) MPIM_Dims_create(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Exscan to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Exscan(...) MPIM_Exscan(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
+#if !defined(MPI_MONITOR_NO_SUBSTITUTION) && (MPI_MONITOR_LEVEL) != MPIM_LEVEL_OFF
+/// Redirects calls from MPI_Abort to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Abort(...) MPIM_REDIRECT(Abort, __VA_ARGS__)
+/// Redirects calls from MPI_Accumulate to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Accumulate(...) MPIM_REDIRECT(Accumulate, __VA_ARGS__)
+/// Redirects calls from MPI_Allgather to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Allgather(...) MPIM_REDIRECT(Allgather, __VA_ARGS__)
+/// Redirects calls from MPI_Allgatherv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Allgatherv(...) MPIM_REDIRECT(Allgatherv, __VA_ARGS__)
+/// Redirects calls from MPI_Allreduce to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Allreduce(...) MPIM_REDIRECT(Allreduce, __VA_ARGS__)
+/// Redirects calls from MPI_Alltoall to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Alltoall(...) MPIM_REDIRECT(Alltoall, __VA_ARGS__)
+/// Redirects calls from MPI_Alltoallv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Alltoallv(...) MPIM_REDIRECT(Alltoallv, __VA_ARGS__)
+/// Redirects calls from MPI_Barrier to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Barrier(...) MPIM_REDIRECT(Barrier, __VA_ARGS__)
+/// Redirects calls from MPI_Bcast to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Bcast(...) MPIM_REDIRECT(Bcast, __VA_ARGS__)
+/// Redirects calls from MPI_Bsend to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Bsend(...) MPIM_REDIRECT(Bsend, __VA_ARGS__)
+/// Redirects calls from MPI_Bsend_init to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Bsend_init(...) MPIM_REDIRECT(Bsend_init, __VA_ARGS__)
+/// Redirects calls from MPI_Cancel to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Cancel(...) MPIM_REDIRECT(Cancel, __VA_ARGS__)
+/// Redirects calls from MPI_Cart_coords to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Cart_coords(...) MPIM_REDIRECT(Cart_coords, __VA_ARGS__)
+/// Redirects calls from MPI_Cart_create to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Cart_create(...) MPIM_REDIRECT(Cart_create, __VA_ARGS__)
+/// Redirects calls from MPI_Cart_get to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Cart_get(...) MPIM_REDIRECT(Cart_get, __VA_ARGS__)
+/// Redirects calls from MPI_Cart_shift to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Cart_shift(...) MPIM_REDIRECT(Cart_shift, __VA_ARGS__)
+/// Redirects calls from MPI_Comm_create to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Comm_create(...) MPIM_REDIRECT(Comm_create, __VA_ARGS__)
+/// Redirects calls from MPI_Comm_free to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Comm_free(...) MPIM_REDIRECT(Comm_free, __VA_ARGS__)
+/// Redirects calls from MPI_Comm_get_name to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Comm_get_name(...) MPIM_REDIRECT(Comm_get_name, __VA_ARGS__)
+/// Redirects calls from MPI_Comm_get_parent to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Comm_get_parent(...) MPIM_REDIRECT(Comm_get_parent, __VA_ARGS__)
+/// Redirects calls from MPI_Comm_group to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Comm_group(...) MPIM_REDIRECT(Comm_group, __VA_ARGS__)
+/// Redirects calls from MPI_Comm_rank to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Comm_rank(...) MPIM_REDIRECT(Comm_rank, __VA_ARGS__)
+/// Redirects calls from MPI_Comm_set_name to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Comm_set_name(...) MPIM_REDIRECT(Comm_set_name, __VA_ARGS__)
+/// Redirects calls from MPI_Comm_size to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Comm_size(...) MPIM_REDIRECT(Comm_size, __VA_ARGS__)
+/// Redirects calls from MPI_Comm_spawn to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Comm_spawn(...) MPIM_REDIRECT(Comm_spawn, __VA_ARGS__)
+/// Redirects calls from MPI_Comm_split to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Comm_split(...) MPIM_REDIRECT(Comm_split, __VA_ARGS__)
+/// Redirects calls from MPI_Compare_and_swap to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Compare_and_swap(...) MPIM_REDIRECT(Compare_and_swap, __VA_ARGS__)
+/// Redirects calls from MPI_Dims_create to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Dims_create(...) MPIM_REDIRECT(Dims_create, __VA_ARGS__)
+/// Redirects calls from MPI_Exscan to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Exscan(...) MPIM_REDIRECT(Exscan, __VA_ARGS__)
 /// Redirects calls from MPI_Finalize to the MPIM version and collects the file name as well as the line at which the MPI call is issued
 #define MPI_Finalize() MPIM_Finalize(__FILE__, __LINE__)
-/// Redirects calls from MPI_Gather to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Gather(...) MPIM_Gather(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Gatherv to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Gatherv(...) MPIM_Gatherv(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Get to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Get(...) MPIM_Get(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Get_address to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Get_address(...) MPIM_Get_address(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Get_count to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Get_count(...) MPIM_Get_count(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Group_difference to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Group_difference(...) MPIM_Group_difference(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Group_incl to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Group_incl(...) MPIM_Group_incl(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Group_intersection to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Group_intersection(...) MPIM_Group_intersection(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Group_rank to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Group_rank(...) MPIM_Group_rank(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Group_size to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Group_size(...) MPIM_Group_size(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Group_union to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Group_union(...) MPIM_Group_union(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Iallgather to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Iallgather(...) MPIM_Iallgather(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Iallgatherv to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Iallgatherv(...) MPIM_Iallgatherv(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Iallreduce to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Iallreduce(...) MPIM_Iallreduce(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Ialltoall to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Ialltoall(...) MPIM_Ialltoall(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Ialltoallv to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Ialltoallv(...) MPIM_Ialltoallv(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Ibarrier to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Ibarrier(...) MPIM_Ibarrier(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Ibsend to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Ibsend(...) MPIM_Ibsend(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Igather to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Igather(...) MPIM_Igather(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Igatherv to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Igatherv(...) MPIM_Igatherv(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
+/// Redirects calls from MPI_Fetch_and_op to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Fetch_and_op(...) MPIM_REDIRECT(Fetch_and_op, __VA_ARGS__)
+/// Redirects calls from MPI_Gather to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Gather(...) MPIM_REDIRECT(Gather, __VA_ARGS__)
+/// Redirects calls from MPI_Gatherv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Gatherv(...) MPIM_REDIRECT(Gatherv, __VA_ARGS__)
+/// Redirects calls from MPI_Get to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Get(...) MPIM_REDIRECT(Get, __VA_ARGS__)
+/// Redirects calls from MPI_Get_accumulate to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Get_accumulate(...) MPIM_REDIRECT(Get_accumulate, __VA_ARGS__)
+/// Redirects calls from MPI_Get_address to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Get_address(...) MPIM_REDIRECT(Get_address, __VA_ARGS__)
+/// Redirects calls from MPI_Get_count to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Get_count(...) MPIM_REDIRECT(Get_count, __VA_ARGS__)
+/// Redirects calls from MPI_Group_difference to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Group_difference(...) MPIM_REDIRECT(Group_difference, __VA_ARGS__)
+/// Redirects calls from MPI_Group_incl to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Group_incl(...) MPIM_REDIRECT(Group_incl, __VA_ARGS__)
+/// Redirects calls from MPI_Group_intersection to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Group_intersection(...) MPIM_REDIRECT(Group_intersection, __VA_ARGS__)
+/// Redirects calls from MPI_Group_rank to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Group_rank(...) MPIM_REDIRECT(Group_rank, __VA_ARGS__)
+/// Redirects calls from MPI_Group_size to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Group_size(...) MPIM_REDIRECT(Group_size, __VA_ARGS__)
+/// Redirects calls from MPI_Group_union to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Group_union(...) MPIM_REDIRECT(Group_union, __VA_ARGS__)
+/// Redirects calls from MPI_Iallgather to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Iallgather(...) MPIM_REDIRECT(Iallgather, __VA_ARGS__)
+/// Redirects calls from MPI_Iallgatherv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Iallgatherv(...) MPIM_REDIRECT(Iallgatherv, __VA_ARGS__)
+/// Redirects calls from MPI_Iallreduce to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Iallreduce(...) MPIM_REDIRECT(Iallreduce, __VA_ARGS__)
+/// Redirects calls from MPI_Ialltoall to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Ialltoall(...) MPIM_REDIRECT(Ialltoall, __VA_ARGS__)
+/// Redirects calls from MPI_Ialltoallv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Ialltoallv(...) MPIM_REDIRECT(Ialltoallv, __VA_ARGS__)
+/// Redirects calls from MPI_Ibarrier to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Ibarrier(...) MPIM_REDIRECT(Ibarrier, __VA_ARGS__)
+/// Redirects calls from MPI_Ibsend to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Ibsend(...) MPIM_REDIRECT(Ibsend, __VA_ARGS__)
+/// Redirects calls from MPI_Igather to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Igather(...) MPIM_REDIRECT(Igather, __VA_ARGS__)
+/// Redirects calls from MPI_Igatherv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Igatherv(...) MPIM_REDIRECT(Igatherv, __VA_ARGS__)
+/// Redirects calls from MPI_Improbe to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Improbe(...) MPIM_REDIRECT(Improbe, __VA_ARGS__)
+/// Redirects calls from MPI_Imrecv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Imrecv(...) MPIM_REDIRECT(Imrecv, __VA_ARGS__)
+/// Redirects calls from MPI_Ineighbor_allgather to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Ineighbor_allgather(...) MPIM_REDIRECT(Ineighbor_allgather, __VA_ARGS__)
+/// Redirects calls from MPI_Ineighbor_alltoall to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Ineighbor_alltoall(...) MPIM_REDIRECT(Ineighbor_alltoall, __VA_ARGS__)
 /// Redirects calls from MPI_Init to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Init(...) MPIM_Init(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Iprobe to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Iprobe(...) MPIM_Iprobe(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Irecv to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Irecv(...) MPIM_Irecv(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Ireduce to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Ireduce(...) MPIM_Ireduce(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Ireduce_scatter to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Ireduce_scatter(...) MPIM_Ireduce_scatter(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Ireduce_scatter_block to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Ireduce_scatter_block(...) MPIM_Ireduce_scatter_block(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Irsend to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Irsend(...) MPIM_Irsend(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Iscatter to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Iscatter(...) MPIM_Iscatter(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Iscatterv to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Iscatterv(...) MPIM_Iscatterv(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Isend to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Isend(...) MPIM_Isend(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Issend to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Issend(...) MPIM_Issend(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Op_create to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Op_create(...) MPIM_Op_create(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Op_free to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Op_free(...) MPIM_Op_free(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Probe to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Probe(...) MPIM_Probe(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Put to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Put(...) MPIM_Put(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Recv to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Recv(...) MPIM_Recv(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Recv_init to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Recv_init(...) MPIM_Recv_init(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Reduce to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Reduce(...) MPIM_Reduce(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Reduce_scatter to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Reduce_scatter(...) MPIM_Reduce_scatter(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Reduce_scatter_block to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Reduce_scatter_block(...) MPIM_Reduce_scatter_block(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Rsend to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Rsend(...) MPIM_Rsend(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Rsend_init to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Rsend_init(...) MPIM_Rsend_init(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Scan to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Scan(...) MPIM_Scan(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Scatter to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Scatter(...) MPIM_Scatter(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Scatterv to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Scatterv(...) MPIM_Scatterv(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Send to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Send(...) MPIM_Send(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Send_init to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Send_init(...) MPIM_Send_init(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Sendrecv to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Sendrecv(...) MPIM_Sendrecv(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Sendrecv_replace to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Sendrecv_replace(...) MPIM_Sendrecv_replace(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Ssend to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Ssend(...) MPIM_Ssend(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Ssend_init to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Ssend_init(...) MPIM_Ssend_init(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Start to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Start(...) MPIM_Start(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Startall to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Startall(...) MPIM_Startall(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Test to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Test(...) MPIM_Test(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Test_cancelled to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Test_cancelled(...) MPIM_Test_cancelled(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Testall to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Testall(...) MPIM_Testall(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Testany to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Testany(...) MPIM_Testany(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Testsome to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Testsome(...) MPIM_Testsome(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_commit to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_commit(...) MPIM_Type_commit(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_contiguous to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_contiguous(...) MPIM_Type_contiguous(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_create_hindexed to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_create_hindexed(...) MPIM_Type_create_hindexed(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_create_hindexed_block to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_create_hindexed_block(...) MPIM_Type_create_hindexed_block(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_create_hvector to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_create_hvector(...) MPIM_Type_create_hvector(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_create_indexed_block to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_create_indexed_block(...) MPIM_Type_create_indexed_block(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_create_struct to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_create_struct(...) MPIM_Type_create_struct(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_create_subarray to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_create_subarray(...) MPIM_Type_create_subarray(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_free to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_free(...) MPIM_Type_free(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_get_extent to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_get_extent(...) MPIM_Type_get_extent(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_indexed to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_indexed(...) MPIM_Type_indexed(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Type_vector to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Type_vector(...) MPIM_Type_vector(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Wait to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Wait(...) MPIM_Wait(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Waitall to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Waitall(...) MPIM_Waitall(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Waitany to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Waitany(...) MPIM_Waitany(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Waitsome to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Waitsome(...) MPIM_Waitsome(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Win_allocate to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Win_allocate(...) MPIM_Win_allocate(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Win_attach to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Win_attach(...) MPIM_Win_attach(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Win_create to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Win_create(...) MPIM_Win_create(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Win_create_dynamic to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Win_create_dynamic(...) MPIM_Win_create_dynamic(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Win_detach to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Win_detach(...) MPIM_Win_detach(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Win_free to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Win_free(...) MPIM_Win_free(__VA_ARGS__, __FILE__, __LINE__, #__VA_ARGS__)
-/// Redirects calls from MPI_Wtime to the MPIM version and collects the file name as well as the line at which the MPI call is issued
-#define MPI_Wtime(...) MPIM_Wtime(__FILE__, __LINE__, #__VA_ARGS__)
+#define MPI_Init(...) MPIM_Init(__VA_ARGS__, __FILE__, __LINE__)
+/// Redirects calls from MPI_Init_thread to the MPIM version and collects the file name as well as the line at which the MPI call is issued
+#define MPI_Init_thread(...) MPIM_Init_thread(__VA_ARGS__, __FILE__, __LINE__)
+/// Redirects calls from MPI_Iprobe to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Iprobe(...) MPIM_REDIRECT(Iprobe, __VA_ARGS__)
+/// Redirects calls from MPI_Irecv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Irecv(...) MPIM_REDIRECT(Irecv, __VA_ARGS__)
+/// Redirects calls from MPI_Ireduce to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Ireduce(...) MPIM_REDIRECT(Ireduce, __VA_ARGS__)
+/// Redirects calls from MPI_Ireduce_scatter to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Ireduce_scatter(...) MPIM_REDIRECT(Ireduce_scatter, __VA_ARGS__)
+/// Redirects calls from MPI_Ireduce_scatter_block to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Ireduce_scatter_block(...) MPIM_REDIRECT(Ireduce_scatter_block, __VA_ARGS__)
+/// Redirects calls from MPI_Irsend to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Irsend(...) MPIM_REDIRECT(Irsend, __VA_ARGS__)
+/// Redirects calls from MPI_Iscatter to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Iscatter(...) MPIM_REDIRECT(Iscatter, __VA_ARGS__)
+/// Redirects calls from MPI_Iscatterv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Iscatterv(...) MPIM_REDIRECT(Iscatterv, __VA_ARGS__)
+/// Redirects calls from MPI_Isend to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Isend(...) MPIM_REDIRECT(Isend, __VA_ARGS__)
+/// Redirects calls from MPI_Issend to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Issend(...) MPIM_REDIRECT(Issend, __VA_ARGS__)
+/// Redirects calls from MPI_Mprobe to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Mprobe(...) MPIM_REDIRECT(Mprobe, __VA_ARGS__)
+/// Redirects calls from MPI_Mrecv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Mrecv(...) MPIM_REDIRECT(Mrecv, __VA_ARGS__)
+/// Redirects calls from MPI_Neighbor_allgather to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Neighbor_allgather(...) MPIM_REDIRECT(Neighbor_allgather, __VA_ARGS__)
+/// Redirects calls from MPI_Neighbor_allgatherv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Neighbor_allgatherv(...) MPIM_REDIRECT(Neighbor_allgatherv, __VA_ARGS__)
+/// Redirects calls from MPI_Neighbor_alltoall to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Neighbor_alltoall(...) MPIM_REDIRECT(Neighbor_alltoall, __VA_ARGS__)
+/// Redirects calls from MPI_Neighbor_alltoallv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Neighbor_alltoallv(...) MPIM_REDIRECT(Neighbor_alltoallv, __VA_ARGS__)
+/// Redirects calls from MPI_Neighbor_alltoallw to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Neighbor_alltoallw(...) MPIM_REDIRECT(Neighbor_alltoallw, __VA_ARGS__)
+/// Redirects calls from MPI_Op_create to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Op_create(...) MPIM_REDIRECT(Op_create, __VA_ARGS__)
+/// Redirects calls from MPI_Op_free to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Op_free(...) MPIM_REDIRECT(Op_free, __VA_ARGS__)
+/// Redirects calls from MPI_Probe to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Probe(...) MPIM_REDIRECT(Probe, __VA_ARGS__)
+/// Redirects calls from MPI_Put to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Put(...) MPIM_REDIRECT(Put, __VA_ARGS__)
+/// Redirects calls from MPI_Raccumulate to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Raccumulate(...) MPIM_REDIRECT(Raccumulate, __VA_ARGS__)
+/// Redirects calls from MPI_Recv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Recv(...) MPIM_REDIRECT(Recv, __VA_ARGS__)
+/// Redirects calls from MPI_Recv_init to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Recv_init(...) MPIM_REDIRECT(Recv_init, __VA_ARGS__)
+/// Redirects calls from MPI_Reduce to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Reduce(...) MPIM_REDIRECT(Reduce, __VA_ARGS__)
+/// Redirects calls from MPI_Reduce_scatter to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Reduce_scatter(...) MPIM_REDIRECT(Reduce_scatter, __VA_ARGS__)
+/// Redirects calls from MPI_Reduce_scatter_block to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Reduce_scatter_block(...) MPIM_REDIRECT(Reduce_scatter_block, __VA_ARGS__)
+/// Redirects calls from MPI_Request_free to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Request_free(...) MPIM_REDIRECT(Request_free, __VA_ARGS__)
+/// Redirects calls from MPI_Rget to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Rget(...) MPIM_REDIRECT(Rget, __VA_ARGS__)
+/// Redirects calls from MPI_Rget_accumulate to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Rget_accumulate(...) MPIM_REDIRECT(Rget_accumulate, __VA_ARGS__)
+/// Redirects calls from MPI_Rput to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Rput(...) MPIM_REDIRECT(Rput, __VA_ARGS__)
+/// Redirects calls from MPI_Rsend to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Rsend(...) MPIM_REDIRECT(Rsend, __VA_ARGS__)
+/// Redirects calls from MPI_Rsend_init to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Rsend_init(...) MPIM_REDIRECT(Rsend_init, __VA_ARGS__)
+/// Redirects calls from MPI_Scan to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Scan(...) MPIM_REDIRECT(Scan, __VA_ARGS__)
+/// Redirects calls from MPI_Scatter to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Scatter(...) MPIM_REDIRECT(Scatter, __VA_ARGS__)
+/// Redirects calls from MPI_Scatterv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Scatterv(...) MPIM_REDIRECT(Scatterv, __VA_ARGS__)
+/// Redirects calls from MPI_Send to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Send(...) MPIM_REDIRECT(Send, __VA_ARGS__)
+/// Redirects calls from MPI_Send_init to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Send_init(...) MPIM_REDIRECT(Send_init, __VA_ARGS__)
+/// Redirects calls from MPI_Sendrecv to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Sendrecv(...) MPIM_REDIRECT(Sendrecv, __VA_ARGS__)
+/// Redirects calls from MPI_Sendrecv_replace to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Sendrecv_replace(...) MPIM_REDIRECT(Sendrecv_replace, __VA_ARGS__)
+/// Redirects calls from MPI_Ssend to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Ssend(...) MPIM_REDIRECT(Ssend, __VA_ARGS__)
+/// Redirects calls from MPI_Ssend_init to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Ssend_init(...) MPIM_REDIRECT(Ssend_init, __VA_ARGS__)
+/// Redirects calls from MPI_Start to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Start(...) MPIM_REDIRECT(Start, __VA_ARGS__)
+/// Redirects calls from MPI_Startall to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Startall(...) MPIM_REDIRECT(Startall, __VA_ARGS__)
+/// Redirects calls from MPI_Test to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Test(...) MPIM_REDIRECT(Test, __VA_ARGS__)
+/// Redirects calls from MPI_Test_cancelled to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Test_cancelled(...) MPIM_REDIRECT(Test_cancelled, __VA_ARGS__)
+/// Redirects calls from MPI_Testall to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Testall(...) MPIM_REDIRECT(Testall, __VA_ARGS__)
+/// Redirects calls from MPI_Testany to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Testany(...) MPIM_REDIRECT(Testany, __VA_ARGS__)
+/// Redirects calls from MPI_Testsome to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Testsome(...) MPIM_REDIRECT(Testsome, __VA_ARGS__)
+/// Redirects calls from MPI_Type_commit to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_commit(...) MPIM_REDIRECT(Type_commit, __VA_ARGS__)
+/// Redirects calls from MPI_Type_contiguous to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_contiguous(...) MPIM_REDIRECT(Type_contiguous, __VA_ARGS__)
+/// Redirects calls from MPI_Type_create_hindexed to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_create_hindexed(...) MPIM_REDIRECT(Type_create_hindexed, __VA_ARGS__)
+/// Redirects calls from MPI_Type_create_hindexed_block to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_create_hindexed_block(...) MPIM_REDIRECT(Type_create_hindexed_block, __VA_ARGS__)
+/// Redirects calls from MPI_Type_create_hvector to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_create_hvector(...) MPIM_REDIRECT(Type_create_hvector, __VA_ARGS__)
+/// Redirects calls from MPI_Type_create_indexed_block to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_create_indexed_block(...) MPIM_REDIRECT(Type_create_indexed_block, __VA_ARGS__)
+/// Redirects calls from MPI_Type_create_struct to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_create_struct(...) MPIM_REDIRECT(Type_create_struct, __VA_ARGS__)
+/// Redirects calls from MPI_Type_create_subarray to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_create_subarray(...) MPIM_REDIRECT(Type_create_subarray, __VA_ARGS__)
+/// Redirects calls from MPI_Type_free to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_free(...) MPIM_REDIRECT(Type_free, __VA_ARGS__)
+/// Redirects calls from MPI_Type_get_extent to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_get_extent(...) MPIM_REDIRECT(Type_get_extent, __VA_ARGS__)
+/// Redirects calls from MPI_Type_indexed to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_indexed(...) MPIM_REDIRECT(Type_indexed, __VA_ARGS__)
+/// Redirects calls from MPI_Type_vector to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Type_vector(...) MPIM_REDIRECT(Type_vector, __VA_ARGS__)
+/// Redirects calls from MPI_Wait to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Wait(...) MPIM_REDIRECT(Wait, __VA_ARGS__)
+/// Redirects calls from MPI_Waitall to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Waitall(...) MPIM_REDIRECT(Waitall, __VA_ARGS__)
+/// Redirects calls from MPI_Waitany to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Waitany(...) MPIM_REDIRECT(Waitany, __VA_ARGS__)
+/// Redirects calls from MPI_Waitsome to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Waitsome(...) MPIM_REDIRECT(Waitsome, __VA_ARGS__)
+/// Redirects calls from MPI_Win_allocate to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_allocate(...) MPIM_REDIRECT(Win_allocate, __VA_ARGS__)
+/// Redirects calls from MPI_Win_allocate_shared to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_allocate_shared(...) MPIM_REDIRECT(Win_allocate_shared, __VA_ARGS__)
+/// Redirects calls from MPI_Win_attach to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_attach(...) MPIM_REDIRECT(Win_attach, __VA_ARGS__)
+/// Redirects calls from MPI_Win_complete to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_complete(...) MPIM_REDIRECT(Win_complete, __VA_ARGS__)
+/// Redirects calls from MPI_Win_create to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_create(...) MPIM_REDIRECT(Win_create, __VA_ARGS__)
+/// Redirects calls from MPI_Win_create_dynamic to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_create_dynamic(...) MPIM_REDIRECT(Win_create_dynamic, __VA_ARGS__)
+/// Redirects calls from MPI_Win_detach to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_detach(...) MPIM_REDIRECT(Win_detach, __VA_ARGS__)
+/// Redirects calls from MPI_Win_fence to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_fence(...) MPIM_REDIRECT(Win_fence, __VA_ARGS__)
+/// Redirects calls from MPI_Win_flush to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_flush(...) MPIM_REDIRECT(Win_flush, __VA_ARGS__)
+/// Redirects calls from MPI_Win_flush_all to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_flush_all(...) MPIM_REDIRECT(Win_flush_all, __VA_ARGS__)
+/// Redirects calls from MPI_Win_flush_local to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_flush_local(...) MPIM_REDIRECT(Win_flush_local, __VA_ARGS__)
+/// Redirects calls from MPI_Win_flush_local_all to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_flush_local_all(...) MPIM_REDIRECT(Win_flush_local_all, __VA_ARGS__)
+/// Redirects calls from MPI_Win_free to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_free(...) MPIM_REDIRECT(Win_free, __VA_ARGS__)
+/// Redirects calls from MPI_Win_lock to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_lock(...) MPIM_REDIRECT(Win_lock, __VA_ARGS__)
+/// Redirects calls from MPI_Win_lock_all to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_lock_all(...) MPIM_REDIRECT(Win_lock_all, __VA_ARGS__)
+/// Redirects calls from MPI_Win_post to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_post(...) MPIM_REDIRECT(Win_post, __VA_ARGS__)
+/// Redirects calls from MPI_Win_shared_query to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_shared_query(...) MPIM_REDIRECT(Win_shared_query, __VA_ARGS__)
+/// Redirects calls from MPI_Win_start to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_start(...) MPIM_REDIRECT(Win_start, __VA_ARGS__)
+/// Redirects calls from MPI_Win_sync to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_sync(...) MPIM_REDIRECT(Win_sync, __VA_ARGS__)
+/// Redirects calls from MPI_Win_test to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_test(...) MPIM_REDIRECT(Win_test, __VA_ARGS__)
+/// Redirects calls from MPI_Win_unlock to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_unlock(...) MPIM_REDIRECT(Win_unlock, __VA_ARGS__)
+/// Redirects calls from MPI_Win_unlock_all to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_unlock_all(...) MPIM_REDIRECT(Win_unlock_all, __VA_ARGS__)
+/// Redirects calls from MPI_Win_wait to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Win_wait(...) MPIM_REDIRECT(Win_wait, __VA_ARGS__)
+/// Redirects calls from MPI_Wtime to the MPIM version if it is monitored, collecting the file name as well as the line at which the MPI call is issued
+#define MPI_Wtime(...) MPIM_REDIRECT_NULLARY(Wtime)
+
+#ifndef __cplusplus
+/// Turns its argument into a string literal
+#define MPIM_STRINGIFY(x) #x
+/// Turns its argument into a string literal once macro-expanded
+#define MPIM_STRINGIFY_EXPANDED(x) MPIM_STRINGIFY(x)
+/// Fails the compilation if an entry of MPIM_ROUTINES has no redirection macro above, the call being left unchanged by the expansion
+#define MPIM_CHECK_REDIRECTION(TYPE, Name, ...) _Static_assert(sizeof(MPIM_STRINGIFY_EXPANDED(MPI_##Name())) != sizeof("MPI_" #Name "()"), "MPI_" #Name " is not redirected to MPIM_" #Name);
+MPIM_ROUTINES(MPIM_CHECK_REDIRECTION)
+#endif // __cplusplus
 #endif // MPI_MONITOR_NO_SUBSTITUTION
 
 #endif // MPI_MONITOR_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,188 @@
+/**
+ * @file mpi_monitor_routines.h
+ * @brief The list of MPI routines monitored, from which the wrappers, their prototypes, the message types and the routine names are generated.
+ **/
+
+#ifndef MPI_MONITOR_ROUTINES_H_INCLUDED
+#define MPI_MONITOR_ROUTINES_H_INCLUDED
+
+/// The routine is a local query: it never waits on other processes, so its calls are not published to the coordinator
+#define MPIM_ROUTINE_LOCAL 0x01
+/// The routine may wait until other processes take part in it
+#define MPIM_ROUTINE_BLOCKING 0x02
+/// The routine starts or tests an operation without waiting for its completion
+#define MPIM_ROUTINE_NONBLOCKING 0x04
+/// The routine is a point-to-point communication
+#define MPIM_ROUTINE_P2P 0x08
+/// The routine must be called by all processes of a communicator or window
+#define MPIM_ROUTINE_COLLECTIVE 0x10
+/// The routine is a one-sided communication or synchronisation
+#define MPIM_ROUTINE_RMA 0x20
+/// The routine only creates a persistent request, the communication happens when the request is started
+#define MPIM_ROUTINE_PERSISTENT 0x40
+/// The routine is a collective in which every process depends on data from every other one, so none can complete before the last one enters
+#define MPIM_ROUTINE_N_TO_N 0x80
+
+/// Removes the parentheses around a parameter or argument list of MPIM_ROUTINES
+#define MPIM_UNPACK(...) __VA_ARGS__
+
+/**
+ * @brief Applies X to every monitored MPI routine, in alphabetical order.
+ * @details Each entry is X(TYPE, Name, return_type, attributes, implementation, (parameters), (forwarded arguments), recorded arguments), where:
+ * - TYPE is the suffix of the MPIM_MESSAGE_ message type;
+ * - Name is the routine name without the MPI_ prefix;
+ * - attributes is a combination of the MPIM_ROUTINE_ flags;
+ * - implementation is GENERATED when the wrapper is generated, HOOKED when it is generated and also calls the MPIM_hook_ macro of the routine once MPI returns, COMPLETING when it is hooked and also calls the MPIM_prehook_ macro of the routine before MPI completes its requests, CUSTOM when it is written by hand, CUSTOM_NULLARY when it is written by hand and the routine takes no parameter;
+ * - recorded arguments is the expression building the MPIM_arguments_t of a call, which tells which parameters hold the peer, the communicator and the data size.
+ * Adding a routine only takes a new entry here and its redirection macro in mpi_monitor.h, whose absence is reported at compile time.
+ **/
+#define MPIM_ROUTINES(X) \
+    X(ABORT, Abort, int, 0, CUSTOM, (MPI_Comm communicator, int error_code), (communicator, error_code), MPIM_arguments_communicator(communicator)) \
+    X(ACCUMULATE, Accumulate, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_RMA, HOOKED, (const void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Op operation, MPI_Win window), (origin_address, origin_count, origin_datatype, target_rank, target_displacement, target_count, target_datatype, operation, window), MPIM_arguments_rma(target_rank, origin_count, origin_datatype, window)) \
+    X(ALLGATHER, Allgather, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_N_TO_N, GENERATED, (void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator), MPIM_arguments_collective(communicator, count_send, datatype_send)) \
+    X(ALLGATHERV, Allgatherv, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_N_TO_N, GENERATED, (void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, MPI_Comm communicator), (buffer_send, count_send, datatype_send, buffer_recv, counts_recv, displacements, datatype_recv, communicator), MPIM_arguments_collective(communicator, count_send, datatype_send)) \
+    X(ALLREDUCE, Allreduce, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_N_TO_N, GENERATED, (const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator), (send_buffer, receive_buffer, count, datatype, operation, communicator), MPIM_arguments_collective(communicator, count, datatype)) \
+    X(ALLTOALL, Alltoall, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_N_TO_N, GENERATED, (void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator), MPIM_arguments_collective(communicator, count_send, datatype_send)) \
+    X(ALLTOALLV, Alltoallv, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_N_TO_N, GENERATED, (void* buffer_send, const int* counts_send, const int* displacements_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements_recv, MPI_Datatype datatype_recv, MPI_Comm communicator), (buffer_send, counts_send, displacements_send, datatype_send, buffer_recv, counts_recv, displacements_recv, datatype_recv, communicator), MPIM_arguments_collective(communicator, MPIM_VARIABLE_COUNT, datatype_send)) \
+    X(BARRIER, Barrier, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_N_TO_N, GENERATED, (MPI_Comm comm), (comm), MPIM_arguments_communicator(comm)) \
+    X(BCAST, Bcast, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (void* buffer, int count, MPI_Datatype datatype, int emitter_rank, MPI_Comm communicator), (buffer, count, datatype, emitter_rank, communicator), MPIM_arguments_rooted_collective(emitter_rank, communicator, count, datatype)) \
+    X(BSEND, Bsend, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_P2P, GENERATED, (void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm), (buffer, count, type, dst, tag, comm), MPIM_arguments_send(dst, tag, comm, count, type)) \
+    X(BSEND_INIT, Bsend_init, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P | MPIM_ROUTINE_PERSISTENT, HOOKED, (void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request), (buffer, count, type, dst, tag, comm, request), MPIM_arguments_send(dst, tag, comm, count, type)) \
+    X(CANCEL, Cancel, int, MPIM_ROUTINE_NONBLOCKING, GENERATED, (MPI_Request* request), (request), MPIM_arguments_requests(1)) \
+    X(CART_COORDS, Cart_coords, int, MPIM_ROUTINE_LOCAL, GENERATED, (MPI_Comm communicator, int rank, int dimension_number, int* coords), (communicator, rank, dimension_number, coords), MPIM_arguments_communicator(communicator)) \
+    X(CART_CREATE, Cart_create, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (MPI_Comm old_communicator, int dimension_number, const int* dimensions, const int* periods, int reorder, MPI_Comm* new_communicator), (old_communicator, dimension_number, dimensions, periods, reorder, new_communicator), MPIM_arguments_communicator(old_communicator)) \
+    X(CART_GET, Cart_get, int, MPIM_ROUTINE_LOCAL, GENERATED, (MPI_Comm communicator, int dimension_number, int* dimensions, int* periods, int* coords), (communicator, dimension_number, dimensions, periods, coords), MPIM_arguments_communicator(communicator)) \
+    X(CART_SHIFT, Cart_shift, int, MPIM_ROUTINE_LOCAL, GENERATED, (MPI_Comm communicator, int direction, int displacement, int* source, int* destination), (communicator, direction, displacement, source, destination), MPIM_arguments_communicator(communicator)) \
+    X(COMM_CREATE, Comm_create, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (MPI_Comm old_communicator, MPI_Group group, MPI_Comm* new_communicator), (old_communicator, group, new_communicator), MPIM_arguments_communicator(old_communicator)) \
+    X(COMM_FREE, Comm_free, int, 0, CUSTOM, (MPI_Comm* communicator), (communicator), MPIM_arguments_communicator(*communicator)) \
+    X(COMM_GET_NAME, Comm_get_name, int, MPIM_ROUTINE_LOCAL, GENERATED, (MPI_Comm communicator, char* name, int* length), (communicator, name, length), MPIM_arguments_communicator(communicator)) \
+    X(COMM_GET_PARENT, Comm_get_parent, int, MPIM_ROUTINE_LOCAL, GENERATED, (MPI_Comm* parent), (parent), MPIM_arguments_none()) \
+    X(COMM_GROUP, Comm_group, int, 0, GENERATED, (MPI_Comm communicator, MPI_Group* group), (communicator, group), MPIM_arguments_communicator(communicator)) \
+    X(COMM_RANK, Comm_rank, int, MPIM_ROUTINE_LOCAL, GENERATED, (MPI_Comm communicator, int* rank), (communicator, rank), MPIM_arguments_communicator(communicator)) \
+    X(COMM_SET_NAME, Comm_set_name, int, 0, GENERATED, (MPI_Comm communicator, const char* name), (communicator, name), MPIM_arguments_communicator(communicator)) \
+    X(COMM_SIZE, Comm_size, int, MPIM_ROUTINE_LOCAL, GENERATED, (MPI_Comm communicator, int* size), (communicator, size), MPIM_arguments_communicator(communicator)) \
+    X(COMM_SPAWN, Comm_spawn, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const char* command, char** command_arguments, int max_process_number, MPI_Info info, int root, MPI_Comm intracommunicator, MPI_Comm* intercommunicator, int* error_codes), (command, command_arguments, max_process_number, info, root, intracommunicator, intercommunicator, error_codes), MPIM_arguments_rooted_collective(root, intracommunicator, 0, MPI_DATATYPE_NULL)) \
+    X(COMM_SPLIT, Comm_split, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (MPI_Comm old_communicator, int colour, int key, MPI_Comm* new_communicator), (old_communicator, colour, key, new_communicator), MPIM_arguments_communicator(old_communicator)) \
+    X(COMPARE_AND_SWAP, Compare_and_swap, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_RMA, HOOKED, (const void* origin_address, const void* compare_address, void* result_address, MPI_Datatype datatype, int target_rank, MPI_Aint target_displacement, MPI_Win window), (origin_address, compare_address, result_address, datatype, target_rank, target_displacement, window), MPIM_arguments_rma(target_rank, 1, datatype, window)) \
+    X(DIMS_CREATE, Dims_create, int, MPIM_ROUTINE_LOCAL, GENERATED, (int process_number, int dimension_number, int* dimensions), (process_number, dimension_number, dimensions), MPIM_arguments_none()) \
+    X(EXSCAN, Exscan, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator), (send_buffer, receive_buffer, count, datatype, operation, communicator), MPIM_arguments_collective(communicator, count, datatype)) \
+    X(FETCH_AND_OP, Fetch_and_op, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_RMA, HOOKED, (const void* origin_address, void* result_address, MPI_Datatype datatype, int target_rank, MPI_Aint target_displacement, MPI_Op operation, MPI_Win window), (origin_address, result_address, datatype, target_rank, target_displacement, operation, window), MPIM_arguments_rma(target_rank, 1, datatype, window)) \
+    X(FINALISED, Finalize, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, CUSTOM_NULLARY, (), (), MPIM_arguments_none()) \
+    X(GATHER, Gather, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator), MPIM_arguments_rooted_collective(root, communicator, count_send, datatype_send)) \
+    X(GATHERV, Gatherv, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, int root, MPI_Comm communicator), (buffer_send, count_send, datatype_send, buffer_recv, counts_recv, displacements, datatype_recv, root, communicator), MPIM_arguments_rooted_collective(root, communicator, count_send, datatype_send)) \
+    X(GET, Get, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_RMA, HOOKED, (void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Win window), (origin_address, origin_count, origin_datatype, target_rank, target_displacement, target_count, target_datatype, window), MPIM_arguments_rma(target_rank, origin_count, origin_datatype, window)) \
+    X(GET_ACCUMULATE, Get_accumulate, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_RMA, HOOKED, (const void* origin_address, int origin_count, MPI_Datatype origin_datatype, void* result_address, int result_count, MPI_Datatype result_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Op operation, MPI_Win window), (origin_address, origin_count, origin_datatype, result_address, result_count, result_datatype, target_rank, target_displacement, target_count, target_datatype, operation, window), MPIM_arguments_rma(target_rank, origin_count, origin_datatype, window)) \
+    X(GET_ADDRESS, Get_address, int, MPIM_ROUTINE_LOCAL, GENERATED, (const void* location, MPI_Aint* address), (location, address), MPIM_arguments_none()) \
+    X(GET_COUNT, Get_count, int, MPIM_ROUTINE_LOCAL, GENERATED, (const MPI_Status* status, MPI_Datatype datatype, int* count), (status, datatype, count), MPIM_arguments_none()) \
+    X(GROUP_DIFFERENCE, Group_difference, int, 0, GENERATED, (MPI_Group group_a, MPI_Group group_b, MPI_Group* difference_group), (group_a, group_b, difference_group), MPIM_arguments_none()) \
+    X(GROUP_INCL, Group_incl, int, 0, GENERATED, (MPI_Group old_group, int rank_count, const int ranks[], MPI_Group* new_group), (old_group, rank_count, ranks, new_group), MPIM_arguments_none()) \
+    X(GROUP_INTERSECTION, Group_intersection, int, 0, GENERATED, (MPI_Group group_a, MPI_Group group_b, MPI_Group* intersection_group), (group_a, group_b, intersection_group), MPIM_arguments_none()) \
+    X(GROUP_RANK, Group_rank, int, MPIM_ROUTINE_LOCAL, GENERATED, (MPI_Group group, int* rank), (group, rank), MPIM_arguments_none()) \
+    X(GROUP_SIZE, Group_size, int, MPIM_ROUTINE_LOCAL, GENERATED, (MPI_Group group, int* size), (group, size), MPIM_arguments_none()) \
+    X(GROUP_UNION, Group_union, int, 0, GENERATED, (MPI_Group group_a, MPI_Group group_b, MPI_Group* union_group), (group_a, group_b, union_group), MPIM_arguments_none()) \
+    X(IALLGATHER, Iallgather, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator, request), MPIM_arguments_collective(communicator, count_send, datatype_send)) \
+    X(IALLGATHERV, Iallgatherv, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request), (buffer_send, count_send, datatype_send, buffer_recv, counts_recv, displacements, datatype_recv, communicator, request), MPIM_arguments_collective(communicator, count_send, datatype_send)) \
+    X(IALLREDUCE, Iallreduce, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, MPI_Request* request), (send_buffer, receive_buffer, count, datatype, operation, communicator, request), MPIM_arguments_collective(communicator, count, datatype)) \
+    X(IALLTOALL, Ialltoall, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator, request), MPIM_arguments_collective(communicator, count_send, datatype_send)) \
+    X(IALLTOALLV, Ialltoallv, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (void* buffer_send, const int* counts_send, const int* displacements_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request), (buffer_send, counts_send, displacements_send, datatype_send, buffer_recv, counts_recv, displacements_recv, datatype_recv, communicator, request), MPIM_arguments_collective(communicator, MPIM_VARIABLE_COUNT, datatype_send)) \
+    X(IBARRIER, Ibarrier, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (MPI_Comm communicator, MPI_Request* request), (communicator, request), MPIM_arguments_communicator(communicator)) \
+    X(IBSEND, Ibsend, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P, GENERATED, (void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request), (buffer, count, type, dst, tag, comm, request), MPIM_arguments_send(dst, tag, comm, count, type)) \
+    X(IGATHER, Igather, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator, request), MPIM_arguments_rooted_collective(root, communicator, count_send, datatype_send)) \
+    X(IGATHERV, Igatherv, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int* counts_recv, const int* displacements, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request), (buffer_send, count_send, datatype_send, buffer_recv, counts_recv, displacements, datatype_recv, root, communicator, request), MPIM_arguments_rooted_collective(root, communicator, count_send, datatype_send)) \
+    X(IMPROBE, Improbe, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P, GENERATED, (int source, int tag, MPI_Comm communicator, int* flag, MPI_Message* matched_message, MPI_Status* status), (source, tag, communicator, flag, matched_message, status), MPIM_arguments_receive(source, tag, communicator, 0, MPI_DATATYPE_NULL)) \
+    X(IMRECV, Imrecv, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P, GENERATED, (void* buffer, int count, MPI_Datatype datatype, MPI_Message* matched_message, MPI_Request* request), (buffer, count, datatype, matched_message, request), MPIM_arguments_matched_receive(count, datatype)) \
+    X(INEIGHBOR_ALLGATHER, Ineighbor_allgather, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator, request), MPIM_arguments_collective(communicator, count_send, datatype_send)) \
+    X(INEIGHBOR_ALLTOALL, Ineighbor_alltoall, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator, MPI_Request* request), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator, request), MPIM_arguments_collective(communicator, count_send, datatype_send)) \
+    X(INITIALISED, Init, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, CUSTOM, (int* argc, char*** argv), (argc, argv), MPIM_arguments_none()) \
+    X(INIT_THREAD, Init_thread, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, CUSTOM, (int* argc, char*** argv, int required, int* provided), (argc, argv, required, provided), MPIM_arguments_none()) \
+    X(IPROBE, Iprobe, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P, GENERATED, (int source, int tag, MPI_Comm communicator, int* flag, MPI_Status* status), (source, tag, communicator, flag, status), MPIM_arguments_receive(source, tag, communicator, 0, MPI_DATATYPE_NULL)) \
+    X(IRECV, Irecv, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P, HOOKED, (void* buffer, int count, MPI_Datatype datatype, int sender, int tag, MPI_Comm communicator, MPI_Request* request), (buffer, count, datatype, sender, tag, communicator, request), MPIM_arguments_receive(sender, tag, communicator, count, datatype)) \
+    X(IREDUCE, Ireduce, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, int root, MPI_Comm communicator, MPI_Request* request), (send_buffer, receive_buffer, count, datatype, operation, root, communicator, request), MPIM_arguments_rooted_collective(root, communicator, count, datatype)) \
+    X(IREDUCE_SCATTER, Ireduce_scatter, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* send_buffer, void* receive_buffer, int* counts, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, MPI_Request* request), (send_buffer, receive_buffer, counts, datatype, operation, communicator, request), MPIM_arguments_collective(communicator, MPIM_VARIABLE_COUNT, datatype)) \
+    X(IREDUCE_SCATTER_BLOCK, Ireduce_scatter_block, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator, MPI_Request* request), (send_buffer, receive_buffer, count, datatype, operation, communicator, request), MPIM_arguments_collective(communicator, count, datatype)) \
+    X(IRSEND, Irsend, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P, GENERATED, (void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request), (buffer, count, type, dst, tag, comm, request), MPIM_arguments_send(dst, tag, comm, count, type)) \
+    X(ISCATTER, Iscatter, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator, request), MPIM_arguments_rooted_collective(root, communicator, count_recv, datatype_recv)) \
+    X(ISCATTERV, Iscatterv, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* buffer_send, const int counts_send[], const int displacements[], MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator, MPI_Request* request), (buffer_send, counts_send, displacements, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator, request), MPIM_arguments_rooted_collective(root, communicator, count_recv, datatype_recv)) \
+    X(ISEND, Isend, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P, GENERATED, (void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request), (buffer, count, type, dst, tag, comm, request), MPIM_arguments_send(dst, tag, comm, count, type)) \
+    X(ISSEND, Issend, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P, GENERATED, (void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm, MPI_Request* request), (buffer, count, type, dst, tag, comm, request), MPIM_arguments_send(dst, tag, comm, count, type)) \
+    X(MPROBE, Mprobe, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_P2P, GENERATED, (int source, int tag, MPI_Comm communicator, MPI_Message* matched_message, MPI_Status* status), (source, tag, communicator, matched_message, status), MPIM_arguments_receive(source, tag, communicator, 0, MPI_DATATYPE_NULL)) \
+    X(MRECV, Mrecv, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_P2P, GENERATED, (void* buffer, int count, MPI_Datatype datatype, MPI_Message* matched_message, MPI_Status* status), (buffer, count, datatype, matched_message, status), MPIM_arguments_matched_receive(count, datatype)) \
+    X(NEIGHBOR_ALLGATHER, Neighbor_allgather, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator), MPIM_arguments_collective(communicator, count_send, datatype_send)) \
+    X(NEIGHBOR_ALLGATHERV, Neighbor_allgatherv, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, const int counts_recv[], const int displacements[], MPI_Datatype datatype_recv, MPI_Comm communicator), (buffer_send, count_send, datatype_send, buffer_recv, counts_recv, displacements, datatype_recv, communicator), MPIM_arguments_collective(communicator, count_send, datatype_send)) \
+    X(NEIGHBOR_ALLTOALL, Neighbor_alltoall, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, MPI_Comm communicator), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, communicator), MPIM_arguments_collective(communicator, count_send, datatype_send)) \
+    X(NEIGHBOR_ALLTOALLV, Neighbor_alltoallv, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* buffer_send, const int counts_send[], const int displacements_send[], MPI_Datatype datatype_send, void* buffer_recv, const int counts_recv[], const int displacements_recv[], MPI_Datatype datatype_recv, MPI_Comm communicator), (buffer_send, counts_send, displacements_send, datatype_send, buffer_recv, counts_recv, displacements_recv, datatype_recv, communicator), MPIM_arguments_collective(communicator, MPIM_VARIABLE_COUNT, datatype_send)) \
+    X(NEIGHBOR_ALLTOALLW, Neighbor_alltoallw, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* buffer_send, const int counts_send[], const MPI_Aint displacements_send[], const MPI_Datatype datatypes_send[], void* buffer_recv, const int counts_recv[], const MPI_Aint displacements_recv[], const MPI_Datatype datatypes_recv[], MPI_Comm communicator), (buffer_send, counts_send, displacements_send, datatypes_send, buffer_recv, counts_recv, displacements_recv, datatypes_recv, communicator), MPIM_arguments_collective(communicator, MPIM_VARIABLE_COUNT, MPI_DATATYPE_NULL)) \
+    X(OP_CREATE, Op_create, int, 0, GENERATED, (MPI_User_function* user_function, int commutativity, MPI_Op* handle), (user_function, commutativity, handle), MPIM_arguments_none()) \
+    X(OP_FREE, Op_free, int, 0, GENERATED, (MPI_Op* handle), (handle), MPIM_arguments_none()) \
+    X(PROBE, Probe, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_P2P, GENERATED, (int source, int tag, MPI_Comm communicator, MPI_Status* status), (source, tag, communicator, status), MPIM_arguments_receive(source, tag, communicator, 0, MPI_DATATYPE_NULL)) \
+    X(PUT, Put, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_RMA, HOOKED, (const void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Win window), (origin_address, origin_count, origin_datatype, target_rank, target_displacement, target_count, target_datatype, window), MPIM_arguments_rma(target_rank, origin_count, origin_datatype, window)) \
+    X(RACCUMULATE, Raccumulate, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_RMA, HOOKED, (const void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Op operation, MPI_Win window, MPI_Request* request), (origin_address, origin_count, origin_datatype, target_rank, target_displacement, target_count, target_datatype, operation, window, request), MPIM_arguments_rma(target_rank, origin_count, origin_datatype, window)) \
+    X(RECV, Recv, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_P2P, CUSTOM, (void* buffer, int count, MPI_Datatype type, int source, int tag, MPI_Comm comm, MPI_Status* status), (buffer, count, type, source, tag, comm, status), MPIM_arguments_receive(source, tag, comm, count, type)) \
+    X(RECV_INIT, Recv_init, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P | MPIM_ROUTINE_PERSISTENT, HOOKED, (void* buffer, int count, MPI_Datatype datatype, int sender, int tag, MPI_Comm communicator, MPI_Request* request), (buffer, count, datatype, sender, tag, communicator, request), MPIM_arguments_receive(sender, tag, communicator, count, datatype)) \
+    X(REDUCE, Reduce, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, int root, MPI_Comm communicator), (send_buffer, receive_buffer, count, datatype, operation, root, communicator), MPIM_arguments_rooted_collective(root, communicator, count, datatype)) \
+    X(REDUCE_SCATTER, Reduce_scatter, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_N_TO_N, GENERATED, (const void* send_buffer, void* receive_buffer, int* counts, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator), (send_buffer, receive_buffer, counts, datatype, operation, communicator), MPIM_arguments_collective(communicator, MPIM_VARIABLE_COUNT, datatype)) \
+    X(REDUCE_SCATTER_BLOCK, Reduce_scatter_block, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_N_TO_N, GENERATED, (const void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator), (send_buffer, receive_buffer, count, datatype, operation, communicator), MPIM_arguments_collective(communicator, count, datatype)) \
+    X(REQUEST_FREE, Request_free, int, 0, CUSTOM, (MPI_Request* request), (request), MPIM_arguments_requests(1)) \
+    X(RGET, Rget, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_RMA, HOOKED, (void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Win window, MPI_Request* request), (origin_address, origin_count, origin_datatype, target_rank, target_displacement, target_count, target_datatype, window, request), MPIM_arguments_rma(target_rank, origin_count, origin_datatype, window)) \
+    X(RGET_ACCUMULATE, Rget_accumulate, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_RMA, HOOKED, (const void* origin_address, int origin_count, MPI_Datatype origin_datatype, void* result_address, int result_count, MPI_Datatype result_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Op operation, MPI_Win window, MPI_Request* request), (origin_address, origin_count, origin_datatype, result_address, result_count, result_datatype, target_rank, target_displacement, target_count, target_datatype, operation, window, request), MPIM_arguments_rma(target_rank, origin_count, origin_datatype, window)) \
+    X(RPUT, Rput, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_RMA, HOOKED, (const void* origin_address, int origin_count, MPI_Datatype origin_datatype, int target_rank, MPI_Aint target_displacement, int target_count, MPI_Datatype target_datatype, MPI_Win window, MPI_Request* request), (origin_address, origin_count, origin_datatype, target_rank, target_displacement, target_count, target_datatype, window, request), MPIM_arguments_rma(target_rank, origin_count, origin_datatype, window)) \
+    X(RSEND, Rsend, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_P2P, GENERATED, (void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm), (buffer, count, type, dst, tag, comm), MPIM_arguments_send(dst, tag, comm, count, type)) \
+    X(RSEND_INIT, Rsend_init, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P | MPIM_ROUTINE_PERSISTENT, HOOKED, (const void* buffer, int count, MPI_Datatype datatype, int recipient, int tag, MPI_Comm communicator, MPI_Request* request), (buffer, count, datatype, recipient, tag, communicator, request), MPIM_arguments_send(recipient, tag, communicator, count, datatype)) \
+    X(SCAN, Scan, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (void* send_buffer, void* receive_buffer, int count, MPI_Datatype datatype, MPI_Op operation, MPI_Comm communicator), (send_buffer, receive_buffer, count, datatype, operation, communicator), MPIM_arguments_collective(communicator, count, datatype)) \
+    X(SCATTER, Scatter, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* buffer_send, int count_send, MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator), (buffer_send, count_send, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator), MPIM_arguments_rooted_collective(root, communicator, count_recv, datatype_recv)) \
+    X(SCATTERV, Scatterv, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE, GENERATED, (const void* buffer_send, const int counts_send[], const int displacements[], MPI_Datatype datatype_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int root, MPI_Comm communicator), (buffer_send, counts_send, displacements, datatype_send, buffer_recv, count_recv, datatype_recv, root, communicator), MPIM_arguments_rooted_collective(root, communicator, count_recv, datatype_recv)) \
+    X(SEND, Send, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_P2P, GENERATED, (void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm), (buffer, count, type, dst, tag, comm), MPIM_arguments_send(dst, tag, comm, count, type)) \
+    X(SEND_INIT, Send_init, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P | MPIM_ROUTINE_PERSISTENT, HOOKED, (const void* buffer, int count, MPI_Datatype datatype, int recipient, int tag, MPI_Comm communicator, MPI_Request* request), (buffer, count, datatype, recipient, tag, communicator, request), MPIM_arguments_send(recipient, tag, communicator, count, datatype)) \
+    X(SENDRECV, Sendrecv, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_P2P, GENERATED, (const void* buffer_send, int count_send, MPI_Datatype datatype_send, int recipient, int tag_send, void* buffer_recv, int count_recv, MPI_Datatype datatype_recv, int sender, int tag_recv, MPI_Comm communicator, MPI_Status* status), (buffer_send, count_send, datatype_send, recipient, tag_send, buffer_recv, count_recv, datatype_recv, sender, tag_recv, communicator, status), MPIM_arguments_sendrecv(recipient, tag_send, sender, tag_recv, communicator, count_send, datatype_send)) \
+    X(SENDRECV_REPLACE, Sendrecv_replace, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_P2P, GENERATED, (void* buffer, int count_send, MPI_Datatype datatype_send, int recipient, int tag_send, int sender, int tag_recv, MPI_Comm communicator, MPI_Status* status), (buffer, count_send, datatype_send, recipient, tag_send, sender, tag_recv, communicator, status), MPIM_arguments_sendrecv(recipient, tag_send, sender, tag_recv, communicator, count_send, datatype_send)) \
+    X(SSEND, Ssend, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_P2P, GENERATED, (void* buffer, int count, MPI_Datatype type, int dst, int tag, MPI_Comm comm), (buffer, count, type, dst, tag, comm), MPIM_arguments_send(dst, tag, comm, count, type)) \
+    X(SSEND_INIT, Ssend_init, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_P2P | MPIM_ROUTINE_PERSISTENT, HOOKED, (const void* buffer, int count, MPI_Datatype datatype, int recipient, int tag, MPI_Comm communicator, MPI_Request* request), (buffer, count, datatype, recipient, tag, communicator, request), MPIM_arguments_send(recipient, tag, communicator, count, datatype)) \
+    X(START, Start, int, MPIM_ROUTINE_NONBLOCKING, HOOKED, (MPI_Request* request), (request), MPIM_arguments_requests(1)) \
+    X(STARTALL, Startall, int, MPIM_ROUTINE_NONBLOCKING, HOOKED, (int count, MPI_Request requests[]), (count, requests), MPIM_arguments_requests(count)) \
+    X(TEST, Test, int, MPIM_ROUTINE_NONBLOCKING, COMPLETING, (MPI_Request* request, int* flag, MPI_Status* status), (request, flag, status), MPIM_arguments_requests(1)) \
+    X(TEST_CANCELLED, Test_cancelled, int, MPIM_ROUTINE_LOCAL, GENERATED, (const MPI_Status* status, int* flag), (status, flag), MPIM_arguments_none()) \
+    X(TESTALL, Testall, int, MPIM_ROUTINE_NONBLOCKING, COMPLETING, (int count, MPI_Request* requests, int* flag, MPI_Status* statuses), (count, requests, flag, statuses), MPIM_arguments_requests(count)) \
+    X(TESTANY, Testany, int, MPIM_ROUTINE_NONBLOCKING, COMPLETING, (int count, MPI_Request* requests, int* index, int* flag, MPI_Status* status), (count, requests, index, flag, status), MPIM_arguments_requests(count)) \
+    X(TESTSOME, Testsome, int, MPIM_ROUTINE_NONBLOCKING, COMPLETING, (int count, MPI_Request* requests, int* index_count, int* indexes, MPI_Status* statuses), (count, requests, index_count, indexes, statuses), MPIM_arguments_requests(count)) \
+    X(TYPE_COMMIT, Type_commit, int, 0, GENERATED, (MPI_Datatype* datatype), (datatype), MPIM_arguments_none()) \
+    X(TYPE_CONTIGUOUS, Type_contiguous, int, 0, GENERATED, (int count, MPI_Datatype old_datatype, MPI_Datatype* new_datatype), (count, old_datatype, new_datatype), MPIM_arguments_none()) \
+    X(TYPE_CREATE_HINDEXED, Type_create_hindexed, int, 0, GENERATED, (int block_count, int* block_lengths, MPI_Aint* displacements, MPI_Datatype old_datatype, MPI_Datatype* new_datatype), (block_count, block_lengths, displacements, old_datatype, new_datatype), MPIM_arguments_none()) \
+    X(TYPE_CREATE_HINDEXED_BLOCK, Type_create_hindexed_block, int, 0, GENERATED, (int block_count, int block_length, MPI_Aint* displacements, MPI_Datatype old_datatype, MPI_Datatype* new_datatype), (block_count, block_length, displacements, old_datatype, new_datatype), MPIM_arguments_none()) \
+    X(TYPE_CREATE_HVECTOR, Type_create_hvector, int, 0, GENERATED, (int block_count, int block_length, MPI_Aint stride, MPI_Datatype old_datatype, MPI_Datatype* new_datatype), (block_count, block_length, stride, old_datatype, new_datatype), MPIM_arguments_none()) \
+    X(TYPE_CREATE_INDEXED_BLOCK, Type_create_indexed_block, int, 0, GENERATED, (int block_count, int block_length, int* displacements, MPI_Datatype old_datatype, MPI_Datatype* new_datatype), (block_count, block_length, displacements, old_datatype, new_datatype), MPIM_arguments_none()) \
+    X(TYPE_CREATE_STRUCT, Type_create_struct, int, 0, GENERATED, (int block_count, const int block_lengths[], const MPI_Aint displacements[], MPI_Datatype block_types[], MPI_Datatype* new_datatype), (block_count, block_lengths, displacements, block_types, new_datatype), MPIM_arguments_none()) \
+    X(TYPE_CREATE_SUBARRAY, Type_create_subarray, int, 0, GENERATED, (int dim_count, const int array_element_counts[], const int subarray_element_counts[], const int subarray_coordinates[], int order, MPI_Datatype old_datatype, MPI_Datatype* new_datatype), (dim_count, array_element_counts, subarray_element_counts, subarray_coordinates, order, old_datatype, new_datatype), MPIM_arguments_none()) \
+    X(TYPE_FREE, Type_free, int, 0, CUSTOM, (MPI_Datatype* datatype), (datatype), MPIM_arguments_none()) \
+    X(TYPE_GET_EXTENT, Type_get_extent, int, MPIM_ROUTINE_LOCAL, GENERATED, (MPI_Datatype datatype, MPI_Aint* lower_bound, MPI_Aint* extent), (datatype, lower_bound, extent), MPIM_arguments_none()) \
+    X(TYPE_INDEXED, Type_indexed, int, 0, GENERATED, (int block_count, int* block_lengths, const int displacements[], MPI_Datatype old_datatype, MPI_Datatype* new_datatype), (block_count, block_lengths, displacements, old_datatype, new_datatype), MPIM_arguments_none()) \
+    X(TYPE_VECTOR, Type_vector, int, 0, GENERATED, (int block_count, int block_length, int stride, MPI_Datatype old_datatype, MPI_Datatype* new_datatype), (block_count, block_length, stride, old_datatype, new_datatype), MPIM_arguments_none()) \
+    X(WAIT, Wait, int, MPIM_ROUTINE_BLOCKING, COMPLETING, (MPI_Request* request, MPI_Status* status), (request, status), MPIM_arguments_requests(1)) \
+    X(WAITALL, Waitall, int, MPIM_ROUTINE_BLOCKING, COMPLETING, (int count, MPI_Request requests[], MPI_Status statuses[]), (count, requests, statuses), MPIM_arguments_requests(count)) \
+    X(WAITANY, Waitany, int, MPIM_ROUTINE_BLOCKING, COMPLETING, (int count, MPI_Request requests[], int* index, MPI_Status* status), (count, requests, index, status), MPIM_arguments_requests(count)) \
+    X(WAITSOME, Waitsome, int, MPIM_ROUTINE_BLOCKING, COMPLETING, (int request_count, MPI_Request requests[], int* index_count, int indices[], MPI_Status statuses[]), (request_count, requests, index_count, indices, statuses), MPIM_arguments_requests(request_count)) \
+    X(WIN_ALLOCATE, Win_allocate, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_RMA, HOOKED, (MPI_Aint size, int displacement_unit, MPI_Info info, MPI_Comm communicator, void* base, MPI_Win* window), (size, displacement_unit, info, communicator, base, window), MPIM_arguments_communicator(communicator)) \
+    X(WIN_ALLOCATE_SHARED, Win_allocate_shared, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_RMA, HOOKED, (MPI_Aint size, int displacement_unit, MPI_Info info, MPI_Comm communicator, void* base, MPI_Win* window), (size, displacement_unit, info, communicator, base, window), MPIM_arguments_communicator(communicator)) \
+    X(WIN_ATTACH, Win_attach, int, MPIM_ROUTINE_RMA, GENERATED, (MPI_Win window, void* base, MPI_Aint size), (window, base, size), MPIM_arguments_window(window)) \
+    X(WIN_COMPLETE, Win_complete, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_RMA, HOOKED, (MPI_Win window), (window), MPIM_arguments_window(window)) \
+    X(WIN_CREATE, Win_create, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_RMA, HOOKED, (void* base, MPI_Aint size, int displacement_unit, MPI_Info info, MPI_Comm communicator, MPI_Win* window), (base, size, displacement_unit, info, communicator, window), MPIM_arguments_communicator(communicator)) \
+    X(WIN_CREATE_DYNAMIC, Win_create_dynamic, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_RMA, HOOKED, (MPI_Info info, MPI_Comm communicator, MPI_Win* window), (info, communicator, window), MPIM_arguments_communicator(communicator)) \
+    X(WIN_DETACH, Win_detach, int, MPIM_ROUTINE_RMA, GENERATED, (MPI_Win window, const void* base), (window, base), MPIM_arguments_window(window)) \
+    X(WIN_FENCE, Win_fence, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_RMA, HOOKED, (int assertion, MPI_Win window), (assertion, window), MPIM_arguments_window(window)) \
+    X(WIN_FLUSH, Win_flush, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_RMA, HOOKED, (int rank, MPI_Win window), (rank, window), MPIM_arguments_rma(rank, 0, MPI_DATATYPE_NULL, window)) \
+    X(WIN_FLUSH_ALL, Win_flush_all, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_RMA, HOOKED, (MPI_Win window), (window), MPIM_arguments_window(window)) \
+    X(WIN_FLUSH_LOCAL, Win_flush_local, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_RMA, HOOKED, (int rank, MPI_Win window), (rank, window), MPIM_arguments_rma(rank, 0, MPI_DATATYPE_NULL, window)) \
+    X(WIN_FLUSH_LOCAL_ALL, Win_flush_local_all, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_RMA, HOOKED, (MPI_Win window), (window), MPIM_arguments_window(window)) \
+    X(WIN_FREE, Win_free, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_COLLECTIVE | MPIM_ROUTINE_RMA, CUSTOM, (MPI_Win* window), (window), MPIM_arguments_window(*window)) \
+    X(WIN_LOCK, Win_lock, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_RMA, HOOKED, (int lock_type, int rank, int assertion, MPI_Win window), (lock_type, rank, assertion, window), MPIM_arguments_rma(rank, 0, MPI_DATATYPE_NULL, window)) \
+    X(WIN_LOCK_ALL, Win_lock_all, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_RMA, HOOKED, (int assertion, MPI_Win window), (assertion, window), MPIM_arguments_window(window)) \
+    X(WIN_POST, Win_post, int, MPIM_ROUTINE_RMA, HOOKED, (MPI_Group group, int assertion, MPI_Win window), (group, assertion, window), MPIM_arguments_window(window)) \
+    X(WIN_SHARED_QUERY, Win_shared_query, int, MPIM_ROUTINE_LOCAL, GENERATED, (MPI_Win window, int rank, MPI_Aint* size, int* displacement_unit, void* base), (window, rank, size, displacement_unit, base), MPIM_arguments_window(window)) \
+    X(WIN_START, Win_start, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_RMA, HOOKED, (MPI_Group group, int assertion, MPI_Win window), (group, assertion, window), MPIM_arguments_window(window)) \
+    X(WIN_SYNC, Win_sync, int, MPIM_ROUTINE_RMA, GENERATED, (MPI_Win window), (window), MPIM_arguments_window(window)) \
+    X(WIN_TEST, Win_test, int, MPIM_ROUTINE_NONBLOCKING | MPIM_ROUTINE_RMA, HOOKED, (MPI_Win window, int* flag), (window, flag), MPIM_arguments_window(window)) \
+    X(WIN_UNLOCK, Win_unlock, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_RMA, HOOKED, (int rank, MPI_Win window), (rank, window), MPIM_arguments_rma(rank, 0, MPI_DATATYPE_NULL, window)) \
+    X(WIN_UNLOCK_ALL, Win_unlock_all, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_RMA, HOOKED, (MPI_Win window), (window), MPIM_arguments_window(window)) \
+    X(WIN_WAIT, Win_wait, int, MPIM_ROUTINE_BLOCKING | MPIM_ROUTINE_RMA, HOOKED, (MPI_Win window), (window), MPIM_arguments_window(window)) \
+    X(WTIME, Wtime, double, MPIM_ROUTINE_LOCAL, CUSTOM_NULLARY, (), (), MPIM_arguments_none())
+
+#endif // MPI_MONITOR_ROUTINES_H_INCLUDED
@@ -0,0 +1,112 @@
+/**
+ * @file mpi_monitor_snapshot.h
+ * @brief The layout of the file in which the aggregator publishes its last snapshot of the slots, for local tools to map read-only.
+ * @details The file starts with a struct MPIM_published_header_t, followed at names_offset by name_count routine names of MPIM_PUBLISHED_NAME_LENGTH bytes, and at slots_offset by slot_count struct MPIM_published_slot_t. The layout never changes during a run.
+ * Every slot is a seqlock: its sequence is odd while the aggregator writes it, and a copy taken between two reads of the same even sequence is consistent. The generation of the header works the same way over the whole frame, for readers wanting every slot from the same frame. Readers never block the aggregator, which never waits for them.
+ **/
+
+#ifndef MPI_MONITOR_SNAPSHOT_H_INCLUDED
+#define MPI_MONITOR_SNAPSHOT_H_INCLUDED
+
+#include <stdbool.h> // bool
+#include <stdint.h> // uint64_t
+#include <string.h> // memcpy
+
+/// Starts the file, "MPIMSNAP" in ASCII, written once the rest of the layout is in place
+#define MPIM_PUBLISHED_MAGIC 0x50414E534D49504DULL
+/// Version of the layout, bumped whenever one of the structures below changes
+#define MPIM_PUBLISHED_VERSION 1
+/// Size of a routine name, NUL-terminated
+#define MPIM_PUBLISHED_NAME_LENGTH 48
+/// Size of the callsite of a slot, NUL-terminated
+#define MPIM_PUBLISHED_WHERE_LENGTH 64
+/// Size of the details of a slot, NUL-terminated
+#define MPIM_PUBLISHED_DETAILS_LENGTH 256
+
+/**
+ * @brief Starts the file.
+ **/
+struct MPIM_published_header_t
+{
+    /// MPIM_PUBLISHED_MAGIC, 0 while the file is being laid out
+    uint64_t magic;
+    /// MPIM_PUBLISHED_VERSION
+    uint32_t version;
+    /// The size of struct MPIM_published_slot_t
+    uint32_t slot_size;
+    /// The offset of the routine names from the start of the file
+    uint64_t names_offset;
+    /// The number of routine names, indexed by the types of the slots
+    uint32_t name_count;
+    /// The number of slots, one per monitored thread of every process
+    uint32_t slot_count;
+    /// The offset of the slots from the start of the file
+    uint64_t slots_offset;
+    /// The number of slots of every process, slot i belonging to thread i % threads_per_process of process i / threads_per_process
+    uint32_t threads_per_process;
+    /// 1 once every process has called MPI_Finalize, the file then holding the last frame of the run
+    uint32_t finished;
+    /// Number of frames published so far times two, odd while a frame is being published
+    uint64_t generation;
+    /// The number of seconds elapsed since the aggregator started at the last frame, in which the times of the slots are expressed
+    double runtime;
+    /// The largest error bound on the clock offsets of the processes at the last frame, in seconds
+    double clock_error;
+};
+
+/**
+ * @brief Describes the last update of a slot.
+ **/
+struct MPIM_published_slot_t
+{
+    /// Number of times the slot was written times two, odd while it is being written
+    uint64_t sequence;
+    /// The routine called, an index in the routine names
+    uint32_t type;
+    /// 1 if the update was sent before the call, 0 if after
+    uint8_t before;
+    /// 1 if the thread has issued an MPI call, or is the first thread of its process
+    uint8_t displayed;
+    /// The time at which the update was sent, in seconds since the aggregator started
+    double time;
+    /// Number of MPI calls issued by the thread
+    uint64_t call_count;
+    /// Time spent by the thread in the MPI calls it completed, in nanoseconds
+    uint64_t mpi_nanoseconds;
+    /// Size of the data sent by the thread in point-to-point communications, in bytes
+    uint64_t sent_bytes;
+    /// Size of the data received by the thread in point-to-point communications, in bytes
+    uint64_t received_bytes;
+    /// The callsite of the call
+    char where[MPIM_PUBLISHED_WHERE_LENGTH];
+    /// The details of the call
+    char details[MPIM_PUBLISHED_DETAILS_LENGTH];
+};
+
+/**
+ * @brief Copies a slot of a mapped snapshot file, retrying while the aggregator writes it.
+ * @param[in] slot The slot, in the mapping.
+ * @param[out] copy The consistent copy of the slot.
+ * @param[in] attempts The number of attempts before giving up.
+ * @return true if the copy is consistent, false if the slot was being written at every attempt.
+ **/
+static inline bool MPIM_published_slot_read(const struct MPIM_published_slot_t* slot, struct MPIM_published_slot_t* copy, int attempts)
+{
+    for(int attempt = 0; attempt < attempts; attempt++)
+    {
+        uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if(sequence % 2 == 1)
+        {
+            continue;
+        }
+        memcpy(copy, slot, sizeof(struct MPIM_published_slot_t));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == sequence)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // MPI_MONITOR_SNAPSHOT_H_INCLUDED
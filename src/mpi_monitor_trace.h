@@ -0,0 +1,196 @@
+/**
+ * @file mpi_monitor_trace.h
+ * @brief The format of the trace in which every MPI process records every MPI call of its threads.
+ * @details The file of a process starts with a struct MPIM_trace_header_t, followed by name_count NUL-terminated routine names spanning names_length bytes, indexed by the types of the events. Blocks follow, each a struct MPIM_trace_block_t followed by stored_length bytes of payload. A block holds the events of a single thread and is decoded on its own, so a trace cut short by a killed job stays readable up to its last complete block, which the checksum tells apart from a torn one.
+ * The payload, once decompressed if the block is compressed, is a sequence of event_count events of varints, the unsigned integers being stored 7 bits per byte starting with the least significant ones, and the signed ones zigzag-encoded first:
+ * - the head, (callsite << 2) | (before << 1) | arguments_follow, the callsite being the index of the callsite of the event in the order in which the block introduced them;
+ * - if the callsite is the next one, its definition: the routine type, the line, the identity of the module, a hash of its path (0 if unknown), the offset of the return address in the module, then the length of the file name followed by its bytes;
+ * - the time of the event minus the time of the previous event of the block, signed, in ticks; the first event of a block counts from the time of the block header;
+ * - if arguments_follow is set, the arguments, which otherwise are those of the previous event at the same callsite: kind, then communicator, count and datatype size, signed, then, signed, the peer and tag for MPIM_TRACE_ARGUMENTS_SEND and MPIM_TRACE_ARGUMENTS_RECEIVE, the destination, send tag, source and receive tag for MPIM_TRACE_ARGUMENTS_SENDRECV, the root for MPIM_TRACE_ARGUMENTS_ROOTED_COLLECTIVE, and the target and window for MPIM_TRACE_ARGUMENTS_RMA.
+ * Compressed payloads are LZ77 sequences: a varint number of literals followed by those bytes, then, unless the block is complete, a varint match length minus MPIM_TRACE_MIN_MATCH and a varint distance back in the decompressed data.
+ **/
+
+#ifndef MPI_MONITOR_TRACE_H_INCLUDED
+#define MPI_MONITOR_TRACE_H_INCLUDED
+
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+#include <string.h> // memcpy
+
+/// Starts the file, "MPIMTRCE" in ASCII
+#define MPIM_TRACE_MAGIC 0x454352544D49504DULL
+/// Starts every block, "MPIB" in ASCII, so that readers resynchronise on nothing else
+#define MPIM_TRACE_BLOCK_MAGIC 0x4249504D
+/// Version of the format, bumped whenever the structures or the encoding below change
+#define MPIM_TRACE_VERSION 3
+/// Set in the flags of a block whose payload is compressed
+#define MPIM_TRACE_BLOCK_COMPRESSED 0x1
+/// Shortest match of the compressed payloads
+#define MPIM_TRACE_MIN_MATCH 4
+/// Largest payload of a block once decompressed, in bytes
+#define MPIM_TRACE_MAX_BLOCK_LENGTH (1 << 20)
+
+/// The kinds of arguments, the same as in the library
+enum MPIM_trace_arguments_kind_t { MPIM_TRACE_ARGUMENTS_NONE,
+                                   MPIM_TRACE_ARGUMENTS_COMMUNICATOR,
+                                   MPIM_TRACE_ARGUMENTS_SEND,
+                                   MPIM_TRACE_ARGUMENTS_RECEIVE,
+                                   MPIM_TRACE_ARGUMENTS_SENDRECV,
+                                   MPIM_TRACE_ARGUMENTS_COLLECTIVE,
+                                   MPIM_TRACE_ARGUMENTS_ROOTED_COLLECTIVE,
+                                   MPIM_TRACE_ARGUMENTS_RMA,
+                                   MPIM_TRACE_ARGUMENTS_REQUESTS,
+                                   MPIM_TRACE_ARGUMENTS_MATCHED_RECEIVE };
+
+/**
+ * @brief Starts the file.
+ **/
+struct MPIM_trace_header_t
+{
+    /// MPIM_TRACE_MAGIC
+    uint64_t magic;
+    /// MPIM_TRACE_VERSION
+    uint32_t version;
+    /// The rank of the process in MPI_COMM_WORLD
+    int32_t rank;
+    /// The size of MPI_COMM_WORLD
+    int32_t comm_size;
+    /// The number of routine names following the header
+    uint32_t name_count;
+    /// The number of bytes of routine names following the header
+    uint32_t names_length;
+    /// MPI_COMM_WORLD, as given by MPI_Comm_c2f, to tell which communicators of the arguments are MPI_COMM_WORLD
+    int32_t world_communicator;
+    /// Number of ticks per second of the clock source of the process
+    double ticks_per_second;
+    /// The time at which the trace started, in ticks, from which the times of the blocks count
+    uint64_t start;
+};
+
+/**
+ * @brief Starts every block.
+ **/
+struct MPIM_trace_block_t
+{
+    /// MPIM_TRACE_BLOCK_MAGIC
+    uint32_t magic;
+    /// The thread whose events the block holds, numbered in the order in which the threads of the process issued their first MPI call
+    uint16_t thread;
+    /// MPIM_TRACE_BLOCK_COMPRESSED if the payload is compressed, 0 otherwise
+    uint16_t flags;
+    /// The number of events in the block
+    uint32_t event_count;
+    /// The length of the payload once decompressed, in bytes
+    uint32_t raw_length;
+    /// The length of the payload following the header, in bytes
+    uint32_t stored_length;
+    /// FNV-1a hash of the payload following the header
+    uint32_t checksum;
+    /// The time from which the first event of the block counts, in ticks since the start of the trace
+    uint64_t time;
+    /// Offset to add to the time of the process to obtain that of MPI process 0 when the block was written, in seconds
+    double clock_offset;
+};
+
+/**
+ * @brief Computes the checksum of a payload.
+ * @param[in] data The payload.
+ * @param[in] length The length of the payload, in bytes.
+ * @return The FNV-1a hash of the payload.
+ **/
+static inline uint32_t MPIM_trace_checksum(const uint8_t* data, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for(size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Reads an unsigned varint.
+ * @param[in,out] cursor The position of the varint, moved past it.
+ * @param[in] end The end of the data.
+ * @param[out] value The integer read.
+ * @return true if the varint is complete, false if the data ends first.
+ **/
+static inline bool MPIM_trace_read_varint(const uint8_t** cursor, const uint8_t* end, uint64_t* value)
+{
+    *value = 0;
+    for(int shift = 0; *cursor < end && shift < 64; shift += 7)
+    {
+        uint8_t byte = *(*cursor)++;
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+        if((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Reads a signed varint.
+ * @param[in,out] cursor The position of the varint, moved past it.
+ * @param[in] end The end of the data.
+ * @param[out] value The integer read.
+ * @return true if the varint is complete, false if the data ends first.
+ **/
+static inline bool MPIM_trace_read_signed_varint(const uint8_t** cursor, const uint8_t* end, int64_t* value)
+{
+    uint64_t zigzag;
+    bool complete = MPIM_trace_read_varint(cursor, end, &zigzag);
+    *value = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+    return complete;
+}
+
+/**
+ * @brief Decompresses the payload of a compressed block.
+ * @param[in] data The compressed payload.
+ * @param[in] length The length of the compressed payload, in bytes.
+ * @param[out] raw The buffer receiving the payload.
+ * @param[in] raw_length The length of the payload, as given by the block header.
+ * @return true if the payload decompresses into exactly raw_length bytes, false if it is corrupt.
+ **/
+static inline bool MPIM_trace_decompress(const uint8_t* data, size_t length, uint8_t* raw, size_t raw_length)
+{
+    const uint8_t* cursor = data;
+    const uint8_t* end = data + length;
+    size_t position = 0;
+    for(;;)
+    {
+        uint64_t literals;
+        if(!MPIM_trace_read_varint(&cursor, end, &literals) || literals > (uint64_t)(end - cursor) || literals > raw_length - position)
+        {
+            return false;
+        }
+        memcpy(raw + position, cursor, literals);
+        cursor += literals;
+        position += literals;
+        if(position == raw_length)
+        {
+            return cursor == end;
+        }
+        uint64_t match_length;
+        uint64_t distance;
+        if(!MPIM_trace_read_varint(&cursor, end, &match_length) || !MPIM_trace_read_varint(&cursor, end, &distance))
+        {
+            return false;
+        }
+        match_length += MPIM_TRACE_MIN_MATCH;
+        if(distance == 0 || distance > position || match_length > raw_length - position)
+        {
+            return false;
+        }
+        // Matches may overlap the bytes they produce, so they are copied byte by byte
+        for(uint64_t i = 0; i < match_length; i++)
+        {
+            raw[position + i] = raw[position + i - distance];
+        }
+        position += match_length;
+    }
+}
+
+#endif // MPI_MONITOR_TRACE_H_INCLUDED
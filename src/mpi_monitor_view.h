@@ -0,0 +1,91 @@
+/**
+ * @file mpi_monitor_view.h
+ * @brief The protocol with which the aggregator serves the live state of the run to the viewers attached to its Unix domain socket.
+ * @details Every message is a header followed by length bytes of payload, in the byte order of the node, as viewers run on the node of MPI process 0:
+ * - MPIM_VIEW_NAMES, sent once to every viewer that attaches: a uint32_t count, followed by as many NUL-terminated routine names, indexed by the type of the rows.
+ * - MPIM_VIEW_FRAME, sent every refresh: a struct MPIM_view_frame_t, followed by row_count rows. A row is a struct MPIM_view_row_t followed by where_length bytes of callsite and details_length bytes of details, neither NUL-terminated. Keyframes hold a row for every slot, other frames only the slots updated since the previous frame.
+ * - MPIM_VIEW_END, without payload, sent once every process has called MPI_Finalize.
+ **/
+
+#ifndef MPI_MONITOR_VIEW_H_INCLUDED
+#define MPI_MONITOR_VIEW_H_INCLUDED
+
+#include <stdint.h> // uint32_t
+
+/// Starts every message, "MPIM" in ASCII, so that a viewer attached to the wrong socket notices
+#define MPIM_VIEW_MAGIC 0x4D49504D
+/// Version of the protocol, bumped whenever one of the structures below changes
+#define MPIM_VIEW_VERSION 2
+/// Size of the buffer holding the name of the flush policy in a frame
+#define MPIM_VIEW_FLUSH_POLICY_LENGTH 16
+/// Size of the buffer holding the name of the communicator of a row
+#define MPIM_VIEW_COMMUNICATOR_LENGTH 16
+
+enum MPIM_view_message_kind_t { MPIM_VIEW_NAMES,
+                                MPIM_VIEW_FRAME,
+                                MPIM_VIEW_END };
+
+/**
+ * @brief Starts every message sent to a viewer.
+ **/
+struct MPIM_view_header_t
+{
+    /// MPIM_VIEW_MAGIC
+    uint32_t magic;
+    /// MPIM_VIEW_VERSION
+    uint16_t version;
+    /// The kind of message, from MPIM_view_message_kind_t
+    uint16_t kind;
+    /// The number of bytes following the header
+    uint32_t length;
+};
+
+/**
+ * @brief Describes the state of the run at a refresh of the live display.
+ **/
+struct MPIM_view_frame_t
+{
+    /// The number of slots, one per monitored thread of every process
+    uint32_t slot_count;
+    /// The number of slots of every process, slot i belonging to thread i % threads_per_process of process i / threads_per_process
+    uint32_t threads_per_process;
+    /// The number of rows following
+    uint32_t row_count;
+    /// 1 if the rows cover every slot, 0 if they only cover the slots updated since the previous frame
+    uint32_t keyframe;
+    /// The number of seconds elapsed since the aggregator started, in which the times of the rows are expressed
+    double runtime;
+    /// The largest error bound on the clock offsets of the processes, in seconds
+    double clock_error;
+    /// The name of the flush policy, NUL-terminated
+    char flush_policy[MPIM_VIEW_FLUSH_POLICY_LENGTH];
+};
+
+/**
+ * @brief Describes the last update of a slot.
+ **/
+struct MPIM_view_row_t
+{
+    /// The slot
+    uint32_t slot;
+    /// The routine called, an index in the names of MPIM_VIEW_NAMES
+    uint32_t type;
+    /// The time at which the update was sent, in seconds since the aggregator started
+    double time;
+    /// Size of the data sent by the thread in point-to-point communications, in bytes
+    uint64_t sent_bytes;
+    /// Size of the data received by the thread in point-to-point communications, in bytes
+    uint64_t received_bytes;
+    /// The name of the communicator of the call, NUL-terminated, empty if the call has none
+    char communicator[MPIM_VIEW_COMMUNICATOR_LENGTH];
+    /// 1 if the update was sent before the call, 0 if after
+    uint8_t before;
+    /// 1 if the slot must be displayed, 0 if its thread has not issued any MPI call yet
+    uint8_t displayed;
+    /// The number of bytes of callsite following the row
+    uint16_t where_length;
+    /// The number of bytes of details following the callsite
+    uint16_t details_length;
+};
+
+#endif // MPI_MONITOR_VIEW_H_INCLUDED